@@ -24,11 +24,20 @@
 #include <stdint.h>
 #include <ghost.h>
 #include <libahci/ahci.hpp>
+#include "port.hpp"
 
 bool ahciDriverIdentifyController();
-bool ahciPortStartCommands(volatile g_ahci_hba_port* port);
-bool ahciPortStopCommands(volatile g_ahci_hba_port* port);
-int ahciFindFreeCommandSlot(volatile g_ahci_hba_port* port);
-void ahciIdentifyDevice(uint8_t portNumber, volatile g_ahci_hba_port* port);
+
+/**
+ * Serves requests to the mountpoint and handles interrupts of the controller. Runs on
+ * core 0, as IRQs can only be waited for there.
+ */
+void ahciDriverServe();
+void ahciDriverHandleInterrupt();
+
+/**
+ * @return the port with the given number or 0 if it has no usable device
+ */
+ahci_port* ahciDriverGetPort(uint8_t number);
 
 #endif
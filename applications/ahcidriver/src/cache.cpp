@@ -0,0 +1,724 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "cache.hpp"
+
+#include <deque>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+#define AHCI_CACHE_RUN_BLOCKS		(AHCI_COMMAND_BUFFER_SIZE / AHCI_CACHE_BLOCK_SIZE)
+#define AHCI_CACHE_REQUEST_BLOCKS	((G_FS_TASKED_DELEGATE_TRANSFER_SIZE / AHCI_CACHE_BLOCK_SIZE) + 1)
+
+/**
+ * Keys are ordered by disk and then by block, so that the dirty blocks of a disk are
+ * adjacent and in the order they are written back.
+ */
+#define AHCI_CACHE_KEY(portNumber, block)	(((uint64_t) (portNumber) << 56) | (block))
+
+struct ahci_cache_request;
+
+struct ahci_cache_block
+{
+	ahci_port* port;
+	uint64_t number;
+	uint8_t* data;
+
+	bool valid;
+	bool loading;
+	bool dirty;
+	bool writing;
+	uint32_t failedWrites;
+	uint32_t pins;
+
+	/**
+	 * Set if the block was dropped while pinned, it is invalidated once it is released.
+	 */
+	bool dropping;
+
+	/**
+	 * Generation of the disk when the block became dirty, and when the content that is
+	 * being written became dirty.
+	 */
+	uint64_t dirtyGeneration;
+	uint64_t writeGeneration;
+
+	std::vector<ahci_cache_request*> waiters;
+
+	ahci_cache_block* newer;
+	ahci_cache_block* older;
+};
+
+/**
+ * A read or write that waits until all of its blocks are loaded.
+ */
+struct ahci_cache_request
+{
+	bool write;
+	uint64_t offset;
+	uint32_t length;
+	uint8_t* buffer;
+
+	ahci_cache_block* blocks[AHCI_CACHE_REQUEST_BLOCKS];
+	uint32_t blockCount;
+	uint32_t loading;
+	bool failed;
+
+	ahci_cache_callback callback;
+	void* context;
+};
+
+struct ahci_cache_sync
+{
+	uint64_t generation;
+	bool failed;
+	ahci_cache_callback callback;
+	void* context;
+};
+
+/**
+ * Adjacent blocks that are read or written with a single command, or a flush of the
+ * disk for the syncs that waited for it.
+ */
+struct ahci_cache_run
+{
+	ahci_port* port;
+	ahci_command_type type;
+	ahci_cache_block* blocks[AHCI_CACHE_RUN_BLOCKS];
+	uint32_t blockCount;
+	std::vector<ahci_cache_sync*> syncs;
+};
+
+/**
+ * Runs wait here while all commands of the disk are in use.
+ *
+ * Each sync starts a new generation of the disk. Changes are counted per generation
+ * until they are written, so a sync waits only for the changes that were made before
+ * it, no matter how many blocks are written in the meantime.
+ */
+struct ahci_cache_disk
+{
+	std::deque<ahci_cache_run*> waitingRuns;
+	std::vector<ahci_cache_sync*> syncs;
+	uint64_t generation;
+	std::map<uint64_t, uint32_t> unwritten;
+
+	/**
+	 * Set when blocks were dropped while no sync waited, to fail the next sync.
+	 */
+	bool droppedBlocks;
+};
+
+static std::unordered_map<uint64_t, ahci_cache_block*> cacheIndex;
+static std::map<uint64_t, ahci_cache_block*> cacheDirty;
+static ahci_cache_block* cacheNewest = 0;
+static ahci_cache_block* cacheOldest = 0;
+static uint32_t cacheBlockCount = 0;
+static ahci_cache_disk cacheDisks[G_AHCI_MAXIMUM_SLOTS];
+
+static g_tid cacheFlushServer;
+
+/**
+ * Returns the block and pins it, so that it is not evicted while in use. Missing blocks
+ * are created invalid, either by reusing the least recently used evictable block or,
+ * if there is none, by allocating a new one.
+ */
+static ahci_cache_block* _ahciCacheAcquire(ahci_port* port, uint64_t number);
+static void _ahciCacheRelease(ahci_cache_block* block);
+static ahci_cache_block* _ahciCacheEvict();
+static void _ahciCacheLinkNewest(ahci_cache_block* block);
+static void _ahciCacheUnlink(ahci_cache_block* block);
+static void _ahciCacheMarkDirty(ahci_cache_block* block);
+
+/**
+ * Marks a block dirty again after its content could not be written.
+ */
+static void _ahciCacheRetry(ahci_cache_block* block);
+
+/**
+ * Removes a change of the given generation from the unwritten changes of the disk.
+ */
+static void _ahciCacheForget(ahci_port* port, uint64_t generation);
+
+/**
+ * Gives up on writing the content of a block that is not dirty again. The block becomes
+ * invalid so that it is read from the disk again, once no request uses it anymore.
+ */
+static void _ahciCacheDrop(ahci_cache_block* block);
+
+/**
+ * @return the number of sectors of the block, which is less than a full block only for
+ * 		the last block of a disk
+ */
+static uint32_t _ahciCacheBlockSectors(ahci_port* port, uint64_t number);
+
+static void _ahciCacheStartRequest(ahci_port* port, bool write, uint64_t offset, uint32_t length, uint8_t* buffer,
+                                   ahci_cache_callback callback, void* context);
+static void _ahciCacheFinishRequest(ahci_cache_request* request);
+
+static ahci_cache_run* _ahciCacheCreateRun(ahci_port* port, ahci_command_type type);
+static void _ahciCacheStartRun(ahci_cache_run* run);
+static void _ahciCacheStartWaitingRuns(ahci_port* port);
+static void _ahciCacheIssueRun(ahci_cache_run* run, ahci_command* command);
+static void _ahciCacheRunCompleted(ahci_port* port, ahci_command* command, bool successful);
+static void _ahciCacheLoaded(ahci_cache_run* run, ahci_command* command, bool successful);
+static void _ahciCacheWritten(ahci_cache_run* run, bool successful);
+static void _ahciCacheFlushed(ahci_cache_run* run, bool successful);
+
+/**
+ * Starts writing back the dirty blocks in the range of the dirty map, combining adjacent
+ * blocks of a disk into one command.
+ */
+static void _ahciCacheWriteBackRange(std::map<uint64_t, ahci_cache_block*>::iterator from,
+                                     std::map<uint64_t, ahci_cache_block*>::iterator to);
+static void _ahciCacheWriteBackDisk(ahci_port* port);
+
+/**
+ * Flushes the disk for the waiting syncs once the changes made before them are written.
+ */
+static void _ahciCacheCheckSyncs(ahci_port* port);
+
+static void _ahciCacheFlusher();
+
+g_tid ahciCacheStartFlusher(g_tid server)
+{
+	cacheFlushServer = server;
+	return g_create_task((void*) &_ahciCacheFlusher);
+}
+
+void _ahciCacheFlusher()
+{
+	uint8_t message = 0;
+	for(;;)
+	{
+		g_sleep(AHCI_CACHE_FLUSH_INTERVAL);
+		g_send_message(cacheFlushServer, &message, sizeof(message));
+	}
+}
+
+void ahciCacheRead(ahci_port* port, uint64_t offset, uint32_t length, uint8_t* buffer, ahci_cache_callback callback,
+                   void* context)
+{
+	_ahciCacheStartRequest(port, false, offset, length, buffer, callback, context);
+}
+
+void ahciCacheWrite(ahci_port* port, uint64_t offset, uint32_t length, uint8_t* buffer, ahci_cache_callback callback,
+                    void* context)
+{
+	_ahciCacheStartRequest(port, true, offset, length, buffer, callback, context);
+}
+
+void ahciCacheSync(ahci_port* port, ahci_cache_callback callback, void* context)
+{
+	ahci_cache_disk* disk = &cacheDisks[port->number];
+
+	auto sync = new ahci_cache_sync();
+	sync->generation = ++disk->generation;
+	sync->failed = disk->droppedBlocks;
+	sync->callback = callback;
+	sync->context = context;
+	disk->droppedBlocks = false;
+
+	disk->syncs.push_back(sync);
+	_ahciCacheCheckSyncs(port);
+}
+
+void ahciCacheWriteBack()
+{
+	_ahciCacheWriteBackRange(cacheDirty.begin(), cacheDirty.end());
+}
+
+void _ahciCacheStartRequest(ahci_port* port, bool write, uint64_t offset, uint32_t length, uint8_t* buffer,
+                            ahci_cache_callback callback, void* context)
+{
+	if(length == 0)
+	{
+		callback(context, true);
+		return;
+	}
+
+	auto request = new ahci_cache_request();
+	request->write = write;
+	request->offset = offset;
+	request->length = length;
+	request->buffer = buffer;
+	request->callback = callback;
+	request->context = context;
+
+	uint64_t first = offset / AHCI_CACHE_BLOCK_SIZE;
+	uint64_t last = (offset + length - 1) / AHCI_CACHE_BLOCK_SIZE;
+	request->blockCount = last - first + 1;
+
+	ahci_cache_run* run = 0;
+	for(uint32_t i = 0; i < request->blockCount; i++)
+	{
+		uint64_t number = first + i;
+		ahci_cache_block* block = _ahciCacheAcquire(port, number);
+		request->blocks[i] = block;
+
+		// Blocks that are written completely don't need to be loaded
+		uint64_t blockStart = number * AHCI_CACHE_BLOCK_SIZE;
+		uint64_t blockEnd = blockStart + _ahciCacheBlockSectors(port, number) * G_ATA_SECTOR_SIZE;
+		bool covered = write && offset <= blockStart && offset + length >= blockEnd;
+
+		if(!block->valid && !block->loading && !covered)
+		{
+			if(run && (run->blockCount == AHCI_CACHE_RUN_BLOCKS ||
+			           run->blocks[run->blockCount - 1]->number != number - 1))
+			{
+				_ahciCacheStartRun(run);
+				run = 0;
+			}
+
+			if(!run)
+				run = _ahciCacheCreateRun(port, AHCI_COMMAND_READ);
+			block->loading = true;
+			run->blocks[run->blockCount++] = block;
+		}
+
+		if(block->loading)
+		{
+			block->waiters.push_back(request);
+			request->loading++;
+		}
+	}
+
+	if(run)
+		_ahciCacheStartRun(run);
+
+	if(request->loading == 0)
+		_ahciCacheFinishRequest(request);
+}
+
+void _ahciCacheFinishRequest(ahci_cache_request* request)
+{
+	for(uint32_t i = 0; i < request->blockCount; i++)
+	{
+		ahci_cache_block* block = request->blocks[i];
+
+		if(!request->failed)
+		{
+			uint64_t blockStart = block->number * AHCI_CACHE_BLOCK_SIZE;
+			uint64_t start = request->offset > blockStart ? request->offset : blockStart;
+			uint64_t end = request->offset + request->length;
+			if(end > blockStart + AHCI_CACHE_BLOCK_SIZE)
+				end = blockStart + AHCI_CACHE_BLOCK_SIZE;
+
+			uint8_t* data = block->data + (start - blockStart);
+			uint8_t* buffer = request->buffer + (start - request->offset);
+			if(request->write)
+			{
+				memcpy(data, buffer, end - start);
+				block->valid = true;
+				_ahciCacheMarkDirty(block);
+			}
+			else
+			{
+				memcpy(buffer, data, end - start);
+			}
+		}
+
+		_ahciCacheRelease(block);
+	}
+
+	request->callback(request->context, !request->failed);
+	delete request;
+
+	if(cacheDirty.size() >= AHCI_CACHE_DIRTY_LIMIT)
+		ahciCacheWriteBack();
+}
+
+ahci_cache_block* _ahciCacheAcquire(ahci_port* port, uint64_t number)
+{
+	uint64_t key = AHCI_CACHE_KEY(port->number, number);
+
+	ahci_cache_block* block;
+	auto existing = cacheIndex.find(key);
+	if(existing != cacheIndex.end())
+	{
+		block = existing->second;
+		_ahciCacheUnlink(block);
+	}
+	else
+	{
+		// Shrink back to the capacity once blocks became evictable again
+		block = 0;
+		while(cacheBlockCount >= AHCI_CACHE_CAPACITY)
+		{
+			block = _ahciCacheEvict();
+			if(!block || cacheBlockCount == AHCI_CACHE_CAPACITY)
+				break;
+
+			delete[] block->data;
+			delete block;
+			block = 0;
+			cacheBlockCount--;
+		}
+
+		if(!block)
+		{
+			block = new ahci_cache_block();
+			block->data = new uint8_t[AHCI_CACHE_BLOCK_SIZE];
+			cacheBlockCount++;
+		}
+
+		block->port = port;
+		block->number = number;
+		block->valid = false;
+		block->loading = false;
+		block->dirty = false;
+		block->writing = false;
+		block->failedWrites = 0;
+		block->pins = 0;
+		block->dropping = false;
+		cacheIndex[key] = block;
+	}
+
+	_ahciCacheLinkNewest(block);
+	block->pins++;
+	return block;
+}
+
+void _ahciCacheRelease(ahci_cache_block* block)
+{
+	if(--block->pins == 0 && block->dropping)
+	{
+		block->dropping = false;
+		block->valid = false;
+	}
+}
+
+ahci_cache_block* _ahciCacheEvict()
+{
+	for(ahci_cache_block* block = cacheOldest; block; block = block->newer)
+	{
+		if(block->pins || block->loading || block->dirty || block->writing)
+			continue;
+
+		_ahciCacheUnlink(block);
+		cacheIndex.erase(AHCI_CACHE_KEY(block->port->number, block->number));
+		return block;
+	}
+	return 0;
+}
+
+void _ahciCacheLinkNewest(ahci_cache_block* block)
+{
+	block->newer = 0;
+	block->older = cacheNewest;
+	if(cacheNewest)
+		cacheNewest->newer = block;
+	else
+		cacheOldest = block;
+	cacheNewest = block;
+}
+
+void _ahciCacheUnlink(ahci_cache_block* block)
+{
+	if(block->newer)
+		block->newer->older = block->older;
+	else
+		cacheNewest = block->older;
+
+	if(block->older)
+		block->older->newer = block->newer;
+	else
+		cacheOldest = block->newer;
+
+	block->newer = 0;
+	block->older = 0;
+}
+
+void _ahciCacheMarkDirty(ahci_cache_block* block)
+{
+	if(block->dirty)
+		return;
+
+	ahci_cache_disk* disk = &cacheDisks[block->port->number];
+	block->dirty = true;
+	block->dropping = false;
+	block->dirtyGeneration = disk->generation;
+	disk->unwritten[block->dirtyGeneration]++;
+	cacheDirty[AHCI_CACHE_KEY(block->port->number, block->number)] = block;
+}
+
+void _ahciCacheRetry(ahci_cache_block* block)
+{
+	// The content that failed is older than changes made during the write, so the block
+	// takes over its generation
+	if(block->dirty)
+	{
+		_ahciCacheForget(block->port, block->dirtyGeneration);
+	}
+	else
+	{
+		block->dirty = true;
+		cacheDirty[AHCI_CACHE_KEY(block->port->number, block->number)] = block;
+	}
+	block->dirtyGeneration = block->writeGeneration;
+}
+
+void _ahciCacheForget(ahci_port* port, uint64_t generation)
+{
+	auto& unwritten = cacheDisks[port->number].unwritten;
+	auto entry = unwritten.find(generation);
+	if(--entry->second == 0)
+		unwritten.erase(entry);
+}
+
+void _ahciCacheDrop(ahci_cache_block* block)
+{
+	_ahciCacheForget(block->port, block->writeGeneration);
+	block->failedWrites = 0;
+
+	if(block->pins)
+		block->dropping = true;
+	else
+		block->valid = false;
+}
+
+uint32_t _ahciCacheBlockSectors(ahci_port* port, uint64_t number)
+{
+	uint64_t remaining = port->sectors - number * AHCI_CACHE_BLOCK_SECTORS;
+	return remaining < AHCI_CACHE_BLOCK_SECTORS ? remaining : AHCI_CACHE_BLOCK_SECTORS;
+}
+
+ahci_cache_run* _ahciCacheCreateRun(ahci_port* port, ahci_command_type type)
+{
+	auto run = new ahci_cache_run();
+	run->port = port;
+	run->type = type;
+	run->blockCount = 0;
+	return run;
+}
+
+void _ahciCacheStartRun(ahci_cache_run* run)
+{
+	auto& waiting = cacheDisks[run->port->number].waitingRuns;
+
+	ahci_command* command = waiting.empty() ? ahciPortAcquireCommand(run->port) : 0;
+	if(command)
+		_ahciCacheIssueRun(run, command);
+	else
+		waiting.push_back(run);
+}
+
+void _ahciCacheStartWaitingRuns(ahci_port* port)
+{
+	auto& waiting = cacheDisks[port->number].waitingRuns;
+	while(!waiting.empty())
+	{
+		ahci_command* command = ahciPortAcquireCommand(port);
+		if(!command)
+			break;
+
+		ahci_cache_run* run = waiting.front();
+		waiting.pop_front();
+		_ahciCacheIssueRun(run, command);
+	}
+}
+
+void _ahciCacheIssueRun(ahci_cache_run* run, ahci_command* command)
+{
+	// Blocks are copied only now, so a write takes the latest content of its blocks
+	uint32_t sectors = 0;
+	for(uint32_t i = 0; i < run->blockCount; i++)
+	{
+		ahci_cache_block* block = run->blocks[i];
+		uint32_t blockSectors = _ahciCacheBlockSectors(run->port, block->number);
+		if(run->type == AHCI_COMMAND_WRITE)
+			memcpy(command->buffer + i * AHCI_CACHE_BLOCK_SIZE, block->data, blockSectors * G_ATA_SECTOR_SIZE);
+		sectors += blockSectors;
+	}
+
+	command->type = run->type;
+	command->lba = run->blockCount ? run->blocks[0]->number * AHCI_CACHE_BLOCK_SECTORS : 0;
+	command->sectors = sectors;
+	command->completed = _ahciCacheRunCompleted;
+	command->context = run;
+	ahciPortSubmit(run->port, command);
+}
+
+void _ahciCacheRunCompleted(ahci_port* port, ahci_command* command, bool successful)
+{
+	auto run = (ahci_cache_run*) command->context;
+
+	if(run->type == AHCI_COMMAND_READ)
+		_ahciCacheLoaded(run, command, successful);
+	else if(run->type == AHCI_COMMAND_WRITE)
+		_ahciCacheWritten(run, successful);
+	else
+		_ahciCacheFlushed(run, successful);
+
+	delete run;
+	_ahciCacheStartWaitingRuns(port);
+}
+
+void _ahciCacheLoaded(ahci_cache_run* run, ahci_command* command, bool successful)
+{
+	// Copy everything first, finishing a request may reuse the command. Blocks that were
+	// completely written in the meantime keep their newer content.
+	for(uint32_t i = 0; i < run->blockCount; i++)
+	{
+		ahci_cache_block* block = run->blocks[i];
+		if(successful && !block->valid)
+		{
+			memcpy(block->data, command->buffer + i * AHCI_CACHE_BLOCK_SIZE,
+			       _ahciCacheBlockSectors(run->port, block->number) * G_ATA_SECTOR_SIZE);
+			block->valid = true;
+		}
+		block->loading = false;
+	}
+
+	if(!successful)
+		klog("failed to read %i blocks at %i from port %i", run->blockCount, (uint32_t) run->blocks[0]->number,
+		     run->port->number);
+
+	for(uint32_t i = 0; i < run->blockCount; i++)
+	{
+		ahci_cache_block* block = run->blocks[i];
+
+		std::vector<ahci_cache_request*> waiters;
+		waiters.swap(block->waiters);
+		for(ahci_cache_request* request: waiters)
+		{
+			if(!block->valid)
+				request->failed = true;
+			if(--request->loading == 0)
+				_ahciCacheFinishRequest(request);
+		}
+	}
+}
+
+void _ahciCacheWritten(ahci_cache_run* run, bool successful)
+{
+	ahci_cache_disk* disk = &cacheDisks[run->port->number];
+
+	bool dropped = false;
+	for(uint32_t i = 0; i < run->blockCount; i++)
+	{
+		ahci_cache_block* block = run->blocks[i];
+		block->writing = false;
+		if(successful)
+		{
+			block->failedWrites = 0;
+			_ahciCacheForget(run->port, block->writeGeneration);
+		}
+		else if(++block->failedWrites < AHCI_CACHE_WRITE_ATTEMPTS || block->dirty)
+		{
+			// Content that was written to the block during the failed write is never dropped
+			_ahciCacheRetry(block);
+		}
+		else
+		{
+			_ahciCacheDrop(block);
+			dropped = true;
+		}
+	}
+
+	if(!successful)
+	{
+		klog("failed to write %i blocks at %i to port %i%s", run->blockCount, (uint32_t) run->blocks[0]->number,
+		     run->port->number, dropped ? ", dropping them" : "");
+
+		for(ahci_cache_sync* sync: disk->syncs)
+			sync->failed = true;
+		if(dropped && disk->syncs.empty())
+			disk->droppedBlocks = true;
+	}
+
+	_ahciCacheCheckSyncs(run->port);
+}
+
+void _ahciCacheFlushed(ahci_cache_run* run, bool successful)
+{
+	for(ahci_cache_sync* sync: run->syncs)
+	{
+		sync->callback(sync->context, successful && !sync->failed);
+		delete sync;
+	}
+}
+
+void _ahciCacheWriteBackRange(std::map<uint64_t, ahci_cache_block*>::iterator from,
+                              std::map<uint64_t, ahci_cache_block*>::iterator to)
+{
+	ahci_cache_run* run = 0;
+	auto entry = from;
+	while(entry != to)
+	{
+		// A block that is still being written stays dirty, two writes of it could be reordered
+		ahci_cache_block* block = entry->second;
+		if(block->writing)
+		{
+			++entry;
+			continue;
+		}
+
+		if(run && (run->port != block->port || run->blockCount == AHCI_CACHE_RUN_BLOCKS ||
+		           run->blocks[run->blockCount - 1]->number != block->number - 1))
+		{
+			_ahciCacheStartRun(run);
+			run = 0;
+		}
+
+		if(!run)
+			run = _ahciCacheCreateRun(block->port, AHCI_COMMAND_WRITE);
+		block->dirty = false;
+		block->writing = true;
+		block->writeGeneration = block->dirtyGeneration;
+		run->blocks[run->blockCount++] = block;
+		entry = cacheDirty.erase(entry);
+	}
+
+	if(run)
+		_ahciCacheStartRun(run);
+}
+
+void _ahciCacheWriteBackDisk(ahci_port* port)
+{
+	_ahciCacheWriteBackRange(cacheDirty.lower_bound(AHCI_CACHE_KEY(port->number, 0)),
+	                         cacheDirty.lower_bound(AHCI_CACHE_KEY(port->number + 1, 0)));
+}
+
+void _ahciCacheCheckSyncs(ahci_port* port)
+{
+	ahci_cache_disk* disk = &cacheDisks[port->number];
+	if(disk->syncs.empty())
+		return;
+
+	// Blocks that changed while they were written are dirty again
+	_ahciCacheWriteBackDisk(port);
+
+	// Syncs are in the order of their generations, those without older changes are done
+	uint64_t oldest = disk->unwritten.empty() ? disk->generation : disk->unwritten.begin()->first;
+	auto done = disk->syncs.begin();
+	while(done != disk->syncs.end() && (*done)->generation <= oldest)
+		++done;
+	if(done == disk->syncs.begin())
+		return;
+
+	auto run = _ahciCacheCreateRun(port, AHCI_COMMAND_FLUSH);
+	run->syncs.assign(disk->syncs.begin(), done);
+	disk->syncs.erase(disk->syncs.begin(), done);
+	_ahciCacheStartRun(run);
+}
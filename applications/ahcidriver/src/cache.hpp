@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __AHCIDRIVER_CACHE__
+#define __AHCIDRIVER_CACHE__
+
+#include "port.hpp"
+
+/**
+ * All reads and writes of a disk go through a cache of blocks. Blocks that are missing
+ * are read with as few commands as possible, by reading adjacent blocks together.
+ * Writes only change the cached blocks, which are written back in the background, so
+ * blocks are only guaranteed to be on the disk after a sync.
+ *
+ * Once there are more blocks than the capacity, the least recently used blocks that are
+ * clean and not in use are evicted. If there is no such block the cache grows, until
+ * write-back made enough blocks clean again.
+ *
+ * A block that could not be written after a number of attempts is dropped, so that it
+ * can be evicted and is read from the disk again. The next sync of the disk fails. A block
+ * that was changed again during the failed write is not dropped but written again, and a
+ * block that is in use by a request is only invalidated once the request is done.
+ */
+#define AHCI_CACHE_BLOCK_SIZE		G_PAGE_SIZE
+#define AHCI_CACHE_BLOCK_SECTORS	(AHCI_CACHE_BLOCK_SIZE / G_ATA_SECTOR_SIZE)
+#define AHCI_CACHE_CAPACITY			4096
+#define AHCI_CACHE_DIRTY_LIMIT		(AHCI_CACHE_CAPACITY / 4)
+#define AHCI_CACHE_FLUSH_INTERVAL	1000
+#define AHCI_CACHE_WRITE_ATTEMPTS	3
+
+/**
+ * Called once a request is done. Requests that can be answered from the cache call
+ * it before they return.
+ */
+typedef void (*ahci_cache_callback)(void* context, bool successful);
+
+/**
+ * Starts the task that regularly makes the given task write back dirty blocks, by
+ * sending it a message.
+ *
+ * @return the id of the flushing task
+ */
+g_tid ahciCacheStartFlusher(g_tid server);
+
+/**
+ * Reads bytes from the disk into the buffer, which must stay valid until the request
+ * is done. The range must be within the disk.
+ */
+void ahciCacheRead(ahci_port* port, uint64_t offset, uint32_t length, uint8_t* buffer, ahci_cache_callback callback,
+                   void* context);
+
+/**
+ * Writes bytes from the buffer to the cache. Blocks that are only partially written
+ * are read first. The range must be within the disk.
+ */
+void ahciCacheWrite(ahci_port* port, uint64_t offset, uint32_t length, uint8_t* buffer, ahci_cache_callback callback,
+                    void* context);
+
+/**
+ * Writes back all dirty blocks of the disk and flushes its write cache. Completes once
+ * the changes made before the sync are written, even if writes continue. Fails if a
+ * block could not be written in the meantime.
+ */
+void ahciCacheSync(ahci_port* port, ahci_cache_callback callback, void* context);
+
+/**
+ * Starts writing back all dirty blocks that are not already being written.
+ */
+void ahciCacheWriteBack();
+
+#endif
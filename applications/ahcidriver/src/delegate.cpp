@@ -0,0 +1,315 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "delegate.hpp"
+#include "ahcidriver.hpp"
+#include "cache.hpp"
+
+#include <libahci/driver.hpp>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The mountpoint has the physical id 0, each disk has the number of its port plus one.
+ */
+#define AHCI_DELEGATE_DISK_ID(port)		((g_fs_phys_id) (port)->number + 1)
+
+/**
+ * State of a read, write or sync while the cache works on it. A sync of the mountpoint
+ * waits for the syncs of all disks.
+ */
+struct ahci_delegate_transfer
+{
+	g_fs_tasked_delegate_request_type type;
+	g_fs_transaction_id transaction;
+	g_address storage;
+	uint32_t length;
+	uint32_t remaining;
+	bool failed;
+};
+
+static ahci_port* _ahciDelegateGetDisk(g_fs_phys_id id);
+static void _ahciDelegateCreateNode(g_fs_virt_id parent, ahci_port* port);
+
+static void _ahciDelegateDiscover(g_fs_tasked_delegate_transaction_storage_discovery* storage);
+static void _ahciDelegateRefresh(g_fs_tasked_delegate_transaction_storage_directory_refresh* storage);
+
+/**
+ * @return whether the transaction was handed to the cache and finishes later
+ */
+static bool _ahciDelegateRead(g_fs_tasked_delegate_request* request);
+static bool _ahciDelegateWrite(g_fs_tasked_delegate_request* request);
+static bool _ahciDelegateSync(g_fs_tasked_delegate_request* request);
+
+static ahci_delegate_transfer* _ahciDelegateCreateTransfer(g_fs_tasked_delegate_request* request, uint32_t length,
+                                                           uint32_t remaining);
+static void _ahciDelegateTransferred(void* context, bool successful);
+
+bool ahciDelegateRegister()
+{
+	g_fs_virt_id mountpoint;
+	g_address storage;
+	g_fs_register_as_delegate_status status = g_fs_register_as_delegate(G_AHCI_DRIVER_MOUNT, 0, &mountpoint, &storage);
+	if(status != G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+	{
+		klog("failed to register as delegate for /mount/%s: %i", G_AHCI_DRIVER_MOUNT, status);
+		return false;
+	}
+	return true;
+}
+
+void ahciDelegateHandle(g_fs_tasked_delegate_request* request)
+{
+	void* storage = (void*) request->storage;
+
+	if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER)
+	{
+		_ahciDelegateDiscover((g_fs_tasked_delegate_transaction_storage_discovery*) storage);
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY)
+	{
+		_ahciDelegateRefresh((g_fs_tasked_delegate_transaction_storage_directory_refresh*) storage);
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN)
+	{
+		auto open = (g_fs_tasked_delegate_transaction_storage_open*) storage;
+		open->result_status = _ahciDelegateGetDisk(open->phys_fs_id) ? G_FS_OPEN_SUCCESSFUL : G_FS_OPEN_NOT_FOUND;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE)
+	{
+		auto close = (g_fs_tasked_delegate_transaction_storage_close*) storage;
+		close->result_status = G_FS_CLOSE_SUCCESSFUL;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH)
+	{
+		auto length = (g_fs_tasked_delegate_transaction_storage_get_length*) storage;
+		ahci_port* port = _ahciDelegateGetDisk(length->phys_fs_id);
+		if(port)
+		{
+			length->result_length = port->sectors * G_ATA_SECTOR_SIZE;
+			length->result_status = G_FS_LENGTH_SUCCESSFUL;
+		}
+		else
+		{
+			length->result_length = 0;
+			length->result_status = G_FS_LENGTH_NOT_FOUND;
+		}
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ)
+	{
+		if(_ahciDelegateRead(request))
+			return;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE)
+	{
+		if(_ahciDelegateWrite(request))
+			return;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_SYNC)
+	{
+		if(_ahciDelegateSync(request))
+			return;
+	}
+
+	g_fs_set_transaction_status(request->transaction, G_FS_TRANSACTION_FINISHED);
+}
+
+ahci_port* _ahciDelegateGetDisk(g_fs_phys_id id)
+{
+	if(id == 0 || id > G_AHCI_MAXIMUM_SLOTS)
+		return 0;
+	return ahciDriverGetPort(id - 1);
+}
+
+void _ahciDelegateCreateNode(g_fs_virt_id parent, ahci_port* port)
+{
+	char name[16];
+	snprintf(name, sizeof(name), "%s%i", G_AHCI_DRIVER_DISK_PREFIX, port->number);
+
+	g_fs_virt_id created;
+	g_fs_create_node(parent, name, G_FS_NODE_TYPE_FILE, AHCI_DELEGATE_DISK_ID(port), &created);
+}
+
+void _ahciDelegateDiscover(g_fs_tasked_delegate_transaction_storage_discovery* storage)
+{
+	storage->result_status = G_FS_DISCOVERY_NOT_FOUND;
+	if(storage->parent_phys_fs_id != 0)
+		return;
+
+	size_t prefixLength = strlen(G_AHCI_DRIVER_DISK_PREFIX);
+	if(strncmp(storage->name, G_AHCI_DRIVER_DISK_PREFIX, prefixLength) != 0)
+		return;
+
+	const char* number = storage->name + prefixLength;
+	char* end;
+	long portNumber = strtol(number, &end, 10);
+	if(end == number || *end != 0 || portNumber < 0 || portNumber >= G_AHCI_MAXIMUM_SLOTS)
+		return;
+
+	ahci_port* port = ahciDriverGetPort(portNumber);
+	if(!port)
+		return;
+
+	_ahciDelegateCreateNode(storage->parent_virt_fs_id, port);
+	storage->result_status = G_FS_DISCOVERY_SUCCESSFUL;
+}
+
+void _ahciDelegateRefresh(g_fs_tasked_delegate_transaction_storage_directory_refresh* storage)
+{
+	if(storage->parent_phys_fs_id == 0)
+	{
+		for(uint8_t number = 0; number < G_AHCI_MAXIMUM_SLOTS; number++)
+		{
+			ahci_port* port = ahciDriverGetPort(number);
+			if(port)
+				_ahciDelegateCreateNode(storage->parent_virt_fs_id, port);
+		}
+	}
+	storage->result_status = G_FS_DIRECTORY_REFRESH_SUCCESSFUL;
+}
+
+bool _ahciDelegateRead(g_fs_tasked_delegate_request* request)
+{
+	auto read = (g_fs_tasked_delegate_transaction_storage_read*) request->storage;
+	read->result_read = 0;
+	read->result_status = G_FS_READ_SUCCESSFUL;
+
+	ahci_port* port = _ahciDelegateGetDisk(read->phys_fs_id);
+	if(!port || read->offset < 0 || read->length < 0 || read->length > G_FS_TASKED_DELEGATE_TRANSFER_SIZE)
+	{
+		read->result_status = G_FS_READ_ERROR;
+		return false;
+	}
+
+	uint64_t capacity = port->sectors * G_ATA_SECTOR_SIZE;
+	uint64_t offset = read->offset;
+	if(offset >= capacity || read->length == 0)
+		return false;
+
+	uint64_t length = read->length;
+	if(length > capacity - offset)
+		length = capacity - offset;
+
+	auto transfer = _ahciDelegateCreateTransfer(request, length, 1);
+	ahciCacheRead(port, offset, length, (uint8_t*) read->mapped_buffer, _ahciDelegateTransferred, transfer);
+	return true;
+}
+
+bool _ahciDelegateWrite(g_fs_tasked_delegate_request* request)
+{
+	auto write = (g_fs_tasked_delegate_transaction_storage_write*) request->storage;
+	write->result_write = 0;
+	write->result_status = G_FS_WRITE_SUCCESSFUL;
+
+	ahci_port* port = _ahciDelegateGetDisk(write->phys_fs_id);
+	if(!port || write->offset < 0 || write->length < 0 || write->length > G_FS_TASKED_DELEGATE_TRANSFER_SIZE)
+	{
+		write->result_status = G_FS_WRITE_ERROR;
+		return false;
+	}
+
+	uint64_t capacity = port->sectors * G_ATA_SECTOR_SIZE;
+	uint64_t offset = write->offset;
+	if(offset >= capacity || write->length == 0)
+		return false;
+
+	uint64_t length = write->length;
+	if(length > capacity - offset)
+		length = capacity - offset;
+
+	auto transfer = _ahciDelegateCreateTransfer(request, length, 1);
+	ahciCacheWrite(port, offset, length, (uint8_t*) write->mapped_buffer, _ahciDelegateTransferred, transfer);
+	return true;
+}
+
+bool _ahciDelegateSync(g_fs_tasked_delegate_request* request)
+{
+	auto sync = (g_fs_tasked_delegate_transaction_storage_sync*) request->storage;
+	sync->result_status = G_FS_SYNC_SUCCESSFUL;
+
+	ahci_port* disk = 0;
+	if(sync->phys_fs_id != 0)
+	{
+		disk = _ahciDelegateGetDisk(sync->phys_fs_id);
+		if(!disk)
+		{
+			sync->result_status = G_FS_SYNC_ERROR;
+			return false;
+		}
+	}
+
+	// Holds one extra reference while the syncs are started
+	auto transfer = _ahciDelegateCreateTransfer(request, 0, 1);
+	for(uint8_t number = 0; number < G_AHCI_MAXIMUM_SLOTS; number++)
+	{
+		ahci_port* port = ahciDriverGetPort(number);
+		if(port && (!disk || port == disk))
+		{
+			transfer->remaining++;
+			ahciCacheSync(port, _ahciDelegateTransferred, transfer);
+		}
+	}
+	_ahciDelegateTransferred(transfer, true);
+	return true;
+}
+
+ahci_delegate_transfer* _ahciDelegateCreateTransfer(g_fs_tasked_delegate_request* request, uint32_t length,
+                                                    uint32_t remaining)
+{
+	auto transfer = new ahci_delegate_transfer();
+	transfer->type = request->type;
+	transfer->transaction = request->transaction;
+	transfer->storage = request->storage;
+	transfer->length = length;
+	transfer->remaining = remaining;
+	transfer->failed = false;
+	return transfer;
+}
+
+void _ahciDelegateTransferred(void* context, bool successful)
+{
+	auto transfer = (ahci_delegate_transfer*) context;
+	if(!successful)
+		transfer->failed = true;
+	if(--transfer->remaining > 0)
+		return;
+
+	if(transfer->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ)
+	{
+		auto read = (g_fs_tasked_delegate_transaction_storage_read*) transfer->storage;
+		read->result_read = transfer->failed ? 0 : transfer->length;
+		read->result_status = transfer->failed ? G_FS_READ_ERROR : G_FS_READ_SUCCESSFUL;
+	}
+	else if(transfer->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE)
+	{
+		auto write = (g_fs_tasked_delegate_transaction_storage_write*) transfer->storage;
+		write->result_write = transfer->failed ? 0 : transfer->length;
+		write->result_status = transfer->failed ? G_FS_WRITE_ERROR : G_FS_WRITE_SUCCESSFUL;
+	}
+	else if(transfer->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_SYNC)
+	{
+		auto sync = (g_fs_tasked_delegate_transaction_storage_sync*) transfer->storage;
+		sync->result_status = transfer->failed ? G_FS_SYNC_ERROR : G_FS_SYNC_SUCCESSFUL;
+	}
+
+	g_fs_set_transaction_status(transfer->transaction, G_FS_TRANSACTION_FINISHED);
+	delete transfer;
+}
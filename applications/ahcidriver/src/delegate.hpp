@@ -0,0 +1,39 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __AHCIDRIVER_DELEGATE__
+#define __AHCIDRIVER_DELEGATE__
+
+#include <ghost.h>
+#include <ghost/filesystem/delegate.h>
+
+/**
+ * Registers the driver as the delegate of its mountpoint. Must be called from the task
+ * that receives the requests.
+ */
+bool ahciDelegateRegister();
+
+/**
+ * Handles a request of the kernel. Reads, writes and syncs finish their transaction
+ * once the cache is done with them, all others finish right away.
+ */
+void ahciDelegateHandle(g_fs_tasked_delegate_request* request);
+
+#endif
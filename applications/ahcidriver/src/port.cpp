@@ -0,0 +1,475 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "port.hpp"
+#include <stdio.h>
+#include <string.h>
+
+#define AHCI_PORT_READY_TIMEOUT		1000
+#define AHCI_IDENTIFY_TIMEOUT		5000
+
+/**
+ * Fills the command header, the PRDT and a host-to-device register FIS for the command
+ * to transfer the given number of bytes from the start of its buffer.
+ */
+static volatile g_fis_reg_h2d* _ahciPortSetupCommand(ahci_port* port, ahci_command* command, uint8_t ataCommand,
+                                                     uint32_t bytes);
+static void _ahciPortSetLba(volatile g_fis_reg_h2d* fis, uint64_t lba);
+
+/**
+ * Queued commands take the sector count in the features register and the tag in the
+ * count register, others have no tag.
+ */
+static void _ahciPortSetCount(volatile g_fis_reg_h2d* fis, uint32_t sectors, int32_t tag);
+
+static bool _ahciPortWaitUntilIdle(volatile g_ahci_hba_port* registers);
+static bool _ahciPortIdentify(ahci_port* port, uint32_t capabilities);
+
+/**
+ * Stops a port that failed to initialize, detaches its memory from the controller
+ * and frees it.
+ */
+static void _ahciPortRelease(ahci_port* port);
+
+/**
+ * @return whether the command can be issued while others are outstanding
+ */
+static bool _ahciPortIsQueueable(ahci_port* port, ahci_command* command);
+
+static void _ahciPortIssue(ahci_port* port, ahci_command* command);
+static void _ahciPortIssuePending(ahci_port* port);
+static void _ahciPortComplete(ahci_port* port, ahci_command* command, bool successful);
+
+/**
+ * Restarts the port after an error. Stopping the port clears CI and SACT, so all
+ * commands that were issued when the error happened are lost.
+ */
+static void _ahciPortRecover(ahci_port* port, uint32_t status);
+
+ahci_port* ahciPortInitialize(uint8_t number, volatile g_ahci_hba_port* registers, uint32_t capabilities)
+{
+	if(!(registers->ssts.det == G_AHCI_HBA_PORT_SSTS_DET_READY))
+	{
+		klog("device on port %i not present or ready: %i", number, registers->ssts.det);
+		return 0;
+	}
+
+	if(registers->sig != G_SATA_SIGNATURE_ATA)
+	{
+		klog("port %i does not have an ATA device: %x", number, registers->sig);
+		return 0;
+	}
+
+	if(!ahciPortStopCommands(registers))
+	{
+		klog("timed out when trying to stop commands on port %i", number);
+		return 0;
+	}
+
+	auto port = new ahci_port();
+	port->number = number;
+	port->registers = registers;
+	port->slots = G_AHCI_HBA_CAP_NCS(capabilities);
+	if(port->slots > AHCI_PORT_SLOTS)
+		port->slots = AHCI_PORT_SLOTS;
+
+	// First page holds the command list and the received FIS, second page the command tables
+	g_physical_address memoryPages[2];
+	auto memory = (uint8_t*) g_alloc_dma_mem(2 * G_PAGE_SIZE, memoryPages);
+	if(!memory)
+	{
+		klog("failed to allocate command memory for port %i", number);
+		delete port;
+		return 0;
+	}
+	memset(memory, 0, 2 * G_PAGE_SIZE);
+
+	port->commandList = (volatile g_hba_command_header*) memory;
+	registers->clb = memoryPages[0];
+	registers->clbu = 0;
+	registers->fb = memoryPages[0] + G_AHCI_COMMAND_LIST_SIZE;
+	registers->fbu = 0;
+
+	for(uint32_t slot = 0; slot < port->slots; slot++)
+	{
+		ahci_command* command = &port->commands[slot];
+		command->state = AHCI_COMMAND_FREE;
+		command->table = (volatile g_hba_command_table*) (memory + G_PAGE_SIZE + slot * AHCI_COMMAND_TABLE_SIZE);
+		command->tablePhysical = memoryPages[1] + slot * AHCI_COMMAND_TABLE_SIZE;
+		port->commandList[slot].ctba = command->tablePhysical;
+		port->commandList[slot].ctbau = 0;
+
+		command->buffer = (uint8_t*) g_alloc_dma_mem(AHCI_COMMAND_BUFFER_SIZE, command->bufferPages);
+		if(!command->buffer)
+		{
+			klog("failed to allocate command buffers for port %i", number);
+			_ahciPortRelease(port);
+			return 0;
+		}
+	}
+
+	registers->serr = 0xFFFFFFFF;
+	registers->is = 0xFFFFFFFF;
+	registers->ie = 0;
+
+	if(!_ahciPortWaitUntilIdle(registers) || !ahciPortStartCommands(registers))
+	{
+		klog("timed out when trying to start commands on port %i", number);
+		_ahciPortRelease(port);
+		return 0;
+	}
+
+	if(!_ahciPortIdentify(port, capabilities))
+	{
+		_ahciPortRelease(port);
+		return 0;
+	}
+
+	// Only enabled now, so that the interrupt handler never sees the polled IDENTIFY command
+	registers->ie = G_AHCI_HBA_PORT_IS_ERRORS | G_AHCI_HBA_PORT_IS_COMPLETIONS;
+
+	klog("port %i: %i MiB, %s, depth %i", number, (uint32_t) (port->sectors / 2048),
+	     port->queued ? "native command queuing" : "no command queuing", port->depth);
+	return port;
+}
+
+void _ahciPortRelease(ahci_port* port)
+{
+	volatile g_ahci_hba_port* registers = port->registers;
+	registers->ie = 0;
+
+	// The controller might still access the memory, so it is better kept
+	if(!ahciPortStopCommands(registers))
+	{
+		klog("timed out when trying to stop commands on port %i, keeping its memory", port->number);
+		return;
+	}
+
+	registers->is = 0xFFFFFFFF;
+	registers->clb = 0;
+	registers->clbu = 0;
+	registers->fb = 0;
+	registers->fbu = 0;
+
+	for(uint32_t slot = 0; slot < port->slots; slot++)
+	{
+		if(port->commands[slot].buffer)
+			g_unmap(port->commands[slot].buffer);
+	}
+	g_unmap((void*) port->commandList);
+	delete port;
+}
+
+bool _ahciPortWaitUntilIdle(volatile g_ahci_hba_port* registers)
+{
+	uint64_t start = g_millis();
+	while(registers->tfd & (G_AHCI_HBA_PORT_TFD_BSY | G_AHCI_HBA_PORT_TFD_DRQ))
+	{
+		if(g_millis() - start > AHCI_PORT_READY_TIMEOUT)
+			return false;
+		g_yield();
+	}
+	return true;
+}
+
+bool _ahciPortIdentify(ahci_port* port, uint32_t capabilities)
+{
+	volatile g_ahci_hba_port* registers = port->registers;
+
+	// Port interrupts are only enabled after this, so the command is polled
+	ahci_command* command = &port->commands[0];
+	command->type = AHCI_COMMAND_READ;
+	auto fis = _ahciPortSetupCommand(port, command, G_ATA_COMMAND_IDENTIFY_DEVICE, G_ATA_SECTOR_SIZE);
+	fis->device = 0;
+	registers->ci = 1;
+
+	uint64_t start = g_millis();
+	while(registers->ci & 1)
+	{
+		if((registers->is & G_AHCI_HBA_PORT_IS_TFES) || g_millis() - start > AHCI_IDENTIFY_TIMEOUT)
+		{
+			klog("failed to identify device on port %i, task file %x", port->number, registers->tfd);
+			return false;
+		}
+		g_yield();
+	}
+	registers->is = 0xFFFFFFFF;
+
+	auto identify = (uint16_t*) command->buffer;
+	if(!(identify[G_ATA_IDENTIFY_COMMAND_SET_2] & (1 << 10)))
+	{
+		klog("device on port %i does not support 48-bit addressing", port->number);
+		return false;
+	}
+
+	port->sectors = 0;
+	for(int i = 3; i >= 0; i--)
+		port->sectors = (port->sectors << 16) | identify[G_ATA_IDENTIFY_LBA48_SECTORS + i];
+
+	port->queued = (capabilities & G_AHCI_HBA_CAP_SNCQ) && (identify[G_ATA_IDENTIFY_SATA_CAPABILITIES] & (1 << 8));
+	if(port->queued)
+	{
+		port->depth = (identify[G_ATA_IDENTIFY_QUEUE_DEPTH] & 0x1F) + 1;
+		if(port->depth > port->slots)
+			port->depth = port->slots;
+	}
+	else
+	{
+		port->depth = 1;
+	}
+	return true;
+}
+
+ahci_command* ahciPortAcquireCommand(ahci_port* port)
+{
+	for(uint32_t slot = 0; slot < port->slots; slot++)
+	{
+		ahci_command* command = &port->commands[slot];
+		if(command->state == AHCI_COMMAND_FREE)
+		{
+			command->state = AHCI_COMMAND_ACQUIRED;
+			return command;
+		}
+	}
+	return 0;
+}
+
+void ahciPortSubmit(ahci_port* port, ahci_command* command)
+{
+	command->state = AHCI_COMMAND_PENDING;
+	command->sequence = port->nextSequence++;
+	_ahciPortIssuePending(port);
+}
+
+void ahciPortHandleInterrupt(ahci_port* port)
+{
+	volatile g_ahci_hba_port* registers = port->registers;
+
+	uint32_t status = registers->is;
+	registers->is = status;
+
+	// Commands that are no longer active finished successfully, even if another one failed
+	uint32_t issued = port->issued;
+	uint32_t finished = issued & ~(registers->ci | registers->sact);
+	uint32_t failed = 0;
+	if(status & G_AHCI_HBA_PORT_IS_ERRORS)
+	{
+		failed = issued & ~finished;
+		_ahciPortRecover(port, status);
+	}
+
+	for(uint32_t slot = 0; slot < port->slots; slot++)
+	{
+		if(finished & (1 << slot))
+			_ahciPortComplete(port, &port->commands[slot], true);
+		else if(failed & (1 << slot))
+			_ahciPortComplete(port, &port->commands[slot], false);
+	}
+
+	_ahciPortIssuePending(port);
+}
+
+void _ahciPortRecover(ahci_port* port, uint32_t status)
+{
+	volatile g_ahci_hba_port* registers = port->registers;
+	klog("error on port %i, interrupt status %x, task file %x, SATA error %x", port->number, status, registers->tfd,
+	     registers->serr);
+
+	if(!ahciPortStopCommands(registers))
+		klog("timed out when trying to stop commands on port %i", port->number);
+
+	registers->serr = 0xFFFFFFFF;
+	registers->is = 0xFFFFFFFF;
+
+	if(registers->tfd & (G_AHCI_HBA_PORT_TFD_BSY | G_AHCI_HBA_PORT_TFD_DRQ))
+	{
+		registers->cmd.clo = 1;
+		uint32_t timeout = 1000000;
+		while(registers->cmd.clo && --timeout)
+		{
+		}
+	}
+
+	if(!ahciPortStartCommands(registers))
+		klog("timed out when trying to restart port %i", port->number);
+}
+
+void _ahciPortIssuePending(ahci_port* port)
+{
+	while((uint32_t) __builtin_popcount(port->issued) < port->depth)
+	{
+		ahci_command* next = 0;
+		for(uint32_t slot = 0; slot < port->slots; slot++)
+		{
+			ahci_command* command = &port->commands[slot];
+			if(command->state == AHCI_COMMAND_PENDING &&
+			   (!next || (int32_t) (command->sequence - next->sequence) < 0))
+				next = command;
+		}
+
+		if(!next)
+			break;
+
+		if(port->issued && ((port->issued & port->issuedUnqueued) || !_ahciPortIsQueueable(port, next)))
+			break;
+		_ahciPortIssue(port, next);
+	}
+}
+
+bool _ahciPortIsQueueable(ahci_port* port, ahci_command* command)
+{
+	return port->queued && command->type != AHCI_COMMAND_FLUSH;
+}
+
+void _ahciPortIssue(ahci_port* port, ahci_command* command)
+{
+	uint32_t slot = command - port->commands;
+	bool queueable = _ahciPortIsQueueable(port, command);
+
+	if(command->type == AHCI_COMMAND_FLUSH)
+	{
+		auto fis = _ahciPortSetupCommand(port, command, G_ATA_COMMAND_FLUSH_CACHE_EXT, 0);
+		fis->device = 0;
+	}
+	else
+	{
+		uint8_t ataCommand;
+		bool write = command->type == AHCI_COMMAND_WRITE;
+		if(queueable)
+			ataCommand = write ? G_ATA_COMMAND_WRITE_FPDMA_QUEUED : G_ATA_COMMAND_READ_FPDMA_QUEUED;
+		else
+			ataCommand = write ? G_ATA_COMMAND_WRITE_DMA_EXT : G_ATA_COMMAND_READ_DMA_EXT;
+
+		auto fis = _ahciPortSetupCommand(port, command, ataCommand, command->sectors * G_ATA_SECTOR_SIZE);
+		_ahciPortSetLba(fis, command->lba);
+		_ahciPortSetCount(fis, command->sectors, queueable ? slot : -1);
+	}
+
+	command->state = AHCI_COMMAND_ISSUED;
+	port->issued |= (1 << slot);
+
+	if(queueable)
+		port->registers->sact = (1 << slot);
+	else
+		port->issuedUnqueued |= (1 << slot);
+	port->registers->ci = (1 << slot);
+}
+
+void _ahciPortSetCount(volatile g_fis_reg_h2d* fis, uint32_t sectors, int32_t tag)
+{
+	if(tag >= 0)
+	{
+		fis->featuresL = sectors & 0xFF;
+		fis->featuresH = (sectors >> 8) & 0xFF;
+		fis->countL = tag << 3;
+		fis->countH = 0;
+	}
+	else
+	{
+		fis->countL = sectors & 0xFF;
+		fis->countH = (sectors >> 8) & 0xFF;
+	}
+}
+
+void _ahciPortComplete(ahci_port* port, ahci_command* command, bool successful)
+{
+	uint32_t slot = command - port->commands;
+	port->issued &= ~(1 << slot);
+	port->issuedUnqueued &= ~(1 << slot);
+	command->state = AHCI_COMMAND_FREE;
+
+	if(command->completed)
+		command->completed(port, command, successful);
+}
+
+volatile g_fis_reg_h2d* _ahciPortSetupCommand(ahci_port* port, ahci_command* command, uint8_t ataCommand,
+                                              uint32_t bytes)
+{
+	auto prdt = (volatile g_hba_prdt_entry*) (((volatile uint8_t*) command->table) + G_HBA_COMMAND_TABLE_PRDT_OFFSET);
+	uint16_t entries = 0;
+	for(uint32_t offset = 0; offset < bytes; offset += G_PAGE_SIZE)
+	{
+		uint32_t length = bytes - offset;
+		if(length > G_PAGE_SIZE)
+			length = G_PAGE_SIZE;
+
+		prdt[entries].dba = command->bufferPages[entries];
+		prdt[entries].dbau = 0;
+		prdt[entries].reserved0 = 0;
+		prdt[entries].dbc = length - 1;
+		prdt[entries].i = 0;
+		entries++;
+	}
+
+	auto fis = (volatile g_fis_reg_h2d*) command->table->cfis;
+	memset((void*) fis, 0, sizeof(g_fis_reg_h2d));
+	fis->type = G_FIS_TYPE_REG_H2D;
+	fis->c = 1;
+	fis->command = ataCommand;
+	fis->device = G_ATA_DEVICE_LBA;
+
+	volatile g_hba_command_header* header = &port->commandList[command - port->commands];
+	header->cfl = sizeof(g_fis_reg_h2d) / sizeof(uint32_t);
+	header->a = 0;
+	header->w = command->type == AHCI_COMMAND_WRITE ? 1 : 0;
+	header->p = 0;
+	header->c = 0;
+	header->prdtl = entries;
+	header->prdbc = 0;
+	return fis;
+}
+
+void _ahciPortSetLba(volatile g_fis_reg_h2d* fis, uint64_t lba)
+{
+	fis->lba0 = lba & 0xFF;
+	fis->lba1 = (lba >> 8) & 0xFF;
+	fis->lba2 = (lba >> 16) & 0xFF;
+	fis->lba3 = (lba >> 24) & 0xFF;
+	fis->lba4 = (lba >> 32) & 0xFF;
+	fis->lba5 = (lba >> 40) & 0xFF;
+}
+
+bool ahciPortStartCommands(volatile g_ahci_hba_port* port)
+{
+	uint32_t timeout = 1000000;
+	while(port->cmd.cr && --timeout)
+	{
+	}
+
+	if(timeout > 0)
+	{
+		port->cmd.fre = 1;
+		port->cmd.st = 1;
+		return true;
+	}
+	return false;
+}
+
+bool ahciPortStopCommands(volatile g_ahci_hba_port* port)
+{
+	port->cmd.st = 0;
+	port->cmd.fre = 0;
+
+	uint32_t timeout = 1000000;
+	while((port->cmd.fr || port->cmd.cr) && --timeout)
+	{
+	}
+	return timeout > 0;
+}
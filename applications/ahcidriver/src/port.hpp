@@ -0,0 +1,131 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __AHCIDRIVER_PORT__
+#define __AHCIDRIVER_PORT__
+
+#include <stdint.h>
+#include <ghost.h>
+#include <ghost/filesystem/delegate.h>
+#include <libahci/ahci.hpp>
+
+/**
+ * A port uses at most one command slot per transaction slot of the delegate, so every
+ * request the kernel has in flight can get a command. Each command has its own buffer
+ * that covers a whole transfer plus the partial sectors around an unaligned read.
+ */
+#define AHCI_PORT_SLOTS				G_FS_TASKED_DELEGATE_SLOTS
+#define AHCI_COMMAND_BUFFER_PAGES	((G_FS_TASKED_DELEGATE_TRANSFER_SIZE / G_PAGE_SIZE) + 1)
+#define AHCI_COMMAND_BUFFER_SIZE	(AHCI_COMMAND_BUFFER_PAGES * G_PAGE_SIZE)
+#define AHCI_COMMAND_TABLE_SIZE		0x200
+
+struct ahci_port;
+struct ahci_command;
+
+typedef void (*ahci_command_callback)(ahci_port* port, ahci_command* command, bool successful);
+
+enum ahci_command_type
+{
+	AHCI_COMMAND_READ,
+	AHCI_COMMAND_WRITE,
+	AHCI_COMMAND_FLUSH
+};
+
+enum ahci_command_state
+{
+	AHCI_COMMAND_FREE,
+	AHCI_COMMAND_ACQUIRED,
+	AHCI_COMMAND_PENDING,
+	AHCI_COMMAND_ISSUED
+};
+
+/**
+ * A command that transfers a range of sectors between the disk and its buffer, or that
+ * flushes the write cache of the disk. The index of the command within its port is the
+ * command slot it is issued in.
+ */
+struct ahci_command
+{
+	ahci_command_state state;
+	uint32_t sequence;
+
+	ahci_command_type type;
+	uint64_t lba;
+	uint32_t sectors;
+
+	uint8_t* buffer;
+	g_physical_address bufferPages[AHCI_COMMAND_BUFFER_PAGES];
+
+	volatile g_hba_command_table* table;
+	g_physical_address tablePhysical;
+
+	ahci_command_callback completed;
+	void* context;
+};
+
+struct ahci_port
+{
+	uint8_t number;
+	volatile g_ahci_hba_port* registers;
+
+	uint32_t slots;
+	uint32_t depth;
+	bool queued;
+	uint64_t sectors;
+
+	uint32_t issued;
+	uint32_t issuedUnqueued;
+	uint32_t nextSequence;
+
+	volatile g_hba_command_header* commandList;
+	ahci_command commands[AHCI_PORT_SLOTS];
+};
+
+/**
+ * Sets up the memory of the port, starts it and identifies the attached device.
+ * Native command queuing is used if both the controller and the device support it.
+ *
+ * @return the port or 0 if there is no usable ATA device attached
+ */
+ahci_port* ahciPortInitialize(uint8_t number, volatile g_ahci_hba_port* registers, uint32_t capabilities);
+
+/**
+ * @return a free command of the port or 0 if all are in use
+ */
+ahci_command* ahciPortAcquireCommand(ahci_port* port);
+
+/**
+ * Queues the command. It is issued right away if the port has room for it, otherwise
+ * once enough of the issued commands have completed. Commands that can't be queued,
+ * like flushes, wait until no other command is issued. When done, the callback of the
+ * command is called and the command is free again.
+ */
+void ahciPortSubmit(ahci_port* port, ahci_command* command);
+
+/**
+ * Completes the commands that the device finished and issues pending ones. If the
+ * port reports an error, the issued commands fail and the port is restarted.
+ */
+void ahciPortHandleInterrupt(ahci_port* port);
+
+bool ahciPortStartCommands(volatile g_ahci_hba_port* port);
+bool ahciPortStopCommands(volatile g_ahci_hba_port* port);
+
+#endif
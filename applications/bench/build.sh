@@ -0,0 +1,12 @@
+#!/bin/bash
+ROOT="../.."
+if [ -f "$ROOT/variables.sh" ]; then
+	. "$ROOT/variables.sh"
+fi
+. "$ROOT/ghost.sh"
+
+# Build configuration
+ARTIFACT_NAME="bench.bin"
+
+# Include application build tasks
+. "../applications.sh"
@@ -0,0 +1,149 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "append.hpp"
+#include "../bench.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_APPEND_PATH			"/bench-append"
+#define BENCH_APPEND_CHUNK			(64 * 1024)
+#define BENCH_APPEND_DEFAULT_MIB	64
+
+static bool benchAppendStage(g_fd fd, uint8_t* chunk, uint64_t from, uint64_t to)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "append %llu to %llu MiB", from / (1024 * 1024), to / (1024 * 1024));
+
+	uint64_t start = g_nanos();
+	for(uint64_t written = from; written < to; written += BENCH_APPEND_CHUNK)
+	{
+		if(g_write(fd, chunk, BENCH_APPEND_CHUNK) != BENCH_APPEND_CHUNK)
+		{
+			fprintf(stderr, "failed to write at offset %llu\n", written);
+			return false;
+		}
+	}
+	benchReportThroughput(name, to - from, g_nanos() - start);
+	return true;
+}
+
+static bool benchAppendHole(g_fd fd, uint8_t* chunk, uint64_t length)
+{
+	// Write a chunk far past the end and check that the hole in between reads as zeros
+	uint64_t start = g_nanos();
+	if(g_seek(fd, length * 2, G_FS_SEEK_SET) != (int64_t) length * 2 ||
+	   g_write(fd, chunk, BENCH_APPEND_CHUNK) != BENCH_APPEND_CHUNK)
+	{
+		fprintf(stderr, "failed to write past the end\n");
+		return false;
+	}
+	benchReport("write past end, leaving a hole", 1, g_nanos() - start);
+
+	uint8_t* hole = new uint8_t[BENCH_APPEND_CHUNK];
+	bool zeros = g_seek(fd, length + length / 2, G_FS_SEEK_SET) == (int64_t) (length + length / 2) &&
+	             g_read(fd, hole, BENCH_APPEND_CHUNK) == BENCH_APPEND_CHUNK;
+	for(uint32_t i = 0; zeros && i < BENCH_APPEND_CHUNK; i++)
+		zeros = hole[i] == 0;
+	delete[] hole;
+
+	if(!zeros)
+		fprintf(stderr, "hole did not read as zeros\n");
+	return zeros;
+}
+
+static bool benchAppendTruncate(g_fd fd, uint64_t length)
+{
+	// Cut the file in the middle of a page, then grow it again; the cut part must read as zeros
+	uint64_t cut = length / 2 + 100;
+	uint64_t start = g_nanos();
+	if(g_ftruncate(fd, cut) != G_FS_TRUNCATE_SUCCESSFUL || g_length(fd) != (int64_t) cut)
+	{
+		fprintf(stderr, "failed to truncate to %llu bytes\n", cut);
+		return false;
+	}
+	benchReport("truncate to half", 1, g_nanos() - start);
+
+	if(g_ftruncate(fd, cut + BENCH_APPEND_CHUNK) != G_FS_TRUNCATE_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to grow the file again\n");
+		return false;
+	}
+
+	uint8_t* tail = new uint8_t[BENCH_APPEND_CHUNK];
+	bool zeros = g_seek(fd, cut, G_FS_SEEK_SET) == (int64_t) cut &&
+	             g_read(fd, tail, BENCH_APPEND_CHUNK) == BENCH_APPEND_CHUNK;
+	for(uint32_t i = 0; zeros && i < BENCH_APPEND_CHUNK; i++)
+		zeros = tail[i] == 0;
+	delete[] tail;
+
+	if(!zeros)
+		fprintf(stderr, "content past a truncation did not read as zeros\n");
+
+	// Truncating to zero frees the pages again
+	start = g_nanos();
+	bool emptied = g_ftruncate(fd, 0) == G_FS_TRUNCATE_SUCCESSFUL && g_length(fd) == 0;
+	benchReport("truncate to zero", 1, g_nanos() - start);
+	if(!emptied)
+		fprintf(stderr, "failed to truncate to zero\n");
+
+	return zeros && emptied;
+}
+
+int benchAppend(int argc, char** argv)
+{
+	uint64_t mib = BENCH_APPEND_DEFAULT_MIB;
+	if(argc > 2)
+		mib = atoi(argv[2]);
+	if(mib == 0)
+		mib = 1;
+	uint64_t length = mib * 1024 * 1024;
+
+	g_fd fd = g_open_f(BENCH_APPEND_PATH, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE |
+	                                          G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s\n", BENCH_APPEND_PATH);
+		return 1;
+	}
+
+	uint8_t* chunk = new uint8_t[BENCH_APPEND_CHUNK];
+	memset(chunk, 0xAB, BENCH_APPEND_CHUNK);
+
+	bool success = true;
+	uint64_t from = 0;
+	uint64_t to = 1024 * 1024;
+	while(success && from < length)
+	{
+		if(to > length)
+			to = length;
+		success = benchAppendStage(fd, chunk, from, to);
+		from = to;
+		to *= 2;
+	}
+
+	success = success && benchAppendHole(fd, chunk, length);
+	success = success && benchAppendTruncate(fd, length);
+	g_close(fd);
+	delete[] chunk;
+
+	return success ? 0 : 1;
+}
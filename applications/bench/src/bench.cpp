@@ -0,0 +1,146 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "bench.hpp"
+#include "append/append.hpp"
+#include "channels/channels.hpp"
+#include "disk/disk.hpp"
+#include "fsdelegate/fsdelegate.hpp"
+#include "lookup/lookup.hpp"
+#include "messages/messages.hpp"
+#include "mutex/mutex.hpp"
+#include "pipes/pipes.hpp"
+#include "ring/ring.hpp"
+#include "timer/timer.hpp"
+
+#include <string.h>
+
+#define MAJOR 0
+#define MINOR 1
+#define PATCH 0
+
+void benchReport(const char* name, uint32_t iterations, uint64_t nanos)
+{
+	if(iterations == 0)
+		iterations = 1;
+	printf("%-32s %8u iterations %10llu ns total %8llu ns/op\n", name, iterations, nanos, nanos / iterations);
+	klog("bench: %s %i iterations %i ns/op", name, iterations, (uint32_t) (nanos / iterations));
+}
+
+void benchReportThroughput(const char* name, uint64_t bytes, uint64_t nanos)
+{
+	if(nanos == 0)
+		nanos = 1;
+	uint64_t mibPerSecond = (bytes * 1000000000ull / nanos) / (1024 * 1024);
+	printf("%-32s %10llu bytes %10llu ns %8llu MiB/s\n", name, bytes, nanos, mibPerSecond);
+	klog("bench: %s %i MiB/s", name, (uint32_t) mibPerSecond);
+}
+
+/**
+ *
+ */
+int main(int argc, char** argv)
+{
+	if(argc > 1)
+	{
+		char* command = argv[1];
+
+		if(strcmp(command, "--message-tx") == 0)
+		{
+			return benchMessageTransactions(argc, argv);
+		}
+		else if(strcmp(command, "--message-grant") == 0)
+		{
+			return benchMessageGrants(argc, argv);
+		}
+		else if(strcmp(command, "--channel") == 0)
+		{
+			return benchChannels(argc, argv);
+		}
+		else if(strcmp(command, "--pipe") == 0)
+		{
+			return benchPipes(argc, argv);
+		}
+		else if(strcmp(command, "--lookup") == 0)
+		{
+			return benchLookup(argc, argv);
+		}
+		else if(strcmp(command, "--mutex") == 0)
+		{
+			return benchMutexContention(argc, argv);
+		}
+		else if(strcmp(command, "--ring") == 0)
+		{
+			return benchRing(argc, argv);
+		}
+		else if(strcmp(command, "--timer") == 0)
+		{
+			return benchTimerJitter(argc, argv);
+		}
+		else if(strcmp(command, "--append") == 0)
+		{
+			return benchAppend(argc, argv);
+		}
+		else if(strcmp(command, "--fs-delegate") == 0)
+		{
+			return benchFsDelegate(argc, argv);
+		}
+		else if(strcmp(command, "--disk") == 0)
+		{
+			return benchDisk(argc, argv);
+		}
+		else if(strcmp(command, "--disk-write") == 0)
+		{
+			return benchDiskWrite(argc, argv);
+		}
+		else if(strcmp(command, "--help") == 0)
+		{
+			printf("bench, v%i.%i.%i\n", MAJOR, MINOR, PATCH);
+			printf("Kernel microbenchmarks\n");
+			printf("\n");
+			printf("The following benchmarks are available:\n");
+			printf("\n");
+			printf("\t--message-tx\treceives many outstanding transactions out of order\n");
+			printf("\t--message-grant\tmoves 1 MiB payloads as page grants and as copies\n");
+			printf("\t--channel\tcompares channels, messages and pipes between two threads\n");
+			printf("\t--pipe [file]\tstreams a large file through a pipe like 'cat file | wc -l'\n");
+			printf("\t--lookup [n]\tresolves paths in a directory with n entries (default 4000)\n");
+			printf("\t--mutex [n]\tlets n threads (default 32) contend for one mutex\n");
+			printf("\t--ring [file]\treads a file in small chunks per call and batched on a ring\n");
+			printf("\t--timer [us]\tmeasures wake-up jitter of sleeps below the tick (default 100 us)\n");
+			printf("\t--append [MiB]\tappends to and truncates a ramdisk file up to the given size (default 64 MiB)\n");
+			printf("\t--fs-delegate [MiB]\treads a file served by a userspace delegate and from the ramdisk (default 16 MiB)\n");
+			printf("\t--disk [file] [MiB]\treads a disk mounted by the AHCI driver (default sata0, 64 MiB)\n");
+			printf("\t--disk-write file [MiB]\toverwrites the start of the given disk and syncs it (default 8 MiB)\n");
+			printf("\n");
+		}
+		else
+		{
+			fprintf(stderr, "unknown benchmark: %s\n", command);
+			return 1;
+		}
+	}
+	else
+	{
+		fprintf(stderr, "usage: bench <benchmark>, see --help\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,212 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "channels.hpp"
+#include "../bench.hpp"
+
+#include <string.h>
+
+#define BENCH_EVENT_SIZE		32
+#define BENCH_STREAM_EVENTS		100000
+#define BENCH_PING_PONGS		10000
+
+/**
+ * Transport under test. The peer thread either streams events to the main
+ * thread or echoes every event it receives back to it.
+ */
+struct bench_transport_t
+{
+	const char* name;
+	bool (*send)(bench_transport_t* transport, bool toPeer, uint8_t* event);
+	bool (*receive)(bench_transport_t* transport, bool atPeer, uint8_t* event);
+
+	g_channel channels[2];
+	g_fd pipeWrite[2];
+	g_fd pipeRead[2];
+	g_tid tids[2];
+
+	uint32_t iterations;
+	bool echo;
+};
+
+static bool benchChannelSend(bench_transport_t* transport, bool toPeer, uint8_t* event)
+{
+	return g_channel_write(&transport->channels[toPeer], event, BENCH_EVENT_SIZE) == G_CHANNEL_STATUS_SUCCESSFUL;
+}
+
+static bool benchChannelReceive(bench_transport_t* transport, bool atPeer, uint8_t* event)
+{
+	uint32_t length;
+	return g_channel_read(&transport->channels[atPeer], event, BENCH_EVENT_SIZE, &length) == G_CHANNEL_STATUS_SUCCESSFUL &&
+	       length == BENCH_EVENT_SIZE;
+}
+
+static bool benchMessageSend(bench_transport_t* transport, bool toPeer, uint8_t* event)
+{
+	return g_send_message(transport->tids[toPeer], event, BENCH_EVENT_SIZE) == G_MESSAGE_SEND_STATUS_SUCCESSFUL;
+}
+
+static bool benchMessageReceive(bench_transport_t* transport, bool atPeer, uint8_t* event)
+{
+	uint8_t buffer[sizeof(g_message_header) + BENCH_EVENT_SIZE];
+	if(g_receive_message(buffer, sizeof(buffer)) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+		return false;
+	memcpy(event, G_MESSAGE_CONTENT(buffer), BENCH_EVENT_SIZE);
+	return true;
+}
+
+static bool benchPipeSend(bench_transport_t* transport, bool toPeer, uint8_t* event)
+{
+	uint32_t written = 0;
+	while(written < BENCH_EVENT_SIZE)
+	{
+		int32_t result = g_write(transport->pipeWrite[toPeer], event + written, BENCH_EVENT_SIZE - written);
+		if(result <= 0)
+			return false;
+		written += result;
+	}
+	return true;
+}
+
+static bool benchPipeReceive(bench_transport_t* transport, bool atPeer, uint8_t* event)
+{
+	uint32_t read = 0;
+	while(read < BENCH_EVENT_SIZE)
+	{
+		int32_t result = g_read(transport->pipeRead[atPeer], event + read, BENCH_EVENT_SIZE - read);
+		if(result <= 0)
+			return false;
+		read += result;
+	}
+	return true;
+}
+
+static void benchTransportPeer(bench_transport_t* transport)
+{
+	uint8_t event[BENCH_EVENT_SIZE];
+	memset(event, 0, sizeof(event));
+
+	for(uint32_t i = 0; i < transport->iterations; i++)
+	{
+		if(transport->echo && !transport->receive(transport, true, event))
+			break;
+		*((uint32_t*) event) = i;
+		if(!transport->send(transport, false, event))
+			break;
+	}
+}
+
+static bool benchTransportSetup(bench_transport_t* transport)
+{
+	transport->tids[0] = g_get_tid();
+	for(int i = 0; i < 2; i++)
+	{
+		if(g_channel_create(&transport->channels[i], G_CHANNEL_DEFAULT_CAPACITY) != G_CHANNEL_STATUS_SUCCESSFUL ||
+		   g_pipe(&transport->pipeWrite[i], &transport->pipeRead[i]) != G_FS_PIPE_SUCCESSFUL)
+			return false;
+	}
+	return true;
+}
+
+static void benchTransportTeardown(bench_transport_t* transport)
+{
+	for(int i = 0; i < 2; i++)
+	{
+		g_channel_close(&transport->channels[i]);
+		g_close(transport->pipeWrite[i]);
+		g_close(transport->pipeRead[i]);
+	}
+}
+
+static bool benchTransportRun(bench_transport_t* transport, bool echo, uint32_t iterations)
+{
+	transport->echo = echo;
+	transport->iterations = iterations;
+	transport->tids[1] = g_create_task_d((void*) &benchTransportPeer, transport);
+
+	uint8_t event[BENCH_EVENT_SIZE];
+	memset(event, 0, sizeof(event));
+
+	uint64_t start = g_nanos();
+	for(uint32_t i = 0; i < iterations; i++)
+	{
+		if(echo && !transport->send(transport, true, event))
+			return false;
+		if(!transport->receive(transport, false, event) || *((uint32_t*) event) != i)
+		{
+			fprintf(stderr, "%s: lost event %u\n", transport->name, i);
+			return false;
+		}
+	}
+	uint64_t nanos = g_nanos() - start;
+	g_join(transport->tids[1]);
+
+	char name[64];
+	if(echo)
+	{
+		snprintf(name, sizeof(name), "%s, round-trip", transport->name);
+		benchReport(name, iterations, nanos);
+	}
+	else
+	{
+		snprintf(name, sizeof(name), "%s, stream", transport->name);
+		benchReport(name, iterations, nanos);
+		benchReportThroughput(name, (uint64_t) iterations * BENCH_EVENT_SIZE, nanos);
+	}
+	return true;
+}
+
+int benchChannels(int argc, char** argv)
+{
+	bench_transport_t transport;
+	if(!benchTransportSetup(&transport))
+	{
+		fprintf(stderr, "failed to set up channels and pipes\n");
+		return 1;
+	}
+
+	struct
+	{
+		const char* name;
+		bool (*send)(bench_transport_t*, bool, uint8_t*);
+		bool (*receive)(bench_transport_t*, bool, uint8_t*);
+	} transports[] = {
+			{"channel", benchChannelSend, benchChannelReceive},
+			{"message", benchMessageSend, benchMessageReceive},
+			{"pipe", benchPipeSend, benchPipeReceive}};
+
+	int result = 0;
+	for(auto& entry: transports)
+	{
+		transport.name = entry.name;
+		transport.send = entry.send;
+		transport.receive = entry.receive;
+
+		if(!benchTransportRun(&transport, false, BENCH_STREAM_EVENTS) ||
+		   !benchTransportRun(&transport, true, BENCH_PING_PONGS))
+		{
+			result = 1;
+			break;
+		}
+	}
+
+	benchTransportTeardown(&transport);
+	return result;
+}
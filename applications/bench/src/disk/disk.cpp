@@ -0,0 +1,253 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "disk.hpp"
+#include "../bench.hpp"
+
+#include <libahci/driver.hpp>
+#include <stdlib.h>
+
+#define BENCH_DISK_DEFAULT_PATH		"/mount/" G_AHCI_DRIVER_MOUNT "/" G_AHCI_DRIVER_DISK_PREFIX "0"
+#define BENCH_DISK_DEFAULT_MIB		64
+#define BENCH_DISK_LARGE_SIZE		(64 * 1024)
+#define BENCH_DISK_SMALL_SIZE		4096
+#define BENCH_DISK_SMALL_READS		1000
+#define BENCH_DISK_THREADS			4
+#define BENCH_DISK_WRITE_DEFAULT_MIB	8
+
+struct bench_disk_reader_t
+{
+	const char* path;
+	uint64_t offset;
+	uint64_t length;
+	bool success;
+};
+
+/**
+ * Reads a range of the disk with its own file descriptor.
+ */
+static void benchDiskReadRange(bench_disk_reader_t* reader)
+{
+	reader->success = false;
+
+	g_fd fd = g_open(reader->path);
+	if(fd == G_FD_NONE)
+		return;
+
+	uint8_t* buffer = new uint8_t[BENCH_DISK_LARGE_SIZE];
+	bool success = g_seek(fd, reader->offset, G_FS_SEEK_SET) == (int64_t) reader->offset;
+	for(uint64_t total = 0; success && total < reader->length; total += BENCH_DISK_LARGE_SIZE)
+		success = g_read(fd, buffer, BENCH_DISK_LARGE_SIZE) == BENCH_DISK_LARGE_SIZE;
+
+	delete[] buffer;
+	g_close(fd);
+	reader->success = success;
+}
+
+static bool benchDiskSequential(const char* path, uint64_t length)
+{
+	bench_disk_reader_t reader;
+	reader.path = path;
+	reader.offset = 0;
+	reader.length = length;
+
+	uint64_t start = g_nanos();
+	benchDiskReadRange(&reader);
+	uint64_t nanos = g_nanos() - start;
+
+	if(!reader.success)
+	{
+		fprintf(stderr, "failed to read %s sequentially\n", path);
+		return false;
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "disk, %i KiB reads", BENCH_DISK_LARGE_SIZE / 1024);
+	benchReportThroughput(name, length, nanos);
+	return true;
+}
+
+static bool benchDiskConcurrent(const char* path, uint64_t length)
+{
+	bench_disk_reader_t readers[BENCH_DISK_THREADS];
+	g_tid threads[BENCH_DISK_THREADS];
+	uint64_t share = length / BENCH_DISK_THREADS;
+
+	uint64_t start = g_nanos();
+	for(int i = 0; i < BENCH_DISK_THREADS; i++)
+	{
+		readers[i].path = path;
+		readers[i].offset = i * share;
+		readers[i].length = share;
+		threads[i] = g_create_task_d((void*) &benchDiskReadRange, &readers[i]);
+	}
+	for(int i = 0; i < BENCH_DISK_THREADS; i++)
+		g_join(threads[i]);
+	uint64_t nanos = g_nanos() - start;
+
+	for(int i = 0; i < BENCH_DISK_THREADS; i++)
+	{
+		if(!readers[i].success)
+		{
+			fprintf(stderr, "failed to read %s from thread %i\n", path, i);
+			return false;
+		}
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "disk, %i threads", BENCH_DISK_THREADS);
+	benchReportThroughput(name, share * BENCH_DISK_THREADS, nanos);
+	return true;
+}
+
+static bool benchDiskRandom(const char* path, uint64_t length)
+{
+	g_fd fd = g_open(path);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s\n", path);
+		return false;
+	}
+
+	uint8_t buffer[BENCH_DISK_SMALL_SIZE];
+	uint64_t blocks = length / BENCH_DISK_SMALL_SIZE;
+	uint32_t seed = 12345;
+	bool success = true;
+
+	uint64_t start = g_nanos();
+	for(uint32_t i = 0; success && i < BENCH_DISK_SMALL_READS; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		uint64_t offset = (seed % blocks) * BENCH_DISK_SMALL_SIZE;
+		success = g_seek(fd, offset, G_FS_SEEK_SET) == (int64_t) offset &&
+		          g_read(fd, buffer, sizeof(buffer)) == sizeof(buffer);
+	}
+	uint64_t nanos = g_nanos() - start;
+	g_close(fd);
+
+	if(!success)
+	{
+		fprintf(stderr, "failed to read %s at random offsets\n", path);
+		return false;
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "disk, %i byte random read", BENCH_DISK_SMALL_SIZE);
+	benchReport(name, BENCH_DISK_SMALL_READS, nanos);
+	return true;
+}
+
+/**
+ * Parses the path and size arguments and limits the size to the disk.
+ *
+ * @return the number of bytes to use or 0 if the disk can't be used
+ */
+static uint64_t benchDiskPrepare(int argc, char** argv, uint64_t defaultMib, const char** outPath)
+{
+	const char* path = BENCH_DISK_DEFAULT_PATH;
+	if(argc > 2)
+		path = argv[2];
+	*outPath = path;
+
+	uint64_t mib = defaultMib;
+	if(argc > 3)
+		mib = atoi(argv[3]);
+	if(mib == 0)
+		mib = 1;
+
+	g_fd fd = g_open(path);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s, is there a disk on an AHCI controller?\n", path);
+		return 0;
+	}
+	int64_t diskLength = g_length(fd);
+	g_close(fd);
+
+	uint64_t length = mib * 1024 * 1024;
+	if(diskLength > 0 && (uint64_t) diskLength < length)
+		length = diskLength - diskLength % (BENCH_DISK_LARGE_SIZE * BENCH_DISK_THREADS);
+	if(length == 0)
+		fprintf(stderr, "%s is too small\n", path);
+	return length;
+}
+
+int benchDisk(int argc, char** argv)
+{
+	const char* path;
+	uint64_t length = benchDiskPrepare(argc, argv, BENCH_DISK_DEFAULT_MIB, &path);
+	if(length == 0)
+		return 1;
+
+	bool success = benchDiskSequential(path, length) && benchDiskConcurrent(path, length) &&
+	               benchDiskRandom(path, length);
+	return success ? 0 : 1;
+}
+
+int benchDiskWrite(int argc, char** argv)
+{
+	// Data on the disk is destroyed, so it is never chosen by default
+	if(argc < 3)
+	{
+		fprintf(stderr, "this overwrites the start of a disk, pass its path explicitly (like %s)\n",
+		        BENCH_DISK_DEFAULT_PATH);
+		return 1;
+	}
+
+	const char* path;
+	uint64_t length = benchDiskPrepare(argc, argv, BENCH_DISK_WRITE_DEFAULT_MIB, &path);
+	if(length == 0)
+		return 1;
+
+	g_fd fd = g_open_f(path, G_FILE_FLAG_MODE_READ | G_FILE_FLAG_MODE_WRITE);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s for writing\n", path);
+		return 1;
+	}
+
+	uint8_t* buffer = new uint8_t[BENCH_DISK_LARGE_SIZE];
+	for(uint32_t i = 0; i < BENCH_DISK_LARGE_SIZE; i++)
+		buffer[i] = (uint8_t) (i * 31);
+
+	bool success = true;
+	uint64_t start = g_nanos();
+	for(uint64_t total = 0; success && total < length; total += BENCH_DISK_LARGE_SIZE)
+		success = g_write(fd, buffer, BENCH_DISK_LARGE_SIZE) == BENCH_DISK_LARGE_SIZE;
+	uint64_t written = g_nanos();
+	success = success && g_fsync(fd) == G_FS_SYNC_SUCCESSFUL;
+	uint64_t synced = g_nanos();
+
+	delete[] buffer;
+	g_close(fd);
+
+	if(!success)
+	{
+		fprintf(stderr, "failed to write and sync %s\n", path);
+		return 1;
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "disk, %i KiB writes", BENCH_DISK_LARGE_SIZE / 1024);
+	benchReportThroughput(name, length, written - start);
+	benchReportThroughput("disk, writes and sync", length, synced - start);
+	benchReport("disk, sync", 1, synced - written);
+	return 0;
+}
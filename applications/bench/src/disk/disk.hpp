@@ -0,0 +1,38 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __BENCH_DISK__
+#define __BENCH_DISK__
+
+/**
+ * Reads a disk that the AHCI driver mounted: the throughput of large sequential reads
+ * from one thread and from several threads at once, which lets the driver queue
+ * their commands, and the latency of small reads at random offsets.
+ */
+int benchDisk(int argc, char** argv);
+
+/**
+ * Writes to a disk that the AHCI driver mounted and syncs it. Shows how fast writes are
+ * taken by the block cache and how long it takes to write them back. Overwrites the
+ * start of the disk, so the path of the disk must be given explicitly.
+ */
+int benchDiskWrite(int argc, char** argv);
+
+#endif
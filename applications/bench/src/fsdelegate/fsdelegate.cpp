@@ -0,0 +1,312 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "fsdelegate.hpp"
+#include "../bench.hpp"
+
+#include <ghost/filesystem/delegate.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_DELEGATE_RAMDISK_PATH		"/bench-delegate"
+#define BENCH_DELEGATE_MOUNTPOINT		"bench"
+#define BENCH_DELEGATE_FILE_NAME		"data"
+#define BENCH_DELEGATE_FILE_ID			1
+#define BENCH_DELEGATE_DEFAULT_MIB		16
+#define BENCH_DELEGATE_OPENS			1000
+#define BENCH_DELEGATE_SMALL_READS		10000
+#define BENCH_DELEGATE_SMALL_SIZE		64
+#define BENCH_DELEGATE_LARGE_SIZE		(64 * 1024)
+
+/**
+ * State shared with the delegate thread. The file content is generated from the
+ * offset, so that both sides can check it without storing it twice.
+ */
+struct bench_delegate_t
+{
+	g_tid main;
+	uint8_t* content;
+	uint64_t length;
+};
+
+static void benchDelegateCreateFile(g_fs_virt_id parent)
+{
+	g_fs_virt_id created;
+	g_fs_create_node(parent, (char*) BENCH_DELEGATE_FILE_NAME, G_FS_NODE_TYPE_FILE, BENCH_DELEGATE_FILE_ID, &created);
+}
+
+static void benchDelegateHandle(bench_delegate_t* state, g_fs_tasked_delegate_request* request)
+{
+	void* storage = (void*) request->storage;
+
+	if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER)
+	{
+		auto discovery = (g_fs_tasked_delegate_transaction_storage_discovery*) storage;
+		if(discovery->parent_phys_fs_id == 0 && strcmp(discovery->name, BENCH_DELEGATE_FILE_NAME) == 0)
+		{
+			benchDelegateCreateFile(discovery->parent_virt_fs_id);
+			discovery->result_status = G_FS_DISCOVERY_SUCCESSFUL;
+		}
+		else
+		{
+			discovery->result_status = G_FS_DISCOVERY_NOT_FOUND;
+		}
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY)
+	{
+		auto refresh = (g_fs_tasked_delegate_transaction_storage_directory_refresh*) storage;
+		if(refresh->parent_phys_fs_id == 0)
+			benchDelegateCreateFile(refresh->parent_virt_fs_id);
+		refresh->result_status = G_FS_DIRECTORY_REFRESH_SUCCESSFUL;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN)
+	{
+		auto open = (g_fs_tasked_delegate_transaction_storage_open*) storage;
+		open->result_status = G_FS_OPEN_SUCCESSFUL;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE)
+	{
+		auto close = (g_fs_tasked_delegate_transaction_storage_close*) storage;
+		close->result_status = G_FS_CLOSE_SUCCESSFUL;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH)
+	{
+		auto length = (g_fs_tasked_delegate_transaction_storage_get_length*) storage;
+		length->result_length = state->length;
+		length->result_status = G_FS_LENGTH_SUCCESSFUL;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ)
+	{
+		auto read = (g_fs_tasked_delegate_transaction_storage_read*) storage;
+		int64_t length = 0;
+		if(read->offset >= 0 && (uint64_t) read->offset < state->length)
+		{
+			length = read->length;
+			if((uint64_t) (read->offset + length) > state->length)
+				length = state->length - read->offset;
+			memcpy(read->mapped_buffer, state->content + read->offset, length);
+		}
+		read->result_read = length;
+		read->result_status = G_FS_READ_SUCCESSFUL;
+	}
+	else if(request->type == G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE)
+	{
+		auto write = (g_fs_tasked_delegate_transaction_storage_write*) storage;
+		write->result_write = 0;
+		write->result_status = G_FS_WRITE_NOT_SUPPORTED;
+	}
+
+	g_fs_set_transaction_status(request->transaction, G_FS_TRANSACTION_FINISHED);
+}
+
+/**
+ * Registers the mountpoint, reports the status to the main thread and then serves
+ * requests until the main thread sends a message that is not a request.
+ */
+static void benchDelegateServe(bench_delegate_t* state)
+{
+	g_fs_virt_id mountpoint;
+	g_address storage;
+	g_fs_register_as_delegate_status status =
+			g_fs_register_as_delegate(BENCH_DELEGATE_MOUNTPOINT, 0, &mountpoint, &storage);
+	g_send_message(state->main, &status, sizeof(status));
+	if(status != G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+		return;
+
+	uint8_t buffer[sizeof(g_message_header) + sizeof(g_fs_tasked_delegate_request)];
+	while(g_receive_message(buffer, sizeof(buffer)) == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+	{
+		auto header = (g_message_header*) buffer;
+		if(header->length != sizeof(g_fs_tasked_delegate_request))
+			break;
+
+		benchDelegateHandle(state, (g_fs_tasked_delegate_request*) G_MESSAGE_CONTENT(buffer));
+	}
+}
+
+static bool benchDelegateOpenClose(const char* target, const char* path)
+{
+	uint64_t start = g_nanos();
+	for(uint32_t i = 0; i < BENCH_DELEGATE_OPENS; i++)
+	{
+		g_fd fd = g_open(path);
+		if(fd == G_FD_NONE)
+		{
+			fprintf(stderr, "failed to open %s\n", path);
+			return false;
+		}
+		g_close(fd);
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "%s, open and close", target);
+	benchReport(name, BENCH_DELEGATE_OPENS, g_nanos() - start);
+	return true;
+}
+
+static bool benchDelegateSmallReads(const char* target, g_fd fd, bench_delegate_t* state)
+{
+	uint8_t buffer[BENCH_DELEGATE_SMALL_SIZE];
+	uint32_t stride = state->length / BENCH_DELEGATE_SMALL_READS;
+
+	uint64_t start = g_nanos();
+	for(uint32_t i = 0; i < BENCH_DELEGATE_SMALL_READS; i++)
+	{
+		uint64_t offset = (uint64_t) i * stride;
+		if(g_seek(fd, offset, G_FS_SEEK_SET) != (int64_t) offset ||
+		   g_read(fd, buffer, sizeof(buffer)) != sizeof(buffer))
+		{
+			fprintf(stderr, "failed to read at offset %llu\n", offset);
+			return false;
+		}
+	}
+	uint64_t nanos = g_nanos() - start;
+
+	char name[64];
+	snprintf(name, sizeof(name), "%s, %i byte read", target, BENCH_DELEGATE_SMALL_SIZE);
+	benchReport(name, BENCH_DELEGATE_SMALL_READS, nanos);
+	return true;
+}
+
+static bool benchDelegateLargeReads(const char* target, g_fd fd, bench_delegate_t* state)
+{
+	uint8_t* buffer = new uint8_t[BENCH_DELEGATE_LARGE_SIZE];
+	bool success = g_seek(fd, 0, G_FS_SEEK_SET) == 0;
+
+	uint64_t total = 0;
+	uint64_t start = g_nanos();
+	while(success && total < state->length)
+	{
+		int32_t read = g_read(fd, buffer, BENCH_DELEGATE_LARGE_SIZE);
+		if(read <= 0 || memcmp(buffer, state->content + total, read) != 0)
+		{
+			fprintf(stderr, "read unexpected content at offset %llu\n", total);
+			success = false;
+		}
+		else
+		{
+			total += read;
+		}
+	}
+	uint64_t nanos = g_nanos() - start;
+	delete[] buffer;
+
+	if(success)
+	{
+		char name[64];
+		snprintf(name, sizeof(name), "%s, %i KiB reads", target, BENCH_DELEGATE_LARGE_SIZE / 1024);
+		benchReportThroughput(name, total, nanos);
+	}
+	return success;
+}
+
+static bool benchDelegateRun(const char* target, const char* path, bench_delegate_t* state)
+{
+	if(!benchDelegateOpenClose(target, path))
+		return false;
+
+	g_fd fd = g_open(path);
+	if(fd == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s\n", path);
+		return false;
+	}
+
+	bool success = benchDelegateSmallReads(target, fd, state) && benchDelegateLargeReads(target, fd, state);
+	g_close(fd);
+	return success;
+}
+
+static bool benchDelegateCreateRamdiskFile(bench_delegate_t* state)
+{
+	g_fd fd = g_open_f(BENCH_DELEGATE_RAMDISK_PATH,
+	                   G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+		return false;
+
+	bool success = true;
+	for(uint64_t total = 0; success && total < state->length; total += BENCH_DELEGATE_LARGE_SIZE)
+		success = g_write(fd, state->content + total, BENCH_DELEGATE_LARGE_SIZE) == BENCH_DELEGATE_LARGE_SIZE;
+
+	g_close(fd);
+	return success;
+}
+
+int benchFsDelegate(int argc, char** argv)
+{
+	uint64_t mib = BENCH_DELEGATE_DEFAULT_MIB;
+	if(argc > 2)
+		mib = atoi(argv[2]);
+	if(mib == 0)
+		mib = 1;
+
+	bench_delegate_t state;
+	state.main = g_get_tid();
+	state.length = mib * 1024 * 1024;
+	state.content = (uint8_t*) g_alloc_mem(state.length);
+	if(!state.content)
+	{
+		fprintf(stderr, "failed to allocate file content\n");
+		return 1;
+	}
+	for(uint64_t i = 0; i < state.length; i++)
+		state.content[i] = (uint8_t) (i * 31 + (i >> 12));
+
+	g_tid delegate = g_create_task_d((void*) &benchDelegateServe, &state);
+
+	uint8_t statusBuffer[sizeof(g_message_header) + sizeof(g_fs_register_as_delegate_status)];
+	g_fs_register_as_delegate_status status = G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	if(g_receive_message(statusBuffer, sizeof(statusBuffer)) == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+		status = *((g_fs_register_as_delegate_status*) G_MESSAGE_CONTENT(statusBuffer));
+
+	bool success = false;
+	if(status != G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to register as delegate with status %i, the driver security level is required\n",
+		        status);
+	}
+	else if(!benchDelegateCreateRamdiskFile(&state))
+	{
+		fprintf(stderr, "failed to create %s\n", BENCH_DELEGATE_RAMDISK_PATH);
+	}
+	else
+	{
+		char path[64];
+		snprintf(path, sizeof(path), "/mount/%s/%s", BENCH_DELEGATE_MOUNTPOINT, BENCH_DELEGATE_FILE_NAME);
+		success = benchDelegateRun("ramdisk", BENCH_DELEGATE_RAMDISK_PATH, &state) &&
+		          benchDelegateRun("delegate", path, &state);
+	}
+
+	// Any other message stops the delegate
+	if(status == G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL)
+	{
+		uint8_t stop = 0;
+		g_send_message(delegate, &stop, sizeof(stop));
+	}
+	g_join(delegate);
+
+	// Truncating frees the pages again
+	g_fd fd = g_open_f(BENCH_DELEGATE_RAMDISK_PATH, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd != G_FD_NONE)
+		g_close(fd);
+
+	g_unmap(state.content);
+	return success ? 0 : 1;
+}
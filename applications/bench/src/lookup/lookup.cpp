@@ -0,0 +1,90 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "lookup.hpp"
+#include "../bench.hpp"
+
+#include <stdlib.h>
+
+#define BENCH_LOOKUP_ENTRIES		4000
+#define BENCH_LOOKUP_NAME_LENGTH	32
+
+static char* benchLookupFormat(const char* format, uint32_t count)
+{
+	char* names = new char[count * BENCH_LOOKUP_NAME_LENGTH];
+	for(uint32_t i = 0; i < count; i++)
+		snprintf(&names[i * BENCH_LOOKUP_NAME_LENGTH], BENCH_LOOKUP_NAME_LENGTH, format, i);
+	return names;
+}
+
+static bool benchLookupCreateFiles(const char* names, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		g_fd fd = g_open_f(&names[i * BENCH_LOOKUP_NAME_LENGTH], G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE);
+		if(fd == G_FD_NONE)
+			return false;
+		g_close(fd);
+	}
+	return true;
+}
+
+static bool benchLookupRun(const char* name, const char* names, uint32_t count, g_fs_stat_status expected)
+{
+	g_fs_stat_data data;
+	uint64_t start = g_nanos();
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(g_fs_stat(&names[i * BENCH_LOOKUP_NAME_LENGTH], &data) != expected)
+		{
+			fprintf(stderr, "unexpected result for %s\n", &names[i * BENCH_LOOKUP_NAME_LENGTH]);
+			return false;
+		}
+	}
+	uint64_t nanos = g_nanos() - start;
+
+	benchReport(name, count, nanos);
+	return true;
+}
+
+int benchLookup(int argc, char** argv)
+{
+	uint32_t entries = BENCH_LOOKUP_ENTRIES;
+	if(argc > 2)
+		entries = atoi(argv[2]);
+	if(entries == 0)
+		entries = 1;
+
+	char* existing = benchLookupFormat("/bench-lookup-%05u", entries);
+	char* missing = benchLookupFormat("/bench-lookup-missing-%05u", entries);
+
+	bool success = benchLookupCreateFiles(existing, entries);
+	if(!success)
+		fprintf(stderr, "failed to create the lookup files\n");
+
+	success = success && benchLookupRun("lookup existing, first", existing, entries, G_FS_STAT_SUCCESS) &&
+	          benchLookupRun("lookup existing, again", existing, entries, G_FS_STAT_SUCCESS) &&
+	          benchLookupRun("lookup missing, first", missing, entries, G_FS_STAT_NOT_FOUND) &&
+	          benchLookupRun("lookup missing, again", missing, entries, G_FS_STAT_NOT_FOUND);
+
+	delete[] existing;
+	delete[] missing;
+	return success ? 0 : 1;
+}
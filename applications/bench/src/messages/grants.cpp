@@ -0,0 +1,135 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "messages.hpp"
+#include "../bench.hpp"
+
+#include <string.h>
+
+#define BENCH_GRANT_PAYLOAD		(1024 * 1024)
+#define BENCH_GRANT_ROUNDS		64
+#define BENCH_GRANT_CHUNK		G_MESSAGE_MAXIMUM_MESSAGE_LENGTH
+
+static g_tid benchGrantMain;
+
+/**
+ * Receives payloads and acknowledges each one. Granted payloads are released
+ * right away, chunked payloads are acknowledged once all chunks arrived.
+ */
+static void benchGrantReceiver(bool* granted)
+{
+	size_t bufferSize = sizeof(g_message_header) + G_MESSAGE_MAXIMUM_MESSAGE_LENGTH;
+	auto buffer = new uint8_t[bufferSize];
+	uint8_t ack = 0;
+
+	for(uint32_t round = 0; round < BENCH_GRANT_ROUNDS; round++)
+	{
+		uint32_t received = 0;
+		while(received < BENCH_GRANT_PAYLOAD)
+		{
+			if(g_receive_message(buffer, bufferSize) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+				return;
+
+			if(*granted)
+			{
+				auto header = (g_message_header*) buffer;
+				if(header->grants != 1)
+					return;
+				g_message_grant* grant = G_MESSAGE_GRANTS(buffer);
+				ack ^= *((uint8_t*) grant->address);
+				received += grant->size;
+				g_release_message_grants(buffer);
+			}
+			else
+			{
+				ack ^= *G_MESSAGE_CONTENT(buffer);
+				received += ((g_message_header*) buffer)->length;
+			}
+		}
+		g_send_message(benchGrantMain, &ack, sizeof(ack));
+	}
+
+	delete[] buffer;
+}
+
+static bool benchGrantRun(bool granted, uint8_t* payload)
+{
+	g_tid receiver = g_create_task_d((void*) &benchGrantReceiver, &granted);
+	uint8_t ackBuffer[sizeof(g_message_header) + 1];
+
+	uint64_t start = g_nanos();
+	for(uint32_t round = 0; round < BENCH_GRANT_ROUNDS; round++)
+	{
+		payload[0] = round;
+		if(granted)
+		{
+			g_message_grant grant;
+			grant.address = payload;
+			grant.size = BENCH_GRANT_PAYLOAD;
+			if(g_send_message_grants(receiver, &round, sizeof(round), &grant, 1) != G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+			{
+				fprintf(stderr, "failed to send grant in round %u\n", round);
+				return false;
+			}
+		}
+		else
+		{
+			for(uint32_t offset = 0; offset < BENCH_GRANT_PAYLOAD; offset += BENCH_GRANT_CHUNK)
+			{
+				if(g_send_message(receiver, payload + offset, BENCH_GRANT_CHUNK) != G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+				{
+					fprintf(stderr, "failed to send chunk in round %u\n", round);
+					return false;
+				}
+			}
+		}
+
+		if(g_receive_message(ackBuffer, sizeof(ackBuffer)) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+		{
+			fprintf(stderr, "missing acknowledgement in round %u\n", round);
+			return false;
+		}
+	}
+	uint64_t nanos = g_nanos() - start;
+	g_join(receiver);
+
+	const char* name = granted ? "1 MiB, page grant" : "1 MiB, copied in chunks";
+	benchReport(name, BENCH_GRANT_ROUNDS, nanos);
+	benchReportThroughput(name, (uint64_t) BENCH_GRANT_ROUNDS * BENCH_GRANT_PAYLOAD, nanos);
+	return true;
+}
+
+int benchMessageGrants(int argc, char** argv)
+{
+	benchGrantMain = g_get_tid();
+
+	auto payload = (uint8_t*) g_alloc_mem(BENCH_GRANT_PAYLOAD);
+	if(!payload)
+	{
+		fprintf(stderr, "failed to allocate payload\n");
+		return 1;
+	}
+	memset(payload, 0xAB, BENCH_GRANT_PAYLOAD);
+
+	int result = (benchGrantRun(true, payload) && benchGrantRun(false, payload)) ? 0 : 1;
+
+	g_unmap(payload);
+	return result;
+}
@@ -0,0 +1,123 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "messages.hpp"
+#include "../bench.hpp"
+
+#include <stdlib.h>
+
+int benchMessageTransactions(int argc, char** argv)
+{
+	const uint32_t outstandingCounts[] = {16, 64, 256, 1024};
+	const uint32_t rounds = 20;
+
+	g_tid self = g_get_tid();
+	uint32_t maximumOutstanding = outstandingCounts[sizeof(outstandingCounts) / sizeof(uint32_t) - 1];
+	auto transactions = new g_message_transaction[maximumOutstanding];
+
+	uint32_t payload = 0;
+	size_t bufferSize = sizeof(g_message_header) + sizeof(payload);
+	auto buffer = new uint8_t[bufferSize];
+
+	for(uint32_t outstanding: outstandingCounts)
+	{
+		uint64_t receiveNanos = 0;
+		for(uint32_t round = 0; round < rounds; round++)
+		{
+			for(uint32_t i = 0; i < outstanding; i++)
+			{
+				transactions[i] = g_get_message_tx_id();
+				payload = i;
+				if(g_send_message_t(self, &payload, sizeof(payload), transactions[i]) != G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+				{
+					fprintf(stderr, "failed to send message %u of %u\n", i, outstanding);
+					return 1;
+				}
+			}
+
+			uint64_t start = g_nanos();
+			for(uint32_t i = outstanding; i > 0; i--)
+			{
+				if(g_receive_message_t(buffer, bufferSize, transactions[i - 1]) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL ||
+				   *((uint32_t*) G_MESSAGE_CONTENT(buffer)) != i - 1)
+				{
+					fprintf(stderr, "failed to receive transaction %i\n", transactions[i - 1]);
+					return 1;
+				}
+			}
+			receiveNanos += g_nanos() - start;
+		}
+
+		char name[64];
+		snprintf(name, sizeof(name), "receive-by-tx, %u outstanding", outstanding);
+		benchReport(name, outstanding * rounds, receiveNanos);
+	}
+
+	// A message without transaction that is never received stays at the head of the queue,
+	// transactional traffic behind it must keep finding space
+	payload = 0;
+	if(g_send_message_m(self, &payload, sizeof(payload), G_MESSAGE_SEND_MODE_NON_BLOCKING) !=
+	   G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to send stale message\n");
+		return 1;
+	}
+
+	const uint32_t outstanding = 64;
+	uint32_t staleRounds = 4 * G_MESSAGE_MAXIMUM_QUEUE_CONTENT / (outstanding * bufferSize);
+	uint64_t staleNanos = 0;
+	for(uint32_t round = 0; round < staleRounds; round++)
+	{
+		uint64_t start = g_nanos();
+		for(uint32_t i = 0; i < outstanding; i++)
+		{
+			transactions[i] = g_get_message_tx_id();
+			payload = i;
+			if(g_send_message_tm(self, &payload, sizeof(payload), transactions[i], G_MESSAGE_SEND_MODE_NON_BLOCKING) !=
+			   G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+			{
+				fprintf(stderr, "failed to send message %u behind stale message in round %u\n", i, round);
+				return 1;
+			}
+		}
+
+		for(uint32_t i = outstanding; i > 0; i--)
+		{
+			if(g_receive_message_t(buffer, bufferSize, transactions[i - 1]) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL ||
+			   *((uint32_t*) G_MESSAGE_CONTENT(buffer)) != i - 1)
+			{
+				fprintf(stderr, "failed to receive transaction %i behind stale message\n", transactions[i - 1]);
+				return 1;
+			}
+		}
+		staleNanos += g_nanos() - start;
+	}
+	benchReport("send and receive-by-tx behind a stale message", outstanding * staleRounds, staleNanos);
+
+	if(g_receive_message(buffer, bufferSize) != G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to receive stale message\n");
+		return 1;
+	}
+
+	delete[] buffer;
+	delete[] transactions;
+	return 0;
+}
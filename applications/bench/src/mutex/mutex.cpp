@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "mutex.hpp"
+#include "../bench.hpp"
+
+#include <stdlib.h>
+
+#define BENCH_MUTEX_THREADS			32
+#define BENCH_MUTEX_ITERATIONS		2000
+
+struct bench_mutex_t
+{
+	g_user_mutex mutex;
+	g_user_mutex startLock;
+	uint32_t iterations;
+	volatile uint32_t counter;
+};
+
+static void benchMutexWorker(bench_mutex_t* bench)
+{
+	// Wait until all workers exist so they really contend
+	g_mutex_acquire(bench->startLock);
+	g_mutex_release(bench->startLock);
+
+	for(uint32_t i = 0; i < bench->iterations; i++)
+	{
+		g_mutex_acquire(bench->mutex);
+		bench->counter = bench->counter + 1;
+		g_mutex_release(bench->mutex);
+	}
+}
+
+static bool benchMutexRun(uint32_t threads, uint32_t iterations)
+{
+	bench_mutex_t bench;
+	bench.mutex = g_mutex_initialize();
+	bench.startLock = g_mutex_initialize();
+	bench.iterations = iterations;
+	bench.counter = 0;
+
+	g_tid* workers = new g_tid[threads];
+	g_mutex_acquire(bench.startLock);
+	for(uint32_t i = 0; i < threads; i++)
+		workers[i] = g_create_task_d((void*) &benchMutexWorker, &bench);
+
+	uint64_t start = g_nanos();
+	g_mutex_release(bench.startLock);
+	for(uint32_t i = 0; i < threads; i++)
+		g_join(workers[i]);
+	uint64_t nanos = g_nanos() - start;
+
+	delete[] workers;
+	g_mutex_destroy(bench.mutex);
+	g_mutex_destroy(bench.startLock);
+
+	uint32_t expected = threads * iterations;
+	if(bench.counter != expected)
+	{
+		fprintf(stderr, "mutex lost updates, counted %u of %u\n", bench.counter, expected);
+		return false;
+	}
+
+	char name[64];
+	snprintf(name, sizeof(name), "mutex, %u threads", threads);
+	benchReport(name, expected, nanos);
+	return true;
+}
+
+int benchMutexContention(int argc, char** argv)
+{
+	uint32_t threads = BENCH_MUTEX_THREADS;
+	if(argc > 2)
+		threads = atoi(argv[2]);
+	if(threads == 0)
+		threads = 1;
+
+	// Uncontended baseline first, then the requested contention
+	if(!benchMutexRun(1, BENCH_MUTEX_ITERATIONS * 4))
+		return 1;
+	if(threads > 1 && !benchMutexRun(threads, BENCH_MUTEX_ITERATIONS))
+		return 1;
+	return 0;
+}
@@ -0,0 +1,229 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "pipes.hpp"
+#include "../bench.hpp"
+
+#include <string.h>
+
+#define BENCH_PIPE_FILE				"/bench-pipe.dat"
+#define BENCH_PIPE_FILE_SIZE		(8 * 1024 * 1024)
+#define BENCH_PIPE_LARGE_CAPACITY	0x10000
+
+/**
+ * One run of the pipeline. The producer plays "cat", the main thread "wc".
+ */
+struct bench_pipeline_t
+{
+	const char* name;
+	uint32_t capacity;
+	uint32_t chunk;
+	bool splice;
+	bool vectored;
+
+	g_fd file;
+	g_fd pipeWrite;
+	g_fd pipeRead;
+	bool producerFailed;
+};
+
+static bool benchPipeCreateFile(const char* path)
+{
+	g_fd fd = g_open_f(path, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+		return false;
+
+	char line[64];
+	uint8_t buffer[0x4000];
+	uint32_t filled = 0;
+	uint32_t total = 0;
+	uint32_t number = 0;
+	bool success = true;
+	while(success && total < BENCH_PIPE_FILE_SIZE)
+	{
+		int length = snprintf(line, sizeof(line), "line %08u of the pipe benchmark input\n", number++);
+		if(filled + length > sizeof(buffer) || total + filled + length > BENCH_PIPE_FILE_SIZE)
+		{
+			success = g_write(fd, buffer, filled) == (int32_t) filled;
+			total += filled;
+			filled = 0;
+			if(total + length > BENCH_PIPE_FILE_SIZE)
+				break;
+		}
+		memcpy(&buffer[filled], line, length);
+		filled += length;
+	}
+
+	g_close(fd);
+	return success;
+}
+
+static void benchPipeProducer(bench_pipeline_t* pipeline)
+{
+	if(pipeline->splice)
+	{
+		for(;;)
+		{
+			int64_t moved = g_splice(pipeline->file, pipeline->pipeWrite, BENCH_PIPE_FILE_SIZE);
+			if(moved == 0)
+				break;
+			if(moved < 0)
+			{
+				pipeline->producerFailed = true;
+				break;
+			}
+		}
+	}
+	else
+	{
+		auto buffer = new uint8_t[pipeline->chunk];
+		int32_t read;
+		while((read = g_read(pipeline->file, buffer, pipeline->chunk)) > 0)
+		{
+			int32_t written = 0;
+			while(written < read)
+			{
+				int32_t result = g_write(pipeline->pipeWrite, buffer + written, read - written);
+				if(result <= 0)
+				{
+					pipeline->producerFailed = true;
+					break;
+				}
+				written += result;
+			}
+			if(pipeline->producerFailed)
+				break;
+		}
+		delete[] buffer;
+	}
+
+	// Closing the only write end lets the consumer see the end of the stream
+	g_close(pipeline->pipeWrite);
+}
+
+static uint32_t benchPipeCountLines(uint8_t* buffer, int32_t length)
+{
+	uint32_t lines = 0;
+	for(int32_t i = 0; i < length; i++)
+	{
+		if(buffer[i] == '\n')
+			++lines;
+	}
+	return lines;
+}
+
+static bool benchPipeRun(bench_pipeline_t* pipeline, const char* path, uint64_t expectedBytes)
+{
+	pipeline->file = g_open(path);
+	if(pipeline->file == G_FD_NONE)
+	{
+		fprintf(stderr, "failed to open %s\n", path);
+		return false;
+	}
+	if(g_pipe_bc(&pipeline->pipeWrite, &pipeline->pipeRead, true, pipeline->capacity) != G_FS_PIPE_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to create pipe with capacity %u\n", pipeline->capacity);
+		g_close(pipeline->file);
+		return false;
+	}
+	pipeline->producerFailed = false;
+
+	auto buffer = new uint8_t[pipeline->chunk];
+	uint64_t bytes = 0;
+	uint32_t lines = 0;
+
+	uint64_t start = g_nanos();
+	g_tid producer = g_create_task_d((void*) &benchPipeProducer, pipeline);
+	for(;;)
+	{
+		int32_t read;
+		if(pipeline->vectored)
+		{
+			// Split the buffer like a consumer that parses into a header and a body
+			g_fs_iovec vectors[2];
+			vectors[0].buffer = buffer;
+			vectors[0].length = pipeline->chunk / 4;
+			vectors[1].buffer = buffer + vectors[0].length;
+			vectors[1].length = pipeline->chunk - vectors[0].length;
+			read = g_readv(pipeline->pipeRead, vectors, 2);
+		}
+		else
+		{
+			read = g_read(pipeline->pipeRead, buffer, pipeline->chunk);
+		}
+		if(read <= 0)
+			break;
+
+		bytes += read;
+		lines += benchPipeCountLines(buffer, read);
+	}
+	uint64_t nanos = g_nanos() - start;
+	g_join(producer);
+
+	delete[] buffer;
+	g_close(pipeline->pipeRead);
+	g_close(pipeline->file);
+
+	if(pipeline->producerFailed || bytes != expectedBytes)
+	{
+		fprintf(stderr, "%s: moved %llu of %llu bytes\n", pipeline->name, bytes, expectedBytes);
+		return false;
+	}
+
+	benchReportThroughput(pipeline->name, bytes, nanos);
+	printf("%-32s %10u lines\n", pipeline->name, lines);
+	return true;
+}
+
+int benchPipes(int argc, char** argv)
+{
+	const char* path = BENCH_PIPE_FILE;
+	if(argc > 2)
+	{
+		path = argv[2];
+	}
+	else if(!benchPipeCreateFile(path))
+	{
+		fprintf(stderr, "failed to create input file %s\n", path);
+		return 1;
+	}
+
+	g_fd file = g_open(path);
+	int64_t length = g_length(file);
+	g_close(file);
+	if(length <= 0)
+	{
+		fprintf(stderr, "input file %s is empty\n", path);
+		return 1;
+	}
+
+	bench_pipeline_t pipelines[] = {
+			{"pipe 4 KiB, read/write", G_PIPE_DEFAULT_CAPACITY, 0x1000, false, false},
+			{"pipe 64 KiB, read/write", BENCH_PIPE_LARGE_CAPACITY, 0x10000, false, false},
+			{"pipe 64 KiB, splice", BENCH_PIPE_LARGE_CAPACITY, 0x10000, true, false},
+			{"pipe 64 KiB, splice + readv", BENCH_PIPE_LARGE_CAPACITY, 0x10000, true, true}};
+
+	for(auto& pipeline: pipelines)
+	{
+		if(!benchPipeRun(&pipeline, path, length))
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,163 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ring.hpp"
+#include "../bench.hpp"
+
+#include <ghost/ring.h>
+#include <ghost/filesystem/callstructs.h>
+#include <ghost/syscall.h>
+#include <string.h>
+
+#define BENCH_RING_FILE				"/bench-ring.dat"
+#define BENCH_RING_FILE_SIZE		(1024 * 1024)
+#define BENCH_RING_CHUNK			512
+#define BENCH_RING_BATCH			64
+
+static bool benchRingCreateFile(const char* path)
+{
+	g_fd fd = g_open_f(path, G_FILE_FLAG_MODE_WRITE | G_FILE_FLAG_MODE_CREATE | G_FILE_FLAG_MODE_TRUNCATE);
+	if(fd == G_FD_NONE)
+		return false;
+
+	uint8_t buffer[0x1000];
+	memset(buffer, 'r', sizeof(buffer));
+	bool success = true;
+	for(uint32_t total = 0; success && total < BENCH_RING_FILE_SIZE; total += sizeof(buffer))
+		success = g_write(fd, buffer, sizeof(buffer)) == sizeof(buffer);
+
+	g_close(fd);
+	return success;
+}
+
+static bool benchRingPerCall(const char* path)
+{
+	g_fd fd = g_open(path);
+	if(fd == G_FD_NONE)
+		return false;
+
+	uint8_t buffer[BENCH_RING_CHUNK];
+	uint32_t calls = 0;
+	uint64_t total = 0;
+
+	uint64_t start = g_nanos();
+	int32_t read;
+	while((read = g_read(fd, buffer, BENCH_RING_CHUNK)) > 0)
+	{
+		total += read;
+		calls++;
+	}
+	uint64_t nanos = g_nanos() - start;
+	g_close(fd);
+
+	if(total != BENCH_RING_FILE_SIZE)
+	{
+		fprintf(stderr, "per-call reads got %llu of %u bytes\n", total, BENCH_RING_FILE_SIZE);
+		return false;
+	}
+	benchReport("read, one call each", calls, nanos);
+	return true;
+}
+
+static bool benchRingBatched(const char* path)
+{
+	g_fd fd = g_open(path);
+	if(fd == G_FD_NONE)
+		return false;
+
+	g_ring ring;
+	if(g_ring_create(&ring, BENCH_RING_BATCH) != G_RING_STATUS_SUCCESSFUL)
+	{
+		g_close(fd);
+		return false;
+	}
+
+	// Reads of one batch go into separate buffers like independent requests would
+	auto buffers = new uint8_t[BENCH_RING_BATCH * BENCH_RING_CHUNK];
+	g_syscall_fs_read calls[BENCH_RING_BATCH];
+	uint32_t reads = 0;
+	uint64_t total = 0;
+	bool done = false;
+	bool success = true;
+
+	uint64_t start = g_nanos();
+	while(!done && success)
+	{
+		for(uint32_t i = 0; i < BENCH_RING_BATCH; i++)
+		{
+			calls[i].fd = fd;
+			calls[i].buffer = &buffers[i * BENCH_RING_CHUNK];
+			calls[i].length = BENCH_RING_CHUNK;
+			g_ring_submit(&ring, G_SYSCALL_FS_READ, &calls[i], i);
+		}
+
+		if(g_ring_enter(&ring, nullptr) != G_RING_STATUS_SUCCESSFUL)
+		{
+			success = false;
+			break;
+		}
+
+		g_ring_completion completion;
+		while(g_ring_reap(&ring, &completion) == G_RING_STATUS_SUCCESSFUL)
+		{
+			g_syscall_fs_read* call = &calls[completion.userData];
+			if(completion.status != G_RING_COMPLETION_SUCCESSFUL || call->status != G_FS_READ_SUCCESSFUL)
+			{
+				success = false;
+				break;
+			}
+			if(call->result == 0)
+				done = true;
+			total += call->result;
+			reads++;
+		}
+	}
+	uint64_t nanos = g_nanos() - start;
+
+	delete[] buffers;
+	g_ring_destroy(&ring);
+	g_close(fd);
+
+	if(!success || total != BENCH_RING_FILE_SIZE)
+	{
+		fprintf(stderr, "batched reads got %llu of %u bytes\n", total, BENCH_RING_FILE_SIZE);
+		return false;
+	}
+	benchReport("read, batched on a ring", reads, nanos);
+	return true;
+}
+
+int benchRing(int argc, char** argv)
+{
+	const char* path = BENCH_RING_FILE;
+	if(argc > 2)
+	{
+		path = argv[2];
+	}
+	else if(!benchRingCreateFile(path))
+	{
+		fprintf(stderr, "failed to create %s\n", path);
+		return 1;
+	}
+
+	if(!benchRingPerCall(path) || !benchRingBatched(path))
+		return 1;
+	return 0;
+}
@@ -0,0 +1,99 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "timer.hpp"
+#include "../bench.hpp"
+
+#include <ghost/poll.h>
+#include <stdlib.h>
+
+#define BENCH_TIMER_DEFAULT_MICROS		100
+#define BENCH_TIMER_ITERATIONS			1000
+
+static int benchTimerCompare(const void* a, const void* b)
+{
+	uint64_t left = *(const uint64_t*) a;
+	uint64_t right = *(const uint64_t*) b;
+	return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+static void benchTimerReport(const char* name, uint64_t* lateness, uint32_t count)
+{
+	qsort(lateness, count, sizeof(uint64_t), benchTimerCompare);
+
+	uint64_t total = 0;
+	for(uint32_t i = 0; i < count; i++)
+		total += lateness[i];
+
+	uint64_t min = lateness[0];
+	uint64_t avg = total / count;
+	uint64_t p99 = lateness[(count * 99) / 100];
+	uint64_t max = lateness[count - 1];
+	printf("%-32s late min %8llu avg %8llu p99 %8llu max %8llu ns\n", name, min, avg, p99, max);
+	klog("bench: %s late avg %i p99 %i max %i ns", name, (uint32_t) avg, (uint32_t) p99, (uint32_t) max);
+}
+
+static void benchTimerSleep(uint64_t nanos, uint64_t* lateness, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint64_t start = g_nanos();
+		g_sleep_nanos(nanos);
+		uint64_t elapsed = g_nanos() - start;
+		lateness[i] = elapsed > nanos ? elapsed - nanos : 0;
+	}
+}
+
+static void benchTimerPoll(uint64_t nanos, uint64_t* lateness, uint32_t count)
+{
+	// Nothing in the set ever becomes ready, so every call ends by its timeout
+	g_poll_set set = {};
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint64_t start = g_nanos();
+		g_poll_tn(&set, nanos, nullptr);
+		uint64_t elapsed = g_nanos() - start;
+		lateness[i] = elapsed > nanos ? elapsed - nanos : 0;
+	}
+}
+
+int benchTimerJitter(int argc, char** argv)
+{
+	uint64_t micros = BENCH_TIMER_DEFAULT_MICROS;
+	if(argc > 2)
+		micros = atoi(argv[2]);
+	if(micros == 0)
+		micros = 1;
+	uint64_t nanos = micros * 1000;
+
+	uint64_t* lateness = new uint64_t[BENCH_TIMER_ITERATIONS];
+	char name[64];
+
+	benchTimerSleep(nanos, lateness, BENCH_TIMER_ITERATIONS);
+	snprintf(name, sizeof(name), "sleep %llu us", micros);
+	benchTimerReport(name, lateness, BENCH_TIMER_ITERATIONS);
+
+	benchTimerPoll(nanos, lateness, BENCH_TIMER_ITERATIONS);
+	snprintf(name, sizeof(name), "poll timeout %llu us", micros);
+	benchTimerReport(name, lateness, BENCH_TIMER_ITERATIONS);
+
+	delete[] lateness;
+	return 0;
+}
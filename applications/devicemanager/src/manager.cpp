@@ -36,6 +36,8 @@ static g_device_id nextDeviceId = 1;
 
 int main()
 {
+	g_create_topic(G_DEVICE_EVENT_TOPIC, G_DEVICE_EVENT_TOPIC_CAPACITY);
+
 	g_tid comHandler = g_create_task((void*) _deviceManagerAwaitCommands);
 	_deviceManagerCheckPciDevices();
 
@@ -52,9 +54,17 @@ void _deviceManagerCheckPciDevices()
 	}
 
 	bool foundVmsvga = false;
+	bool foundAhci = false;
 
 	for(int i = 0; i < num; i++)
 	{
+		if(devices[i].classCode == PCI_BASE_CLASS_MASS_STORAGE &&
+		   devices[i].subclassCode == PCI_01_SUBCLASS_SATA &&
+		   devices[i].progIf == PCI_01_06_PROGIF_AHCI)
+		{
+			foundAhci = true;
+		}
+
 		if(devices[i].classCode == PCI_BASE_CLASS_DISPLAY &&
 		   devices[i].subclassCode == PCI_03_SUBCLASS_VGA &&
 		   devices[i].progIf == PCI_03_00_PROGIF_VGA_COMPATIBLE)
@@ -81,6 +91,12 @@ void _deviceManagerCheckPciDevices()
 	}
 	pciDriverFreeDeviceList(devices);
 
+	if(foundAhci)
+	{
+		klog("starting AHCI driver");
+		g_spawn("/applications/ahcidriver.bin", "", "", G_SECURITY_LEVEL_DRIVER);
+	}
+
 	// TODO Implement something more sophisticated
 	if(foundVmsvga)
 	{
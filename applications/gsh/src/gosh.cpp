@@ -30,6 +30,12 @@
 
 char* cwdbuf = 0;
 
+/**
+ * Pipes between the programs of a pipeline are larger than the default so that
+ * streaming producers don't have to switch to the consumer on every small fill.
+ */
+#define GSH_PIPELINE_CAPACITY 0x10000
+
 std::vector<std::string> gshAutocomplete(std::string toComplete)
 {
 	std::string cwd(cwdbuf);
@@ -376,7 +382,7 @@ void gshProcessExpression(pipe_expression_t* pipeexpr)
 		g_fd pipeRead = G_FD_NONE;
 		if(calls > 1 && callIndex < calls - 1)
 		{
-			g_fs_pipe_status pipe_stat = g_pipe(&pipeWrite, &pipeRead);
+			g_fs_pipe_status pipe_stat = g_pipe_bc(&pipeWrite, &pipeRead, true, GSH_PIPELINE_CAPACITY);
 
 			if(pipe_stat != G_FS_PIPE_SUCCESSFUL)
 			{
@@ -90,6 +90,28 @@ typedef struct {
 #define G_AHCI_HBA_PORT_SSTS_DET_READY		3 // Device presence detected and Phy communication established
 #define G_AHCI_HBA_PORT_SSTS_DET_OFFLINE	4 // Phy in offline mode as a result of the interface being disabled or running in a BIST loopback mode
 
+/**
+ * HBAxPORT.IS and HBAxPORT.IE
+ */
+#define G_AHCI_HBA_PORT_IS_DHRS		(1 << 0) // Device to Host Register FIS Interrupt
+#define G_AHCI_HBA_PORT_IS_PSS		(1 << 1) // PIO Setup FIS Interrupt
+#define G_AHCI_HBA_PORT_IS_DSS		(1 << 2) // DMA Setup FIS Interrupt
+#define G_AHCI_HBA_PORT_IS_SDBS		(1 << 3) // Set Device Bits Interrupt
+#define G_AHCI_HBA_PORT_IS_IFS		(1 << 27) // Interface Fatal Error
+#define G_AHCI_HBA_PORT_IS_HBDS		(1 << 28) // Host Bus Data Error
+#define G_AHCI_HBA_PORT_IS_HBFS		(1 << 29) // Host Bus Fatal Error
+#define G_AHCI_HBA_PORT_IS_TFES		(1 << 30) // Task File Error
+
+#define G_AHCI_HBA_PORT_IS_ERRORS	(G_AHCI_HBA_PORT_IS_IFS | G_AHCI_HBA_PORT_IS_HBDS | G_AHCI_HBA_PORT_IS_HBFS | G_AHCI_HBA_PORT_IS_TFES)
+#define G_AHCI_HBA_PORT_IS_COMPLETIONS	(G_AHCI_HBA_PORT_IS_DHRS | G_AHCI_HBA_PORT_IS_PSS | G_AHCI_HBA_PORT_IS_DSS | G_AHCI_HBA_PORT_IS_SDBS)
+
+/**
+ * HBAxPORT.TFD
+ */
+#define G_AHCI_HBA_PORT_TFD_ERR		(1 << 0) // Error
+#define G_AHCI_HBA_PORT_TFD_DRQ		(1 << 3) // Data Transfer Requested
+#define G_AHCI_HBA_PORT_TFD_BSY		(1 << 7) // Busy
+
 
 typedef struct {
 	uint32_t cap; // Host Capabilities
@@ -110,6 +132,21 @@ typedef struct {
 	uint32_t bohc; // BIOS/OS Handoff Control and Status
 } __attribute__((packed)) g_ahci_hba_ghc;
 
+/**
+ * HBA.CAP
+ */
+#define G_AHCI_HBA_CAP_NCS(cap)		((((cap) >> 8) & 0x1F) + 1) // Number of Command Slots
+#define G_AHCI_HBA_CAP_SNCQ			(1 << 30) // Supports Native Command Queuing
+#define G_AHCI_HBA_CAP_S64A			(1 << 31) // Supports 64-bit Addressing
+
+/**
+ * The command list holds 32 command headers and must be aligned to 1 KiB, the
+ * received FIS structure must be aligned to 256 bytes.
+ */
+#define G_AHCI_COMMAND_LIST_SIZE	0x400
+#define G_AHCI_RECEIVED_FIS_SIZE	0x100
+#define G_AHCI_MAXIMUM_SLOTS		32
+
 #define G_AHCI_HBA_PORT_OFFSET 0x100
 
 /**
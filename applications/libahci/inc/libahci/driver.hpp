@@ -23,5 +23,13 @@
 
 #define G_AHCI_DRIVER_NAME		"ahcidriver"
 
+/**
+ * The driver mounts the disks it found at "/mount/ahci". Each disk is a file named
+ * after the port it is attached to, like "sata0", that reads and writes its sectors.
+ * Writes are cached by the driver and only stored durably after {g_fsync}.
+ */
+#define G_AHCI_DRIVER_MOUNT			"ahci"
+#define G_AHCI_DRIVER_DISK_PREFIX	"sata"
+
 
 #endif
@@ -44,6 +44,28 @@
 #define G_FIS_TYPE_PIO_SETUP      0x5F    // PIO Setup FIS - Device to Host
 #define G_FIS_TYPE_SET_DEVICE     0xA1    // Set Device Bits FIS - Device to Host
 
+/**
+ * ATA commands (ATA/ATAPI Command Set 4)
+ */
+#define G_ATA_COMMAND_READ_DMA_EXT			0x25
+#define G_ATA_COMMAND_WRITE_DMA_EXT			0x35
+#define G_ATA_COMMAND_READ_FPDMA_QUEUED		0x60
+#define G_ATA_COMMAND_WRITE_FPDMA_QUEUED	0x61
+#define G_ATA_COMMAND_FLUSH_CACHE_EXT		0xEA
+#define G_ATA_COMMAND_IDENTIFY_DEVICE		0xEC
+
+#define G_ATA_DEVICE_LBA					(1 << 6)
+#define G_ATA_SECTOR_SIZE					512
+
+/**
+ * Words of the data returned by IDENTIFY DEVICE
+ */
+#define G_ATA_IDENTIFY_QUEUE_DEPTH			75 // bits 0-4: maximum queue depth - 1
+#define G_ATA_IDENTIFY_SATA_CAPABILITIES	76 // bit 8: supports Native Command Queuing
+#define G_ATA_IDENTIFY_COMMAND_SET_2		83 // bit 10: supports 48-bit addressing
+#define G_ATA_IDENTIFY_LBA28_SECTORS		60 // words 60-61
+#define G_ATA_IDENTIFY_LBA48_SECTORS		100 // words 100-103
+
 /**
  * Register Device to Host FIS
  */
@@ -77,6 +77,11 @@ struct g_device_manager_register_device_response
 */
 #define G_DEVICE_EVENT_TOPIC		"device"
 
+/**
+ * Subscribers read the device topic from its start, so it retains enough events for all devices
+ */
+#define G_DEVICE_EVENT_TOPIC_CAPACITY	1024
+
 typedef uint16_t g_device_event;
 #define G_DEVICE_EVENT_DEVICE_REGISTERED	((g_device_event) 0)
 
@@ -27,7 +27,6 @@
 uint8_t mousePacketNumber = 0;
 uint8_t mousePacketBuffer[4];
 bool intelliMouseMode = false; // 4-byte sequences
-g_user_mutex packetLock = g_mutex_initialize();
 
 g_fd keyIrqIn;
 g_fd mouseIrqIn;
@@ -55,34 +54,32 @@ ps2_status_t ps2Initialize(void (*mouseCallback)(int16_t, int16_t, uint8_t, int8
 	g_irq_create_redirect(1, 1);
 	g_irq_create_redirect(12, 12);
 
-	g_create_task_a((void*) &ps2AwaitKeyIrq, 0);
-	g_create_task_a((void*) &ps2AwaitMouseIrq, 0);
+	g_create_task_a((void*) &ps2AwaitIrqs, 0);
 	return G_PS2_STATUS_SUCCESS;
 }
 
-void ps2AwaitKeyIrq()
+void ps2AwaitIrqs()
 {
-	g_task_register_name("libps2/await-key");
-	for(;;)
-	{
-		g_await_irq_t(1, 50);
-		ps2CheckForData();
-	}
-}
+	g_task_register_name("libps2/await-irqs");
+
+	g_poll_irq irqs[2];
+	irqs[0].irq = 1;
+	irqs[1].irq = 12;
+
+	g_poll_set set = {};
+	set.irqs = irqs;
+	set.irq_count = 2;
 
-void ps2AwaitMouseIrq()
-{
-	g_task_register_name("libps2/await-mouse");
 	for(;;)
 	{
-		g_await_irq_t(12, 50);
+		// Timeout is only a safety net in case the controller misses an edge
+		g_poll_t(&set, 500);
 		ps2CheckForData();
 	}
 }
 
 void ps2CheckForData()
 {
-	g_mutex_acquire(packetLock);
 	uint8_t status;
 	while(((status = g_io_port_read_byte(G_PS2_STATUS_PORT)) & 0x01) != 0)
 	{
@@ -102,7 +99,6 @@ void ps2CheckForData()
 
 		++packetCount;
 	}
-	g_mutex_release(packetLock);
 }
 
 ps2_status_t ps2InitializeMouse()
@@ -61,13 +61,8 @@ void ps2HandleMouseData(uint8_t value);
 int ps2WriteToMouse(uint8_t value);
 
 /**
- * Awaits IRQs from the key IRQ device.
+ * Awaits IRQs from both the key and the mouse IRQ device in a single task.
  */
-void ps2AwaitKeyIrq();
-
-/**
- * Awaits IRQs from the mouse IRQ device.
- */
-void ps2AwaitMouseIrq();
+void ps2AwaitIrqs();
 
 #endif
@@ -124,25 +124,30 @@ bool g_ui::addListener(g_ui_component_id id, g_ui_component_event_type eventType
  */
 void g_ui::eventDispatchThread()
 {
-	size_t bufLen = G_UI_MAXIMUM_MESSAGE_SIZE;
+	size_t bufLen = 8 * (sizeof(g_message_header) + G_UI_MAXIMUM_MESSAGE_SIZE);
 	auto buf = new uint8_t[bufLen];
 
 	while(true)
 	{
-		auto stat = g_receive_message(buf, bufLen);
+		uint32_t count;
+		auto stat = g_receive_messages(buf, bufLen, 0, &count);
 		if(stat == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
 		{
-			// event message
-			auto event_header = (g_ui_component_event_header*) G_MESSAGE_CONTENT(buf);
-			g_component* component = g_component_registry::get(event_header->component_id);
-
-			if(component == nullptr)
+			auto message = (g_message_header*) buf;
+			for(uint32_t i = 0; i < count; i++, message = G_MESSAGE_BATCH_NEXT(message))
 			{
-				klog("event received for unknown component %i", event_header->component_id);
-				continue;
-			}
+				// event message
+				auto event_header = (g_ui_component_event_header*) G_MESSAGE_CONTENT(message);
+				g_component* component = g_component_registry::get(event_header->component_id);
 
-			component->handle(event_header);
+				if(component == nullptr)
+				{
+					klog("event received for unknown component %i", event_header->component_id);
+					continue;
+				}
+
+				component->handle(event_header);
+			}
 		}
 		else
 		{
@@ -226,13 +226,7 @@ void navigatorLoad(bool keepHistory)
 	g_fs_directory_entry* entry;
 	while((entry = g_read_directory(dir)) != nullptr)
 	{
-		std::string path = currentBase + "/" + entry->name;
-		g_fs_stat_data statData;
-		if(g_fs_stat(path.c_str(), &statData) != G_FS_STAT_SUCCESS)
-		{
-			klog("failed to stat file %s", path.c_str());
-		}
-		children.push_back({entry->name, statData.type});
+		children.push_back({entry->name, entry->type});
 	}
 	std::sort(children.begin(), children.end(), [](const file_entry_t& a, const file_entry_t& b)
 	{
@@ -0,0 +1,44 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "cache.hpp"
+
+#include <ghost.h>
+
+int procCache(int argc, char** argv)
+{
+	g_kernquery_page_cache_data data;
+	g_kernquery_status status = g_kernquery(G_KERNQUERY_PAGE_CACHE_GET, (uint8_t*) &data);
+	if(status != G_KERNQUERY_STATUS_SUCCESSFUL)
+	{
+		fprintf(stderr, "failed to query the kernel for the page cache (code %i)\n", status);
+		return -1;
+	}
+
+	uint64_t lookups = data.hits + data.misses;
+	uint32_t hitRate = lookups ? (uint32_t) ((data.hits * 100) / lookups) : 0;
+
+	println("page cache:  %i of %i pages (%i KiB)", data.pages, data.capacity, data.pages * 4);
+	println("hits:        %llu (%i%%)", data.hits, hitRate);
+	println("misses:      %llu", data.misses);
+	println("evictions:   %llu", data.evictions);
+	println("mapped:      %llu", data.mapped);
+	return 0;
+}
@@ -26,6 +26,7 @@
 #define MINOR 2
 #define PATCH 1
 
+#include "cache/cache.hpp"
 #include "list/list.hpp"
 
 /**
@@ -50,6 +51,10 @@ int main(int argc, char** argv)
 				g_sleep(1000);
 			}
 		}
+		else if(strcmp(command, "-c") == 0 || strcmp(command, "--cache") == 0)
+		{
+			return procCache(argc, argv);
+		}
 		else if(strcmp(command, "-k") == 0 || strcmp(command, "--kill") == 0)
 		{
 			if(argc > 2)
@@ -92,6 +97,7 @@ int main(int argc, char** argv)
 			println("");
 			println("\t-l\t\tlists running tasks");
 			println("\t-k <id>\tkills a process");
+			println("\t-c\t\tshows the page cache counters");
 			println("");
 		}
 		else
@@ -211,8 +211,9 @@ bool vbeApplyVideoMode(uint32_t mode, g_vbe_mode_info_block* modeInfoBlock, g_vb
 
 	if(vm86SwitchVideoMode(mode) && vm86LoadModeInfo(mode, modeInfoBlock))
 	{
-		void* area = g_map_mmio((void*) modeInfoBlock->lfbPhysicalBase,
-		                        modeInfoBlock->linBytesPerScanline * modeInfoBlock->resolutionY);
+		void* area = g_map_mmio_f((void*) modeInfoBlock->lfbPhysicalBase,
+		                          modeInfoBlock->linBytesPerScanline * modeInfoBlock->resolutionY,
+		                          G_MMIO_FLAGS_WRITE_COMBINING);
 		result.resolutionX = modeInfoBlock->resolutionX;
 		result.resolutionY = modeInfoBlock->resolutionY;
 		result.bpp = modeInfoBlock->bpp;
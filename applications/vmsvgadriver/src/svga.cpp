@@ -147,7 +147,8 @@ void svgaSetMode(uint32_t width, uint32_t height, uint32_t bpp)
 	svgaWriteReg(SVGA_REG_CONFIG_DONE, true);
 
 	device.fb.size = svgaReadReg(SVGA_REG_FB_SIZE);
-	device.fb.mapped = (uint32_t*) g_map_mmio((void*) device.fb.physical, device.fb.size);
+	device.fb.mapped = (uint32_t*) g_map_mmio_f((void*) device.fb.physical, device.fb.size,
+	                                           G_MMIO_FLAGS_WRITE_COMBINING);
 }
 
 uint32_t* svgaGetFb()
@@ -36,24 +36,29 @@
 #include "layout/grid_layout_manager.hpp"
 #include "layout/flex_layout_manager.hpp"
 
+/**
+ * Requests are received in batches, the buffer fits at least one message of maximum size.
+ */
+#define G_INTERFACE_RECEIVER_BATCH_SIZE (8 * (sizeof(g_message_header) + G_UI_MAXIMUM_MESSAGE_SIZE))
+
 void interfaceReceiverThread()
 {
+	size_t buflen = G_INTERFACE_RECEIVER_BATCH_SIZE;
+	auto buf = new uint8_t[buflen];
+
 	while(true)
 	{
-		size_t buflen = sizeof(g_message_header) + G_UI_MAXIMUM_MESSAGE_SIZE;
-		auto buf = new uint8_t[buflen];
-		bool deferred = false;
-
-		g_message_receive_status stat = g_receive_message_tmb(
-				buf, buflen,
-				G_MESSAGE_TRANSACTION_NONE, G_MESSAGE_RECEIVE_MODE_BLOCKING,
-				0); // TODO break condition not working
+		uint32_t count;
+		g_message_receive_status stat = g_receive_messages(buf, buflen, 0, &count);
 
 		if(stat == G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL)
 		{
 			auto message = (g_message_header*) buf;
-
-			interfaceReceiverProcessCommand(message);
+			for(uint32_t i = 0; i < count; i++)
+			{
+				interfaceReceiverProcessCommand(message);
+				message = G_MESSAGE_BATCH_NEXT(message);
+			}
 		}
 		else if(stat == G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE)
 		{
@@ -63,9 +68,6 @@ void interfaceReceiverThread()
 		{
 			klog("an unknown error occurred when trying to receive a UI request (code: %i)", stat);
 		}
-
-		if(!deferred)
-			delete buf;
 	}
 }
 
@@ -21,6 +21,7 @@
 #include "test.hpp"
 
 #include <layout/flex_layout_manager.hpp>
+#include <string.h>
 
 #include "components/button.hpp"
 #include "components/checkbox.hpp"
@@ -224,3 +225,39 @@ void test_t::createTestComponents()
 	// createTestWindow2();
 	// createTestWindow3();
 }
+
+void test_t::benchmarkVideoOutput(g_video_output* output)
+{
+	g_dimension resolution = output->getResolution();
+	g_rectangle screenBounds(0, 0, resolution.width, resolution.height);
+
+	uint32_t pixels = resolution.width * resolution.height;
+	auto buffer = new g_color_argb[pixels];
+	for(uint32_t i = 0; i < pixels; i++)
+		buffer[i] = ARGB(255, i & 0xFF, (i >> 8) & 0xFF, 0);
+
+	const int frames = 100;
+	uint64_t start = g_millis();
+	for(int i = 0; i < frames; i++)
+		output->blit(screenBounds, screenBounds, buffer);
+	uint64_t elapsed = g_millis() - start;
+	if(elapsed == 0)
+		elapsed = 1;
+
+	// Copying the same amount between ordinary memory is the reference for the blit
+	auto copy = new g_color_argb[pixels];
+	start = g_millis();
+	for(int i = 0; i < frames; i++)
+		memcpy(copy, buffer, pixels * sizeof(g_color_argb));
+	uint64_t copyElapsed = g_millis() - start;
+	if(copyElapsed == 0)
+		copyElapsed = 1;
+
+	uint64_t bytes = (uint64_t) pixels * sizeof(g_color_argb) * frames;
+	klog("blit benchmark: %i frames of %ix%i in %i ms, %i MiB/s (memory copy: %i MiB/s)", frames, resolution.width,
+	     resolution.height, (uint32_t) elapsed, (uint32_t) ((bytes * 1000 / elapsed) / (1024 * 1024)),
+	     (uint32_t) ((bytes * 1000 / copyElapsed) / (1024 * 1024)));
+
+	delete[] copy;
+	delete[] buffer;
+}
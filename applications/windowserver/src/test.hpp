@@ -27,6 +27,12 @@ class test_t
 {
   public:
     static void createTestComponents();
+
+    /**
+     * Measures the throughput of full-screen blits to the given output and
+     * writes it to the kernel log, next to a copy of the same size in memory.
+     */
+    static void benchmarkVideoOutput(g_video_output* output);
 };
 
 #endif
@@ -91,6 +91,8 @@ void windowserver_t::launch()
 	g_task_register_name("windowserver");
 
 	initializeVideo();
+	if(debugOn)
+		test_t::benchmarkVideoOutput(videoOutput);
 
 	g_create_task((void*) &startInputHandlers);
 
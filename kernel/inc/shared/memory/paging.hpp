@@ -30,7 +30,7 @@
 #define G_PAGE_TABLE_WRITETHROUGH   (1 << 3)
 #define G_PAGE_TABLE_CACHE_DISABLED (1 << 4)
 #define G_PAGE_TABLE_ACCESSED       (1 << 5)
-#define G_PAGE_TABLE_SIZE           (1 << 6)
+#define G_PAGE_TABLE_SIZE           (1 << 7)
 
 #define G_PAGE_PRESENT              (1)
 #define G_PAGE_READWRITE            (1 << 1)
@@ -41,6 +41,19 @@
 #define G_PAGE_DIRTY                (1 << 6)
 #define G_PAGE_GLOBAL               (1 << 7)
 
+/**
+ * The PAT is programmed so that the write-through bit selects write-combining
+ * (see processorEnablePat). The same bit is used on 4 MiB directory entries.
+ */
+#define G_PAGE_WRITE_COMBINING      G_PAGE_WRITETHROUGH
+#define G_PAGE_CACHE_MASK           (G_PAGE_WRITETHROUGH | G_PAGE_CACHE_DISABLED)
+
+/**
+ * Size of a page mapped directly by a directory entry with G_PAGE_TABLE_SIZE set
+ */
+#define G_LARGE_PAGE_SIZE           0x400000
+#define G_LARGE_PAGE_ALIGN_MASK     (G_LARGE_PAGE_SIZE - 1)
+
 /**
  * Default flag definitions
  */
@@ -71,6 +71,25 @@ void syscall(uint32_t callId, void* syscallData)
 	task->state = state;
 }
 
+bool syscallNested(g_task* task, uint32_t callId, void* data)
+{
+	if(callId > G_SYSCALL_MAX)
+		return false;
+
+	g_syscall_registration* reg = &syscallRegistrations[callId];
+	if(reg->handler == 0)
+		return false;
+
+	if(!reg->interruptible)
+		interruptsDisable();
+
+	reg->handler(task, data);
+	asm volatile("" ::: "memory");
+
+	interruptsEnable();
+	return true;
+}
+
 void _syscallRegister(int callId, g_syscall_handler handler, bool interruptible = false)
 {
 	if(callId > G_SYSCALL_MAX)
@@ -93,6 +112,7 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_FORK, (g_syscall_handler) syscallFork);
 	_syscallRegister(G_SYSCALL_JOIN, (g_syscall_handler) syscallJoin);
 	_syscallRegister(G_SYSCALL_SLEEP, (g_syscall_handler) syscallSleep);
+	_syscallRegister(G_SYSCALL_SLEEP_NANOS, (g_syscall_handler) syscallSleepNanos);
 	_syscallRegister(G_SYSCALL_RELEASE_CLI_ARGUMENTS, (g_syscall_handler) syscallReleaseCliArguments);
 	_syscallRegister(G_SYSCALL_GET_WORKING_DIRECTORY, (g_syscall_handler) syscallGetWorkingDirectory);
 	_syscallRegister(G_SYSCALL_SET_WORKING_DIRECTORY, (g_syscall_handler) syscallSetWorkingDirectory);
@@ -120,12 +140,21 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_SHARE_MEMORY, (g_syscall_handler) syscallShareMemory, true);
 	_syscallRegister(G_SYSCALL_MAP_MMIO_AREA, (g_syscall_handler) syscallMapMmioArea, true);
 	_syscallRegister(G_SYSCALL_SBRK, (g_syscall_handler) syscallSbrk, true);
+	_syscallRegister(G_SYSCALL_SHM_CREATE, (g_syscall_handler) syscallShmCreate, true);
+	_syscallRegister(G_SYSCALL_SHM_GRANT, (g_syscall_handler) syscallShmGrant, true);
+	_syscallRegister(G_SYSCALL_SHM_MAP, (g_syscall_handler) syscallShmMap, true);
+	_syscallRegister(G_SYSCALL_SHM_RESIZE, (g_syscall_handler) syscallShmResize, true);
+	_syscallRegister(G_SYSCALL_SHM_SEAL, (g_syscall_handler) syscallShmSeal, true);
+	_syscallRegister(G_SYSCALL_SHM_RELEASE, (g_syscall_handler) syscallShmRelease, true);
+	_syscallRegister(G_SYSCALL_ALLOCATE_DMA_MEMORY, (g_syscall_handler) syscallAllocateDmaMemory, true);
 
 	// Mutex
 	_syscallRegister(G_SYSCALL_USER_MUTEX_INITIALIZE, (g_syscall_handler) syscallMutexInitialize);
 	_syscallRegister(G_SYSCALL_USER_MUTEX_ACQUIRE, (g_syscall_handler) sycallMutexAcquire);
 	_syscallRegister(G_SYSCALL_USER_MUTEX_RELEASE, (g_syscall_handler) syscallMutexRelease);
 	_syscallRegister(G_SYSCALL_USER_MUTEX_DESTROY, (g_syscall_handler) syscallMutexDestroy);
+	_syscallRegister(G_SYSCALL_FUTEX_WAIT, (g_syscall_handler) syscallFutexWait);
+	_syscallRegister(G_SYSCALL_FUTEX_WAKE, (g_syscall_handler) syscallFutexWake);
 
 	// Messages
 	_syscallRegister(G_SYSCALL_MESSAGE_SEND, (g_syscall_handler) syscallMessageSend);
@@ -133,6 +162,9 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_MESSAGE_NEXT_TXID, (g_syscall_handler) syscallMessageNextTxId);
 	_syscallRegister(G_SYSCALL_MESSAGE_TOPIC_SEND, (g_syscall_handler) syscallMessageTopicSend);
 	_syscallRegister(G_SYSCALL_MESSAGE_TOPIC_RECEIVE, (g_syscall_handler) syscallMessageTopicReceive);
+	_syscallRegister(G_SYSCALL_MESSAGE_RECEIVE_BATCH, (g_syscall_handler) syscallMessageReceiveBatch);
+	_syscallRegister(G_SYSCALL_MESSAGE_TOPIC_CREATE, (g_syscall_handler) syscallMessageTopicCreate);
+	_syscallRegister(G_SYSCALL_MESSAGE_SEND_GRANTS, (g_syscall_handler) syscallMessageSendGrants, true);
 
 	// Filesystem
 	_syscallRegister(G_SYSCALL_FS_OPEN, (g_syscall_handler) syscallFsOpen, true);
@@ -142,14 +174,24 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_FS_CLOSE, (g_syscall_handler) syscallFsClose, true);
 	_syscallRegister(G_SYSCALL_FS_CLONEFD, (g_syscall_handler) syscallFsCloneFd, true);
 	_syscallRegister(G_SYSCALL_FS_LENGTH, (g_syscall_handler) syscallFsLength, true);
+	_syscallRegister(G_SYSCALL_FS_SYNC, (g_syscall_handler) syscallFsSync, true);
+	_syscallRegister(G_SYSCALL_FS_TRUNCATE, (g_syscall_handler) syscallFsTruncate, true);
 	_syscallRegister(G_SYSCALL_FS_TELL, (g_syscall_handler) syscallFsTell, true);
 	_syscallRegister(G_SYSCALL_FS_STAT, (g_syscall_handler) syscallFsStat, true);
 	_syscallRegister(G_SYSCALL_FS_FSTAT, (g_syscall_handler) syscallFsFstat, true);
 	_syscallRegister(G_SYSCALL_FS_PIPE, (g_syscall_handler) syscallFsPipe, true);
+	_syscallRegister(G_SYSCALL_FS_PIPE_CAPACITY, (g_syscall_handler) syscallFsPipeCapacity, true);
+	_syscallRegister(G_SYSCALL_FS_READV, (g_syscall_handler) syscallFsReadVector, true);
+	_syscallRegister(G_SYSCALL_FS_WRITEV, (g_syscall_handler) syscallFsWriteVector, true);
+	_syscallRegister(G_SYSCALL_FS_SPLICE, (g_syscall_handler) syscallFsSplice, true);
 	_syscallRegister(G_SYSCALL_FS_OPEN_DIRECTORY, (g_syscall_handler) syscallFsOpenDirectory, true);
 	_syscallRegister(G_SYSCALL_FS_READ_DIRECTORY, (g_syscall_handler) syscallFsReadDirectory, true);
+	_syscallRegister(G_SYSCALL_FS_READ_DIRECTORY_ENTRIES, (g_syscall_handler) syscallFsReadDirectoryEntries, true);
 	_syscallRegister(G_SYSCALL_FS_CLOSE_DIRECTORY, (g_syscall_handler) syscallFsCloseDirectory, true);
 	_syscallRegister(G_SYSCALL_FS_REAL_PATH, (g_syscall_handler) syscallFsRealPath, true);
+	_syscallRegister(G_SYSCALL_FS_REGISTER_AS_DELEGATE, (g_syscall_handler) syscallFsRegisterAsDelegate, true);
+	_syscallRegister(G_SYSCALL_FS_SET_TRANSACTION_STATUS, (g_syscall_handler) syscallFsSetTransactionStatus, true);
+	_syscallRegister(G_SYSCALL_FS_CREATE_NODE, (g_syscall_handler) syscallFsCreateNode, true);
 
 	// System
 	_syscallRegister(G_SYSCALL_LOG, (g_syscall_handler) syscallLog);
@@ -158,6 +200,8 @@ void syscallRegisterAll()
 	_syscallRegister(G_SYSCALL_CALL_VM86, (g_syscall_handler) syscallCallVm86);
 	_syscallRegister(G_SYSCALL_IRQ_CREATE_REDIRECT, (g_syscall_handler) syscallIrqCreateRedirect);
 	_syscallRegister(G_SYSCALL_AWAIT_IRQ, (g_syscall_handler) syscallAwaitIrq, true);
+	_syscallRegister(G_SYSCALL_POLL, (g_syscall_handler) syscallPoll, true);
+	_syscallRegister(G_SYSCALL_RING_ENTER, (g_syscall_handler) syscallRingEnter, true);
 
 	// Kernquery
 	_syscallRegister(G_SYSCALL_KERNQUERY, (g_syscall_handler) syscallKernQuery);
@@ -55,6 +55,15 @@ extern g_syscall_registration* syscallRegistrations;
 void syscallHandle(g_task* task);
 void syscall(uint32_t callId, void* data);
 
+/**
+ * Issues a system call from within a handler that is interruptible, for example when
+ * draining a submission ring. Interrupts are disabled for the call if its registration
+ * requires it and enabled again afterwards.
+ *
+ * @return false if there is no such call
+ */
+bool syscallNested(g_task* task, uint32_t callId, void* data);
+
 /**
  * Creates the system call table.
  */
@@ -21,6 +21,7 @@
 #include "kernel/calls/syscall_filesystem.hpp"
 #include "kernel/filesystem/filesystem.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/system/interrupts/requests.hpp"
 #include "shared/logger/logger.hpp"
 #include "shared/utils/string.hpp"
@@ -62,9 +63,30 @@ void syscallFsWrite(g_task* task, g_syscall_fs_write* data)
 	}
 }
 
+void syscallFsReadVector(g_task* task, g_syscall_fs_readv* data)
+{
+	int64_t read;
+	data->status = filesystemReadVector(task, data->fd, data->vectors, data->count, &read);
+	data->result = (data->status == G_FS_READ_SUCCESSFUL) ? read : G_FD_NONE;
+}
+
+void syscallFsWriteVector(g_task* task, g_syscall_fs_writev* data)
+{
+	int64_t wrote;
+	data->status = filesystemWriteVector(task, data->fd, data->vectors, data->count, &wrote);
+	data->result = (data->status == G_FS_WRITE_SUCCESSFUL) ? wrote : G_FD_NONE;
+}
+
+void syscallFsSplice(g_task* task, g_syscall_fs_splice* data)
+{
+	int64_t moved = 0;
+	data->status = filesystemSplice(task, data->in, data->out, data->length, &moved);
+	data->result = (data->status == G_FS_SPLICE_SUCCESSFUL || moved > 0) ? moved : G_FD_NONE;
+}
+
 void syscallFsClose(g_task* task, g_syscall_fs_close* data)
 {
-	data->status = filesystemClose(task->process->id, data->fd, true);
+	data->status = filesystemClose(task->process, data->fd, true);
 }
 
 void syscallFsLength(g_task* task, g_syscall_fs_length* data)
@@ -74,6 +96,19 @@ void syscallFsLength(g_task* task, g_syscall_fs_length* data)
 	data->length = length;
 }
 
+void syscallFsSync(g_task* task, g_syscall_fs_sync* data)
+{
+	if(data->all)
+		data->status = filesystemSyncAll();
+	else
+		data->status = filesystemSync(task, data->fd);
+}
+
+void syscallFsTruncate(g_task* task, g_syscall_fs_truncate* data)
+{
+	data->status = filesystemTruncate(task, data->fd, data->length);
+}
+
 void syscallFsCloneFd(g_task* task, g_syscall_fs_clonefd* data)
 {
 	data->status = filesystemProcessCloneDescriptor(data->source_pid, data->source_fd, data->target_pid,
@@ -83,7 +118,7 @@ void syscallFsCloneFd(g_task* task, g_syscall_fs_clonefd* data)
 void syscallFsTell(g_task* task, g_syscall_fs_tell* data)
 {
 
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, data->fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, data->fd);
 	if(!descriptor)
 	{
 		data->status = G_FS_TELL_INVALID_FD;
@@ -98,7 +133,7 @@ void syscallFsTell(g_task* task, g_syscall_fs_tell* data)
 void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data)
 {
 	g_fs_node* pipeNode;
-	data->status = filesystemCreatePipe(data->blocking, &pipeNode);
+	data->status = filesystemCreatePipe(data->blocking, data->capacity, &pipeNode);
 
 	if(data->status != G_FS_PIPE_SUCCESSFUL)
 	{
@@ -109,7 +144,7 @@ void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data)
 	}
 
 	g_file_flag_mode writeFlags = (G_FILE_FLAG_MODE_WRITE | (data->blocking ? G_FILE_FLAG_MODE_BLOCKING : 0));
-	g_fs_open_status writeOpen = filesystemOpenNodeFd(pipeNode, writeFlags, task->process->id, &data->write_fd);
+	g_fs_open_status writeOpen = filesystemOpenNodeFd(pipeNode, writeFlags, task->process, &data->write_fd);
 	if(writeOpen != G_FS_OPEN_SUCCESSFUL)
 	{
 		logInfo("%! failed to open write end of pipe %i for task %i with status %i", "filesystem", pipeNode->id,
@@ -119,10 +154,10 @@ void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data)
 	}
 
 	g_file_flag_mode readFlags = (G_FILE_FLAG_MODE_READ | (data->blocking ? G_FILE_FLAG_MODE_BLOCKING : 0));
-	g_fs_open_status readOpen = filesystemOpenNodeFd(pipeNode, readFlags, task->process->id, &data->read_fd);
+	g_fs_open_status readOpen = filesystemOpenNodeFd(pipeNode, readFlags, task->process, &data->read_fd);
 	if(readOpen != G_FS_OPEN_SUCCESSFUL)
 	{
-		if(filesystemClose(task->process->id, writeOpen, true) != G_FS_CLOSE_SUCCESSFUL)
+		if(filesystemClose(task->process, data->write_fd, true) != G_FS_CLOSE_SUCCESSFUL)
 		{
 			logInfo("%! failed to close write end of pipe %i for task %i after failing to open read end", "filesystem",
 			        pipeNode->id, task->id);
@@ -136,6 +171,11 @@ void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data)
 	data->status = G_FS_PIPE_SUCCESSFUL;
 }
 
+void syscallFsPipeCapacity(g_task* task, g_syscall_fs_pipe_capacity* data)
+{
+	data->status = filesystemSetPipeCapacity(task, data->fd, data->capacity);
+}
+
 void syscallFsOpenDirectory(g_task* task, g_syscall_fs_open_directory* data)
 {
 	auto findRes = filesystemFind(nullptr, data->path);
@@ -181,6 +221,19 @@ void syscallFsReadDirectory(g_task* task, g_syscall_fs_read_directory* data)
 	}
 }
 
+void syscallFsReadDirectoryEntries(g_task* task, g_syscall_fs_read_directory_entries* data)
+{
+	g_fs_node* directory = filesystemGetNode(data->node_id);
+	if(!directory || directory->type == G_FS_NODE_TYPE_FILE)
+	{
+		data->written = 0;
+		data->status = G_FS_READ_DIRECTORY_ERROR;
+		return;
+	}
+
+	data->status = filesystemReadDirectoryEntries(directory, &data->cursor, data->buffer, data->length, &data->written);
+}
+
 void syscallFsCloseDirectory(g_task* task, g_syscall_fs_close_directory* data)
 {
 	// TODO
@@ -200,3 +253,39 @@ void syscallFsFstat(g_task* task, g_syscall_fs_fstat* data)
 {
 	data->status = filesystemFstat(task, data->fd, data->out);
 }
+
+void syscallFsRegisterAsDelegate(g_task* task, g_syscall_fs_register_as_delegate* data)
+{
+	data->mountpoint_id = 0;
+	data->transaction_storage = 0;
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		data->result = G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+		return;
+	}
+
+	data->result = filesystemRegisterAsDelegate(task, data->name, data->phys_mountpoint_id, &data->mountpoint_id,
+	                                            &data->transaction_storage);
+}
+
+void syscallFsSetTransactionStatus(g_task* task, g_syscall_fs_set_transaction_status* data)
+{
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+		return;
+
+	if(!filesystemTaskedDelegateSetTransactionStatus(task, data->transaction, data->status))
+		logDebug("%! task %i set status of unknown transaction %i", "fs", task->id, (uint32_t) data->transaction);
+}
+
+void syscallFsCreateNode(g_task* task, g_syscall_fs_create_node* data)
+{
+	data->created_id = 0;
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+	{
+		data->result = G_FS_CREATE_NODE_STATUS_FAILED_NOT_PERMITTED;
+		return;
+	}
+
+	data->result = filesystemCreateDelegateNode(task, data->parent_id, data->name, data->type, data->phys_fs_id,
+	                                            &data->created_id);
+}
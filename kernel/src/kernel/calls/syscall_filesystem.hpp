@@ -36,6 +36,10 @@ void syscallFsClose(g_task* task, g_syscall_fs_close* data);
 
 void syscallFsLength(g_task* task, g_syscall_fs_length* data);
 
+void syscallFsSync(g_task* task, g_syscall_fs_sync* data);
+
+void syscallFsTruncate(g_task* task, g_syscall_fs_truncate* data);
+
 void syscallFsTell(g_task* task, g_syscall_fs_tell* data);
 
 void syscallFsStat(g_task* task, g_syscall_fs_stat* data);
@@ -46,12 +50,28 @@ void syscallFsCloneFd(g_task* task, g_syscall_fs_clonefd* data);
 
 void syscallFsPipe(g_task* task, g_syscall_fs_pipe* data);
 
+void syscallFsPipeCapacity(g_task* task, g_syscall_fs_pipe_capacity* data);
+
+void syscallFsReadVector(g_task* task, g_syscall_fs_readv* data);
+
+void syscallFsWriteVector(g_task* task, g_syscall_fs_writev* data);
+
+void syscallFsSplice(g_task* task, g_syscall_fs_splice* data);
+
 void syscallFsOpenDirectory(g_task* task, g_syscall_fs_open_directory* data);
 
 void syscallFsReadDirectory(g_task* task, g_syscall_fs_read_directory* data);
 
+void syscallFsReadDirectoryEntries(g_task* task, g_syscall_fs_read_directory_entries* data);
+
 void syscallFsCloseDirectory(g_task* task, g_syscall_fs_close_directory* data);
 
 void syscallFsRealPath(g_task* task, g_syscall_fs_real_path* data);
 
+void syscallFsRegisterAsDelegate(g_task* task, g_syscall_fs_register_as_delegate* data);
+
+void syscallFsSetTransactionStatus(g_task* task, g_syscall_fs_set_transaction_status* data);
+
+void syscallFsCreateNode(g_task* task, g_syscall_fs_create_node* data);
+
 #endif
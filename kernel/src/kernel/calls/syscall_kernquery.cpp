@@ -19,6 +19,8 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/calls/syscall_kernquery.hpp"
+#include "kernel/filesystem/filesystem_page_cache.hpp"
+#include "kernel/ipc/message_queues.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/tasking_directory.hpp"
 #include "kernel/utils/hashmap.hpp"
@@ -85,6 +87,40 @@ void syscallKernQuery(g_task* task, g_syscall_kernquery* data)
 
 		mutexRelease(&target->lock);
 	}
+	else if(data->command == G_KERNQUERY_MESSAGE_QUEUE_GET)
+	{
+		auto out = (g_kernquery_message_queue_data*) data->buffer;
+
+		g_message_queue_statistics statistics;
+		if(messageQueueGetStatistics(out->id, &statistics))
+		{
+			data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+			out->found = true;
+			out->depth = statistics.depth;
+			out->high_water_depth = statistics.highWaterDepth;
+			out->high_water_size = statistics.highWaterSize;
+			out->capacity = G_MESSAGE_MAXIMUM_QUEUE_CONTENT;
+		}
+		else
+		{
+			data->status = G_KERNQUERY_STATUS_UNKNOWN_ID;
+			out->found = false;
+		}
+	}
+	else if(data->command == G_KERNQUERY_PAGE_CACHE_GET)
+	{
+		auto out = (g_kernquery_page_cache_data*) data->buffer;
+
+		g_fs_page_cache_statistics statistics;
+		filesystemPageCacheGetStatistics(&statistics);
+		out->hits = statistics.hits;
+		out->misses = statistics.misses;
+		out->evictions = statistics.evictions;
+		out->mapped = statistics.mapped;
+		out->pages = statistics.pages;
+		out->capacity = statistics.capacity;
+		data->status = G_KERNQUERY_STATUS_SUCCESSFUL;
+	}
 	else
 	{
 		data->status = G_KERNQUERY_STATUS_ERROR;
@@ -19,14 +19,24 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/calls/syscall_memory.hpp"
+#include "kernel/ipc/shared_memory.hpp"
 #include "kernel/memory/lower_heap.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/page_reference_tracker.hpp"
+#include "kernel/system/processor/processor.hpp"
 #include "kernel/tasking/tasking_memory.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 
 #include "shared/logger/logger.hpp"
 
+/**
+ * Maps newly allocated physical pages to a free range of the process. If physicalPages
+ * is given, it is filled with the address of each page.
+ *
+ * @return the virtual address of the range or 0 if allocation failed
+ */
+g_virtual_address _syscallAllocatePages(g_task* task, uint32_t pages, g_physical_address* physicalPages);
+
 void syscallSbrk(g_task* task, g_syscall_sbrk* data)
 {
 	data->successful = taskingMemoryExtendHeap(task, data->amount, &data->address);
@@ -62,11 +72,32 @@ void syscallAllocateMemory(g_task* task, g_syscall_alloc_mem* data)
 		return;
 	}
 
+	data->virtualResult = (void*) _syscallAllocatePages(task, pages, nullptr);
+}
+
+void syscallAllocateDmaMemory(g_task* task, g_syscall_alloc_dma_mem* data)
+{
+	data->virtualResult = nullptr;
+	if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+		return;
+
+	uint32_t pages = G_PAGE_ALIGN_UP(data->size) / G_PAGE_SIZE;
+	if(pages == 0 || !data->physicalPages)
+	{
+		logInfo("%! task %i failed to allocate an empty DMA memory area", "syscall", task->id);
+		return;
+	}
+
+	data->virtualResult = (void*) _syscallAllocatePages(task, pages, data->physicalPages);
+}
+
+g_virtual_address _syscallAllocatePages(g_task* task, uint32_t pages, g_physical_address* physicalPages)
+{
 	g_virtual_address mapped = addressRangePoolAllocate(task->process->virtualRangePool, pages);
 	if(mapped == 0)
 	{
 		logInfo("%! task %i failed to allocate a virtual address range for memory mapping", "syscall", task->id);
-		return;
+		return 0;
 	}
 
 	bool failedPhysical = false;
@@ -79,6 +110,8 @@ void syscallAllocateMemory(g_task* task, g_syscall_alloc_mem* data)
 			break;
 		}
 		pagingMapPage(mapped + i * G_PAGE_SIZE, page, G_PAGE_TABLE_USER_DEFAULT, G_PAGE_USER_DEFAULT);
+		if(physicalPages)
+			physicalPages[i] = page;
 	}
 
 	if(failedPhysical)
@@ -90,48 +123,21 @@ void syscallAllocateMemory(g_task* task, g_syscall_alloc_mem* data)
 			memoryPhysicalFree(page);
 		}
 		addressRangePoolFree(task->process->virtualRangePool, mapped);
-		return;
+		return 0;
 	}
 
-	data->virtualResult = (void*) mapped;
+	return mapped;
 }
 
 void syscallUnmap(g_task* task, g_syscall_unmap* data)
 {
-	g_address_range* range = addressRangePoolFind(task->process->virtualRangePool, data->virtualBase);
-	if(!range)
-		return;
-
-	for(uint32_t i = 0; i < range->pages; i++)
-	{
-		g_virtual_address virt = range->base + i * G_PAGE_SIZE;
-		g_physical_address page = pagingVirtualToPhysical(virt);
-		if(!page)
-			continue;
-
-		if((range->flags & G_PROC_VIRTUAL_RANGE_FLAG_WEAK) == 0)
-			memoryPhysicalFree(page);
-
-		pagingUnmapPage(virt);
-	}
-
-	addressRangePoolFree(task->process->virtualRangePool, range->base);
+	taskingMemoryUnmapRange(task->process, data->virtualBase);
 }
 
 void syscallShareMemory(g_task* task, g_syscall_share_mem* data)
 {
 	data->virtualAddress = 0;
 
-	g_task* targetTask = taskingGetById(data->processId);
-	if(!targetTask)
-	{
-		logInfo("%! task %i was unable to share memory with non-existing process %i", "syscall", task->id,
-		        data->processId);
-		return;
-	}
-	g_process* targetProcess = targetTask->process;
-	mutexAcquire(&targetProcess->lock);
-
 	g_virtual_address memory = (g_virtual_address) data->memory;
 	uint32_t pages = G_PAGE_ALIGN_UP(data->size) / G_PAGE_SIZE;
 	if(memory > G_KERNEL_AREA_START || (memory + pages * G_PAGE_SIZE) > G_KERNEL_AREA_START)
@@ -141,65 +147,88 @@ void syscallShareMemory(g_task* task, g_syscall_share_mem* data)
 		return;
 	}
 
-	g_virtual_address virtualRangeBase = addressRangePoolAllocate(targetProcess->virtualRangePool, pages,
-	                                                              G_PROC_VIRTUAL_RANGE_FLAG_NONE);
-	mutexRelease(&targetProcess->lock);
-
-	if(virtualRangeBase == 0)
+	g_task* targetTask = taskingGetById(data->processId);
+	if(!targetTask)
 	{
-		logInfo(
-				"%! task %i was unable to share memory area %h of size %h with task %i because there was no free virtual range",
-				"syscall",
-				task->id, memory, pages * G_PAGE_SIZE, targetProcess->main->id);
+		logInfo("%! task %i was unable to share memory with non-existing process %i", "syscall", task->id,
+		        data->processId);
 		return;
 	}
 
-	for(uint32_t i = 0; i < pages; i++)
-	{
-		g_physical_address physicalAddr = pagingVirtualToPhysical(memory + i * G_PAGE_SIZE);
+	data->virtualAddress = (void*) taskingMemoryShare(targetTask->process, memory, pages);
+}
 
-		targetTask = taskingGetById(data->processId);
-		if(!targetTask)
-		{
-			logInfo("%! task %i was unable to share memory with no longer existing process %i", "syscall", task->id,
-			        data->processId);
-			return;
-		}
+void syscallMapMmioArea(g_task* task, g_syscall_map_mmio* data)
+{
+	uint32_t pages = G_PAGE_ALIGN_UP(data->size) / G_PAGE_SIZE;
+
+	g_virtual_address virtualRangeBase = taskingMemoryAllocateRangeFor(task->process, data->physicalAddress, pages,
+	                                                                    G_PROC_VIRTUAL_RANGE_FLAG_WEAK);
+	if(virtualRangeBase == 0)
+	{
+		logInfo("%! task %i failed to map mmio memory, could not allocate virtual range", "syscall", task->id);
+		return;
+	}
 
-		mutexAcquire(&targetProcess->lock);
-		targetProcess = targetTask->process;
+	uint32_t pageFlags = G_PAGE_USER_DEFAULT;
+	if((data->flags & G_MMIO_FLAGS_WRITE_COMBINING) && processorHasFeature(g_cpuid_standard_edx_feature::PAT))
+		pageFlags |= G_PAGE_WRITE_COMBINING;
 
-		g_physical_address back = taskingMemoryTemporarySwitchTo(targetProcess->pageDirectory);
-		pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, physicalAddr, G_PAGE_TABLE_USER_DEFAULT, G_PAGE_USER_DEFAULT);
-		taskingMemoryTemporarySwitchBack(back);
-		mutexRelease(&targetProcess->lock);
+	taskingMemoryMapContiguous(virtualRangeBase, data->physicalAddress, pages, pageFlags);
 
-		pageReferenceTrackerIncrement(physicalAddr);
-	}
+	// Logged so that blit benchmarks can be related to how the framebuffer was mapped
+	bool largePages = pagingLargePagesAvailable() && pages >= G_LARGE_PAGE_SIZE / G_PAGE_SIZE &&
+	                  ((data->physicalAddress | virtualRangeBase) & G_LARGE_PAGE_ALIGN_MASK) == 0;
+	logInfo("%! task %i mapped mmio %h (%i pages) at %h, write-combining: %b, large pages: %b", "syscall",
+	        task->id, data->physicalAddress, pages, virtualRangeBase, (pageFlags & G_PAGE_WRITE_COMBINING) != 0,
+	        largePages);
 
 	data->virtualAddress = (void*) virtualRangeBase;
-	logDebug("%! shared memory area of process %i at %h of size %h with process %i to address %h", "syscall", task->id,
-	         memory,
-	         pages * G_PAGE_SIZE, targetProcess->main->id, virtualRangeBase);
 }
 
-void syscallMapMmioArea(g_task* task, g_syscall_map_mmio* data)
+void syscallShmCreate(g_task* task, g_syscall_shm_create* data)
 {
 	uint32_t pages = G_PAGE_ALIGN_UP(data->size) / G_PAGE_SIZE;
+	g_shm shm = G_SHM_NONE;
+	data->status = sharedMemoryCreate(task->process, pages, &shm);
+	data->shm = shm;
+}
 
-	g_virtual_address virtualRangeBase = addressRangePoolAllocate(task->process->virtualRangePool, pages,
-	                                                              G_PROC_VIRTUAL_RANGE_FLAG_WEAK);
-	if(virtualRangeBase == 0)
+void syscallShmGrant(g_task* task, g_syscall_shm_grant* data)
+{
+	g_task* targetTask = taskingGetById(data->processId);
+	if(!targetTask)
 	{
-		logInfo("%! task %i failed to map mmio memory, could not allocate virtual range", "syscall", task->id);
+		logInfo("%! task %i was unable to grant shared memory to non-existing process %i", "syscall", task->id,
+		        data->processId);
+		data->status = G_SHM_STATUS_ERROR;
 		return;
 	}
 
-	for(uint32_t i = 0; i < pages; i++)
-	{
-		pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, data->physicalAddress + i * G_PAGE_SIZE,
-		              G_PAGE_TABLE_USER_DEFAULT, G_PAGE_USER_DEFAULT);
-	}
+	data->status = sharedMemoryGrant(task->process, data->shm, targetTask->process);
+}
 
-	data->virtualAddress = (void*) virtualRangeBase;
+void syscallShmMap(g_task* task, g_syscall_shm_map* data)
+{
+	g_virtual_address address = 0;
+	uint32_t pages = 0;
+	data->status = sharedMemoryMap(task->process, data->shm, &address, &pages);
+	data->virtualAddress = (void*) address;
+	data->size = pages * G_PAGE_SIZE;
+}
+
+void syscallShmResize(g_task* task, g_syscall_shm_resize* data)
+{
+	uint32_t pages = G_PAGE_ALIGN_UP(data->size) / G_PAGE_SIZE;
+	data->status = sharedMemoryResize(task->process, data->shm, pages);
+}
+
+void syscallShmSeal(g_task* task, g_syscall_shm_seal* data)
+{
+	data->status = sharedMemorySeal(task->process, data->shm);
+}
+
+void syscallShmRelease(g_task* task, g_syscall_shm_release* data)
+{
+	data->status = sharedMemoryRelease(task->process, data->shm);
 }
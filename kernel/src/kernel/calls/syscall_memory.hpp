@@ -32,10 +32,24 @@ void syscallLowerMemoryFree(g_task* task, g_syscall_lower_free* data);
 
 void syscallAllocateMemory(g_task* task, g_syscall_alloc_mem* data);
 
+void syscallAllocateDmaMemory(g_task* task, g_syscall_alloc_dma_mem* data);
+
 void syscallUnmap(g_task* task, g_syscall_unmap* data);
 
 void syscallShareMemory(g_task* task, g_syscall_share_mem* data);
 
 void syscallMapMmioArea(g_task* task, g_syscall_map_mmio* data);
 
+void syscallShmCreate(g_task* task, g_syscall_shm_create* data);
+
+void syscallShmGrant(g_task* task, g_syscall_shm_grant* data);
+
+void syscallShmMap(g_task* task, g_syscall_shm_map* data);
+
+void syscallShmResize(g_task* task, g_syscall_shm_resize* data);
+
+void syscallShmSeal(g_task* task, g_syscall_shm_seal* data);
+
+void syscallShmRelease(g_task* task, g_syscall_shm_release* data);
+
 #endif
@@ -21,6 +21,9 @@
 #include "kernel/calls/syscall_messaging.hpp"
 #include "kernel/ipc/message_queues.hpp"
 #include "kernel/ipc/message_topics.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/tasking/tasking_memory.hpp"
 #include "kernel/tasking/user_mutex.hpp"
 #include "shared/logger/logger.hpp"
 
@@ -38,6 +41,122 @@ void syscallMessageSend(g_task* task, g_syscall_send_message* data)
 	messageQueueUnwaitForSend(task->id, data->receiver);
 }
 
+/**
+ * Maps the areas granted by the sender into the receiving process and fills the
+ * descriptors that are appended to the message.
+ */
+static g_message_send_status _syscallMessageMapGrants(g_task* task, g_process* receiver, g_message_grant* grants,
+                                                      uint32_t count, g_message_grant_flags flags,
+                                                      g_message_grant* outMapped, uint32_t* outMappedCount)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		g_virtual_address address = (g_virtual_address) grants[i].address;
+		uint32_t pages = G_PAGE_ALIGN_UP(grants[i].size) / G_PAGE_SIZE;
+		if((address & G_PAGE_ALIGN_MASK) || pages == 0 || address >= G_KERNEL_AREA_START ||
+		   pages > (G_KERNEL_AREA_START - address) / G_PAGE_SIZE)
+			return G_MESSAGE_SEND_STATUS_INVALID_GRANT;
+
+		// Only whole ranges can be moved, otherwise unmapping would leave a hole in some other area
+		if(flags & G_MESSAGE_GRANT_FLAGS_MOVE)
+		{
+			g_address_range* range = addressRangePoolFind(task->process->virtualRangePool, address);
+			if(!range || !range->used || range->pages != pages || (range->flags & G_PROC_VIRTUAL_RANGE_FLAG_WEAK))
+				return G_MESSAGE_SEND_STATUS_INVALID_GRANT;
+		}
+
+		g_virtual_address mapped = taskingMemoryShare(receiver, address, pages);
+		if(!mapped)
+			return G_MESSAGE_SEND_STATUS_FAILED;
+
+		outMapped[i].address = (void*) mapped;
+		outMapped[i].size = grants[i].size;
+		(*outMappedCount)++;
+	}
+	return G_MESSAGE_SEND_STATUS_SUCCESSFUL;
+}
+
+/**
+ * Removes grants from the receiving process again if the message could not be sent. Only
+ * called without waiting in between mapping and revoking, so the process still exists.
+ */
+static void _syscallMessageRevokeGrants(g_process* receiver, g_message_grant* mapped, uint32_t count)
+{
+	if(count == 0)
+		return;
+
+	mutexAcquire(&receiver->lock);
+	g_physical_address back = taskingMemoryTemporarySwitchTo(receiver->pageDirectory);
+	for(uint32_t i = 0; i < count; i++)
+		taskingMemoryUnmapRange(receiver, (g_virtual_address) mapped[i].address);
+	taskingMemoryTemporarySwitchBack(back);
+	mutexRelease(&receiver->lock);
+}
+
+void syscallMessageSendGrants(g_task* task, g_syscall_send_message_grants* data)
+{
+	uint32_t grantsLength = data->grantCount * sizeof(g_message_grant);
+	if(data->grantCount > G_MESSAGE_MAXIMUM_GRANTS || data->length > G_MESSAGE_MAXIMUM_MESSAGE_LENGTH ||
+	   data->length + grantsLength > G_MESSAGE_MAXIMUM_MESSAGE_LENGTH)
+	{
+		data->status = G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
+		return;
+	}
+
+	// The descriptors with the addresses in the receiver are sent behind the content
+	uint32_t length = data->length + grantsLength;
+	auto content = (uint8_t*) heapAllocate(length);
+	if(!content)
+	{
+		data->status = G_MESSAGE_SEND_STATUS_FAILED;
+		return;
+	}
+	memoryCopy(content, data->buffer, data->length);
+	auto mapped = (g_message_grant*) (content + data->length);
+
+	// Grants are never left mapped while waiting, the receiver could exit in the meantime
+	for(;;)
+	{
+		g_task* receiverTask = taskingGetById(data->receiver);
+		if(!receiverTask)
+		{
+			data->status = G_MESSAGE_SEND_STATUS_FAILED;
+			break;
+		}
+		g_process* receiver = receiverTask->process;
+
+		uint32_t mappedCount = 0;
+		data->status = _syscallMessageMapGrants(task, receiver, data->grants, data->grantCount, data->flags, mapped,
+		                                        &mappedCount);
+		if(data->status == G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+			data->status = messageQueueSend(task->id, data->receiver, content, length, data->transaction,
+			                                data->grantCount);
+
+		if(data->status == G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+			break;
+		_syscallMessageRevokeGrants(receiver, mapped, mappedCount);
+
+		if(data->status != G_MESSAGE_SEND_STATUS_FULL || data->mode != G_MESSAGE_SEND_MODE_BLOCKING)
+			break;
+
+		taskingWait(task, __func__, [task, data]()
+		{
+			messageQueueWaitForSend(task->id, data->receiver);
+		});
+	}
+	messageQueueUnwaitForSend(task->id, data->receiver);
+
+	if(data->status == G_MESSAGE_SEND_STATUS_SUCCESSFUL && (data->flags & G_MESSAGE_GRANT_FLAGS_MOVE))
+	{
+		mutexAcquire(&task->process->lock);
+		for(uint32_t i = 0; i < data->grantCount; i++)
+			taskingMemoryUnmapRange(task->process, (g_virtual_address) data->grants[i].address);
+		mutexRelease(&task->process->lock);
+	}
+
+	heapFree(content);
+}
+
 void syscallMessageReceive(g_task* task, g_syscall_receive_message* data)
 {
 	while((data->status = messageQueueReceive(task->id, data->buffer, data->maximum, data->transaction)) ==
@@ -54,6 +173,18 @@ void syscallMessageReceive(g_task* task, g_syscall_receive_message* data)
 	}
 }
 
+void syscallMessageReceiveBatch(g_task* task, g_syscall_receive_message_batch* data)
+{
+	uint32_t count;
+	while((data->status = messageQueueReceiveBatch(task->id, data->buffer, data->maximum, data->maximumCount, &count))
+	      == G_MESSAGE_RECEIVE_STATUS_EMPTY &&
+	      data->mode == G_MESSAGE_RECEIVE_MODE_BLOCKING)
+	{
+		taskingWait(task, __func__);
+	}
+	data->count = count;
+}
+
 void syscallMessageNextTxId(g_task* task, g_syscall_message_next_txid* data)
 {
 	data->transaction = messageQueueNextTxId();
@@ -74,8 +205,9 @@ void syscallMessageTopicSend(g_task* task, g_syscall_send_topic_message* data)
 
 void syscallMessageTopicReceive(g_task* task, g_syscall_receive_topic_message* data)
 {
-	while((data->status = messageTopicsReceive(data->topic, data->start_after, data->buffer, data->maximum)) ==
-	      G_MESSAGE_RECEIVE_STATUS_EMPTY &&
+	uint32_t dropped;
+	while((data->status = messageTopicsReceive(data->topic, data->start_after, data->buffer, data->maximum,
+	                                           &dropped)) == G_MESSAGE_RECEIVE_STATUS_EMPTY &&
 	      data->mode == G_MESSAGE_RECEIVE_MODE_BLOCKING)
 	{
 		taskingWait(task, __func__, [data, task]()
@@ -84,4 +216,10 @@ void syscallMessageTopicReceive(g_task* task, g_syscall_receive_topic_message* d
 		});
 	}
 	messageTopicsUnwaitForReceive(data->topic, task->id);
+	data->dropped = dropped;
+}
+
+void syscallMessageTopicCreate(g_task* task, g_syscall_create_topic* data)
+{
+	data->status = messageTopicsCreate(data->topic, data->capacity);
 }
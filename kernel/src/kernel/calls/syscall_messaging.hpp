@@ -28,10 +28,16 @@ void syscallMessageSend(g_task* task, g_syscall_send_message* data);
 
 void syscallMessageReceive(g_task* task, g_syscall_receive_message* data);
 
+void syscallMessageReceiveBatch(g_task* task, g_syscall_receive_message_batch* data);
+
 void syscallMessageTopicSend(g_task* task, g_syscall_send_topic_message* data);
 
 void syscallMessageTopicReceive(g_task* task, g_syscall_receive_topic_message* data);
 
+void syscallMessageTopicCreate(g_task* task, g_syscall_create_topic* data);
+
 void syscallMessageNextTxId(g_task* task, g_syscall_message_next_txid* data);
 
+void syscallMessageSendGrants(g_task* task, g_syscall_send_message_grants* data);
+
 #endif
@@ -20,10 +20,11 @@
 
 #include "kernel/calls/syscall_mutex.hpp"
 #include "kernel/tasking/user_mutex.hpp"
+#include "kernel/tasking/futex.hpp"
 
 void syscallMutexInitialize(g_task* task, g_syscall_user_mutex_initialize* data)
 {
-	data->mutex = userMutexCreate(data->reentrant);
+	data->mutex = userMutexCreate(task->process, data->reentrant);
 }
 
 void sycallMutexAcquire(g_task* task, g_syscall_user_mutex_acquire* data)
@@ -35,11 +36,21 @@ void sycallMutexAcquire(g_task* task, g_syscall_user_mutex_acquire* data)
 
 void syscallMutexRelease(g_task* task, g_syscall_user_mutex_release* data)
 {
-	userMutexRelease(data->mutex);
+	userMutexRelease(task, data->mutex);
 }
 
 void syscallMutexDestroy(g_task* task, g_syscall_user_mutex_destroy* data)
 {
-	userMutexDestroy(data->mutex);
+	userMutexDestroy(task->process, data->mutex);
+}
+
+void syscallFutexWait(g_task* task, g_syscall_futex_wait* data)
+{
+	data->status = futexWait(task, (g_address) data->address, data->expected, data->timeout);
+}
+
+void syscallFutexWake(g_task* task, g_syscall_futex_wake* data)
+{
+	data->status = futexWake((g_address) data->address);
 }
 
@@ -32,4 +32,8 @@ void syscallMutexRelease(g_task* task, g_syscall_user_mutex_release* data);
 
 void syscallMutexDestroy(g_task* task, g_syscall_user_mutex_destroy* data);
 
+void syscallFutexWait(g_task* task, g_syscall_futex_wait* data);
+
+void syscallFutexWake(g_task* task, g_syscall_futex_wake* data);
+
 #endif
@@ -19,14 +19,19 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/calls/syscall_system.hpp"
+#include "kernel/calls/syscall.hpp"
 #include "kernel/system/interrupts/requests.hpp"
 #include "kernel/system/processor/processor.hpp"
 #include "kernel/tasking/clock.hpp"
+#include "kernel/tasking/poll.hpp"
 #include "kernel/filesystem/filesystem.hpp"
 #include "kernel/system/interrupts/apic/ioapic.hpp"
 #include "shared/logger/logger.hpp"
 #include "kernel/tasking/elf/elf_object.hpp"
 #include "shared/utils/string.hpp"
+#include "shared/memory/constants.hpp"
+
+#include <ghost/syscall.h>
 
 void _getBinaryNameWithoutExtension(g_task* task, char buf[], int len)
 {
@@ -126,10 +131,97 @@ void syscallAwaitIrq(g_task* task, g_syscall_await_irq* data)
 	requestsSetHandlerTask(data->irq, task->id);
 	taskingWait(task, __func__, [data, task]()
 	{
+		// An IRQ that fired while the handler was busy must not be lost
+		if(requestsConsumePending(data->irq))
+		{
+			taskingWake(task);
+			return;
+		}
+
 		if(data->timeout)
 		{
 			clockUnwaitForTime(task->id);
 			clockWaitForTime(task->id, clockGetLocal()->time + data->timeout);
 		}
 	});
+	requestsConsumePending(data->irq);
+}
+
+void syscallPoll(g_task* task, g_syscall_poll* data)
+{
+	uint32_t ready;
+	data->status = pollWait(task, data->set, data->timeout, &ready);
+	data->ready = ready;
+}
+
+/**
+ * Calls that may be issued through a ring. Everything else would either make no sense
+ * in a batch (like exiting) or needs its result before the next call can be queued.
+ */
+static bool _syscallRingIsSupported(uint32_t call)
+{
+	switch(call)
+	{
+		case G_SYSCALL_FS_READ:
+		case G_SYSCALL_FS_WRITE:
+		case G_SYSCALL_FS_READV:
+		case G_SYSCALL_FS_WRITEV:
+		case G_SYSCALL_FS_SEEK:
+		case G_SYSCALL_MESSAGE_SEND:
+		case G_SYSCALL_MESSAGE_RECEIVE:
+		case G_SYSCALL_AWAIT_IRQ:
+		case G_SYSCALL_SLEEP:
+		case G_SYSCALL_SLEEP_NANOS:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void syscallRingEnter(g_task* task, g_syscall_ring_enter* data)
+{
+	data->processed = 0;
+
+	// Size is read once, userspace may change the header while we work on it
+	g_ring_header* header = data->ring;
+	uint32_t entries = header ? header->entries : 0;
+	if(!header || header->magic != G_RING_MAGIC || entries < G_RING_MINIMUM_ENTRIES ||
+	   entries > G_RING_MAXIMUM_ENTRIES || (entries & (entries - 1)) ||
+	   (g_virtual_address) header >= G_KERNEL_AREA_START - G_RING_SIZE(G_RING_MAXIMUM_ENTRIES))
+	{
+		data->status = G_RING_STATUS_INVALID;
+		return;
+	}
+
+	g_ring_submission* submissions = G_RING_SUBMISSIONS(header);
+	g_ring_completion* completions = G_RING_COMPLETIONS(header, entries);
+	data->status = G_RING_STATUS_SUCCESSFUL;
+
+	// At most one round, so a task that keeps submitting can not hold us here forever
+	while(data->processed < entries && header->submissionHead != header->submissionTail)
+	{
+		if(header->completionTail - header->completionHead >= entries)
+		{
+			data->status = G_RING_STATUS_BUSY;
+			break;
+		}
+
+		uint32_t head = header->submissionHead;
+		g_ring_submission submission = submissions[head & (entries - 1)];
+		header->submissionHead = head + 1;
+
+		g_ring_completion_status status = G_RING_COMPLETION_UNSUPPORTED;
+		if(_syscallRingIsSupported(submission.call) && syscallNested(task, submission.call, submission.data))
+			status = G_RING_COMPLETION_SUCCESSFUL;
+
+		uint32_t tail = header->completionTail;
+		g_ring_completion* completion = &completions[tail & (entries - 1)];
+		completion->userData = submission.userData;
+		completion->call = submission.call;
+		completion->status = status;
+		asm volatile("" ::: "memory");
+		header->completionTail = tail + 1;
+
+		data->processed++;
+	}
 }
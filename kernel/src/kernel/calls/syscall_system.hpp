@@ -23,6 +23,8 @@
 
 #include "kernel/tasking/tasking.hpp"
 #include <ghost/system/callstructs.h>
+#include <ghost/poll/callstructs.h>
+#include <ghost/ring/callstructs.h>
 
 void syscallLog(g_task* task, g_syscall_log* data);
 
@@ -36,4 +38,8 @@ void syscallIrqCreateRedirect(g_task* task, g_syscall_irq_create_redirect* data)
 
 void syscallAwaitIrq(g_task* task, g_syscall_await_irq* data);
 
+void syscallPoll(g_task* task, g_syscall_poll* data);
+
+void syscallRingEnter(g_task* task, g_syscall_ring_enter* data);
+
 #endif
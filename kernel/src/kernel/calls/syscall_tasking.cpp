@@ -39,6 +39,14 @@ void syscallSleep(g_task* task, g_syscall_sleep* data)
 	});
 }
 
+void syscallSleepNanos(g_task* task, g_syscall_sleep_nanos* data)
+{
+	taskingWait(task, __func__, [task, data]()
+	{
+		clockWaitForDeadline(task->id, clockGetDeadline(data->nanoseconds));
+	});
+}
+
 void syscallYield(g_task* task, g_syscall_yield* data)
 {
 	if(data->target != G_TID_NONE)
@@ -110,7 +118,7 @@ void syscallSpawn(g_task* task, g_syscall_spawn* data)
 		data->status = target.status;
 		data->validationDetails = target.validation;
 
-		filesystemClose(task->process->id, fd, true);
+		filesystemClose(task->process, fd, true);
 
 		if(data->status == G_SPAWN_STATUS_SUCCESSFUL)
 		{
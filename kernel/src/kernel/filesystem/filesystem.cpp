@@ -19,9 +19,12 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "kernel/filesystem/filesystem.hpp"
+#include "kernel/filesystem/filesystem_lookup.hpp"
+#include "kernel/filesystem/filesystem_page_cache.hpp"
 #include "kernel/filesystem/filesystem_pipedelegate.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
 #include "kernel/filesystem/filesystem_ramdiskdelegate.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/ipc/pipes.hpp"
 #include "kernel/memory/memory.hpp"
@@ -38,19 +41,48 @@ static g_fs_node* pipesFolder;
 
 static g_fs_virt_id filesystemNextNodeId;
 static g_mutex filesystemNextNodeIdLock;
+static g_mutex filesystemMountLock;
 
 static g_hashmap<g_fs_virt_id, g_fs_node*>* filesystemNodes;
 
 g_fs_open_status _filesystemChooseOrigin(const char* path, g_task* task, g_fs_node*& origin);
 
+/**
+ * Checks whether a name given by a task can be used for a node.
+ */
+bool _filesystemIsValidNodeName(const char* name);
+
+/**
+ * Finds a child in the lookup cache or the node tree. If the cache remembers the name
+ * as missing, outKnownMissing is set and the delegate does not have to be asked.
+ */
+bool _filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild, bool* outKnownMissing);
+
+/**
+ * Reads from or writes to the file behind a descriptor at its current offset. If wait is set
+ * and the node is blocking, the task waits until the operation is no longer busy.
+ */
+g_fs_read_status _filesystemReadDescriptor(g_task* task, g_file_descriptor* descriptor, g_fs_node* node,
+                                           uint8_t* buffer, uint64_t length, bool wait, int64_t* outRead);
+g_fs_write_status _filesystemWriteDescriptor(g_task* task, g_file_descriptor* descriptor, g_fs_node* node,
+                                             uint8_t* buffer, uint64_t length, bool wait, int64_t* outWrote);
+
+/**
+ * Size of the kernel buffer that splice moves data through.
+ */
+#define G_FS_SPLICE_CHUNK (G_PAGE_SIZE * 4)
+
 void filesystemInitialize()
 {
 	mutexInitializeTask(&filesystemNextNodeIdLock, __func__);
+	mutexInitializeTask(&filesystemMountLock, __func__);
 	filesystemNextNodeId = 0;
 
 	filesystemNodes = hashmapCreateNumeric<g_fs_virt_id, g_fs_node*>(1024);
+	filesystemLookupInitialize();
+	filesystemPageCacheInitialize();
+	filesystemTaskedDelegateInitialize();
 
-	filesystemProcessInitialize();
 	filesystemCreateRoot();
 }
 
@@ -67,6 +99,8 @@ void filesystemCreateRoot()
 	ramdiskDelegate->getLength = filesystemRamdiskDelegateGetLength;
 	ramdiskDelegate->close = filesystemRamdiskDelegateClose;
 	ramdiskDelegate->refreshDir = filesystemRamdiskDelegateRefreshDir;
+	ramdiskDelegate->cacheMisses = true;
+	ramdiskDelegate->cachePages = true;
 
 	filesystemRoot = filesystemCreateNode(G_FS_NODE_TYPE_ROOT, "root");
 	filesystemRoot->delegate = ramdiskDelegate;
@@ -89,6 +123,9 @@ void filesystemCreateRoot()
 	pipeDelegate->getLength = filesystemPipeDelegateGetLength;
 	pipeDelegate->waitForRead = filesystemPipeDelegateWaitForRead;
 	pipeDelegate->waitForWrite = filesystemPipeDelegateWaitForWrite;
+	pipeDelegate->unwaitForRead = filesystemPipeDelegateUnwaitForRead;
+	pipeDelegate->unwaitForWrite = filesystemPipeDelegateUnwaitForWrite;
+	pipeDelegate->poll = filesystemPipeDelegatePoll;
 	pipeDelegate->close = filesystemPipeDelegateClose;
 
 	pipesFolder = filesystemCreateNode(G_FS_NODE_TYPE_MOUNTPOINT, "pipes");
@@ -124,9 +161,12 @@ void filesystemAddChild(g_fs_node* parent, g_fs_node* child)
 	g_fs_node_entry* entry = (g_fs_node_entry*) heapAllocate(sizeof(g_fs_node_entry));
 	entry->node = child;
 	entry->next = parent->children;
+	child->entry = entry;
 	parent->children = entry;
 
 	mutexRelease(&parent->lock);
+
+	filesystemLookupInvalidate(parent, child->name);
 }
 
 g_fs_virt_id filesystemGetNextNodeId()
@@ -168,11 +208,121 @@ g_fs_delegate* filesystemFindDelegate(g_fs_node* node)
 	return delegate;
 }
 
+g_fs_register_as_delegate_status filesystemRegisterAsDelegate(g_task* task, const char* name,
+                                                              g_fs_phys_id physMountpointId,
+                                                              g_fs_virt_id* outMountpointId, g_address* outStorage)
+{
+	if(!_filesystemIsValidNodeName(name))
+	{
+		logInfo("%! task %i tried to register as delegate with an invalid name", "fs", task->id);
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	}
+
+	mutexAcquire(&filesystemMountLock);
+	g_fs_node* existing;
+	if(filesystemFindExistingChild(mountFolder, name, &existing))
+	{
+		// A restarted driver takes over the mountpoint of its dead predecessor
+		if(!existing->delegate || !existing->delegate->tasked ||
+		   !filesystemTaskedDelegateTakeOver(existing->delegate->tasked, task, outStorage))
+		{
+			mutexRelease(&filesystemMountLock);
+			return G_FS_REGISTER_AS_DELEGATE_FAILED_EXISTING;
+		}
+
+		existing->physicalId = physMountpointId;
+		existing->upToDate = false;
+		mutexRelease(&filesystemMountLock);
+
+		logInfo("%! task %i took over mountpoint '%s'", "fs", task->id, name);
+		*outMountpointId = existing->id;
+		return G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL;
+	}
+
+	g_fs_delegate* delegate = filesystemCreateDelegate();
+	delegate->open = filesystemTaskedDelegateOpen;
+	delegate->discover = filesystemTaskedDelegateDiscover;
+	delegate->read = filesystemTaskedDelegateRead;
+	delegate->write = filesystemTaskedDelegateWrite;
+	delegate->getLength = filesystemTaskedDelegateGetLength;
+	delegate->close = filesystemTaskedDelegateClose;
+	delegate->refreshDir = filesystemTaskedDelegateRefreshDir;
+	delegate->sync = filesystemTaskedDelegateSync;
+	delegate->tasked = filesystemTaskedDelegateCreate(task, delegate, outStorage);
+	if(!delegate->tasked)
+	{
+		mutexRelease(&filesystemMountLock);
+		heapFree(delegate);
+		return G_FS_REGISTER_AS_DELEGATE_FAILED_DELEGATE_CREATION;
+	}
+
+	g_fs_node* mountpoint = filesystemCreateNode(G_FS_NODE_TYPE_MOUNTPOINT, name);
+	mountpoint->physicalId = physMountpointId;
+	mountpoint->delegate = delegate;
+	filesystemAddChild(mountFolder, mountpoint);
+	mutexRelease(&filesystemMountLock);
+
+	logInfo("%! task %i registered as delegate for mountpoint '%s'", "fs", task->id, name);
+	*outMountpointId = mountpoint->id;
+	return G_FS_REGISTER_AS_DELEGATE_SUCCESSFUL;
+}
+
+g_fs_create_node_status filesystemCreateDelegateNode(g_task* task, g_fs_virt_id parentId, const char* name,
+                                                     g_fs_node_type type, g_fs_phys_id physicalId,
+                                                     g_fs_virt_id* outCreatedId)
+{
+	g_fs_node* parent = filesystemGetNode(parentId);
+	if(!parent)
+		return G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(parent);
+	if(!delegate->tasked || delegate->tasked->process != task->process)
+	{
+		logInfo("%! task %i tried to create a node in %i which it is not the delegate for", "fs", task->id,
+		        parent->id);
+		return G_FS_CREATE_NODE_STATUS_FAILED_NOT_PERMITTED;
+	}
+
+	if(!_filesystemIsValidNodeName(name) ||
+	   (type != G_FS_NODE_TYPE_FILE && type != G_FS_NODE_TYPE_FOLDER))
+		return G_FS_CREATE_NODE_STATUS_FAILED_INVALID;
+
+	g_fs_node* child;
+	if(filesystemFindExistingChild(parent, name, &child))
+	{
+		child->type = type;
+		child->physicalId = physicalId;
+		*outCreatedId = child->id;
+		return G_FS_CREATE_NODE_STATUS_UPDATED;
+	}
+
+	child = filesystemCreateNode(type, name);
+	child->physicalId = physicalId;
+	filesystemAddChild(parent, child);
+	*outCreatedId = child->id;
+	return G_FS_CREATE_NODE_STATUS_CREATED;
+}
+
+bool _filesystemIsValidNodeName(const char* name)
+{
+	int length = stringLength(name);
+	if(length == 0 || length >= G_FILENAME_MAX)
+		return false;
+	if(stringIndexOf(name, '/') != -1)
+		return false;
+	return !stringEquals(name, ".") && !stringEquals(name, "..");
+}
+
 bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild)
 {
-	mutexAcquire(&parent->lock);
+	bool knownMissing;
+	return _filesystemFindExistingChild(parent, name, outChild, &knownMissing);
+}
 
+bool _filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node** outChild, bool* outKnownMissing)
+{
 	g_fs_node* child = nullptr;
+	*outKnownMissing = false;
 
 	if(stringEquals(name, ".."))
 	{
@@ -182,8 +332,13 @@ bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node*
 	{
 		child = parent;
 	}
+	else if(filesystemLookupGet(parent, name, &child))
+	{
+		*outKnownMissing = (child == nullptr);
+	}
 	else
 	{
+		mutexAcquire(&parent->lock);
 		g_fs_node_entry* childEntry = parent->children;
 		while(childEntry)
 		{
@@ -194,9 +349,11 @@ bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node*
 			}
 			childEntry = childEntry->next;
 		}
-	}
+		mutexRelease(&parent->lock);
 
-	mutexRelease(&parent->lock);
+		if(child)
+			filesystemLookupPutFound(parent, name, child);
+	}
 
 	if(outChild)
 		*outChild = child;
@@ -205,8 +362,11 @@ bool filesystemFindExistingChild(g_fs_node* parent, const char* name, g_fs_node*
 
 g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_node** outChild)
 {
-	if(filesystemFindExistingChild(parent, name, outChild))
+	bool knownMissing;
+	if(_filesystemFindExistingChild(parent, name, outChild, &knownMissing))
 		return G_FS_OPEN_SUCCESSFUL;
+	if(knownMissing)
+		return G_FS_OPEN_NOT_FOUND;
 
 	g_fs_delegate* delegate = filesystemFindDelegate(parent);
 	if(!delegate->discover)
@@ -214,7 +374,12 @@ g_fs_open_status filesystemFindChild(g_fs_node* parent, const char* name, g_fs_n
 		*outChild = 0;
 		return G_FS_OPEN_ERROR;
 	}
-	return delegate->discover(parent, name, outChild);
+
+	uint32_t generation = filesystemLookupGetGeneration();
+	g_fs_open_status status = delegate->discover(parent, name, outChild);
+	if(status == G_FS_OPEN_NOT_FOUND && delegate->cacheMisses)
+		filesystemLookupPutMissing(parent, name, generation);
+	return status;
 }
 
 g_filesystem_find_result filesystemFind(g_fs_node* parent, const char* path)
@@ -299,7 +464,7 @@ g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task
 
 		if(flags & G_FILE_FLAG_MODE_TRUNCATE)
 		{
-			if(filesystemTruncate(findRes.node) != G_FS_OPEN_SUCCESSFUL)
+			if(filesystemTruncate(findRes.node, 0) != G_FS_OPEN_SUCCESSFUL)
 			{
 				logInfo("%! failed to truncate file %i", "fs", findRes.node->id);
 				return G_FS_OPEN_ERROR;
@@ -334,10 +499,10 @@ g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task
 	}
 
 	// Actually open the file
-	return filesystemOpenNodeFd(findRes.node, flags, task->process->id, outFd);
+	return filesystemOpenNodeFd(findRes.node, flags, task->process, outFd);
 }
 
-g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_pid process,
+g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_process* process,
                                     g_file_descriptor** outDescriptor, g_fd optionalTargetFd)
 {
 	g_fs_delegate* delegate = filesystemFindDelegate(file);
@@ -348,14 +513,14 @@ g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_p
 	}
 
 	g_fs_open_status status = delegate->open(file, flags);
-	if(status == G_FS_OPEN_SUCCESSFUL && process != G_PID_NONE)
+	if(status == G_FS_OPEN_SUCCESSFUL && process)
 	{
 		status = filesystemProcessCreateDescriptor(process, file->id, flags, outDescriptor, optionalTargetFd);
 	}
 	return status;
 }
 
-g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g_pid process, g_fd* outFd,
+g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g_process* process, g_fd* outFd,
                                       g_fd optionalTargetFd)
 {
 	g_file_descriptor* descriptor = nullptr;
@@ -367,7 +532,7 @@ g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g
 
 g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outRead)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_READ_INVALID_FD;
@@ -379,10 +544,16 @@ g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t
 		return G_FS_READ_INVALID_FD;
 	}
 
-	int64_t read;
+	return _filesystemReadDescriptor(task, descriptor, node, buffer, length, true, outRead);
+}
+
+g_fs_read_status _filesystemReadDescriptor(g_task* task, g_file_descriptor* descriptor, g_fs_node* node,
+                                           uint8_t* buffer, uint64_t length, bool wait, int64_t* outRead)
+{
+	int64_t read = 0;
 	g_fs_read_status status;
 	while((status = filesystemRead(node, buffer, descriptor->offset, length, &read)) == G_FS_READ_BUSY
-	      && node->blocking)
+	      && node->blocking && wait)
 	{
 		g_fs_delegate* delegate = filesystemFindDelegate(node);
 		if(!delegate->waitForRead)
@@ -394,7 +565,7 @@ g_fs_read_status filesystemRead(g_task* task, g_fd fd, uint8_t* buffer, uint64_t
 		task->status = G_TASK_STATUS_WAITING;
 		task->waitsFor = "read";
 		mutexRelease(&task->lock);
-		delegate->waitForRead(task->id, node);
+		delegate->waitForRead(task->id, node, true);
 		taskingYield();
 		INTERRUPTS_RESUME;
 	}
@@ -412,12 +583,15 @@ g_fs_read_status filesystemRead(g_fs_node* node, uint8_t* buffer, uint64_t offse
 	if(!delegate->read)
 		return G_FS_READ_ERROR;
 
+	if(delegate->cachePages)
+		return filesystemPageCacheRead(node, buffer, offset, length, outRead);
+
 	return delegate->read(node, buffer, offset, length, outRead);
 }
 
 g_fs_length_status filesystemGetLength(g_task* task, g_fd fd, uint64_t* outLength)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_LENGTH_INVALID_FD;
@@ -441,9 +615,52 @@ g_fs_length_status filesystemGetLength(g_fs_node* node, uint64_t* outLength)
 	return delegate->getLength(node, outLength);
 }
 
+g_fs_sync_status filesystemSync(g_task* task, g_fd fd)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return G_FS_SYNC_INVALID_FD;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return G_FS_SYNC_INVALID_FD;
+
+	return filesystemSync(node);
+}
+
+g_fs_sync_status filesystemSync(g_fs_node* node)
+{
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if(!delegate->sync)
+		return G_FS_SYNC_SUCCESSFUL;
+
+	return delegate->sync(node);
+}
+
+g_fs_sync_status filesystemSyncAll()
+{
+	// Mountpoints are never removed, so the list can be walked without holding the lock
+	mutexAcquire(&mountFolder->lock);
+	g_fs_node_entry* entry = mountFolder->children;
+	mutexRelease(&mountFolder->lock);
+
+	g_fs_sync_status status = G_FS_SYNC_SUCCESSFUL;
+	for(; entry; entry = entry->next)
+	{
+		// Mountpoints stay when their delegate exits, there is nothing left to sync then
+		g_fs_delegate* delegate = entry->node->delegate;
+		if(delegate && delegate->tasked && !delegate->tasked->alive)
+			continue;
+
+		if(filesystemSync(entry->node) != G_FS_SYNC_SUCCESSFUL)
+			status = G_FS_SYNC_ERROR;
+	}
+	return status;
+}
+
 g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64_t length, int64_t* outWrote)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_WRITE_INVALID_FD;
@@ -453,6 +670,12 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 	if(!node)
 		return G_FS_WRITE_INVALID_FD;
 
+	return _filesystemWriteDescriptor(task, descriptor, node, buffer, length, true, outWrote);
+}
+
+g_fs_write_status _filesystemWriteDescriptor(g_task* task, g_file_descriptor* descriptor, g_fs_node* node,
+                                             uint8_t* buffer, uint64_t length, bool wait, int64_t* outWrote)
+{
 	uint64_t startOffset = descriptor->offset;
 	if(descriptor->openFlags & G_FILE_FLAG_MODE_APPEND)
 	{
@@ -463,10 +686,11 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 		}
 	}
 
-	int64_t wrote;
+	int64_t wrote = 0;
 	g_fs_write_status status;
 
-	while((status = filesystemWrite(node, buffer, startOffset, length, &wrote)) == G_FS_WRITE_BUSY && node->blocking)
+	while((status = filesystemWrite(node, buffer, startOffset, length, &wrote)) == G_FS_WRITE_BUSY && node->blocking &&
+	      wait)
 	{
 		g_fs_delegate* delegate = filesystemFindDelegate(node);
 		if(!delegate->waitForWrite)
@@ -478,7 +702,7 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 		task->status = G_TASK_STATUS_WAITING;
 		task->waitsFor = "write";
 		mutexRelease(&task->lock);
-		delegate->waitForWrite(task->id, node);
+		delegate->waitForWrite(task->id, node, true);
 		taskingYield();
 		INTERRUPTS_RESUME;
 	}
@@ -496,7 +720,203 @@ g_fs_write_status filesystemWrite(g_fs_node* node, uint8_t* buffer, uint64_t off
 	if(!delegate->write)
 		return G_FS_WRITE_ERROR;
 
-	return delegate->write(node, buffer, offset, length, outWrote);
+	g_fs_write_status status = delegate->write(node, buffer, offset, length, outWrote);
+	if(delegate->cachePages)
+		filesystemPageCacheInvalidate(node, offset);
+	return status;
+}
+
+g_fs_read_status filesystemReadVector(g_task* task, g_fd fd, g_fs_iovec* vectors, uint32_t count, int64_t* outRead)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return G_FS_READ_INVALID_FD;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return G_FS_READ_INVALID_FD;
+
+	if(count > G_FS_IOVEC_MAXIMUM)
+		return G_FS_READ_ERROR;
+
+	int64_t total = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(vectors[i].length == 0)
+			continue;
+
+		// Only wait for the first bytes, afterwards take what is there
+		int64_t read;
+		g_fs_read_status status = _filesystemReadDescriptor(task, descriptor, node, (uint8_t*) vectors[i].buffer,
+		                                                    vectors[i].length, total == 0, &read);
+		if(status != G_FS_READ_SUCCESSFUL)
+		{
+			if(total == 0)
+				return status;
+			break;
+		}
+
+		total += read;
+		if((uint64_t) read < vectors[i].length)
+			break;
+	}
+
+	*outRead = total;
+	return G_FS_READ_SUCCESSFUL;
+}
+
+g_fs_write_status filesystemWriteVector(g_task* task, g_fd fd, g_fs_iovec* vectors, uint32_t count,
+                                        int64_t* outWrote)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return G_FS_WRITE_INVALID_FD;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return G_FS_WRITE_INVALID_FD;
+
+	if(count > G_FS_IOVEC_MAXIMUM)
+		return G_FS_WRITE_ERROR;
+
+	int64_t total = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		if(vectors[i].length == 0)
+			continue;
+
+		int64_t wrote;
+		g_fs_write_status status = _filesystemWriteDescriptor(task, descriptor, node, (uint8_t*) vectors[i].buffer,
+		                                                      vectors[i].length, total == 0, &wrote);
+		if(status != G_FS_WRITE_SUCCESSFUL)
+		{
+			if(total == 0)
+				return status;
+			break;
+		}
+
+		total += wrote;
+		if((uint64_t) wrote < vectors[i].length)
+			break;
+	}
+
+	*outWrote = total;
+	return G_FS_WRITE_SUCCESSFUL;
+}
+
+g_fs_splice_status filesystemSplice(g_task* task, g_fd in, g_fd out, uint64_t length, int64_t* outMoved)
+{
+	g_file_descriptor* inDescriptor = filesystemProcessGetDescriptor(task->process, in);
+	g_file_descriptor* outDescriptor = filesystemProcessGetDescriptor(task->process, out);
+	if(!inDescriptor || !outDescriptor)
+		return G_FS_SPLICE_INVALID_FD;
+
+	g_fs_node* inNode = filesystemGetNode(inDescriptor->nodeId);
+	g_fs_node* outNode = filesystemGetNode(outDescriptor->nodeId);
+	if(!inNode || !outNode)
+		return G_FS_SPLICE_INVALID_FD;
+
+	uint8_t* chunk = (uint8_t*) heapAllocate(G_FS_SPLICE_CHUNK);
+	if(!chunk)
+		return G_FS_SPLICE_ERROR;
+
+	g_fs_splice_status status = G_FS_SPLICE_SUCCESSFUL;
+	uint64_t moved = 0;
+	while(moved < length)
+	{
+		uint64_t chunkLength = length - moved;
+		if(chunkLength > G_FS_SPLICE_CHUNK)
+			chunkLength = G_FS_SPLICE_CHUNK;
+
+		// Input is only waited for until something was moved, like a normal read
+		int64_t read;
+		g_fs_read_status readStatus =
+				_filesystemReadDescriptor(task, inDescriptor, inNode, chunk, chunkLength, moved == 0, &read);
+		if(readStatus != G_FS_READ_SUCCESSFUL)
+		{
+			if(moved == 0)
+				status = (readStatus == G_FS_READ_BUSY) ? G_FS_SPLICE_BUSY : G_FS_SPLICE_ERROR;
+			break;
+		}
+		if(read == 0)
+			break;
+
+		// What was taken from the input must be written completely
+		int64_t written = 0;
+		while(written < read)
+		{
+			int64_t wrote;
+			g_fs_write_status writeStatus = _filesystemWriteDescriptor(task, outDescriptor, outNode, &chunk[written],
+			                                                           read - written, true, &wrote);
+			if(writeStatus != G_FS_WRITE_SUCCESSFUL || wrote == 0)
+			{
+				logInfo("%! splice of task %i lost %i bytes, writing to file %i failed with status %i", "fs",
+				        task->id, (int32_t) (read - written), outNode->id, writeStatus);
+				status = G_FS_SPLICE_ERROR;
+				break;
+			}
+			written += wrote;
+		}
+
+		moved += written;
+		if(status != G_FS_SPLICE_SUCCESSFUL || (uint64_t) read < chunkLength)
+			break;
+	}
+
+	heapFree(chunk);
+	*outMoved = moved;
+	return status;
+}
+
+g_poll_events filesystemPoll(g_task* task, g_fd fd, g_poll_events events)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return G_POLL_EVENT_INVALID;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return G_POLL_EVENT_INVALID;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if(!delegate->poll)
+		return events & (G_POLL_EVENT_READ | G_POLL_EVENT_WRITE);
+
+	return delegate->poll(node) & events;
+}
+
+void filesystemWaitForEvents(g_task* task, g_fd fd, g_poll_events events)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if((events & G_POLL_EVENT_READ) && delegate->waitForRead)
+		delegate->waitForRead(task->id, node, false);
+	if((events & G_POLL_EVENT_WRITE) && delegate->waitForWrite)
+		delegate->waitForWrite(task->id, node, false);
+}
+
+void filesystemUnwaitForEvents(g_task* task, g_fd fd, g_poll_events events)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return;
+
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	if((events & G_POLL_EVENT_READ) && delegate->unwaitForRead)
+		delegate->unwaitForRead(task->id, node);
+	if((events & G_POLL_EVENT_WRITE) && delegate->unwaitForWrite)
+		delegate->unwaitForWrite(task->id, node);
 }
 
 g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_node** outFile)
@@ -508,19 +928,41 @@ g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_
 	return delegate->create(parent, name, outFile);
 }
 
-g_fs_open_status filesystemTruncate(g_fs_node* file)
+g_fs_open_status filesystemTruncate(g_fs_node* file, uint64_t length)
 {
 	g_fs_delegate* delegate = filesystemFindDelegate(file);
 	if(!delegate->truncate)
 		return G_FS_OPEN_ERROR;
 
-	return delegate->truncate(file);
+	g_fs_open_status status = delegate->truncate(file, length);
+	if(delegate->cachePages)
+		filesystemPageCacheInvalidate(file, length);
+	return status;
+}
+
+g_fs_truncate_status filesystemTruncate(g_task* task, g_fd fd, uint64_t length)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor || !(descriptor->openFlags & G_FILE_FLAG_MODE_WRITE))
+		return G_FS_TRUNCATE_INVALID_FD;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node)
+		return G_FS_TRUNCATE_INVALID_FD;
+
+	// Pipes can only be emptied, which happens when they are opened with the truncate flag
+	if(node->type != G_FS_NODE_TYPE_FILE || !filesystemFindDelegate(node)->truncate)
+		return G_FS_TRUNCATE_NOT_SUPPORTED;
+
+	if(filesystemTruncate(node, length) != G_FS_OPEN_SUCCESSFUL)
+		return G_FS_TRUNCATE_ERROR;
+	return G_FS_TRUNCATE_SUCCESSFUL;
 }
 
-g_fs_pipe_status filesystemCreatePipe(g_bool blocking, g_fs_node** outPipeNode)
+g_fs_pipe_status filesystemCreatePipe(g_bool blocking, uint32_t capacity, g_fs_node** outPipeNode)
 {
 	g_fs_phys_id pipeId;
-	g_fs_pipe_status status = pipeCreate(&pipeId);
+	g_fs_pipe_status status = pipeCreate(&pipeId, capacity);
 	if(status != G_FS_PIPE_SUCCESSFUL)
 	{
 		logInfo("%! failed to create pipe with status %i", "fs", status);
@@ -542,19 +984,32 @@ g_fs_pipe_status filesystemCreatePipe(g_bool blocking, g_fs_node** outPipeNode)
 	return G_FS_PIPE_SUCCESSFUL;
 }
 
-g_fs_close_status filesystemClose(g_pid pid, g_fd fd, g_bool removeDescriptor)
+g_fs_pipe_status filesystemSetPipeCapacity(g_task* task, g_fd fd, uint32_t capacity)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(pid, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
+	if(!descriptor)
+		return G_FS_PIPE_INVALID_FD;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node || node->type != G_FS_NODE_TYPE_PIPE)
+		return G_FS_PIPE_INVALID_FD;
+
+	return pipeSetCapacity(node->physicalId, capacity);
+}
+
+g_fs_close_status filesystemClose(g_process* process, g_fd fd, g_bool removeDescriptor)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(process, fd);
 	if(!descriptor)
 	{
-		logDebug("%! failed to close fd %i in process %i, illegal descriptor", "fs", fd, pid);
+		logDebug("%! failed to close fd %i in process %i, illegal descriptor", "fs", fd, process->id);
 		return G_FS_CLOSE_INVALID_FD;
 	}
 
 	g_fs_node* file = filesystemGetNode(descriptor->nodeId);
 	if(!file)
 	{
-		logInfo("%! failed to close fd %i in process %i, illegal node", "fs", pid);
+		logInfo("%! failed to close fd %i in process %i, illegal node", "fs", fd, process->id);
 		return G_FS_CLOSE_INVALID_FD;
 	}
 
@@ -568,23 +1023,23 @@ g_fs_close_status filesystemClose(g_pid pid, g_fd fd, g_bool removeDescriptor)
 	g_fs_close_status status = delegate->close(file, descriptor->openFlags);
 	if(status == G_FS_CLOSE_SUCCESSFUL)
 	{
-		logDebug("%! closed file descriptor %i in process %i", "fs", fd, pid);
+		logDebug("%! closed file descriptor %i in process %i", "fs", fd, process->id);
 	}
 	else
 	{
-		logWarn("%! failed to close fd %i in process %i with status: %i", "fs", fd, pid, status);
+		logWarn("%! failed to close fd %i in process %i with status: %i", "fs", fd, process->id, status);
 	}
 
 	// TODO In which case do we *not* remove it?
 	if(removeDescriptor)
-		filesystemProcessRemoveDescriptor(pid, fd);
+		filesystemProcessRemoveDescriptor(process, fd);
 
 	return status;
 }
 
 g_fs_seek_status filesystemSeek(g_task* task, g_fd fd, g_fs_seek_mode mode, int64_t amount, int64_t* outResult)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 	{
 		return G_FS_SEEK_INVALID_FD;
@@ -604,28 +1059,26 @@ g_fs_seek_status filesystemSeek(g_task* task, g_fd fd, g_fs_seek_mode mode, int6
 	}
 
 	// add amount to offset
+	int64_t offset = descriptor->offset;
 	if(mode == G_FS_SEEK_CUR)
 	{
-		descriptor->offset += amount;
+		offset += amount;
 	}
 	else if(mode == G_FS_SEEK_SET)
 	{
-		descriptor->offset = amount;
+		offset = amount;
 	}
 	else if(mode == G_FS_SEEK_END)
 	{
-		descriptor->offset = length - amount;
+		offset = length - amount;
 	}
 
-	// validate offset
-	if(descriptor->offset > length)
+	// validate offset, seeking past the end is allowed so that a write can leave a hole
+	if(offset < 0)
 	{
-		descriptor->offset = length;
-	}
-	if(descriptor->offset < 0)
-	{
-		descriptor->offset = 0;
+		offset = 0;
 	}
+	descriptor->offset = offset;
 
 	*outResult = descriptor->offset;
 	return G_FS_SEEK_SUCCESSFUL;
@@ -729,6 +1182,63 @@ g_fs_read_directory_status filesystemReadDirectory(g_fs_node* dir, uint32_t inde
 	return G_FS_READ_DIRECTORY_EOD;
 }
 
+g_fs_read_directory_status filesystemReadDirectoryEntries(g_fs_node* dir, g_fs_directory_cursor* cursor,
+                                                          uint8_t* buffer, uint32_t length, uint32_t* outWritten)
+{
+	*outWritten = 0;
+
+	g_fs_node_entry* entry;
+	if(*cursor == G_FS_DIRECTORY_CURSOR_START)
+	{
+		entry = dir->children;
+	}
+	else if(*cursor == G_FS_DIRECTORY_CURSOR_END)
+	{
+		return G_FS_READ_DIRECTORY_EOD;
+	}
+	else
+	{
+		g_fs_node* next = filesystemGetNode(*cursor);
+		if(!next || next->parent != dir)
+			return G_FS_READ_DIRECTORY_ERROR;
+		entry = next->entry;
+	}
+
+	uint32_t written = 0;
+	while(entry)
+	{
+		g_fs_node* child = entry->node;
+		uint32_t nameLength = stringLength(child->name);
+		uint32_t recordLength = (sizeof(g_fs_directory_record) + nameLength + 1 + 3) & ~3;
+		if(written + recordLength > length)
+			break;
+
+		int64_t size = 0;
+		if(child->type == G_FS_NODE_TYPE_FILE)
+		{
+			uint64_t fileLength;
+			size = filesystemGetLength(child, &fileLength) == G_FS_LENGTH_SUCCESSFUL ? (int64_t) fileLength : -1;
+		}
+
+		auto record = (g_fs_directory_record*) &buffer[written];
+		record->record_length = recordLength;
+		record->node_id = child->id;
+		record->type = child->type;
+		record->size = size;
+		memoryCopy(G_FS_DIRECTORY_RECORD_NAME(record), child->name, nameLength + 1);
+
+		written += recordLength;
+		entry = entry->next;
+	}
+
+	*cursor = entry ? entry->node->id : G_FS_DIRECTORY_CURSOR_END;
+	*outWritten = written;
+
+	if(written)
+		return G_FS_READ_DIRECTORY_SUCCESSFUL;
+	return entry ? G_FS_READ_DIRECTORY_BUFFER_TOO_SMALL : G_FS_READ_DIRECTORY_EOD;
+}
+
 bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t len)
 {
 	int64_t seeked;
@@ -762,10 +1272,22 @@ bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t le
 	return true;
 }
 
+bool filesystemMapCachedPage(g_process* process, g_fd fd, uint64_t offset, g_virtual_address address)
+{
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(process, fd);
+	if(!descriptor)
+		return false;
+
+	g_fs_node* node = filesystemGetNode(descriptor->nodeId);
+	if(!node || !filesystemFindDelegate(node)->cachePages)
+		return false;
+
+	return filesystemPageCacheMapPage(node, G_FS_PAGE_CACHE_INDEX(offset), address);
+}
 
 bool filesystemGetFileName(g_fd fd, const char** outName)
 {
-	auto descriptor = filesystemProcessGetDescriptor(taskingGetCurrentTask()->process->id, fd);
+	auto descriptor = filesystemProcessGetDescriptor(taskingGetCurrentTask()->process, fd);
 	if(!descriptor)
 		return false;
 
@@ -837,7 +1359,7 @@ g_fs_stat_status filesystemStat(g_task* task, const char* path, g_fs_stat_data*
 
 g_fs_stat_status filesystemFstat(g_task* task, g_fd fd, g_fs_stat_data* out)
 {
-	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process->id, fd);
+	g_file_descriptor* descriptor = filesystemProcessGetDescriptor(task->process, fd);
 	if(!descriptor)
 		return G_FS_STAT_INVALID_FD;
 
@@ -24,11 +24,14 @@
 #include "kernel/tasking/tasking.hpp"
 #include "shared/system/mutex.hpp"
 #include <ghost/filesystem/types.h>
+#include <ghost/poll/types.h>
 
 struct g_fs_node;
 struct g_fs_node_entry;
 struct g_fs_delegate;
 struct g_file_descriptor;
+struct g_fs_page_cache_entry;
+struct g_fs_tasked_delegate;
 
 /**
  * A node on the virtual file system.
@@ -44,10 +47,23 @@ struct g_fs_node
     g_fs_node* parent;
     g_fs_node_entry* children;
 
+    /**
+     * Entry of this node in the children list of its parent, used to continue
+     * listing a directory from this node.
+     */
+    g_fs_node_entry* entry;
+
     g_fs_delegate* delegate;
 
     bool blocking;
     bool upToDate;
+
+    /**
+     * Pages of this file in the page cache. The generation changes whenever they are
+     * invalidated, so that a page that was read concurrently is not cached.
+     */
+    g_fs_page_cache_entry* cachedPages;
+    uint32_t cacheGeneration;
  };
 
 /**
@@ -72,12 +88,42 @@ struct g_fs_delegate
     g_fs_write_status (*write)(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length, int64_t* outWrote);
     g_fs_length_status (*getLength)(g_fs_node* node, uint64_t* outLength);
     g_fs_open_status (*create)(g_fs_node* parent, const char* name, g_fs_node** outFile);
-    g_fs_open_status (*truncate)(g_fs_node* file);
+    g_fs_open_status (*truncate)(g_fs_node* file, uint64_t length);
     g_fs_close_status (*close)(g_fs_node* node, g_file_flag_mode openFlags);
     g_fs_directory_refresh_status (*refreshDir)(g_fs_node* node);
 
-    void (*waitForRead)(g_tid task, g_fs_node* node);
-    void (*waitForWrite)(g_tid task, g_fs_node* node);
+    /**
+     * Writes back what the delegate buffered for the node. Delegates without this
+     * function have nothing to write back.
+     */
+    g_fs_sync_status (*sync)(g_fs_node* node);
+
+    /**
+     * Set if every file of this delegate is created through the VFS, so that a name
+     * the delegate could not discover can be remembered as missing.
+     */
+    bool cacheMisses;
+
+    /**
+     * Set if file contents only change through the VFS, so that they can be kept in
+     * the page cache.
+     */
+    bool cachePages;
+
+    /**
+     * Set for delegates that forward their requests to a task.
+     */
+    g_fs_tasked_delegate* tasked;
+
+    /**
+     * Exclusive waiters consume what they wait for and are woken one at a time,
+     * polling tasks wait non-exclusively.
+     */
+    void (*waitForRead)(g_tid task, g_fs_node* node, bool exclusive);
+    void (*waitForWrite)(g_tid task, g_fs_node* node, bool exclusive);
+    void (*unwaitForRead)(g_tid task, g_fs_node* node);
+    void (*unwaitForWrite)(g_tid task, g_fs_node* node);
+    g_poll_events (*poll)(g_fs_node* node);
 };
 
 struct g_filesystem_find_result
@@ -149,6 +195,21 @@ void filesystemAddChild(g_fs_node* parent, g_fs_node* child);
  */
 g_fs_delegate* filesystemCreateDelegate();
 
+/**
+ * Creates a mountpoint with the given name in "/mount" and makes the task its delegate.
+ */
+g_fs_register_as_delegate_status filesystemRegisterAsDelegate(g_task* task, const char* name,
+                                                              g_fs_phys_id physMountpointId,
+                                                              g_fs_virt_id* outMountpointId, g_address* outStorage);
+
+/**
+ * Creates or updates a node on behalf of a delegate task. The task must be the delegate
+ * responsible for the parent.
+ */
+g_fs_create_node_status filesystemCreateDelegateNode(g_task* task, g_fs_virt_id parentId, const char* name,
+                                                     g_fs_node_type type, g_fs_phys_id physicalId,
+                                                     g_fs_virt_id* outCreatedId);
+
 /**
  * Returns the file system root.
  */
@@ -163,9 +224,9 @@ g_fs_delegate* filesystemFindDelegate(g_fs_node* node);
  * Opens a file, creating a file descriptor.
  */
 g_fs_open_status filesystemOpen(const char* path, g_file_flag_mode flags, g_task* task, g_fd* outFd);
-g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_pid process,
+g_fs_open_status filesystemOpenNode(g_fs_node* file, g_file_flag_mode flags, g_process* process,
                                     g_file_descriptor** outDescriptor, g_fd optionalTargetFd = G_FD_NONE);
-g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g_pid process, g_fd* outFd,
+g_fs_open_status filesystemOpenNodeFd(g_fs_node* file, g_file_flag_mode flags, g_process* process, g_fd* outFd,
                                       g_fd optionalTargetFd = G_FD_NONE);
 
 /**
@@ -181,10 +242,37 @@ g_fs_write_status filesystemWrite(g_task* task, g_fd fd, uint8_t* buffer, uint64
 g_fs_write_status filesystemWrite(g_fs_node* file, uint8_t* buffer, uint64_t offset, uint64_t length,
                                   int64_t* outWrote);
 
+/**
+ * Reads into or writes from multiple buffers. Only waits for the first buffer, then
+ * transfers as much as possible without blocking.
+ */
+g_fs_read_status filesystemReadVector(g_task* task, g_fd fd, g_fs_iovec* vectors, uint32_t count, int64_t* outRead);
+g_fs_write_status filesystemWriteVector(g_task* task, g_fd fd, g_fs_iovec* vectors, uint32_t count,
+                                        int64_t* outWrote);
+
+/**
+ * Moves up to length bytes from one file to another through a kernel buffer.
+ */
+g_fs_splice_status filesystemSplice(g_task* task, g_fd in, g_fd out, uint64_t length, int64_t* outMoved);
+
+/**
+ * Checks which of the events would not block on the file. Files whose delegate can't
+ * block are always ready.
+ *
+ * @return the ready events or G_POLL_EVENT_INVALID if the descriptor does not exist
+ */
+g_poll_events filesystemPoll(g_task* task, g_fd fd, g_poll_events events);
+
+/**
+ * Adds the task to the wait queues of the file for the given events, or removes it again.
+ */
+void filesystemWaitForEvents(g_task* task, g_fd fd, g_poll_events events);
+void filesystemUnwaitForEvents(g_task* task, g_fd fd, g_poll_events events);
+
 /**
  * Closes a file descriptor.
  */
-g_fs_close_status filesystemClose(g_pid process, g_fd fd, g_bool removeDescriptor);
+g_fs_close_status filesystemClose(g_process* process, g_fd fd, g_bool removeDescriptor);
 
 /**
  * Seeks in a file.
@@ -197,20 +285,38 @@ g_fs_seek_status filesystemSeek(g_task* task, g_fd fd, g_fs_seek_mode mode, int6
 g_fs_length_status filesystemGetLength(g_fs_node* file, uint64_t* outLength);
 g_fs_length_status filesystemGetLength(g_task* task, g_fd fd, uint64_t* outLength);
 
+/**
+ * Makes the delegate of a file write back what it buffered, so that it is stored
+ * durably, or does so for all mounted file systems.
+ */
+g_fs_sync_status filesystemSync(g_task* task, g_fd fd);
+g_fs_sync_status filesystemSync(g_fs_node* node);
+g_fs_sync_status filesystemSyncAll();
+
 /**
  * Creates a file.
  */
 g_fs_open_status filesystemCreateFile(g_fs_node* parent, const char* name, g_fs_node** outFile);
 
 /**
- * Truncates a file.
+ * Sets the length of a file, opening a file with the truncate flag sets it to zero.
+ */
+g_fs_open_status filesystemTruncate(g_fs_node* file, uint64_t length);
+
+/**
+ * Sets the length of the file behind a descriptor that is open for writing.
+ */
+g_fs_truncate_status filesystemTruncate(g_task* task, g_fd fd, uint64_t length);
+
+/**
+ * Creates a new pipe on the filesystem. A capacity of zero uses the default capacity.
  */
-g_fs_open_status filesystemTruncate(g_fs_node* file);
+g_fs_pipe_status filesystemCreatePipe(g_bool blocking, uint32_t capacity, g_fs_node** outPipeNode);
 
 /**
- * Creates a new pipe on the filesystem.
+ * Changes the capacity of the pipe behind the file descriptor.
  */
-g_fs_pipe_status filesystemCreatePipe(g_bool blocking, g_fs_node** outPipeNode);
+g_fs_pipe_status filesystemSetPipeCapacity(g_task* task, g_fd fd, uint32_t capacity);
 
 /**
  * Writes the absolute path of node into the given buffer (which must be of G_PATH_MAX bytes size).
@@ -236,11 +342,28 @@ g_fs_open_directory_status filesystemOpenDirectory(g_fs_node* parent);
  */
 g_fs_read_directory_status filesystemReadDirectory(g_fs_node* parent, uint32_t index, g_fs_node** outChild);
 
+/**
+ * Writes as many directory records as fit into the buffer, starting at the child that
+ * the cursor refers to. As children are only ever added at the front of the list, the
+ * cursor stays valid while the directory changes.
+ */
+g_fs_read_directory_status filesystemReadDirectoryEntries(g_fs_node* dir, g_fs_directory_cursor* cursor,
+                                                          uint8_t* buffer, uint32_t length, uint32_t* outWritten);
+
 /**
  * Reads bytes from a file to a buffer in memory.
  */
 bool filesystemReadToMemory(g_fd fd, size_t offset, uint8_t* buffer, uint64_t len);
 
+/**
+ * Maps the page of a file at the page-aligned offset read-only into the current address
+ * space, sharing it with the page cache.
+ *
+ * @return whether the page was mapped, false if the file is not cached or the page is
+ * 		not completely within the file
+ */
+bool filesystemMapCachedPage(g_process* process, g_fd fd, uint64_t offset, g_virtual_address address);
+
 /**
  * Attempts to retrieve the real path of a path in the filesystem.
  */
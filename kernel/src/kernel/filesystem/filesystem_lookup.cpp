@@ -0,0 +1,166 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_lookup.hpp"
+#include "kernel/memory/heap.hpp"
+#include "shared/utils/string.hpp"
+
+static g_fs_lookup_entry** lookupBuckets;
+static g_mutex lookupLock;
+static volatile uint32_t lookupGeneration;
+
+uint32_t _filesystemLookupHash(g_fs_node* parent, const char* name);
+void _filesystemLookupPut(g_fs_node* parent, const char* name, g_fs_node* node);
+
+void filesystemLookupInitialize()
+{
+	mutexInitializeTask(&lookupLock, __func__);
+	lookupBuckets = (g_fs_lookup_entry**) heapAllocateClear(sizeof(g_fs_lookup_entry*) * G_FS_LOOKUP_BUCKETS);
+	lookupGeneration = 0;
+}
+
+uint32_t _filesystemLookupHash(g_fs_node* parent, const char* name)
+{
+	return ((uint32_t) stringHash(name)) ^ ((uint32_t) parent->id * 0x9E3779B1);
+}
+
+bool filesystemLookupGet(g_fs_node* parent, const char* name, g_fs_node** outNode)
+{
+	uint32_t hash = _filesystemLookupHash(parent, name);
+	g_fs_lookup_entry** bucket = &lookupBuckets[hash % G_FS_LOOKUP_BUCKETS];
+
+	mutexAcquire(&lookupLock);
+
+	g_fs_lookup_entry* previous = nullptr;
+	g_fs_lookup_entry* entry = *bucket;
+	while(entry)
+	{
+		if(entry->hash == hash && entry->parent == parent && stringEquals(entry->name, name))
+		{
+			// Move to front so that the least recently used entry is evicted
+			if(previous)
+			{
+				previous->next = entry->next;
+				entry->next = *bucket;
+				*bucket = entry;
+			}
+
+			*outNode = entry->node;
+			mutexRelease(&lookupLock);
+			return true;
+		}
+		previous = entry;
+		entry = entry->next;
+	}
+
+	mutexRelease(&lookupLock);
+	return false;
+}
+
+void filesystemLookupPutFound(g_fs_node* parent, const char* name, g_fs_node* node)
+{
+	mutexAcquire(&lookupLock);
+	_filesystemLookupPut(parent, name, node);
+	mutexRelease(&lookupLock);
+}
+
+void filesystemLookupPutMissing(g_fs_node* parent, const char* name, uint32_t generation)
+{
+	mutexAcquire(&lookupLock);
+	if(generation == lookupGeneration)
+		_filesystemLookupPut(parent, name, nullptr);
+	mutexRelease(&lookupLock);
+}
+
+uint32_t filesystemLookupGetGeneration()
+{
+	return lookupGeneration;
+}
+
+void _filesystemLookupPut(g_fs_node* parent, const char* name, g_fs_node* node)
+{
+	uint32_t hash = _filesystemLookupHash(parent, name);
+	g_fs_lookup_entry** bucket = &lookupBuckets[hash % G_FS_LOOKUP_BUCKETS];
+
+	g_fs_lookup_entry* previous = nullptr;
+	g_fs_lookup_entry* entry = *bucket;
+	uint32_t depth = 0;
+	while(entry)
+	{
+		if(entry->hash == hash && entry->parent == parent && stringEquals(entry->name, name))
+		{
+			entry->node = node;
+			return;
+		}
+
+		// Drop the least recently used entry of a full bucket
+		if(++depth == G_FS_LOOKUP_BUCKET_DEPTH)
+		{
+			previous->next = nullptr;
+			while(entry)
+			{
+				auto next = entry->next;
+				heapFree(entry->name);
+				heapFree(entry);
+				entry = next;
+			}
+			break;
+		}
+		previous = entry;
+		entry = entry->next;
+	}
+
+	entry = (g_fs_lookup_entry*) heapAllocate(sizeof(g_fs_lookup_entry));
+	entry->parent = parent;
+	entry->hash = hash;
+	entry->name = stringDuplicate(name);
+	entry->node = node;
+	entry->next = *bucket;
+	*bucket = entry;
+}
+
+void filesystemLookupInvalidate(g_fs_node* parent, const char* name)
+{
+	uint32_t hash = _filesystemLookupHash(parent, name);
+	g_fs_lookup_entry** bucket = &lookupBuckets[hash % G_FS_LOOKUP_BUCKETS];
+
+	mutexAcquire(&lookupLock);
+	lookupGeneration++;
+
+	g_fs_lookup_entry* previous = nullptr;
+	g_fs_lookup_entry* entry = *bucket;
+	while(entry)
+	{
+		if(entry->hash == hash && entry->parent == parent && stringEquals(entry->name, name))
+		{
+			if(previous)
+				previous->next = entry->next;
+			else
+				*bucket = entry->next;
+			heapFree(entry->name);
+			heapFree(entry);
+			break;
+		}
+		previous = entry;
+		entry = entry->next;
+	}
+
+	mutexRelease(&lookupLock);
+}
@@ -0,0 +1,83 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_LOOKUP__
+#define __KERNEL_FILESYSTEM_LOOKUP__
+
+#include "kernel/filesystem/filesystem.hpp"
+
+/**
+ * Size of the lookup cache. Each bucket keeps its most recently used entries in
+ * front and drops the last one when it is full.
+ */
+#define G_FS_LOOKUP_BUCKETS         4096
+#define G_FS_LOOKUP_BUCKET_DEPTH    4
+
+/**
+ * Cached result of looking up a name in a parent node. A null node means that the
+ * delegate reported the name as not found.
+ */
+struct g_fs_lookup_entry
+{
+    g_fs_node* parent;
+    uint32_t hash;
+    char* name;
+    g_fs_node* node;
+
+    g_fs_lookup_entry* next;
+};
+
+/**
+ * Initializes the lookup cache.
+ */
+void filesystemLookupInitialize();
+
+/**
+ * Looks up a name in the cache.
+ *
+ * @param outNode
+ * 		is filled with the cached node, or null for a cached miss
+ * @return whether there was an entry for the name
+ */
+bool filesystemLookupGet(g_fs_node* parent, const char* name, g_fs_node** outNode);
+
+/**
+ * Stores a found child.
+ */
+void filesystemLookupPutFound(g_fs_node* parent, const char* name, g_fs_node* node);
+
+/**
+ * Stores that a name does not exist. The entry is only stored if no child was added
+ * anywhere since the given generation, so a miss can not hide a concurrent create.
+ */
+void filesystemLookupPutMissing(g_fs_node* parent, const char* name, uint32_t generation);
+
+/**
+ * @return the current generation, to be passed to {filesystemLookupPutMissing}
+ */
+uint32_t filesystemLookupGetGeneration();
+
+/**
+ * Removes the entry for a name, must be called whenever a child is added, removed
+ * or renamed.
+ */
+void filesystemLookupInvalidate(g_fs_node* parent, const char* name);
+
+#endif
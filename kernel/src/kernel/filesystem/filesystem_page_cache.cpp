@@ -0,0 +1,508 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_page_cache.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/memory/page_reference_tracker.hpp"
+#include "shared/logger/logger.hpp"
+
+static g_fs_page_cache_entry* cacheEntries = nullptr;
+static g_fs_page_cache_entry** cacheBuckets;
+static g_fs_page_cache_entry* cacheFree;
+static g_fs_page_cache_entry* cacheReleased;
+static g_fs_page_cache_entry* cacheLruHead;
+static g_fs_page_cache_entry* cacheLruTail;
+static g_fs_page_cache_statistics cacheStatistics;
+static g_mutex cacheLock;
+
+/**
+ * Looks up a page and pins it. A missing page is read from the delegate. Returns null if
+ * the page is beyond the end of the file or reading failed, in which case outStatus is set.
+ * If there was no page available for the cache, outUncached is set.
+ */
+g_fs_page_cache_entry* _filesystemPageCacheGet(g_fs_node* node, uint64_t index, g_fs_read_status* outStatus,
+                                               bool* outUncached);
+
+/**
+ * Drops a pin taken by {_filesystemPageCacheGet}.
+ */
+void _filesystemPageCacheUnpin(g_fs_page_cache_entry* entry);
+
+/**
+ * Returns the content of an entry. Slots are remapped without notifying other processors,
+ * so the local TLB entry is dropped before each access.
+ */
+uint8_t* _filesystemPageCacheAccess(g_fs_page_cache_entry* entry);
+
+/**
+ * Takes a free slot and maps the given physical page to it. If there is no free slot or
+ * physical memory is low, the least recently used page is evicted first. If a released
+ * slot is reused, its previous page is put into outReleased to be freed by the caller.
+ */
+g_fs_page_cache_entry* _filesystemPageCacheAllocate(g_physical_address physical, g_physical_address* outReleased);
+
+/**
+ * Evicts the least recently used entry that is not pinned.
+ */
+bool _filesystemPageCacheEvict();
+
+/**
+ * Removes an entry from the hash table, the list of its node and the LRU list. The entry
+ * is released unless it is pinned.
+ */
+void _filesystemPageCacheRemove(g_fs_page_cache_entry* entry);
+
+/**
+ * Unmaps the page of an entry and puts the entry on the released list.
+ */
+void _filesystemPageCacheRelease(g_fs_page_cache_entry* entry);
+
+/**
+ * Frees the physical pages of all released entries and puts them on the free list. Physical
+ * pages are never allocated or freed while holding the cache lock, as the allocator takes
+ * the lock of the page reference tracker and the heap, which in turn allocates pages.
+ */
+void _filesystemPageCacheFreeReleased();
+
+void _filesystemPageCacheLruUnlink(g_fs_page_cache_entry* entry);
+void _filesystemPageCacheLruPush(g_fs_page_cache_entry* entry);
+g_fs_page_cache_entry** _filesystemPageCacheBucket(g_fs_node* node, uint64_t index);
+
+void filesystemPageCacheInitialize()
+{
+	mutexInitializeGlobal(&cacheLock, __func__);
+	memorySetBytes(&cacheStatistics, 0, sizeof(g_fs_page_cache_statistics));
+
+	uint32_t capacity = memoryPhysicalAllocator.freePageCount / G_FS_PAGE_CACHE_MEMORY_DIVISOR;
+	if(capacity > G_FS_PAGE_CACHE_MAXIMUM_PAGES)
+		capacity = G_FS_PAGE_CACHE_MAXIMUM_PAGES;
+
+	g_virtual_address window = addressRangePoolAllocate(memoryVirtualRangePool, capacity);
+	if(!window)
+	{
+		logWarn("%! failed to reserve a virtual window, file pages are not cached", "pagecache");
+		capacity = 0;
+	}
+
+	cacheBuckets = (g_fs_page_cache_entry**) heapAllocateClear(sizeof(g_fs_page_cache_entry*) * G_FS_PAGE_CACHE_BUCKETS);
+	cacheFree = nullptr;
+	cacheReleased = nullptr;
+	cacheLruHead = nullptr;
+	cacheLruTail = nullptr;
+
+	if(capacity)
+	{
+		cacheEntries = (g_fs_page_cache_entry*) heapAllocateClear(sizeof(g_fs_page_cache_entry) * capacity);
+		for(uint32_t i = capacity; i > 0; i--)
+		{
+			g_fs_page_cache_entry* entry = &cacheEntries[i - 1];
+			entry->virt = window + (i - 1) * G_PAGE_SIZE;
+			entry->nextInBucket = cacheFree;
+			cacheFree = entry;
+		}
+	}
+	cacheStatistics.capacity = capacity;
+
+	logInfo("%! up to %i pages (%i KiB)", "pagecache", capacity, capacity * (G_PAGE_SIZE / 1024));
+}
+
+g_fs_read_status filesystemPageCacheRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length,
+                                         int64_t* outRead)
+{
+	uint64_t done = 0;
+	while(done < length)
+	{
+		uint64_t position = offset + done;
+		uint32_t inPage = position & (G_PAGE_SIZE - 1);
+
+		g_fs_read_status status;
+		bool uncached;
+		g_fs_page_cache_entry* entry = _filesystemPageCacheGet(node, G_FS_PAGE_CACHE_INDEX(position), &status, &uncached);
+		if(!entry)
+		{
+			if(uncached)
+			{
+				int64_t read = 0;
+				status = filesystemFindDelegate(node)->read(node, buffer + done, position, length - done, &read);
+				if(read > 0)
+					done += read;
+			}
+
+			if(status != G_FS_READ_SUCCESSFUL && done == 0)
+			{
+				_filesystemPageCacheFreeReleased();
+				return status;
+			}
+			break;
+		}
+
+		uint32_t pageLength = entry->length;
+		uint32_t available = pageLength > inPage ? pageLength - inPage : 0;
+		uint32_t copy = length - done < available ? length - done : available;
+		memoryCopy(buffer + done, _filesystemPageCacheAccess(entry) + inPage, copy);
+		_filesystemPageCacheUnpin(entry);
+
+		done += copy;
+		if(pageLength < G_PAGE_SIZE)
+			break;
+	}
+	_filesystemPageCacheFreeReleased();
+
+	*outRead = done;
+	return G_FS_READ_SUCCESSFUL;
+}
+
+bool filesystemPageCacheMapPage(g_fs_node* node, uint64_t index, g_virtual_address address)
+{
+	g_fs_read_status status;
+	bool uncached;
+	g_fs_page_cache_entry* entry = _filesystemPageCacheGet(node, index, &status, &uncached);
+	if(!entry)
+	{
+		_filesystemPageCacheFreeReleased();
+		return false;
+	}
+
+	bool full = entry->length == G_PAGE_SIZE;
+	if(full)
+	{
+		pageReferenceTrackerIncrement(entry->physical);
+		pagingMapPage(address, entry->physical, G_PAGE_TABLE_USER_DEFAULT, G_PAGE_PRESENT | G_PAGE_USERSPACE);
+	}
+
+	mutexAcquire(&cacheLock);
+	if(full)
+		cacheStatistics.mapped++;
+	mutexRelease(&cacheLock);
+
+	_filesystemPageCacheUnpin(entry);
+	_filesystemPageCacheFreeReleased();
+	return full;
+}
+
+void filesystemPageCacheInvalidate(g_fs_node* node, uint64_t offset)
+{
+	uint64_t index = G_FS_PAGE_CACHE_INDEX(offset);
+
+	mutexAcquire(&cacheLock);
+	node->cacheGeneration++;
+
+	g_fs_page_cache_entry* entry = node->cachedPages;
+	while(entry)
+	{
+		g_fs_page_cache_entry* next = entry->nodeNext;
+		if(entry->index >= index || entry->length < G_PAGE_SIZE)
+			_filesystemPageCacheRemove(entry);
+		entry = next;
+	}
+	mutexRelease(&cacheLock);
+
+	_filesystemPageCacheFreeReleased();
+}
+
+uint32_t filesystemPageCacheReclaim(uint32_t count)
+{
+	if(!cacheEntries)
+		return 0;
+
+	mutexAcquire(&cacheLock);
+	uint32_t evicted = 0;
+	while(evicted < count && _filesystemPageCacheEvict())
+		evicted++;
+	mutexRelease(&cacheLock);
+
+	_filesystemPageCacheFreeReleased();
+	return evicted;
+}
+
+void filesystemPageCacheTrim()
+{
+	while(memoryPhysicalAllocator.freePageCount < G_FS_PAGE_CACHE_RESERVED_PAGES &&
+	      filesystemPageCacheReclaim(G_FS_PAGE_CACHE_RECLAIM_BATCH))
+	{
+	}
+}
+
+void filesystemPageCacheGetStatistics(g_fs_page_cache_statistics* out)
+{
+	mutexAcquire(&cacheLock);
+	memoryCopy(out, &cacheStatistics, sizeof(g_fs_page_cache_statistics));
+	mutexRelease(&cacheLock);
+}
+
+g_fs_page_cache_entry* _filesystemPageCacheGet(g_fs_node* node, uint64_t index, g_fs_read_status* outStatus,
+                                               bool* outUncached)
+{
+	*outStatus = G_FS_READ_SUCCESSFUL;
+	*outUncached = false;
+
+	g_fs_page_cache_entry** bucket = _filesystemPageCacheBucket(node, index);
+
+	mutexAcquire(&cacheLock);
+	g_fs_page_cache_entry* entry = *bucket;
+	while(entry && (entry->node != node || entry->index != index))
+		entry = entry->nextInBucket;
+
+	if(entry)
+	{
+		entry->pins++;
+		_filesystemPageCacheLruUnlink(entry);
+		_filesystemPageCacheLruPush(entry);
+		cacheStatistics.hits++;
+		mutexRelease(&cacheLock);
+		return entry;
+	}
+
+	cacheStatistics.misses++;
+	uint32_t generation = node->cacheGeneration;
+	mutexRelease(&cacheLock);
+
+	g_physical_address physical = memoryPhysicalAllocate();
+	if(!physical)
+	{
+		*outUncached = true;
+		return nullptr;
+	}
+
+	mutexAcquire(&cacheLock);
+	g_physical_address released = 0;
+	entry = _filesystemPageCacheAllocate(physical, &released);
+	if(entry)
+		entry->pins = 1;
+	mutexRelease(&cacheLock);
+
+	memoryPhysicalFree(released);
+	if(!entry)
+	{
+		memoryPhysicalFree(physical);
+		*outUncached = true;
+		return nullptr;
+	}
+
+	// Fill outside of the lock as the delegate may take a while
+	g_fs_delegate* delegate = filesystemFindDelegate(node);
+	uint8_t* content = _filesystemPageCacheAccess(entry);
+	uint32_t filled = 0;
+	while(filled < G_PAGE_SIZE)
+	{
+		int64_t read = 0;
+		g_fs_read_status status = delegate->read(node, content + filled, index * G_PAGE_SIZE + filled,
+		                                         G_PAGE_SIZE - filled, &read);
+		if(status != G_FS_READ_SUCCESSFUL)
+		{
+			*outStatus = status;
+			break;
+		}
+		if(read <= 0)
+			break;
+		filled += read;
+	}
+
+	mutexAcquire(&cacheLock);
+	if(*outStatus != G_FS_READ_SUCCESSFUL || filled == 0)
+	{
+		entry->pins--;
+		_filesystemPageCacheRelease(entry);
+		mutexRelease(&cacheLock);
+		return nullptr;
+	}
+
+	entry->node = node;
+	entry->index = index;
+	entry->length = filled;
+
+	// If the file changed while reading or another task was faster, the page is only
+	// used for this access
+	g_fs_page_cache_entry* existing = *bucket;
+	while(existing && (existing->node != node || existing->index != index))
+		existing = existing->nextInBucket;
+
+	if(!existing && generation == node->cacheGeneration)
+	{
+		entry->cached = true;
+		entry->nextInBucket = *bucket;
+		*bucket = entry;
+		_filesystemPageCacheLruPush(entry);
+
+		entry->nodePrevious = nullptr;
+		entry->nodeNext = node->cachedPages;
+		if(node->cachedPages)
+			node->cachedPages->nodePrevious = entry;
+		node->cachedPages = entry;
+
+		cacheStatistics.pages++;
+	}
+	mutexRelease(&cacheLock);
+	return entry;
+}
+
+void _filesystemPageCacheUnpin(g_fs_page_cache_entry* entry)
+{
+	mutexAcquire(&cacheLock);
+	entry->pins--;
+	if(entry->pins == 0 && !entry->cached)
+		_filesystemPageCacheRelease(entry);
+	mutexRelease(&cacheLock);
+}
+
+uint8_t* _filesystemPageCacheAccess(g_fs_page_cache_entry* entry)
+{
+	pagingInvalidatePage(entry->virt);
+	return (uint8_t*) entry->virt;
+}
+
+g_fs_page_cache_entry* _filesystemPageCacheAllocate(g_physical_address physical, g_physical_address* outReleased)
+{
+	// Under memory pressure the cache does not grow but replaces its own pages
+	if(((!cacheFree && !cacheReleased) || memoryPhysicalAllocator.freePageCount < G_FS_PAGE_CACHE_RESERVED_PAGES) &&
+	   !_filesystemPageCacheEvict())
+		return nullptr;
+
+	g_fs_page_cache_entry* entry;
+	if(cacheFree)
+	{
+		entry = cacheFree;
+		cacheFree = entry->nextInBucket;
+	}
+	else if(cacheReleased)
+	{
+		entry = cacheReleased;
+		cacheReleased = entry->nextInBucket;
+		*outReleased = entry->physical;
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	entry->physical = physical;
+	entry->nextInBucket = nullptr;
+	entry->cached = false;
+	pagingMapPage(entry->virt, physical, G_PAGE_TABLE_KERNEL_DEFAULT, G_PAGE_KERNEL_DEFAULT);
+	return entry;
+}
+
+bool _filesystemPageCacheEvict()
+{
+	g_fs_page_cache_entry* entry = cacheLruTail;
+	while(entry && entry->pins)
+		entry = entry->lruPrevious;
+
+	if(!entry)
+		return false;
+
+	_filesystemPageCacheRemove(entry);
+	cacheStatistics.evictions++;
+	return true;
+}
+
+void _filesystemPageCacheRemove(g_fs_page_cache_entry* entry)
+{
+	g_fs_page_cache_entry** bucket = _filesystemPageCacheBucket(entry->node, entry->index);
+	while(*bucket != entry)
+		bucket = &(*bucket)->nextInBucket;
+	*bucket = entry->nextInBucket;
+
+	_filesystemPageCacheLruUnlink(entry);
+
+	if(entry->nodePrevious)
+		entry->nodePrevious->nodeNext = entry->nodeNext;
+	else
+		entry->node->cachedPages = entry->nodeNext;
+	if(entry->nodeNext)
+		entry->nodeNext->nodePrevious = entry->nodePrevious;
+
+	entry->cached = false;
+	cacheStatistics.pages--;
+
+	if(entry->pins == 0)
+		_filesystemPageCacheRelease(entry);
+}
+
+void _filesystemPageCacheRelease(g_fs_page_cache_entry* entry)
+{
+	pagingUnmapPage(entry->virt);
+
+	entry->node = nullptr;
+	entry->nextInBucket = cacheReleased;
+	cacheReleased = entry;
+}
+
+void _filesystemPageCacheFreeReleased()
+{
+	// Reading without the lock is fine, a missed entry is freed by the next call
+	if(!cacheReleased)
+		return;
+
+	mutexAcquire(&cacheLock);
+	g_fs_page_cache_entry* released = cacheReleased;
+	cacheReleased = nullptr;
+	mutexRelease(&cacheLock);
+
+	if(!released)
+		return;
+
+	g_fs_page_cache_entry* last = released;
+	for(g_fs_page_cache_entry* entry = released; entry; entry = entry->nextInBucket)
+	{
+		memoryPhysicalFree(entry->physical);
+		entry->physical = 0;
+		last = entry;
+	}
+
+	mutexAcquire(&cacheLock);
+	last->nextInBucket = cacheFree;
+	cacheFree = released;
+	mutexRelease(&cacheLock);
+}
+
+void _filesystemPageCacheLruUnlink(g_fs_page_cache_entry* entry)
+{
+	if(entry->lruPrevious)
+		entry->lruPrevious->lruNext = entry->lruNext;
+	else
+		cacheLruHead = entry->lruNext;
+
+	if(entry->lruNext)
+		entry->lruNext->lruPrevious = entry->lruPrevious;
+	else
+		cacheLruTail = entry->lruPrevious;
+
+	entry->lruPrevious = nullptr;
+	entry->lruNext = nullptr;
+}
+
+void _filesystemPageCacheLruPush(g_fs_page_cache_entry* entry)
+{
+	entry->lruPrevious = nullptr;
+	entry->lruNext = cacheLruHead;
+	if(cacheLruHead)
+		cacheLruHead->lruPrevious = entry;
+	else
+		cacheLruTail = entry;
+	cacheLruHead = entry;
+}
+
+g_fs_page_cache_entry** _filesystemPageCacheBucket(g_fs_node* node, uint64_t index)
+{
+	uint32_t hash = ((uint32_t) index * 0x9E3779B1) ^ ((uint32_t) node->id * 0x85EBCA6B);
+	return &cacheBuckets[(hash >> 16) % G_FS_PAGE_CACHE_BUCKETS];
+}
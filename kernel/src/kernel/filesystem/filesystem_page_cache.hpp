@@ -0,0 +1,132 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_PAGE_CACHE__
+#define __KERNEL_FILESYSTEM_PAGE_CACHE__
+
+#include "kernel/filesystem/filesystem.hpp"
+
+/**
+ * The cache takes up to a quarter of the free physical memory at boot, but never more
+ * than the maximum. It stops growing and reuses its least recently used pages once
+ * fewer than the reserved number of physical pages are free.
+ */
+#define G_FS_PAGE_CACHE_MAXIMUM_PAGES   8192
+#define G_FS_PAGE_CACHE_MEMORY_DIVISOR  4
+#define G_FS_PAGE_CACHE_RESERVED_PAGES  1024
+#define G_FS_PAGE_CACHE_BUCKETS         4096
+
+/**
+ * Number of pages that are evicted at once when physical memory runs low.
+ */
+#define G_FS_PAGE_CACHE_RECLAIM_BATCH   64
+
+#define G_FS_PAGE_CACHE_INDEX(offset)   ((offset) >> 12)
+
+/**
+ * A page of file content. Each entry owns one slot of the virtual window of the cache,
+ * where its physical page is mapped to the kernel.
+ */
+struct g_fs_page_cache_entry
+{
+    g_fs_node* node;
+    uint64_t index;
+
+    /**
+     * Number of valid bytes, only the last page of a file is not full.
+     */
+    uint32_t length;
+
+    /**
+     * Released entries keep their physical page until it is freed outside of the cache lock.
+     */
+    g_physical_address physical;
+    g_virtual_address virt;
+
+    /**
+     * Pinned entries are in use outside of the cache lock and are not evicted. An entry
+     * that was removed while pinned is released when the last pin is dropped.
+     */
+    uint32_t pins;
+    bool cached;
+
+    g_fs_page_cache_entry* nextInBucket;
+    g_fs_page_cache_entry* lruPrevious;
+    g_fs_page_cache_entry* lruNext;
+    g_fs_page_cache_entry* nodePrevious;
+    g_fs_page_cache_entry* nodeNext;
+};
+
+struct g_fs_page_cache_statistics
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t mapped;
+    uint32_t pages;
+    uint32_t capacity;
+};
+
+/**
+ * Initializes the page cache, must be called after the memory management.
+ */
+void filesystemPageCacheInitialize();
+
+/**
+ * Reads from a file through the cache. Missing pages are read from the delegate as a
+ * whole. If no page can be allocated for the cache, the delegate is read directly.
+ */
+g_fs_read_status filesystemPageCacheRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length,
+                                         int64_t* outRead);
+
+/**
+ * Maps the cached page with the given index read-only into the current address space.
+ * The physical page is shared with the cache and stays alive while it is mapped.
+ *
+ * @return whether the page was mapped, false if it is not a full page of the file
+ */
+bool filesystemPageCacheMapPage(g_fs_node* node, uint64_t index, g_virtual_address address);
+
+/**
+ * Drops all cached pages of a file from the given offset on, and any partial page as
+ * it might have grown. Must be called after the content of a file has changed. Pages
+ * that are already mapped into processes keep their content.
+ */
+void filesystemPageCacheInvalidate(g_fs_node* node, uint64_t offset);
+
+/**
+ * Evicts up to the given number of least recently used pages.
+ *
+ * @return the number of evicted pages
+ */
+uint32_t filesystemPageCacheReclaim(uint32_t count);
+
+/**
+ * Evicts pages while fewer than the reserved number of physical pages are free. Must be
+ * called without holding any locks, as it frees physical pages.
+ */
+void filesystemPageCacheTrim();
+
+/**
+ * Fills the statistics of the cache.
+ */
+void filesystemPageCacheGetStatistics(g_fs_page_cache_statistics* out);
+
+#endif
@@ -53,17 +53,32 @@ g_fs_length_status filesystemPipeDelegateGetLength(g_fs_node* node, uint64_t* ou
 	return pipeGetLength(node->physicalId, outLength);
 }
 
-g_fs_open_status filesystemPipeDelegateTruncate(g_fs_node* file)
+g_fs_open_status filesystemPipeDelegateTruncate(g_fs_node* file, uint64_t length)
 {
 	return pipeTruncate(file->physicalId);
 }
 
-void filesystemPipeDelegateWaitForRead(g_tid task, g_fs_node* node)
+void filesystemPipeDelegateWaitForRead(g_tid task, g_fs_node* node, bool exclusive)
 {
-	pipeWaitForRead(task, node->physicalId);
+	pipeWaitForRead(task, node->physicalId, exclusive);
 }
 
-void filesystemPipeDelegateWaitForWrite(g_tid task, g_fs_node* node)
+void filesystemPipeDelegateWaitForWrite(g_tid task, g_fs_node* node, bool exclusive)
 {
-	pipeWaitForWrite(task, node->physicalId);
+	pipeWaitForWrite(task, node->physicalId, exclusive);
+}
+
+void filesystemPipeDelegateUnwaitForRead(g_tid task, g_fs_node* node)
+{
+	pipeUnwaitForRead(task, node->physicalId);
+}
+
+void filesystemPipeDelegateUnwaitForWrite(g_tid task, g_fs_node* node)
+{
+	pipeUnwaitForWrite(task, node->physicalId);
+}
+
+g_poll_events filesystemPipeDelegatePoll(g_fs_node* node)
+{
+	return pipePoll(node->physicalId);
 }
@@ -37,10 +37,16 @@ g_fs_write_status filesystemPipeDelegateWrite(g_fs_node* node, uint8_t* buffer,
 
 g_fs_length_status filesystemPipeDelegateGetLength(g_fs_node* node, uint64_t* outLength);
 
-g_fs_open_status filesystemPipeDelegateTruncate(g_fs_node* file);
+g_fs_open_status filesystemPipeDelegateTruncate(g_fs_node* file, uint64_t length);
 
-void filesystemPipeDelegateWaitForRead(g_tid task, g_fs_node* node);
+void filesystemPipeDelegateWaitForRead(g_tid task, g_fs_node* node, bool exclusive);
 
-void filesystemPipeDelegateWaitForWrite(g_tid task, g_fs_node* node);
+void filesystemPipeDelegateWaitForWrite(g_tid task, g_fs_node* node, bool exclusive);
+
+void filesystemPipeDelegateUnwaitForRead(g_tid task, g_fs_node* node);
+
+void filesystemPipeDelegateUnwaitForWrite(g_tid task, g_fs_node* node);
+
+g_poll_events filesystemPipeDelegatePoll(g_fs_node* node);
 
 #endif
@@ -22,105 +22,201 @@
 #include "kernel/memory/memory.hpp"
 #include "shared/logger/logger.hpp"
 
-static g_hashmap<g_pid, g_filesystem_process*>* filesystemProcessInfo;
+/**
+ * Allocates a zeroed descriptor table with the given capacity.
+ */
+g_file_descriptor_table* _filesystemProcessCreateTable(uint32_t capacity);
+
+/**
+ * Grows the table so that it can hold the given descriptor. Must be called while holding
+ * the process file system lock.
+ */
+bool _filesystemProcessEnsureCapacity(g_filesystem_process* info, g_fd fd);
+
+/**
+ * Resolves the process with the given id.
+ */
+g_process* _filesystemProcessGetById(g_pid pid);
 
-void filesystemProcessInitialize()
+void filesystemProcessCreate(g_process* process)
 {
-	filesystemProcessInfo = hashmapCreateNumeric<g_pid, g_filesystem_process*>(128);
+	g_filesystem_process* info = (g_filesystem_process*) heapAllocate(sizeof(g_filesystem_process));
+	mutexInitializeTask(&info->lock, __func__);
+	info->table = _filesystemProcessCreateTable(G_FILESYSTEM_PROCESS_INITIAL_CAPACITY);
+	info->lowestFree = G_FILESYSTEM_PROCESS_FIRST_FD;
+
+	process->filesystem = info;
 }
 
-void filesystemProcessCreate(g_pid pid)
+g_file_descriptor_table* _filesystemProcessCreateTable(uint32_t capacity)
 {
-	g_filesystem_process* info = (g_filesystem_process*) heapAllocate(sizeof(g_filesystem_process));
+	g_file_descriptor_table* table = (g_file_descriptor_table*) heapAllocate(sizeof(g_file_descriptor_table));
+	table->capacity = capacity;
+	table->entries = (g_file_descriptor**) heapAllocateClear(sizeof(g_file_descriptor*) * capacity);
+	table->retired = nullptr;
+	return table;
+}
 
-	info->nextDescriptor = 3; // after stdin, stdout, stderr
-	mutexInitializeTask(&info->nextDescriptorLock, __func__);
-	info->descriptors = hashmapCreateNumeric<g_fd, g_file_descriptor*>(128);
+bool _filesystemProcessEnsureCapacity(g_filesystem_process* info, g_fd fd)
+{
+	g_file_descriptor_table* current = info->table;
+	if((uint32_t) fd < current->capacity)
+		return true;
+
+	if(fd >= G_FILESYSTEM_PROCESS_MAXIMUM_CAPACITY)
+		return false;
+
+	uint32_t capacity = current->capacity;
+	while(capacity <= (uint32_t) fd)
+		capacity *= 2;
 
-	hashmapPut(filesystemProcessInfo, pid, info);
+	g_file_descriptor_table* grown = _filesystemProcessCreateTable(capacity);
+	memoryCopy(grown->entries, current->entries, sizeof(g_file_descriptor*) * current->capacity);
+	grown->retired = current;
+	info->table = grown;
+	return true;
 }
 
-g_fs_open_status filesystemProcessCreateDescriptor(g_pid pid, g_fs_virt_id nodeId, g_file_flag_mode flags, g_file_descriptor** outDescriptor, g_fd optionalFd)
+g_fs_open_status filesystemProcessCreateDescriptor(g_process* process, g_fs_virt_id nodeId, g_file_flag_mode flags,
+                                                   g_file_descriptor** outDescriptor, g_fd optionalFd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
 	{
-		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", pid);
+		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", process->id);
 		return G_FS_OPEN_ERROR;
 	}
 
-	g_file_descriptor* descriptor = (g_file_descriptor*) heapAllocate(sizeof(g_file_descriptor));
+	mutexAcquire(&info->lock);
 
-	if(optionalFd == G_FD_NONE)
+	g_fd fd = optionalFd;
+	if(fd == G_FD_NONE)
 	{
-		mutexAcquire(&info->nextDescriptorLock);
-		descriptor->id = info->nextDescriptor++;
-		mutexRelease(&info->nextDescriptorLock);
+		fd = info->lowestFree;
+		g_file_descriptor_table* table = info->table;
+		while((uint32_t) fd < table->capacity && table->entries[fd])
+			++fd;
 	}
-	else
+
+	if(fd < 0 || !_filesystemProcessEnsureCapacity(info, fd))
 	{
-		descriptor->id = optionalFd;
+		mutexRelease(&info->lock);
+		logInfo("%! process %i ran out of file descriptors", "filesystem", process->id);
+		return G_FS_OPEN_ERROR;
 	}
+
+	g_file_descriptor_table* table = info->table;
+	g_file_descriptor* descriptor = table->entries[fd];
+	if(!descriptor)
+		descriptor = (g_file_descriptor*) heapAllocate(sizeof(g_file_descriptor));
+
+	descriptor->id = fd;
 	descriptor->nodeId = nodeId;
 	descriptor->offset = 0;
 	descriptor->openFlags = flags;
+	table->entries[fd] = descriptor;
+
+	if(fd == info->lowestFree)
+		info->lowestFree = fd + 1;
+
+	mutexRelease(&info->lock);
 
-	hashmapPut<g_fd, g_file_descriptor*>(info->descriptors, descriptor->id, descriptor);
 	*outDescriptor = descriptor;
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
-g_file_descriptor* filesystemProcessGetDescriptor(g_pid pid, g_fd fd)
+g_file_descriptor* filesystemProcessGetDescriptor(g_process* process, g_fd fd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
-	{
-		logInfo("%! tried to create file descriptor in process %i that doesn't exist", "filesystem", pid);
-		return 0;
-	}
+		return nullptr;
+
+	g_file_descriptor_table* table = info->table;
+	if(fd < 0 || (uint32_t) fd >= table->capacity)
+		return nullptr;
 
-	return hashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
+	return table->entries[fd];
 }
 
-void filesystemProcessRemove(g_pid pid)
+void filesystemProcessRemove(g_process* process)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
 		return;
 
-	g_hashmap_iterator<g_fd, g_file_descriptor*> iter = hashmapIteratorStart<g_fd, g_file_descriptor*>(info->descriptors);
-	while(hashmapIteratorHasNext<g_fd, g_file_descriptor*>(&iter))
+	g_file_descriptor_table* table = info->table;
+	for(uint32_t fd = 0; fd < table->capacity; fd++)
+	{
+		g_file_descriptor* descriptor = table->entries[fd];
+		if(!descriptor)
+			continue;
+
+		filesystemClose(process, fd, false);
+		heapFree(descriptor);
+	}
+
+	while(table)
 	{
-		g_hashmap_entry<g_fd, g_file_descriptor*>* entry = hashmapIteratorNext<g_fd, g_file_descriptor*>(&iter);
-		filesystemClose(pid, entry->key, false);
-		heapFree(entry->value);
+		g_file_descriptor_table* retired = table->retired;
+		heapFree(table->entries);
+		heapFree(table);
+		table = retired;
 	}
-	hashmapIteratorEnd<g_fd, g_file_descriptor*>(&iter);
 
-	hashmapRemove<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid);
+	process->filesystem = nullptr;
 	heapFree(info);
 }
 
-void filesystemProcessRemoveDescriptor(g_pid pid, g_fd fd)
+void filesystemProcessRemoveDescriptor(g_process* process, g_fd fd)
 {
-	g_filesystem_process* info = hashmapGet<g_pid, g_filesystem_process*>(filesystemProcessInfo, pid, 0);
+	g_filesystem_process* info = process->filesystem;
 	if(!info)
 		return;
 
-	g_file_descriptor* descriptor = hashmapGet<g_fd, g_file_descriptor*>(info->descriptors, fd, 0);
-	if(!descriptor)
-		return;
+	mutexAcquire(&info->lock);
+
+	g_file_descriptor_table* table = info->table;
+	g_file_descriptor* descriptor = nullptr;
+	if(fd >= 0 && (uint32_t) fd < table->capacity)
+	{
+		descriptor = table->entries[fd];
+		table->entries[fd] = nullptr;
+
+		if(descriptor && fd >= G_FILESYSTEM_PROCESS_FIRST_FD && fd < info->lowestFree)
+			info->lowestFree = fd;
+	}
+
+	mutexRelease(&info->lock);
+
+	if(descriptor)
+		heapFree(descriptor);
+}
 
-	hashmapRemove(info->descriptors, fd);
-	heapFree(descriptor);
+g_process* _filesystemProcessGetById(g_pid pid)
+{
+	g_task* main = taskingGetById(pid);
+	if(!main)
+		return nullptr;
+	return main->process;
 }
 
 g_fs_clonefd_status filesystemProcessCloneDescriptor(g_pid sourcePid, g_fd sourceFd, g_pid targetPid, g_fd targetFd, g_fd* outFd)
 {
+	g_process* source = _filesystemProcessGetById(sourcePid);
+	if(!source)
+		return G_FS_CLONEFD_INVALID_SOURCE_FD;
+
+	g_process* target = _filesystemProcessGetById(targetPid);
+	if(!target)
+	{
+		logInfo("%! failed to clone descriptor %i to process %i, process not found", "fs", sourceFd, targetPid);
+		return G_FS_CLONEFD_ERROR;
+	}
+
 	if(targetFd != G_FD_NONE)
-		filesystemClose(targetPid, targetFd, true);
+		filesystemClose(target, targetFd, true);
 
-	g_file_descriptor* sourceDescriptor = filesystemProcessGetDescriptor(sourcePid, sourceFd);
+	g_file_descriptor* sourceDescriptor = filesystemProcessGetDescriptor(source, sourceFd);
 	if(!sourceDescriptor)
 		return G_FS_CLONEFD_INVALID_SOURCE_FD;
 
@@ -132,7 +228,7 @@ g_fs_clonefd_status filesystemProcessCloneDescriptor(g_pid sourcePid, g_fd sourc
 	}
 
 	g_file_descriptor* createdFd;
-	g_fs_open_status status = filesystemOpenNode(node, sourceDescriptor->openFlags, targetPid, &createdFd, targetFd);
+	g_fs_open_status status = filesystemOpenNode(node, sourceDescriptor->openFlags, target, &createdFd, targetFd);
 	if(status != G_FS_OPEN_SUCCESSFUL)
 	{
 		logInfo("%! failed to clone descriptor %i to process %i in descriptor %i with status %i", "fs", sourceDescriptor->id, targetPid, targetFd, status);
@@ -22,10 +22,17 @@
 #define __KERNEL_FILESYSTEM_PROCESS__
 
 #include "kernel/filesystem/filesystem.hpp"
-#include "kernel/utils/hashmap.hpp"
 
 #include <ghost/filesystem/types.h>
 
+/**
+ * Descriptors 0 to 2 are reserved for stdio, others are allocated starting here.
+ */
+#define G_FILESYSTEM_PROCESS_FIRST_FD           3
+
+#define G_FILESYSTEM_PROCESS_INITIAL_CAPACITY   32
+#define G_FILESYSTEM_PROCESS_MAXIMUM_CAPACITY   0x10000
+
 /**
  * Structure of a file descriptor.
  */
@@ -38,45 +45,60 @@ struct g_file_descriptor
 };
 
 /**
- * Per-process file system information structure.
+ * Array of descriptors indexed by their number. When the table grows, the previous
+ * array is kept in the "retired" list until the process is removed, so that lookups
+ * that still hold the old array never read freed memory and don't need a lock.
  */
-struct g_filesystem_process
+struct g_file_descriptor_table
 {
-    g_fd nextDescriptor;
-    g_mutex nextDescriptorLock;
-    g_hashmap<g_fd, g_file_descriptor*>* descriptors;
+    uint32_t capacity;
+    g_file_descriptor** entries;
+    g_file_descriptor_table* retired;
 };
 
 /**
- * Initializes this unit.
+ * Per-process file system information structure.
  */
-void filesystemProcessInitialize();
+struct g_filesystem_process
+{
+    /**
+     * Held when modifying the table; lookups only read the current table pointer.
+     */
+    g_mutex lock;
+    g_file_descriptor_table* volatile table;
+
+    /**
+     * Slots below this index are known to be in use.
+     */
+    g_fd lowestFree;
+};
 
 /**
- * Creates a file system information structure for a process.
+ * Creates the file system information structure for a process.
  */
-void filesystemProcessCreate(g_pid pid);
+void filesystemProcessCreate(g_process* process);
 
 /**
  * Removes file system information for a process. Closes all file descriptors of this process.
  */
-void filesystemProcessRemove(g_pid pid);
+void filesystemProcessRemove(g_process* process);
 
 /**
- * Creates a file descriptor opening a node.
+ * Creates a file descriptor opening a node. If no descriptor number is given, the lowest
+ * free one is used.
  */
-g_fs_open_status filesystemProcessCreateDescriptor(g_pid pid, g_fs_virt_id nodeId, g_file_flag_mode flags,
+g_fs_open_status filesystemProcessCreateDescriptor(g_process* process, g_fs_virt_id nodeId, g_file_flag_mode flags,
                                                    g_file_descriptor** outDescriptor, g_fd optionalFd = G_FD_NONE);
 
 /**
  * Finds a file descriptor.
  */
-g_file_descriptor* filesystemProcessGetDescriptor(g_pid pid, g_fd fd);
+g_file_descriptor* filesystemProcessGetDescriptor(g_process* process, g_fd fd);
 
 /**
  * Closes a file descriptor.
  */
-void filesystemProcessRemoveDescriptor(g_pid pid, g_fd fd);
+void filesystemProcessRemoveDescriptor(g_process* process, g_fd fd);
 
 /**
  * Clones a file descriptor.
@@ -71,11 +71,11 @@ g_fs_read_status filesystemRamdiskDelegateRead(g_fs_node* node, uint8_t* buffer,
 	if(!entry)
 		return G_FS_READ_ERROR;
 
-	if(offset + length > entry->dataSize)
-		length = entry->dataSize - offset;
+	int64_t read = ramdiskRead(entry, offset, buffer, length);
+	if(read < 0)
+		return G_FS_READ_ERROR;
 
-	memoryCopy(buffer, &entry->data[offset], length);
-	*outRead = length;
+	*outRead = read;
 	return G_FS_READ_SUCCESSFUL;
 }
 
@@ -86,41 +86,11 @@ g_fs_write_status filesystemRamdiskDelegateWrite(g_fs_node* node, uint8_t* buffe
 	if(!entry)
 		return G_FS_WRITE_ERROR;
 
-	// copy data from ramdisk memory into variable memory
-	if(entry->dataOnRamdisk)
-	{
-		uint32_t buflen = entry->dataSize * 1.2;
-		uint8_t* new_buffer = (uint8_t*) heapAllocate(sizeof(uint8_t) * buflen);
-		memoryCopy(new_buffer, entry->data, entry->dataSize);
-		entry->data = new_buffer;
-		entry->notOnRdBufferLength = buflen;
-	}
-	else if(entry->data == nullptr)
-	{
-		uint32_t initbuflen = 32;
-		entry->data = (uint8_t*) heapAllocate(sizeof(uint8_t) * initbuflen);
-		entry->notOnRdBufferLength = initbuflen;
-	}
-
-	entry->dataOnRamdisk = false;
-
-	// expand buffer until enough space is available
-	uint32_t space;
-	while((space = entry->notOnRdBufferLength - offset) < length)
-	{
-		uint32_t buflen = entry->notOnRdBufferLength * 1.2;
-		uint8_t* new_buffer = new uint8_t[buflen];
-		memoryCopy(new_buffer, entry->data, entry->dataSize);
-		heapFree(entry->data);
-		entry->data = new_buffer;
-		entry->notOnRdBufferLength = buflen;
-	}
-
-	// copy data
-	memoryCopy(&entry->data[offset], buffer, length);
-	entry->dataSize = offset + length;
-	*outWrote = length;
+	int64_t wrote = ramdiskWrite(entry, offset, buffer, length);
+	if(wrote < 0)
+		return G_FS_WRITE_ERROR;
 
+	*outWrote = wrote;
 	return G_FS_WRITE_SUCCESSFUL;
 }
 
@@ -150,20 +120,15 @@ g_fs_open_status filesystemRamdiskDelegateCreate(g_fs_node* parent, const char*
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
-g_fs_open_status filesystemRamdiskDelegateTruncate(g_fs_node* file)
+g_fs_open_status filesystemRamdiskDelegateTruncate(g_fs_node* file, uint64_t length)
 {
 	g_ramdisk_entry* entry = ramdiskFindById(file->physicalId);
 	if(!entry)
 		return G_FS_OPEN_ERROR;
 
-	if(!entry->dataOnRamdisk)
-	{
-		entry->dataSize = 0;
-		entry->notOnRdBufferLength = 0;
-		if(entry->data)
-			heapFree(entry->data);
-		entry->data = 0;
-	}
+	if(!ramdiskTruncate(entry, length))
+		return G_FS_OPEN_ERROR;
+
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
@@ -173,12 +138,8 @@ g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDir(g_fs_node* dir
 	if(!dirEntry)
 		return G_FS_DIRECTORY_REFRESH_ERROR;
 
-	auto childCount = ramdiskGetChildCount(dirEntry->id);
-
-	for(uint32_t i = 0; i < childCount; i++)
+	for(g_ramdisk_entry* childEntry = dirEntry->children; childEntry; childEntry = childEntry->nextSibling)
 	{
-		auto childEntry = ramdiskGetChildAt(dirEntry->id, i);
-
 		if(!filesystemFindExistingChild(dir, childEntry->name))
 		{
 			g_fs_node_type nodeType = childEntry->type == G_RAMDISK_ENTRY_TYPE_FILE
@@ -41,7 +41,7 @@ g_fs_length_status filesystemRamdiskDelegateGetLength(g_fs_node* node, uint64_t*
 
 g_fs_open_status filesystemRamdiskDelegateCreate(g_fs_node* parent, const char* name, g_fs_node** outFile);
 
-g_fs_open_status filesystemRamdiskDelegateTruncate(g_fs_node* file);
+g_fs_open_status filesystemRamdiskDelegateTruncate(g_fs_node* file, uint64_t length);
 
 g_fs_directory_refresh_status filesystemRamdiskDelegateRefreshDir(g_fs_node* dir);
 
@@ -0,0 +1,654 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
+#include "kernel/ipc/message_queues.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/tasking/tasking_memory.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/memory/memory.hpp"
+#include "shared/utils/string.hpp"
+
+static g_fs_tasked_delegate* taskedDelegates = nullptr;
+static g_mutex taskedDelegatesLock;
+
+static g_fs_transaction_id taskedDelegateNextTransaction = 0;
+static g_mutex taskedDelegateTransactionLock;
+
+/**
+ * Allocates the transaction storage, shares it with the process of the task and sets
+ * up the slots. The task becomes the delegate task.
+ *
+ * @return whether the storage was created
+ */
+bool _filesystemTaskedDelegateCreateStorage(g_fs_tasked_delegate* tasked, g_task* task, g_address* outStorage);
+
+/**
+ * Frees the transaction storage of a dead delegate once no slot is used anymore. The
+ * lock of the delegate must be held.
+ */
+void _filesystemTaskedDelegateFreeStorageIfIdle(g_fs_tasked_delegate* tasked);
+
+/**
+ * Takes a free slot of the delegate, waiting until one is available.
+ *
+ * @return the slot or null if the delegate task is gone
+ */
+g_fs_tasked_delegate_slot* _filesystemTaskedDelegateAcquireSlot(g_fs_tasked_delegate* tasked, g_task* task);
+
+/**
+ * Gives a slot back and wakes the next task waiting for one.
+ */
+void _filesystemTaskedDelegateReleaseSlot(g_fs_tasked_delegate* tasked, g_fs_tasked_delegate_slot* slot);
+
+/**
+ * Same as {_filesystemTaskedDelegateReleaseSlot}, the lock of the delegate must be held.
+ */
+void _filesystemTaskedDelegateFreeSlot(g_fs_tasked_delegate* tasked, g_fs_tasked_delegate_slot* slot);
+
+/**
+ * Sends a request for the prepared storage of the slot to the delegate task and waits
+ * until the delegate finished the transaction. Requests are sent again while the
+ * delegate asks for a repetition.
+ *
+ * @return whether the transaction was finished
+ */
+bool _filesystemTaskedDelegatePerform(g_fs_tasked_delegate* tasked, g_fs_tasked_delegate_slot* slot, g_task* task,
+                                      g_fs_tasked_delegate_request_type type);
+
+void filesystemTaskedDelegateInitialize()
+{
+	mutexInitializeTask(&taskedDelegatesLock, __func__);
+	mutexInitializeTask(&taskedDelegateTransactionLock, __func__);
+}
+
+g_fs_tasked_delegate* filesystemTaskedDelegateCreate(g_task* task, g_fs_delegate* delegate, g_address* outStorage)
+{
+	g_fs_tasked_delegate* tasked = (g_fs_tasked_delegate*) heapAllocateClear(sizeof(g_fs_tasked_delegate));
+	mutexInitializeTask(&tasked->lock, __func__);
+	waitQueueInitialize(&tasked->waitersSlot);
+	tasked->delegate = delegate;
+
+	if(!_filesystemTaskedDelegateCreateStorage(tasked, task, outStorage))
+	{
+		waitQueueDestroy(&tasked->waitersSlot);
+		heapFree(tasked);
+		return nullptr;
+	}
+
+	mutexAcquire(&taskedDelegatesLock);
+	tasked->next = taskedDelegates;
+	taskedDelegates = tasked;
+	mutexRelease(&taskedDelegatesLock);
+	return tasked;
+}
+
+bool filesystemTaskedDelegateTakeOver(g_fs_tasked_delegate* tasked, g_task* task, g_address* outStorage)
+{
+	mutexAcquire(&tasked->lock);
+	bool tookOver = !tasked->alive && !tasked->slots[0].storage &&
+	                _filesystemTaskedDelegateCreateStorage(tasked, task, outStorage);
+	mutexRelease(&tasked->lock);
+	return tookOver;
+}
+
+bool _filesystemTaskedDelegateCreateStorage(g_fs_tasked_delegate* tasked, g_task* task, g_address* outStorage)
+{
+	uint32_t pages = G_FS_TASKED_DELEGATE_SLOTS * (G_FS_TASKED_DELEGATE_SLOT_SIZE / G_PAGE_SIZE);
+	g_virtual_address storage = memoryAllocateKernel(pages);
+	if(!storage)
+	{
+		logInfo("%! failed to allocate transaction storage for delegate task %i", "fs", task->id);
+		return false;
+	}
+	memorySetBytes((void*) storage, 0, pages * G_PAGE_SIZE);
+
+	g_virtual_address storageInDelegate = taskingMemoryShare(task->process, storage, pages);
+	if(!storageInDelegate)
+	{
+		logInfo("%! failed to share transaction storage with delegate task %i", "fs", task->id);
+		memoryFreeKernelRange(storage);
+		return false;
+	}
+
+	tasked->task = task->id;
+	tasked->process = task->process;
+	tasked->alive = true;
+
+	for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+	{
+		g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+		slot->used = false;
+		slot->requester = G_TID_NONE;
+		slot->storage = (uint8_t*) (storage + i * G_FS_TASKED_DELEGATE_SLOT_SIZE);
+		slot->buffer = slot->storage + G_PAGE_SIZE;
+		slot->storageInDelegate = storageInDelegate + i * G_FS_TASKED_DELEGATE_SLOT_SIZE;
+		slot->bufferInDelegate = slot->storageInDelegate + G_PAGE_SIZE;
+	}
+
+	*outStorage = storageInDelegate;
+	return true;
+}
+
+void _filesystemTaskedDelegateFreeStorageIfIdle(g_fs_tasked_delegate* tasked)
+{
+	if(tasked->alive || !tasked->slots[0].storage)
+		return;
+
+	for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+	{
+		if(tasked->slots[i].used)
+			return;
+	}
+
+	// The mapping in the delegate process goes away with the process
+	memoryFreeKernelRange((g_virtual_address) tasked->slots[0].storage);
+	for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+	{
+		g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+		slot->storage = nullptr;
+		slot->buffer = nullptr;
+		slot->storageInDelegate = 0;
+		slot->bufferInDelegate = 0;
+	}
+}
+
+bool filesystemTaskedDelegateSetTransactionStatus(g_task* task, g_fs_transaction_id id,
+                                                  g_fs_transaction_status status)
+{
+	bool found = false;
+
+	mutexAcquire(&taskedDelegatesLock);
+	for(g_fs_tasked_delegate* tasked = taskedDelegates; tasked && !found; tasked = tasked->next)
+	{
+		mutexAcquire(&tasked->lock);
+		if(tasked->alive && tasked->process == task->process)
+		{
+			for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+			{
+				g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+				if(!slot->used || slot->transaction != id || slot->status != G_FS_TRANSACTION_WAITING)
+					continue;
+
+				slot->status = status;
+				if(slot->requester == G_TID_NONE)
+				{
+					_filesystemTaskedDelegateFreeSlot(tasked, slot);
+				}
+				else
+				{
+					g_task* requester = taskingGetById(slot->requester);
+					if(requester)
+						taskingWake(requester);
+				}
+				found = true;
+				break;
+			}
+		}
+		mutexRelease(&tasked->lock);
+	}
+	mutexRelease(&taskedDelegatesLock);
+
+	return found;
+}
+
+void filesystemTaskedDelegateTaskRemoved(g_tid task)
+{
+	mutexAcquire(&taskedDelegatesLock);
+	for(g_fs_tasked_delegate* tasked = taskedDelegates; tasked; tasked = tasked->next)
+	{
+		mutexAcquire(&tasked->lock);
+		if(tasked->task == task && tasked->alive)
+		{
+			logInfo("%! delegate task %i was removed, failing its pending transactions", "fs", task);
+			tasked->alive = false;
+
+			for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+			{
+				g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+				if(!slot->used)
+					continue;
+
+				if(slot->requester == G_TID_NONE)
+				{
+					_filesystemTaskedDelegateFreeSlot(tasked, slot);
+				}
+				else
+				{
+					g_task* requester = taskingGetById(slot->requester);
+					if(requester)
+						taskingWake(requester);
+				}
+			}
+			waitQueueWake(&tasked->waitersSlot);
+			_filesystemTaskedDelegateFreeStorageIfIdle(tasked);
+		}
+		else
+		{
+			for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+			{
+				g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+				if(!slot->used || slot->requester != task)
+					continue;
+
+				// The delegate may still work on the storage, so the slot is kept until it finishes
+				slot->requester = G_TID_NONE;
+				if(slot->status != G_FS_TRANSACTION_WAITING || !tasked->alive)
+					_filesystemTaskedDelegateFreeSlot(tasked, slot);
+			}
+		}
+		mutexRelease(&tasked->lock);
+	}
+	mutexRelease(&taskedDelegatesLock);
+}
+
+g_fs_tasked_delegate_slot* _filesystemTaskedDelegateAcquireSlot(g_fs_tasked_delegate* tasked, g_task* task)
+{
+	// The delegate task can't wait for itself
+	if(task->id == tasked->task)
+	{
+		logInfo("%! delegate task %i tried to access its own mountpoint", "fs", task->id);
+		return nullptr;
+	}
+
+	mutexAcquire(&tasked->lock);
+	for(;;)
+	{
+		waitQueueRemove(&tasked->waitersSlot, task->id);
+		if(!tasked->alive)
+		{
+			mutexRelease(&tasked->lock);
+			return nullptr;
+		}
+
+		for(uint32_t i = 0; i < G_FS_TASKED_DELEGATE_SLOTS; i++)
+		{
+			g_fs_tasked_delegate_slot* slot = &tasked->slots[i];
+			if(slot->used)
+				continue;
+
+			slot->used = true;
+			slot->requester = task->id;
+			mutexRelease(&tasked->lock);
+			return slot;
+		}
+
+		taskingWait(task, __func__, [tasked, task]()
+		{
+			waitQueueAdd(&tasked->waitersSlot, task->id, true);
+			mutexRelease(&tasked->lock);
+		});
+		mutexAcquire(&tasked->lock);
+	}
+}
+
+void _filesystemTaskedDelegateReleaseSlot(g_fs_tasked_delegate* tasked, g_fs_tasked_delegate_slot* slot)
+{
+	mutexAcquire(&tasked->lock);
+	_filesystemTaskedDelegateFreeSlot(tasked, slot);
+	mutexRelease(&tasked->lock);
+}
+
+void _filesystemTaskedDelegateFreeSlot(g_fs_tasked_delegate* tasked, g_fs_tasked_delegate_slot* slot)
+{
+	slot->used = false;
+	slot->requester = G_TID_NONE;
+	waitQueueWakeOne(&tasked->waitersSlot);
+	_filesystemTaskedDelegateFreeStorageIfIdle(tasked);
+}
+
+bool _filesystemTaskedDelegatePerform(g_fs_tasked_delegate* tasked, g_fs_tasked_delegate_slot* slot, g_task* task,
+                                      g_fs_tasked_delegate_request_type type)
+{
+	g_fs_tasked_delegate_request request;
+	request.type = type;
+	request.storage = slot->storageInDelegate;
+
+	for(;;)
+	{
+		mutexAcquire(&taskedDelegateTransactionLock);
+		request.transaction = taskedDelegateNextTransaction++;
+		mutexRelease(&taskedDelegateTransactionLock);
+
+		mutexAcquire(&tasked->lock);
+		bool alive = tasked->alive;
+		g_tid receiver = tasked->task;
+		slot->transaction = request.transaction;
+		slot->status = G_FS_TRANSACTION_WAITING;
+		mutexRelease(&tasked->lock);
+
+		if(!alive)
+			return false;
+
+		g_message_send_status sendStatus;
+		while((sendStatus = messageQueueSend(task->id, receiver, &request, sizeof(request),
+		                                     G_MESSAGE_TRANSACTION_NONE)) == G_MESSAGE_SEND_STATUS_FULL)
+		{
+			taskingWait(task, __func__, [task, receiver]()
+			{
+				messageQueueWaitForSend(task->id, receiver);
+			});
+		}
+		messageQueueUnwaitForSend(task->id, receiver);
+
+		if(sendStatus != G_MESSAGE_SEND_STATUS_SUCCESSFUL)
+		{
+			logInfo("%! failed to send request to delegate task %i with status %i", "fs", receiver, sendStatus);
+			return false;
+		}
+
+		mutexAcquire(&tasked->lock);
+		while(slot->status == G_FS_TRANSACTION_WAITING && tasked->alive)
+		{
+			taskingWait(task, __func__, [tasked]()
+			{
+				mutexRelease(&tasked->lock);
+			});
+			mutexAcquire(&tasked->lock);
+		}
+		g_fs_transaction_status status = slot->status;
+		mutexRelease(&tasked->lock);
+
+		if(status == G_FS_TRANSACTION_FINISHED)
+			return true;
+		if(status != G_FS_TRANSACTION_REPEAT)
+			return false;
+	}
+}
+
+g_fs_open_status filesystemTaskedDelegateOpen(g_fs_node* node, g_file_flag_mode flags)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(node)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_OPEN_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_open*) slot->storage;
+	storage->phys_fs_id = node->physicalId;
+	stringCopy(storage->name, node->name);
+	storage->flags = flags;
+	storage->result_status = G_FS_OPEN_ERROR;
+
+	g_fs_open_status status = G_FS_OPEN_ERROR;
+	if(_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN))
+		status = storage->result_status;
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+	return status;
+}
+
+g_fs_close_status filesystemTaskedDelegateClose(g_fs_node* node, g_file_flag_mode openFlags)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(node)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_CLOSE_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_close*) slot->storage;
+	storage->phys_fs_id = node->physicalId;
+	storage->result_status = G_FS_CLOSE_ERROR;
+
+	g_fs_close_status status = G_FS_CLOSE_ERROR;
+	if(_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE))
+		status = storage->result_status;
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+	return status;
+}
+
+g_fs_open_status filesystemTaskedDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode)
+{
+	*outNode = nullptr;
+	if(stringLength(name) >= G_FILENAME_MAX)
+		return G_FS_OPEN_NOT_FOUND;
+
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(parent)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_OPEN_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_discovery*) slot->storage;
+	storage->parent_phys_fs_id = parent->physicalId;
+	storage->parent_virt_fs_id = parent->id;
+	stringCopy(storage->name, name);
+	storage->result_status = G_FS_DISCOVERY_ERROR;
+
+	g_fs_discovery_status discovery = G_FS_DISCOVERY_ERROR;
+	if(_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_DISCOVER))
+		discovery = storage->result_status;
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+
+	if(discovery == G_FS_DISCOVERY_SUCCESSFUL)
+	{
+		// The delegate has created the node while performing the transaction
+		if(filesystemFindExistingChild(parent, name, outNode))
+			return G_FS_OPEN_SUCCESSFUL;
+
+		logInfo("%! delegate task %i discovered '%s' in %i but did not create a node", "fs", tasked->task, name,
+		        parent->id);
+		return G_FS_OPEN_ERROR;
+	}
+	if(discovery == G_FS_DISCOVERY_NOT_FOUND)
+		return G_FS_OPEN_NOT_FOUND;
+	if(discovery == G_FS_DISCOVERY_BUSY)
+		return G_FS_OPEN_BUSY;
+	return G_FS_OPEN_ERROR;
+}
+
+g_fs_read_status filesystemTaskedDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length,
+                                              int64_t* outRead)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(node)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_READ_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_read*) slot->storage;
+	g_fs_read_status status = G_FS_READ_SUCCESSFUL;
+	uint64_t total = 0;
+
+	// Larger reads are split into chunks that fit the transfer buffer
+	while(total < length)
+	{
+		uint64_t chunk = length - total;
+		if(chunk > G_FS_TASKED_DELEGATE_TRANSFER_SIZE)
+			chunk = G_FS_TASKED_DELEGATE_TRANSFER_SIZE;
+
+		storage->phys_fs_id = node->physicalId;
+		storage->mapped_buffer = (void*) slot->bufferInDelegate;
+		storage->offset = offset + total;
+		storage->length = chunk;
+		storage->mapping_start = 0;
+		storage->mapping_pages = 0;
+		storage->result_read = 0;
+		storage->result_status = G_FS_READ_ERROR;
+
+		if(!_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ))
+		{
+			status = G_FS_READ_ERROR;
+			break;
+		}
+
+		status = storage->result_status;
+		int64_t read = storage->result_read;
+		if(status != G_FS_READ_SUCCESSFUL || read <= 0)
+			break;
+		if((uint64_t) read > chunk)
+			read = chunk;
+
+		memoryCopy(buffer + total, slot->buffer, read);
+		total += read;
+
+		if((uint64_t) read < chunk)
+			break;
+	}
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+
+	// Report what was transferred before a later chunk failed
+	if(total > 0)
+		status = G_FS_READ_SUCCESSFUL;
+	*outRead = total;
+	return status;
+}
+
+g_fs_write_status filesystemTaskedDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length,
+                                                int64_t* outWrote)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(node)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_WRITE_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_write*) slot->storage;
+	g_fs_write_status status = G_FS_WRITE_SUCCESSFUL;
+	uint64_t total = 0;
+
+	while(total < length)
+	{
+		uint64_t chunk = length - total;
+		if(chunk > G_FS_TASKED_DELEGATE_TRANSFER_SIZE)
+			chunk = G_FS_TASKED_DELEGATE_TRANSFER_SIZE;
+
+		memoryCopy(slot->buffer, buffer + total, chunk);
+
+		storage->phys_fs_id = node->physicalId;
+		storage->mapped_buffer = (void*) slot->bufferInDelegate;
+		storage->offset = offset + total;
+		storage->length = chunk;
+		storage->mapping_start = 0;
+		storage->mapping_pages = 0;
+		storage->result_write = 0;
+		storage->result_status = G_FS_WRITE_ERROR;
+
+		if(!_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_WRITE))
+		{
+			status = G_FS_WRITE_ERROR;
+			break;
+		}
+
+		status = storage->result_status;
+		int64_t wrote = storage->result_write;
+		if(status != G_FS_WRITE_SUCCESSFUL || wrote <= 0)
+			break;
+		if((uint64_t) wrote > chunk)
+			wrote = chunk;
+
+		total += wrote;
+
+		if((uint64_t) wrote < chunk)
+			break;
+	}
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+
+	if(total > 0)
+		status = G_FS_WRITE_SUCCESSFUL;
+	*outWrote = total;
+	return status;
+}
+
+g_fs_length_status filesystemTaskedDelegateGetLength(g_fs_node* node, uint64_t* outLength)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(node)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_LENGTH_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_get_length*) slot->storage;
+	storage->phys_fs_id = node->physicalId;
+	storage->result_length = 0;
+	storage->result_status = G_FS_LENGTH_ERROR;
+
+	g_fs_length_status status = G_FS_LENGTH_ERROR;
+	int64_t length = 0;
+	if(_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_GET_LENGTH))
+	{
+		status = storage->result_status;
+		length = storage->result_length;
+	}
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+
+	if(status == G_FS_LENGTH_SUCCESSFUL)
+	{
+		if(length < 0)
+			return G_FS_LENGTH_ERROR;
+		*outLength = length;
+	}
+	return status;
+}
+
+g_fs_directory_refresh_status filesystemTaskedDelegateRefreshDir(g_fs_node* dir)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(dir)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_DIRECTORY_REFRESH_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_directory_refresh*) slot->storage;
+	storage->parent_phys_fs_id = dir->physicalId;
+	storage->parent_virt_fs_id = dir->id;
+	storage->result_status = G_FS_DIRECTORY_REFRESH_ERROR;
+
+	g_fs_directory_refresh_status status = G_FS_DIRECTORY_REFRESH_ERROR;
+	if(_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY))
+		status = storage->result_status;
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+	return status;
+}
+
+g_fs_sync_status filesystemTaskedDelegateSync(g_fs_node* node)
+{
+	g_fs_tasked_delegate* tasked = filesystemFindDelegate(node)->tasked;
+	g_task* task = taskingGetCurrentTask();
+
+	g_fs_tasked_delegate_slot* slot = _filesystemTaskedDelegateAcquireSlot(tasked, task);
+	if(!slot)
+		return G_FS_SYNC_ERROR;
+
+	auto storage = (g_fs_tasked_delegate_transaction_storage_sync*) slot->storage;
+	storage->phys_fs_id = node->physicalId;
+	storage->result_status = G_FS_SYNC_ERROR;
+
+	g_fs_sync_status status = G_FS_SYNC_ERROR;
+	if(_filesystemTaskedDelegatePerform(tasked, slot, task, G_FS_TASKED_DELEGATE_REQUEST_TYPE_SYNC))
+		status = storage->result_status;
+
+	_filesystemTaskedDelegateReleaseSlot(tasked, slot);
+	return status;
+}
@@ -0,0 +1,124 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FILESYSTEM_TASKED_DELEGATE__
+#define __KERNEL_FILESYSTEM_TASKED_DELEGATE__
+
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/utils/wait_queue.hpp"
+#include <ghost/filesystem/delegate.h>
+
+/**
+ * A slot of the transaction storage. While a task uses a slot, the delegate task fills
+ * the storage and the transfer buffer, which the kernel accesses through its own mapping.
+ */
+struct g_fs_tasked_delegate_slot
+{
+    bool used;
+    g_fs_transaction_id transaction;
+    g_fs_transaction_status status;
+
+    /**
+     * Task that performs the transaction, none if it was removed while the delegate
+     * still worked on it. The slot is then freed once the delegate finishes.
+     */
+    g_tid requester;
+
+    uint8_t* storage;
+    uint8_t* buffer;
+    g_address storageInDelegate;
+    g_address bufferInDelegate;
+};
+
+/**
+ * A file system delegate that forwards requests to a task.
+ */
+struct g_fs_tasked_delegate
+{
+    g_mutex lock;
+    g_fs_delegate* delegate;
+
+    g_tid task;
+    g_process* process;
+    bool alive;
+
+    g_fs_tasked_delegate_slot slots[G_FS_TASKED_DELEGATE_SLOTS];
+    g_wait_queue waitersSlot;
+
+    g_fs_tasked_delegate* next;
+};
+
+/**
+ * Initializes the list of tasked delegates.
+ */
+void filesystemTaskedDelegateInitialize();
+
+/**
+ * Creates the tasked part of the delegate and shares its transaction storage with the
+ * process of the task.
+ *
+ * @return the tasked delegate or null if the storage could not be created
+ */
+g_fs_tasked_delegate* filesystemTaskedDelegateCreate(g_task* task, g_fs_delegate* delegate, g_address* outStorage);
+
+/**
+ * Lets the task replace a dead delegate task, for example when a driver is restarted.
+ * This is only possible once the storage of the dead task was freed, which happens when
+ * the last task that waited for one of its transactions has given up its slot.
+ *
+ * @return whether the task is now the delegate task
+ */
+bool filesystemTaskedDelegateTakeOver(g_fs_tasked_delegate* tasked, g_task* task, g_address* outStorage);
+
+/**
+ * Sets the status of a transaction of one of the delegates of the process of the task
+ * and wakes the task that waits for it.
+ *
+ * @return whether the transaction was found
+ */
+bool filesystemTaskedDelegateSetTransactionStatus(g_task* task, g_fs_transaction_id id,
+                                                  g_fs_transaction_status status);
+
+/**
+ * Fails all transactions of a delegate when its task is removed, and releases the slots
+ * of a task that waited for a transaction. The storage of a dead delegate is freed once
+ * none of its slots is used anymore.
+ */
+void filesystemTaskedDelegateTaskRemoved(g_tid task);
+
+g_fs_open_status filesystemTaskedDelegateOpen(g_fs_node* node, g_file_flag_mode flags);
+
+g_fs_close_status filesystemTaskedDelegateClose(g_fs_node* node, g_file_flag_mode openFlags);
+
+g_fs_open_status filesystemTaskedDelegateDiscover(g_fs_node* parent, const char* name, g_fs_node** outNode);
+
+g_fs_read_status filesystemTaskedDelegateRead(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length,
+                                              int64_t* outRead);
+
+g_fs_write_status filesystemTaskedDelegateWrite(g_fs_node* node, uint8_t* buffer, uint64_t offset, uint64_t length,
+                                                int64_t* outWrote);
+
+g_fs_length_status filesystemTaskedDelegateGetLength(g_fs_node* node, uint64_t* outLength);
+
+g_fs_directory_refresh_status filesystemTaskedDelegateRefreshDir(g_fs_node* dir);
+
+g_fs_sync_status filesystemTaskedDelegateSync(g_fs_node* node);
+
+#endif
@@ -22,6 +22,7 @@
 #include "kernel/memory/heap.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/paging.hpp"
+#include "kernel/utils/lz4.hpp"
 #include "shared/memory/memory.hpp"
 #include "shared/panic.hpp"
 #include "shared/utils/string.hpp"
@@ -29,11 +30,92 @@
 
 g_ramdisk* ramdiskMain = 0;
 
+/**
+ * Extents are pages in blocks of kernel virtual space, so that a large file does not take
+ * a range of the kernel range pool for each of its pages. The space of a block is kept and
+ * reused once its pages are freed.
+ */
+struct g_ramdisk_extent_block
+{
+	g_virtual_address base;
+	uint32_t used;
+	g_ramdisk_extent_block* next;
+};
+
+static g_ramdisk_extent_block* ramdiskExtentBlocks = 0;
+static g_ramdisk_extent_block* ramdiskExtentLastFreed = 0;
+static g_mutex ramdiskExtentLock;
+
+/**
+ * Adds the entry to the id index.
+ */
+void _ramdiskIndexById(g_ramdisk_entry* entry);
+
+/**
+ * Adds the entry to the name index and the children of its parent.
+ */
+void _ramdiskIndexInParent(g_ramdisk_entry* entry);
+
+/**
+ * Returns the name index bucket for the child "name" of the parent with "parentId".
+ */
+g_ramdisk_entry** _ramdiskNameBucket(g_ramdisk_id parentId, const char* name);
+
+/**
+ * Unpacks one chunk of a compressed file into the target, which must have space for
+ * the whole chunk. The helpers below must be called while holding the lock of the entry.
+ */
+bool _ramdiskDecompressChunk(g_ramdisk_entry* entry, uint32_t chunk, uint8_t* target);
+
+/**
+ * Decompresses the contents of a compressed file into pages, needed before it is modified.
+ */
+bool _ramdiskDecompress(g_ramdisk_entry* entry);
+
+/**
+ * Reads a range of an unmodified compressed file, unpacking only the chunks it covers.
+ */
+int64_t _ramdiskReadCompressed(g_ramdisk_entry* entry, uint32_t offset, uint8_t* buffer, uint32_t length);
+
+/**
+ * Moves the contents of a file into pages so that it can be modified.
+ */
+bool _ramdiskMakeWritable(g_ramdisk_entry* entry);
+
+/**
+ * Grows the page table of the entry so that it holds at least "count" pages. Only
+ * the table of page pointers is copied, never the file contents.
+ *
+ * @return whether the table has the capacity
+ */
+bool _ramdiskEnsurePageCapacity(g_ramdisk_entry* entry, uint32_t count);
+
+/**
+ * Copies data into the pages of the entry, allocating pages for holes.
+ *
+ * @return the number of bytes written, less than requested if memory ran out
+ */
+uint32_t _ramdiskWritePages(g_ramdisk_entry* entry, uint32_t offset, const uint8_t* buffer, uint32_t length);
+
+/**
+ * Allocates a zeroed page for an extent.
+ *
+ * @return the page, or null if there is no memory left
+ */
+uint8_t* _ramdiskAllocateExtent();
+
+/**
+ * Frees the page of an extent.
+ */
+void _ramdiskFreeExtent(uint8_t* extent);
+
 void ramdiskLoadFromModule(g_multiboot_module* module)
 {
 	if(ramdiskMain)
 		panic("%! tried to initialize ramdisk multiple times", "kern");
 
+	mutexInitializeTask(&ramdiskExtentLock, __func__);
+
 	int pages = G_PAGE_ALIGN_UP(module->moduleEnd - module->moduleStart) / G_PAGE_SIZE;
 
 	g_virtual_address newLocation = addressRangePoolAllocate(memoryVirtualRangePool, pages);
@@ -62,15 +144,28 @@ void ramdiskParseContents(g_multiboot_module* module)
 
 	ramdiskMain->root = new g_ramdisk_entry;
 	ramdiskMain->root->id = 0;
+	ramdiskMain->root->type = G_RAMDISK_ENTRY_TYPE_FOLDER;
+	ramdiskMain->root->children = 0;
 	ramdiskMain->firstEntry = 0;
 	ramdiskMain->nextUnusedId = 0;
 
 	uint32_t pos = 0;
+	uint32_t entryCount = 0;
+	uint32_t compressedCount = 0;
+	uint64_t compressedBytes = 0;
+	uint64_t uncompressedBytes = 0;
 	g_ramdisk_entry* currentHeader = 0;
 	while((g_address) (data + pos) < dataEnd)
 	{
 		g_ramdisk_entry* entry = new g_ramdisk_entry;
 		entry->next = 0;
+		entry->children = 0;
+		entry->compressedData = 0;
+		entry->compressedSize = 0;
+		entry->pages = 0;
+		entry->pageCapacity = 0;
+		mutexInitializeTask(&entry->lock, __func__);
+		++entryCount;
 
 		if(currentHeader == 0)
 		{
@@ -111,7 +206,28 @@ void ramdiskParseContents(g_multiboot_module* module)
 
 		// If its a file, load content into buffer
 		entry->dataOnRamdisk = true;
-		if(entry->type == G_RAMDISK_ENTRY_TYPE_FILE)
+		if(entry->type == G_RAMDISK_ENTRY_TYPE_FILE_LZ4)
+		{
+			// Decompressed and compressed length
+			uint32_t* datalengthptr = (uint32_t*) (data + pos);
+			entry->dataSize = *datalengthptr;
+			pos += 4;
+			uint32_t* compressedlengthptr = (uint32_t*) (data + pos);
+			entry->compressedSize = *compressedlengthptr;
+			pos += 4;
+
+			// Data is decompressed chunk by chunk when it is read
+			entry->type = G_RAMDISK_ENTRY_TYPE_FILE;
+			entry->compressedData = (uint8_t*) (data + pos);
+			entry->data = 0;
+			entry->dataOnRamdisk = false;
+			pos += entry->compressedSize;
+
+			++compressedCount;
+			compressedBytes += entry->compressedSize;
+			uncompressedBytes += entry->dataSize;
+		}
+		else if(entry->type == G_RAMDISK_ENTRY_TYPE_FILE)
 		{
 			// Data length
 			uint32_t* datalengthptr = (uint32_t*) (data + pos);
@@ -134,18 +250,67 @@ void ramdiskParseContents(g_multiboot_module* module)
 			ramdiskMain->nextUnusedId = entry->id + 1;
 		}
 	}
+
+	// Build the indexes once all entries are known, parents may come after their children
+	uint32_t bucketCount = G_RAMDISK_MINIMUM_INDEX_BUCKETS;
+	while(bucketCount < entryCount)
+		bucketCount *= 2;
+	ramdiskMain->bucketCount = bucketCount;
+	ramdiskMain->idBuckets = (g_ramdisk_entry**) heapAllocateClear(sizeof(g_ramdisk_entry*) * bucketCount);
+	ramdiskMain->nameBuckets = (g_ramdisk_entry**) heapAllocateClear(sizeof(g_ramdisk_entry*) * bucketCount);
+
+	if(compressedCount)
+	{
+		logInfo("%! %i compressed files, %i KB stored in %i KB and unpacked when read", "ramdisk", compressedCount,
+		        (uint32_t) (uncompressedBytes / 1024), (uint32_t) (compressedBytes / 1024));
+	}
+
+	_ramdiskIndexById(ramdiskMain->root);
+	for(g_ramdisk_entry* entry = ramdiskMain->firstEntry; entry; entry = entry->next)
+		_ramdiskIndexById(entry);
+	for(g_ramdisk_entry* entry = ramdiskMain->firstEntry; entry; entry = entry->next)
+		_ramdiskIndexInParent(entry);
 }
 
-g_ramdisk_entry* ramdiskFindChild(g_ramdisk_entry* parent, const char* childName)
+void _ramdiskIndexById(g_ramdisk_entry* entry)
 {
+	g_ramdisk_entry** bucket = &ramdiskMain->idBuckets[entry->id & (ramdiskMain->bucketCount - 1)];
+	entry->nextById = *bucket;
+	*bucket = entry;
+}
 
-	g_ramdisk_entry* current = ramdiskMain->firstEntry;
+void _ramdiskIndexInParent(g_ramdisk_entry* entry)
+{
+	g_ramdisk_entry** bucket = _ramdiskNameBucket(entry->parentid, entry->name);
+	entry->nextByName = *bucket;
+	*bucket = entry;
+
+	g_ramdisk_entry* parent = ramdiskFindById(entry->parentid);
+	if(!parent)
+	{
+		logWarn("%! entry %i has unknown parent %i", "ramdisk", entry->id, entry->parentid);
+		entry->nextSibling = 0;
+		return;
+	}
+	entry->nextSibling = parent->children;
+	parent->children = entry;
+}
+
+g_ramdisk_entry** _ramdiskNameBucket(g_ramdisk_id parentId, const char* name)
+{
+	uint32_t hash = ((uint32_t) stringHash(name)) ^ (parentId * 0x9E3779B1);
+	return &ramdiskMain->nameBuckets[hash & (ramdiskMain->bucketCount - 1)];
+}
+
+g_ramdisk_entry* ramdiskFindChild(g_ramdisk_entry* parent, const char* childName)
+{
+	g_ramdisk_entry* current = *_ramdiskNameBucket(parent->id, childName);
 	while(current)
 	{
 		if(current->parentid == parent->id && stringEquals(current->name, childName))
 			return current;
 
-		current = current->next;
+		current = current->nextByName;
 	}
 
 	return 0;
@@ -153,26 +318,16 @@ g_ramdisk_entry* ramdiskFindChild(g_ramdisk_entry* parent, const char* childName
 
 g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id)
 {
-	g_ramdisk_entry* foundNode = 0;
-
-	if(id == 0)
-	{
-		return ramdiskMain->root;
-	}
-
-	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
-	while(currentNode != 0)
+	g_ramdisk_entry* current = ramdiskMain->idBuckets[id & (ramdiskMain->bucketCount - 1)];
+	while(current)
 	{
-		if(currentNode->id == id)
-		{
-			foundNode = currentNode;
-			break;
-		}
+		if(current->id == id)
+			return current;
 
-		currentNode = currentNode->next;
+		current = current->nextById;
 	}
 
-	return foundNode;
+	return 0;
 }
 
 g_ramdisk_entry* ramdiskFindAbsolute(const char* path)
@@ -214,41 +369,368 @@ g_ramdisk_entry* ramdiskFindRelative(g_ramdisk_entry* node, const char* path)
 	return currentNode;
 }
 
-uint32_t ramdiskGetChildCount(g_ramdisk_id id)
+bool _ramdiskDecompressChunk(g_ramdisk_entry* entry, uint32_t chunk, uint8_t* target)
 {
-	uint32_t count = 0;
+	// The chunks are preceded by a table with the end offset of each of them
+	uint32_t chunkCount = (entry->dataSize + G_RAMDISK_COMPRESSED_CHUNK_SIZE - 1) / G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+	uint32_t* ends = (uint32_t*) entry->compressedData;
+	uint8_t* chunks = entry->compressedData + chunkCount * sizeof(uint32_t);
+
+	uint32_t start = chunk ? ends[chunk - 1] : 0;
+	uint32_t packedLength = ends[chunk] - start;
+	uint32_t length = entry->dataSize - chunk * G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+	if(length > G_RAMDISK_COMPRESSED_CHUNK_SIZE)
+		length = G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+
+	// Chunks that do not get smaller are stored as they are
+	if(packedLength == length)
+	{
+		memoryCopy(target, &chunks[start], length);
+		return true;
+	}
 
-	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
-	while(currentNode != 0)
+	if(lz4Decompress(&chunks[start], packedLength, target, length) != (int32_t) length)
 	{
-		if(currentNode->parentid == id)
+		logWarn("%! failed to decompress chunk %i of entry %i (%s)", "ramdisk", chunk, entry->id, entry->name);
+		return false;
+	}
+	return true;
+}
+
+bool _ramdiskDecompress(g_ramdisk_entry* entry)
+{
+	if(!entry->compressedData)
+		return true;
+
+	bool loaded = true;
+	uint8_t* buffer = (uint8_t*) heapAllocate(G_RAMDISK_COMPRESSED_CHUNK_SIZE);
+	for(uint32_t offset = 0; offset < entry->dataSize; offset += G_RAMDISK_COMPRESSED_CHUNK_SIZE)
+	{
+		if(!_ramdiskDecompressChunk(entry, offset / G_RAMDISK_COMPRESSED_CHUNK_SIZE, buffer))
 		{
-			++count;
+			loaded = false;
+			break;
+		}
+
+		uint32_t length = entry->dataSize - offset;
+		if(length > G_RAMDISK_COMPRESSED_CHUNK_SIZE)
+			length = G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+		if(_ramdiskWritePages(entry, offset, buffer, length) != length)
+		{
+			loaded = false;
+			break;
 		}
-		currentNode = currentNode->next;
 	}
+	heapFree(buffer);
 
-	return count;
+	if(loaded)
+		entry->compressedData = 0;
+	return loaded;
 }
 
-g_ramdisk_entry* ramdiskGetChildAt(g_ramdisk_id id, uint32_t index)
+bool _ramdiskMakeWritable(g_ramdisk_entry* entry)
 {
+	if(!_ramdiskDecompress(entry))
+		return false;
 
-	uint32_t pos = 0;
+	// On failure the pages written so far are overwritten by the next attempt
+	if(entry->dataOnRamdisk)
+	{
+		if(_ramdiskWritePages(entry, 0, entry->data, entry->dataSize) != entry->dataSize)
+			return false;
+		entry->data = 0;
+		entry->dataOnRamdisk = false;
+	}
+	return true;
+}
+
+bool _ramdiskEnsurePageCapacity(g_ramdisk_entry* entry, uint32_t count)
+{
+	if(count <= entry->pageCapacity)
+		return true;
+
+	uint32_t capacity = entry->pageCapacity ? entry->pageCapacity : G_RAMDISK_MINIMUM_PAGE_CAPACITY;
+	while(capacity < count)
+		capacity *= 2;
+
+	uint8_t** pages = (uint8_t**) heapAllocateClear(sizeof(uint8_t*) * capacity);
+	if(!pages)
+		return false;
+
+	if(entry->pages)
+	{
+		memoryCopy(pages, entry->pages, sizeof(uint8_t*) * entry->pageCapacity);
+		heapFree(entry->pages);
+	}
+	entry->pages = pages;
+	entry->pageCapacity = capacity;
+	return true;
+}
 
-	g_ramdisk_entry* currentNode = ramdiskMain->firstEntry;
-	while(currentNode)
+uint32_t _ramdiskWritePages(g_ramdisk_entry* entry, uint32_t offset, const uint8_t* buffer, uint32_t length)
+{
+	uint32_t end = offset + length;
+	if(!_ramdiskEnsurePageCapacity(entry, G_PAGE_ALIGN_UP(end) / G_PAGE_SIZE))
+		return 0;
+
+	uint32_t position = offset;
+	while(position < end)
 	{
-		if(currentNode->parentid == id)
+		uint32_t index = position / G_PAGE_SIZE;
+		uint32_t pageOffset = position % G_PAGE_SIZE;
+		uint32_t chunk = G_PAGE_SIZE - pageOffset;
+		if(chunk > end - position)
+			chunk = end - position;
+
+		uint8_t* page = entry->pages[index];
+		if(!page)
 		{
-			if(pos == index)
-				return currentNode;
-			++pos;
+			page = _ramdiskAllocateExtent();
+			if(!page)
+			{
+				logWarn("%! out of memory while writing entry %i (%s)", "ramdisk", entry->id, entry->name);
+				break;
+			}
+			entry->pages[index] = page;
 		}
-		currentNode = currentNode->next;
+		memoryCopy(&page[pageOffset], &buffer[position - offset], chunk);
+		position += chunk;
 	}
 
-	return 0;
+	if(position > entry->dataSize)
+		entry->dataSize = position;
+	return position - offset;
+}
+
+uint8_t* _ramdiskAllocateExtent()
+{
+	g_physical_address physical = memoryPhysicalAllocate();
+	if(!physical)
+		return 0;
+
+	mutexAcquire(&ramdiskExtentLock);
+	g_ramdisk_extent_block* block = ramdiskExtentBlocks;
+	while(block && block->used == 0xFFFFFFFF)
+		block = block->next;
+
+	if(!block)
+	{
+		g_virtual_address base = addressRangePoolAllocate(memoryVirtualRangePool, G_RAMDISK_EXTENT_BLOCK_PAGES);
+		if(base)
+		{
+			block = (g_ramdisk_extent_block*) heapAllocate(sizeof(g_ramdisk_extent_block));
+			if(block)
+			{
+				block->base = base;
+				block->used = 0;
+				block->next = ramdiskExtentBlocks;
+				ramdiskExtentBlocks = block;
+			}
+			else
+			{
+				addressRangePoolFree(memoryVirtualRangePool, base);
+			}
+		}
+
+		if(!block)
+		{
+			mutexRelease(&ramdiskExtentLock);
+			memoryPhysicalFree(physical);
+			return 0;
+		}
+	}
+
+	uint32_t slot = __builtin_ctz(~block->used);
+	block->used |= 1u << slot;
+	mutexRelease(&ramdiskExtentLock);
+
+	g_virtual_address extent = block->base + slot * G_PAGE_SIZE;
+	pagingMapPage(extent, physical, G_PAGE_TABLE_KERNEL_DEFAULT, G_PAGE_KERNEL_DEFAULT);
+	memorySetBytes((void*) extent, 0, G_PAGE_SIZE);
+	return (uint8_t*) extent;
+}
+
+void _ramdiskFreeExtent(uint8_t* extent)
+{
+	g_virtual_address virt = (g_virtual_address) extent;
+	g_physical_address physical = pagingVirtualToPhysical(virt);
+	pagingUnmapPage(virt);
+	memoryPhysicalFree(physical);
+
+	// Pages are mostly freed in runs, so the block of the previous one is checked first
+	mutexAcquire(&ramdiskExtentLock);
+	g_ramdisk_extent_block* block = ramdiskExtentLastFreed;
+	if(!block || virt < block->base || virt >= block->base + G_RAMDISK_EXTENT_BLOCK_PAGES * G_PAGE_SIZE)
+	{
+		block = ramdiskExtentBlocks;
+		while(block && (virt < block->base || virt >= block->base + G_RAMDISK_EXTENT_BLOCK_PAGES * G_PAGE_SIZE))
+			block = block->next;
+	}
+
+	if(block)
+	{
+		block->used &= ~(1u << ((virt - block->base) / G_PAGE_SIZE));
+		ramdiskExtentLastFreed = block;
+	}
+	else
+	{
+		logWarn("%! tried to free unknown extent %h", "ramdisk", virt);
+	}
+	mutexRelease(&ramdiskExtentLock);
+}
+
+int64_t ramdiskRead(g_ramdisk_entry* entry, uint64_t offset, uint8_t* buffer, uint64_t length)
+{
+	mutexAcquire(&entry->lock);
+
+	if(offset >= entry->dataSize)
+	{
+		mutexRelease(&entry->lock);
+		return 0;
+	}
+	if(length > entry->dataSize - offset)
+		length = entry->dataSize - offset;
+
+	if(entry->dataOnRamdisk)
+	{
+		memoryCopy(buffer, &entry->data[offset], length);
+		mutexRelease(&entry->lock);
+		return length;
+	}
+
+	// Unmodified compressed files are not kept unpacked, the page cache holds what was read
+	if(entry->compressedData)
+	{
+		int64_t read = _ramdiskReadCompressed(entry, offset, buffer, length);
+		mutexRelease(&entry->lock);
+		return read;
+	}
+
+	uint32_t start = offset;
+	uint32_t end = start + length;
+	uint32_t position = start;
+	while(position < end)
+	{
+		uint32_t index = position / G_PAGE_SIZE;
+		uint32_t pageOffset = position % G_PAGE_SIZE;
+		uint32_t chunk = G_PAGE_SIZE - pageOffset;
+		if(chunk > end - position)
+			chunk = end - position;
+
+		uint8_t* page = index < entry->pageCapacity ? entry->pages[index] : 0;
+		if(page)
+			memoryCopy(&buffer[position - start], &page[pageOffset], chunk);
+		else
+			memorySetBytes(&buffer[position - start], 0, chunk);
+		position += chunk;
+	}
+
+	mutexRelease(&entry->lock);
+	return length;
+}
+
+int64_t _ramdiskReadCompressed(g_ramdisk_entry* entry, uint32_t offset, uint8_t* buffer, uint32_t length)
+{
+	uint8_t* partial = 0;
+	uint32_t end = offset + length;
+	uint32_t position = offset;
+	while(position < end)
+	{
+		uint32_t chunk = position / G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+		uint32_t chunkStart = chunk * G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+		uint32_t chunkEnd = chunkStart + G_RAMDISK_COMPRESSED_CHUNK_SIZE;
+		if(chunkEnd > entry->dataSize)
+			chunkEnd = entry->dataSize;
+		uint32_t copyEnd = chunkEnd < end ? chunkEnd : end;
+
+		// Whole chunks are unpacked right into the buffer
+		bool decompressed;
+		if(position == chunkStart && copyEnd == chunkEnd)
+		{
+			decompressed = _ramdiskDecompressChunk(entry, chunk, &buffer[position - offset]);
+		}
+		else
+		{
+			if(!partial)
+				partial = (uint8_t*) heapAllocate(G_RAMDISK_COMPRESSED_CHUNK_SIZE);
+			decompressed = partial && _ramdiskDecompressChunk(entry, chunk, partial);
+			if(decompressed)
+				memoryCopy(&buffer[position - offset], &partial[position - chunkStart], copyEnd - position);
+		}
+
+		if(!decompressed)
+		{
+			if(partial)
+				heapFree(partial);
+			return -1;
+		}
+		position = copyEnd;
+	}
+
+	if(partial)
+		heapFree(partial);
+	return length;
+}
+
+int64_t ramdiskWrite(g_ramdisk_entry* entry, uint64_t offset, uint8_t* buffer, uint64_t length)
+{
+	if(offset + length > G_RAMDISK_MAXIMUM_FILE_SIZE)
+		return -1;
+
+	mutexAcquire(&entry->lock);
+
+	// A short write is reported if memory ran out on the way
+	uint32_t written = 0;
+	if(_ramdiskMakeWritable(entry))
+		written = _ramdiskWritePages(entry, offset, buffer, length);
+
+	mutexRelease(&entry->lock);
+	return (written > 0 || length == 0) ? (int64_t) written : -1;
+}
+
+bool ramdiskTruncate(g_ramdisk_entry* entry, uint64_t length)
+{
+	if(length > G_RAMDISK_MAXIMUM_FILE_SIZE)
+		return false;
+
+	mutexAcquire(&entry->lock);
+
+	// Emptying a file needs nothing from its previous contents
+	if(length == 0 && (entry->compressedData || entry->dataOnRamdisk))
+	{
+		entry->compressedData = 0;
+		entry->data = 0;
+		entry->dataOnRamdisk = false;
+	}
+
+	if(!_ramdiskMakeWritable(entry))
+	{
+		mutexRelease(&entry->lock);
+		return false;
+	}
+
+	if(length < entry->dataSize)
+	{
+		uint32_t keep = G_PAGE_ALIGN_UP((uint32_t) length) / G_PAGE_SIZE;
+		for(uint32_t i = keep; i < entry->pageCapacity; i++)
+		{
+			if(entry->pages[i])
+			{
+				_ramdiskFreeExtent(entry->pages[i]);
+				entry->pages[i] = 0;
+			}
+		}
+
+		// Clear the rest of the last page, so that growing the file again reads zeros
+		uint32_t tail = ((uint32_t) length) % G_PAGE_SIZE;
+		if(tail && keep <= entry->pageCapacity && entry->pages[keep - 1])
+			memorySetBytes(&entry->pages[keep - 1][tail], 0, G_PAGE_SIZE - tail);
+	}
+
+	entry->dataSize = length;
+
+	mutexRelease(&entry->lock);
+	return true;
 }
 
 g_ramdisk_entry* ramdiskGetRoot()
@@ -273,7 +755,15 @@ g_ramdisk_entry* ramdiskCreateFile(g_ramdisk_entry* parent, const char* filename
 	entry->data = nullptr;
 	entry->dataSize = 0;
 	entry->dataOnRamdisk = false;
-	entry->notOnRdBufferLength = 0;
+	entry->pages = 0;
+	entry->pageCapacity = 0;
+	mutexInitializeTask(&entry->lock, __func__);
+	entry->compressedData = 0;
+	entry->compressedSize = 0;
+	entry->children = 0;
+
+	_ramdiskIndexById(entry);
+	_ramdiskIndexInParent(entry);
 
 	return entry;
 }
@@ -27,11 +27,23 @@
 #include "kernel/filesystem/ramdisk_entry.hpp"
 #include "shared/multiboot/multiboot.hpp"
 
+#define G_RAMDISK_MINIMUM_INDEX_BUCKETS		256
+#define G_RAMDISK_MINIMUM_PAGE_CAPACITY		16
+#define G_RAMDISK_EXTENT_BLOCK_PAGES		32
+#define G_RAMDISK_MAXIMUM_FILE_SIZE			((uint64_t) 0xFFFFF000)
+
 struct g_ramdisk
 {
 	g_ramdisk_entry* firstEntry;
 	g_ramdisk_entry* root;
 	uint32_t nextUnusedId = 0;
+
+	/**
+	 * Hash indexes by id and by parent id and name, built when the contents are parsed.
+	 */
+	g_ramdisk_entry** idBuckets;
+	g_ramdisk_entry** nameBuckets;
+	uint32_t bucketCount;
 };
 
 extern g_ramdisk* ramdiskMain;
@@ -82,21 +94,30 @@ g_ramdisk_entry* ramdiskFindRelative(g_ramdisk_entry* node, const char* path);
 g_ramdisk_entry* ramdiskFindById(g_ramdisk_id id);
 
 /**
- * Returns the number of children that the entry with "id" has
+ * Reads from a file. Compressed files are unpacked chunk by chunk as they are read.
  *
- * @param id	the entries id
- * @return the number of children
+ * @param entry the file entry
+ * @return the number of bytes read, or -1 on failure
  */
-uint32_t ramdiskGetChildCount(g_ramdisk_id id);
+int64_t ramdiskRead(g_ramdisk_entry* entry, uint64_t offset, uint8_t* buffer, uint64_t length);
 
 /**
- * Returns the child at "index" of the node "id"
+ * Writes to a file. Writing past the end of the file leaves a hole in between.
  *
- * @param id	the parent entries id
- * @param index	the index of the child
- * @return the entry if found, else 0
+ * @param entry the file entry
+ * @return the number of bytes written, which is less than requested if memory ran
+ * 		out, or -1 if nothing could be written
+ */
+int64_t ramdiskWrite(g_ramdisk_entry* entry, uint64_t offset, uint8_t* buffer, uint64_t length);
+
+/**
+ * Sets the length of a file. Pages past the new end are freed, extending the file
+ * leaves a hole.
+ *
+ * @param entry the file entry
+ * @return whether the file was truncated
  */
-g_ramdisk_entry* ramdiskGetChildAt(g_ramdisk_id id, uint32_t index);
+bool ramdiskTruncate(g_ramdisk_entry* entry, uint64_t length);
 
 /**
  * Returns the root.
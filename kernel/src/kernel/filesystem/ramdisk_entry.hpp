@@ -24,6 +24,8 @@
 #include <ghost/stdint.h>
 #include <ghost/ramdisk.h>
 
+#include "shared/system/mutex.hpp"
+
 /**
  * Struct of a ramdisk entry
  */
@@ -40,7 +42,40 @@ struct g_ramdisk_entry
 	uint8_t* data;
 
 	bool dataOnRamdisk;
-	uint32_t notOnRdBufferLength;
+
+	/**
+	 * Contents of files that were written, or not loaded from the ramdisk, are held in
+	 * page-sized extents. Each is a physical page mapped into a block of kernel space
+	 * that is shared with other extents, so they do not fragment the kernel heap or the
+	 * kernel range pool. A missing page is a hole that reads as zeros.
+	 */
+	uint8_t** pages;
+	uint32_t pageCapacity;
+
+	/**
+	 * Held while the contents of the file are accessed.
+	 */
+	g_mutex lock;
+
+	/**
+	 * If the file is stored compressed on the ramdisk, this points to the compressed
+	 * contents until the file is modified. Reading only unpacks the chunks it needs,
+	 * the contents are moved into pages once the file is written.
+	 */
+	uint8_t* compressedData;
+	uint32_t compressedSize;
+
+	/**
+	 * Children of this entry, linked through their "nextSibling".
+	 */
+	g_ramdisk_entry* children;
+	g_ramdisk_entry* nextSibling;
+
+	/**
+	 * Links within the id and name index buckets.
+	 */
+	g_ramdisk_entry* nextById;
+	g_ramdisk_entry* nextByName;
 };
 
 #endif
@@ -31,8 +31,29 @@ static g_mutex messageTxLock;
 static g_hashmap<g_tid, g_message_queue*>* messageQueues = nullptr;
 static g_mutex messageQueuesLock;
 
-void _messageQueuesRemove(g_message_queue* queue, g_message_header* message);
-void _messageQueuesAddToTail(g_message_queue* queue, g_message_header* message);
+/**
+ * The limit applies to the live messages including their headers. The ring is large enough
+ * to hold that many bytes even if they are all messages without content. Compacting leaves
+ * the free space in up to two pieces and may pad the end, so three of the largest records
+ * are added to make sure that a message within the limit always fits after compacting.
+ */
+#define G_MESSAGE_QUEUE_RECORD_OVERHEAD (sizeof(g_message_record) - sizeof(g_message_header) + 3)
+#define G_MESSAGE_QUEUE_MAXIMUM_RECORD  G_ALIGN_UP(sizeof(g_message_record) + G_MESSAGE_MAXIMUM_MESSAGE_LENGTH, 4)
+#define G_MESSAGE_QUEUE_CAPACITY                                                                                       \
+	((uint32_t) (G_MESSAGE_MAXIMUM_QUEUE_CONTENT +                                                                     \
+	             G_MESSAGE_MAXIMUM_QUEUE_CONTENT / sizeof(g_message_header) * G_MESSAGE_QUEUE_RECORD_OVERHEAD +    \
+	             3 * G_MESSAGE_QUEUE_MAXIMUM_RECORD))
+#define G_MESSAGE_RECORD_AT(queue, offset) ((g_message_record*) ((queue)->buffer + (offset)))
+
+uint32_t _messageQueuesAllocateRecord(g_message_queue* queue, uint32_t recordSize);
+void _messageQueuesAdvance(g_message_queue* queue);
+void _messageQueuesCompact(g_message_queue* queue);
+void _messageQueuesConsume(g_message_queue* queue, uint32_t offset);
+uint32_t _messageQueuesFind(g_message_queue* queue, g_message_transaction tx);
+g_message_index_slot* _messageQueuesIndexFind(g_message_queue* queue, g_message_transaction tx);
+bool _messageQueuesIndexResize(g_message_queue* queue, uint32_t slots);
+void _messageQueuesIndexAdd(g_message_queue* queue, uint32_t offset);
+void _messageQueuesIndexRemove(g_message_queue* queue, uint32_t offset);
 void _messageQueuesWakeWaitingReceiver(g_message_queue* queue);
 g_message_queue* _messageQueuesGetOrCreate(g_tid receiver);
 
@@ -44,36 +65,78 @@ void messageQueuesInitialize()
 }
 
 g_message_send_status messageQueueSend(g_tid sender, g_tid receiver, void* content, uint32_t length,
-                                       g_message_transaction tx)
+                                       g_message_transaction tx, uint32_t grants)
 {
 	if(length > G_MESSAGE_MAXIMUM_MESSAGE_LENGTH)
 		return G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
 
-	g_message_send_status status;
 	uint32_t lengthWithHeader = sizeof(g_message_header) + length;
 
 	auto queue = _messageQueuesGetOrCreate(receiver);
+	if(!queue)
+		return G_MESSAGE_SEND_STATUS_FAILED;
+
+	// The ring is only allocated once there is something to put into it
+	if(!queue->buffer)
+	{
+		auto buffer = (uint8_t*) heapAllocate(G_MESSAGE_QUEUE_CAPACITY);
+		if(!buffer)
+		{
+			logInfo("%! failed to allocate message ring for task %i", "messages", receiver);
+			return G_MESSAGE_SEND_STATUS_FAILED;
+		}
+
+		mutexAcquire(&queue->lock);
+		if(queue->buffer)
+			heapFree(buffer);
+		else
+			queue->buffer = buffer;
+		mutexRelease(&queue->lock);
+	}
+
 	mutexAcquire(&queue->lock);
-	bool queueFull = queue->size + lengthWithHeader > G_MESSAGE_MAXIMUM_QUEUE_CONTENT;
-	mutexRelease(&queue->lock);
 
-	if(queueFull)
+	uint32_t offset = G_MESSAGE_RECORD_NONE;
+	if(queue->size + lengthWithHeader <= G_MESSAGE_MAXIMUM_QUEUE_CONTENT)
 	{
-		status = G_MESSAGE_SEND_STATUS_FULL;
+		uint32_t recordSize = G_ALIGN_UP(sizeof(g_message_record) + length, 4);
+		offset = _messageQueuesAllocateRecord(queue, recordSize);
+		if(offset == G_MESSAGE_RECORD_NONE)
+		{
+			_messageQueuesCompact(queue);
+			offset = _messageQueuesAllocateRecord(queue, recordSize);
+		}
 	}
-	else
+
+	if(offset == G_MESSAGE_RECORD_NONE)
 	{
-		auto message = (g_message_header*) heapAllocate(lengthWithHeader);
-		message->length = length;
-		message->sender = sender;
-		message->transaction = tx;
-		memoryCopy(G_MESSAGE_CONTENT(message), content, length);
-		_messageQueuesAddToTail(queue, message);
-		_messageQueuesWakeWaitingReceiver(queue);
-		status = G_MESSAGE_SEND_STATUS_SUCCESSFUL;
+		mutexRelease(&queue->lock);
+		return G_MESSAGE_SEND_STATUS_FULL;
 	}
 
-	return status;
+	g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+	record->state = G_MESSAGE_RECORD_STATE_LIVE;
+	record->nextInTransaction = G_MESSAGE_RECORD_NONE;
+	record->header.length = length;
+	record->header.sender = sender;
+	record->header.transaction = tx;
+	record->header.previous = nullptr;
+	record->header.next = nullptr;
+	record->header.grants = grants;
+	memoryCopy(G_MESSAGE_CONTENT(&record->header), content, length);
+	_messageQueuesIndexAdd(queue, offset);
+
+	queue->size += lengthWithHeader;
+	queue->statistics.depth++;
+	if(queue->statistics.depth > queue->statistics.highWaterDepth)
+		queue->statistics.highWaterDepth = queue->statistics.depth;
+	if(queue->size > queue->statistics.highWaterSize)
+		queue->statistics.highWaterSize = queue->size;
+
+	mutexRelease(&queue->lock);
+
+	_messageQueuesWakeWaitingReceiver(queue);
+	return G_MESSAGE_SEND_STATUS_SUCCESSFUL;
 }
 
 g_message_receive_status messageQueueReceive(g_tid receiver, g_message_header* out, uint32_t max,
@@ -88,28 +151,23 @@ g_message_receive_status messageQueueReceive(g_tid receiver, g_message_header* o
 		return G_MESSAGE_RECEIVE_STATUS_EMPTY;
 
 	mutexAcquire(&queue->lock);
-	g_message_header* message = queue->head;
-	while(message)
-	{
-		if(tx == G_MESSAGE_TRANSACTION_NONE || message->transaction == tx)
-			break;
-
-		message = message->next;
-	}
 
 	g_message_receive_status status;
-	if(message)
+	uint32_t offset = _messageQueuesFind(queue, tx);
+	if(offset != G_MESSAGE_RECORD_NONE)
 	{
-		int32_t len = sizeof(g_message_header) + message->length;
+		g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+		uint32_t len = sizeof(g_message_header) + record->header.length;
 		if(len > max)
 		{
 			status = G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE;
 		}
 		else
 		{
-			memoryCopy(out, message, len);
-			_messageQueuesRemove(queue, message);
-			heapFree(message);
+			memoryCopy(out, &record->header, len);
+			_messageQueuesConsume(queue, offset);
+			_messageQueuesAdvance(queue);
+
 			waitQueueWake(&queue->waitersSend);
 			status = G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL;
 		}
@@ -124,6 +182,56 @@ g_message_receive_status messageQueueReceive(g_tid receiver, g_message_header* o
 	return status;
 }
 
+g_message_receive_status messageQueueReceiveBatch(g_tid receiver, g_message_header* out, uint32_t max,
+                                                  uint32_t maxCount, uint32_t* outCount)
+{
+	*outCount = 0;
+
+	auto receiverEntry = hashmapGetEntry(messageQueues, receiver);
+
+	g_message_queue* queue;
+	if(receiverEntry)
+		queue = receiverEntry->value;
+	else
+		return G_MESSAGE_RECEIVE_STATUS_EMPTY;
+
+	mutexAcquire(&queue->lock);
+
+	uint32_t position = 0;
+	uint32_t count = 0;
+	g_message_receive_status status = G_MESSAGE_RECEIVE_STATUS_EMPTY;
+	while(queue->used > 0 && (maxCount == 0 || count < maxCount))
+	{
+		uint32_t offset = queue->readOffset;
+		g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+		uint32_t len = sizeof(g_message_header) + record->header.length;
+		if(position + len > max)
+		{
+			if(count == 0)
+				status = G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE;
+			break;
+		}
+
+		memoryCopy(((uint8_t*) out) + position, &record->header, len);
+		position += G_ALIGN_UP(len, G_MESSAGE_BATCH_ALIGNMENT);
+		count++;
+
+		_messageQueuesConsume(queue, offset);
+		_messageQueuesAdvance(queue);
+	}
+
+	if(count > 0)
+	{
+		waitQueueWake(&queue->waitersSend);
+		status = G_MESSAGE_RECEIVE_STATUS_SUCCESSFUL;
+	}
+
+	mutexRelease(&queue->lock);
+
+	*outCount = count;
+	return status;
+}
+
 g_message_transaction messageQueueNextTxId()
 {
 	mutexAcquire(&messageTxLock);
@@ -132,6 +240,32 @@ g_message_transaction messageQueueNextTxId()
 	return tx;
 }
 
+bool messageQueueGetStatistics(g_tid receiver, g_message_queue_statistics* out)
+{
+	mutexAcquire(&messageQueuesLock);
+
+	bool found = false;
+	auto entry = hashmapGetEntry(messageQueues, receiver);
+	if(entry)
+	{
+		*out = entry->value->statistics;
+		found = true;
+	}
+
+	mutexRelease(&messageQueuesLock);
+	return found;
+}
+
+bool messageQueueHasMessages(g_tid receiver)
+{
+	mutexAcquire(&messageQueuesLock);
+
+	auto entry = hashmapGetEntry(messageQueues, receiver);
+	bool hasMessages = entry && entry->value->statistics.depth > 0;
+
+	mutexRelease(&messageQueuesLock);
+	return hasMessages;
+}
 
 void messageQueueTaskRemoved(g_tid task)
 {
@@ -142,18 +276,14 @@ void messageQueueTaskRemoved(g_tid task)
 	{
 		g_message_queue* queue = receiverEntry->value;
 		mutexAcquire(&queue->lock);
-
-		g_message_header* head = queue->head;
-		while(head)
-		{
-			g_message_header* next = head->next;
-			heapFree(head);
-			head = next;
-		}
-
 		mutexRelease(&queue->lock);
 
 		hashmapRemove(messageQueues, task);
+		waitQueueWake(&queue->waitersSend);
+		waitQueueDestroy(&queue->waitersSend);
+		if(queue->buffer)
+			heapFree(queue->buffer);
+		heapFree(queue->index);
 		heapFree(queue);
 	}
 
@@ -163,13 +293,15 @@ void messageQueueTaskRemoved(g_tid task)
 void messageQueueWaitForSend(g_tid sender, g_tid receiver)
 {
 	g_message_queue* queue = _messageQueuesGetOrCreate(receiver);
-	waitQueueAdd(&queue->waitersSend, sender);
+	if(queue)
+		waitQueueAdd(&queue->waitersSend, sender);
 }
 
 void messageQueueUnwaitForSend(g_tid sender, g_tid receiver)
 {
 	g_message_queue* queue = _messageQueuesGetOrCreate(receiver);
-	waitQueueRemove(&queue->waitersSend, sender);
+	if(queue)
+		waitQueueRemove(&queue->waitersSend, sender);
 }
 
 void _messageQueuesWakeWaitingReceiver(g_message_queue* queue)
@@ -178,49 +310,356 @@ void _messageQueuesWakeWaitingReceiver(g_message_queue* queue)
 	taskingWake(task);
 }
 
-void _messageQueuesRemove(g_message_queue* queue, g_message_header* message)
+/**
+ * Reserves a contiguous record in the ring. If the record does not fit at the end
+ * of the buffer, the rest is filled with padding and the record is placed at the start.
+ * Ends shorter than a record header are skipped implicitly.
+ *
+ * @return the offset of the record or G_MESSAGE_RECORD_NONE if there is no space
+ */
+uint32_t _messageQueuesAllocateRecord(g_message_queue* queue, uint32_t recordSize)
 {
-	mutexAcquire(&queue->lock);
+	if(queue->used > 0 && queue->writeOffset == queue->readOffset)
+		return G_MESSAGE_RECORD_NONE;
+
+	uint32_t offset;
+	if(queue->writeOffset >= queue->readOffset)
+	{
+		uint32_t tail = G_MESSAGE_QUEUE_CAPACITY - queue->writeOffset;
+		if(recordSize <= tail)
+		{
+			offset = queue->writeOffset;
+		}
+		else if(recordSize <= queue->readOffset)
+		{
+			if(tail >= sizeof(g_message_record))
+			{
+				g_message_record* padding = G_MESSAGE_RECORD_AT(queue, queue->writeOffset);
+				padding->size = tail;
+				padding->state = G_MESSAGE_RECORD_STATE_PADDING;
+			}
+			queue->used += tail;
+			offset = 0;
+		}
+		else
+		{
+			return G_MESSAGE_RECORD_NONE;
+		}
+	}
+	else
+	{
+		if(recordSize > queue->readOffset - queue->writeOffset)
+			return G_MESSAGE_RECORD_NONE;
+		offset = queue->writeOffset;
+	}
 
-	queue->size -= sizeof(g_message_header) + message->length;
+	G_MESSAGE_RECORD_AT(queue, offset)->size = recordSize;
+	queue->used += recordSize;
+	queue->writeOffset = offset + recordSize;
+	if(queue->writeOffset == G_MESSAGE_QUEUE_CAPACITY)
+		queue->writeOffset = 0;
+	return offset;
+}
 
-	if(message == queue->head)
-		queue->head = message->next;
+/**
+ * Marks a live record as consumed and removes it from the index.
+ */
+void _messageQueuesConsume(g_message_queue* queue, uint32_t offset)
+{
+	g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+	_messageQueuesIndexRemove(queue, offset);
+	record->state = G_MESSAGE_RECORD_STATE_CONSUMED;
+	queue->size -= sizeof(g_message_header) + record->header.length;
+	queue->statistics.depth--;
+}
 
-	if(message == queue->tail)
-		queue->tail = message->previous;
+/**
+ * Moves the read offset past all consumed records and padding, so that it
+ * always points to the oldest live record.
+ */
+void _messageQueuesAdvance(g_message_queue* queue)
+{
+	while(queue->used > 0)
+	{
+		uint32_t tail = G_MESSAGE_QUEUE_CAPACITY - queue->readOffset;
+		if(tail < sizeof(g_message_record))
+		{
+			queue->used -= tail;
+			queue->readOffset = 0;
+			continue;
+		}
 
-	if(message->next)
-		message->next->previous = message->previous;
+		g_message_record* record = G_MESSAGE_RECORD_AT(queue, queue->readOffset);
+		if(record->state == G_MESSAGE_RECORD_STATE_LIVE)
+			break;
 
-	if(message->previous)
-		message->previous->next = message->next;
+		queue->used -= record->size;
+		queue->readOffset += record->size;
+		if(queue->readOffset == G_MESSAGE_QUEUE_CAPACITY)
+			queue->readOffset = 0;
+	}
 
-	mutexRelease(&queue->lock);
+	if(queue->used == 0)
+	{
+		queue->readOffset = 0;
+		queue->writeOffset = 0;
+		memorySetBytes(queue->index, 0, sizeof(g_message_index_slot) * queue->indexSlots);
+		queue->indexUsed = 0;
+		queue->indexDeleted = 0;
+	}
 }
 
-void _messageQueuesAddToTail(g_message_queue* queue, g_message_header* message)
+/**
+ * Moves all live records towards the read offset, in place and in their order, and rebuilds
+ * the index. Needed when the ring has no contiguous space left although the live messages
+ * are within the limit, for example when an old message that is never received pins the
+ * read offset. Records only move backwards in the ring, so none is overwritten before it
+ * was moved.
+ */
+void _messageQueuesCompact(g_message_queue* queue)
 {
-	mutexAcquire(&queue->lock);
+	uint32_t source = queue->readOffset;
+	uint32_t target = queue->readOffset;
+	uint32_t remaining = queue->used;
+	uint32_t used = 0;
+	while(remaining > 0)
+	{
+		uint32_t tail = G_MESSAGE_QUEUE_CAPACITY - source;
+		if(tail < sizeof(g_message_record))
+		{
+			remaining -= tail;
+			source = 0;
+			continue;
+		}
 
-	queue->size += sizeof(g_message_header) + message->length;
+		g_message_record* record = G_MESSAGE_RECORD_AT(queue, source);
+		uint32_t size = record->size;
+		if(record->state == G_MESSAGE_RECORD_STATE_LIVE)
+		{
+			// If the record does not fit before the end, the source has already wrapped
+			uint32_t targetTail = G_MESSAGE_QUEUE_CAPACITY - target;
+			if(size > targetTail)
+			{
+				if(targetTail >= sizeof(g_message_record))
+				{
+					g_message_record* padding = G_MESSAGE_RECORD_AT(queue, target);
+					padding->size = targetTail;
+					padding->state = G_MESSAGE_RECORD_STATE_PADDING;
+				}
+				used += targetTail;
+				target = 0;
+			}
+
+			if(target != source)
+				memoryCopy(G_MESSAGE_RECORD_AT(queue, target), record, size);
+			used += size;
+			target += size;
+			if(target == G_MESSAGE_QUEUE_CAPACITY)
+				target = 0;
+		}
 
-	message->next = nullptr;
-	if(queue->head)
+		remaining -= size;
+		source += size;
+		if(source == G_MESSAGE_QUEUE_CAPACITY)
+			source = 0;
+	}
+
+	queue->writeOffset = target;
+	queue->used = used;
+
+	memorySetBytes(queue->index, 0, sizeof(g_message_index_slot) * queue->indexSlots);
+	queue->indexUsed = 0;
+	queue->indexDeleted = 0;
+	queue->unindexed = 0;
+
+	uint32_t offset = queue->readOffset;
+	remaining = used;
+	while(remaining > 0)
 	{
-		message->previous = queue->tail;
-		queue->tail->next = message;
-		queue->tail = message;
+		uint32_t tail = G_MESSAGE_QUEUE_CAPACITY - offset;
+		if(tail < sizeof(g_message_record))
+		{
+			remaining -= tail;
+			offset = 0;
+			continue;
+		}
+
+		g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+		if(record->state == G_MESSAGE_RECORD_STATE_LIVE)
+		{
+			record->nextInTransaction = G_MESSAGE_RECORD_NONE;
+			_messageQueuesIndexAdd(queue, offset);
+		}
+
+		remaining -= record->size;
+		offset += record->size;
+		if(offset == G_MESSAGE_QUEUE_CAPACITY)
+			offset = 0;
 	}
-	else
+}
+
+/**
+ * @return offset of the oldest live record with the given transaction, or of the oldest
+ * 		live record at all if no transaction is given
+ */
+uint32_t _messageQueuesFind(g_message_queue* queue, g_message_transaction tx)
+{
+	if(queue->used == 0)
+		return G_MESSAGE_RECORD_NONE;
+
+	if(tx == G_MESSAGE_TRANSACTION_NONE)
+		return queue->readOffset;
+
+	if(queue->unindexed == 0)
 	{
-		queue->head = message;
-		queue->tail = message;
-		message->previous = nullptr;
-		message->next = nullptr;
+		g_message_index_slot* slot = _messageQueuesIndexFind(queue, tx);
+		return slot ? slot->first : G_MESSAGE_RECORD_NONE;
 	}
 
-	mutexRelease(&queue->lock);
+	// Some records are not in the index, walk the ring to keep the order
+	uint32_t offset = queue->readOffset;
+	uint32_t remaining = queue->used;
+	while(remaining > 0)
+	{
+		uint32_t tail = G_MESSAGE_QUEUE_CAPACITY - offset;
+		if(tail < sizeof(g_message_record))
+		{
+			remaining -= tail;
+			offset = 0;
+			continue;
+		}
+
+		g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+		if(record->state == G_MESSAGE_RECORD_STATE_LIVE && record->header.transaction == tx)
+			return offset;
+
+		remaining -= record->size;
+		offset += record->size;
+		if(offset == G_MESSAGE_QUEUE_CAPACITY)
+			offset = 0;
+	}
+	return G_MESSAGE_RECORD_NONE;
+}
+
+g_message_index_slot* _messageQueuesIndexFind(g_message_queue* queue, g_message_transaction tx)
+{
+	uint32_t mask = queue->indexSlots - 1;
+	uint32_t start = ((uint32_t) tx) & mask;
+	for(uint32_t i = 0; i < queue->indexSlots; i++)
+	{
+		g_message_index_slot* slot = &queue->index[(start + i) & mask];
+		if(slot->used && slot->transaction == tx)
+			return slot;
+		if(!slot->used && !slot->deleted)
+			break;
+	}
+	return nullptr;
+}
+
+/**
+ * Moves all used slots into a new table of the given size, dropping deleted slots.
+ */
+bool _messageQueuesIndexResize(g_message_queue* queue, uint32_t slots)
+{
+	auto index = (g_message_index_slot*) heapAllocateClear(sizeof(g_message_index_slot) * slots);
+	if(!index)
+		return false;
+
+	uint32_t mask = slots - 1;
+	for(uint32_t i = 0; i < queue->indexSlots; i++)
+	{
+		g_message_index_slot* slot = &queue->index[i];
+		if(!slot->used)
+			continue;
+
+		uint32_t target = ((uint32_t) slot->transaction) & mask;
+		while(index[target].used)
+			target = (target + 1) & mask;
+		index[target] = *slot;
+	}
+
+	heapFree(queue->index);
+	queue->index = index;
+	queue->indexSlots = slots;
+	queue->indexDeleted = 0;
+	return true;
+}
+
+void _messageQueuesIndexAdd(g_message_queue* queue, uint32_t offset)
+{
+	g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+	g_message_transaction tx = record->header.transaction;
+
+	g_message_index_slot* slot = _messageQueuesIndexFind(queue, tx);
+	if(slot)
+	{
+		G_MESSAGE_RECORD_AT(queue, slot->last)->nextInTransaction = offset;
+		slot->last = offset;
+		record->indexed = true;
+		return;
+	}
+
+	// Keep the load below 3/4, growing the table or clearing deleted slots
+	if((queue->indexUsed + queue->indexDeleted + 1) * 4 > queue->indexSlots * 3)
+	{
+		uint32_t slots = queue->indexSlots;
+		if((queue->indexUsed + 1) * 2 > slots && slots < G_MESSAGE_QUEUE_INDEX_MAXIMUM_SLOTS)
+			slots *= 2;
+		_messageQueuesIndexResize(queue, slots);
+	}
+
+	uint32_t mask = queue->indexSlots - 1;
+	uint32_t start = ((uint32_t) tx) & mask;
+	for(uint32_t i = 0; i < queue->indexSlots; i++)
+	{
+		slot = &queue->index[(start + i) & mask];
+		if(!slot->used)
+		{
+			if(slot->deleted)
+				queue->indexDeleted--;
+			queue->indexUsed++;
+			slot->used = true;
+			slot->deleted = false;
+			slot->transaction = tx;
+			slot->first = offset;
+			slot->last = offset;
+			record->indexed = true;
+			return;
+		}
+	}
+
+	record->indexed = false;
+	queue->unindexed++;
+}
+
+/**
+ * Removes a record from the index. Records are always received in order per transaction,
+ * so the record is the first in its chain.
+ */
+void _messageQueuesIndexRemove(g_message_queue* queue, uint32_t offset)
+{
+	g_message_record* record = G_MESSAGE_RECORD_AT(queue, offset);
+	if(!record->indexed)
+	{
+		queue->unindexed--;
+		return;
+	}
+
+	g_message_index_slot* slot = _messageQueuesIndexFind(queue, record->header.transaction);
+	if(!slot)
+		return;
+
+	if(record->nextInTransaction == G_MESSAGE_RECORD_NONE)
+	{
+		slot->used = false;
+		slot->deleted = true;
+		queue->indexUsed--;
+		queue->indexDeleted++;
+	}
+	else
+	{
+		slot->first = record->nextInTransaction;
+	}
 }
 
 g_message_queue* _messageQueuesGetOrCreate(g_tid receiver)
@@ -236,14 +675,28 @@ g_message_queue* _messageQueuesGetOrCreate(g_tid receiver)
 	}
 	else
 	{
-		queue = (g_message_queue*) heapAllocate(sizeof(g_message_queue));
-		mutexInitializeTask(&queue->lock, __func__);
-		queue->task = receiver;
-		queue->size = 0;
-		queue->head = nullptr;
-		queue->tail = nullptr;
-		waitQueueInitialize(&queue->waitersSend);
-		hashmapPut(messageQueues, receiver, queue);
+		queue = (g_message_queue*) heapAllocateClear(sizeof(g_message_queue));
+		if(queue)
+		{
+			queue->index = (g_message_index_slot*) heapAllocateClear(
+					sizeof(g_message_index_slot) * G_MESSAGE_QUEUE_INDEX_INITIAL_SLOTS);
+			queue->indexSlots = G_MESSAGE_QUEUE_INDEX_INITIAL_SLOTS;
+		}
+
+		if(!queue || !queue->index)
+		{
+			logInfo("%! failed to allocate message queue for task %i", "messages", receiver);
+			if(queue)
+				heapFree(queue);
+			queue = nullptr;
+		}
+		else
+		{
+			mutexInitializeTask(&queue->lock, __func__);
+			queue->task = receiver;
+			waitQueueInitialize(&queue->waitersSend);
+			hashmapPut(messageQueues, receiver, queue);
+		}
 	}
 
 	mutexRelease(&messageQueuesLock);
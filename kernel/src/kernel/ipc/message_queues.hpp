@@ -26,16 +26,76 @@
 
 #include <ghost/messages/callstructs.h>
 
+/**
+ * Number of slots in the transaction index of each queue. The index grows up to the maximum,
+ * which is large enough to hold every record that fits into a queue.
+ */
+#define G_MESSAGE_QUEUE_INDEX_INITIAL_SLOTS 64
+#define G_MESSAGE_QUEUE_INDEX_MAXIMUM_SLOTS 4096
+
+#define G_MESSAGE_RECORD_NONE           ((uint32_t) -1)
+
+#define G_MESSAGE_RECORD_STATE_LIVE     0
+#define G_MESSAGE_RECORD_STATE_CONSUMED 1
+#define G_MESSAGE_RECORD_STATE_PADDING  2
+
+/**
+ * A record in the ring buffer of a queue. The message header and its content
+ * follow directly after the record.
+ */
+struct g_message_record
+{
+    uint32_t size; // bytes occupied in the ring, including this record
+    uint32_t nextInTransaction; // offset of the next record with the same transaction
+    uint8_t state;
+    bool indexed;
+    uint16_t reserved;
+    g_message_header header;
+};
+
+/**
+ * Slot in the transaction index, chaining all live records of a transaction.
+ */
+struct g_message_index_slot
+{
+    g_message_transaction transaction;
+    uint32_t first;
+    uint32_t last;
+    bool used;
+    bool deleted;
+};
+
+struct g_message_queue_statistics
+{
+    uint32_t depth;
+    uint32_t highWaterDepth;
+    uint32_t highWaterSize;
+};
+
 /**
  * A message queue exists per task and removes messages once they are read by
  * the receiving task.
+ *
+ * Messages are stored as variable-length records in a ring buffer that is allocated
+ * with the first message. Receiving out of order by transaction marks the record as
+ * consumed, its space is reclaimed once the read offset passes it. If a message that
+ * is never received holds the read offset, the ring is compacted in place once it runs full.
  */
 struct g_message_queue
 {
     g_mutex lock;
-    g_message_header* head;
-    g_message_header* tail;
-    uint32_t size;
+    uint8_t* buffer;
+    uint32_t readOffset;
+    uint32_t writeOffset;
+    uint32_t used; // bytes used in the ring, including consumed records and padding
+    uint32_t size; // bytes of live messages including their headers
+
+    g_message_index_slot* index;
+    uint32_t indexSlots;
+    uint32_t indexUsed;
+    uint32_t indexDeleted;
+    uint32_t unindexed; // live records that did not fit into the index
+    g_message_queue_statistics statistics;
 
     g_tid task;
     g_wait_queue waitersSend;
@@ -47,21 +107,41 @@ struct g_message_queue
 void messageQueuesInitialize();
 
 /**
- * Sends a message.
+ * Sends a message. If the message carries page grants, their descriptors are the last
+ * part of the content and the number of them is passed as grants.
  */
 g_message_send_status messageQueueSend(g_tid sender, g_tid receiver, void* content, uint32_t length,
-                                  g_message_transaction tx);
+                                  g_message_transaction tx, uint32_t grants = 0);
 
 /**
  * Receives a message.
  */
 g_message_receive_status messageQueueReceive(g_tid receiver, g_message_header* out, uint32_t max, g_message_transaction tx);
 
+/**
+ * Receives as many messages as fit into the buffer, in the order they were sent. Each message
+ * is aligned to G_MESSAGE_BATCH_ALIGNMENT.
+ */
+g_message_receive_status messageQueueReceiveBatch(g_tid receiver, g_message_header* out, uint32_t max,
+                                                  uint32_t maxCount, uint32_t* outCount);
+
 /**
  * @return the next free message transaction ID in the system
  */
 g_message_transaction messageQueueNextTxId();
 
+/**
+ * Reads the statistics of the queue of the given task.
+ *
+ * @return whether the task has a queue
+ */
+bool messageQueueGetStatistics(g_tid receiver, g_message_queue_statistics* out);
+
+/**
+ * @return whether there are messages in the queue of the task
+ */
+bool messageQueueHasMessages(g_tid receiver);
+
 /**
  * Cleans up messages when a task is removed.
  */
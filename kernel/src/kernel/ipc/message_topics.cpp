@@ -29,7 +29,7 @@ static g_hashmap<const char*, g_message_topic*>* messageTopics = nullptr;
 static g_mutex messageTopicsLock;
 
 g_message_topic* _messageTopicsGetOrCreate(const char* name);
-void _messageTopicsAddToTail(g_message_topic* topic, g_message_header* message);
+void _messageTopicsResize(g_message_topic* topic, uint32_t capacity);
 
 void messageTopicsInitialize()
 {
@@ -37,44 +37,72 @@ void messageTopicsInitialize()
 	mutexInitializeGlobal(&messageTopicsLock);
 }
 
-g_message_send_status messageTopicsPost(const char* topicName, g_tid sender, void* content, uint32_t length)
+g_message_topic_status messageTopicsCreate(const char* topicName, uint32_t capacity)
 {
+	if(capacity == 0 || capacity > G_MESSAGE_TOPIC_MAXIMUM_CAPACITY)
+		return G_MESSAGE_TOPIC_STATUS_INVALID_CAPACITY;
+
 	g_message_topic* topic = _messageTopicsGetOrCreate(topicName);
 	mutexAcquire(&topic->lock);
+	_messageTopicsResize(topic, capacity);
+	mutexRelease(&topic->lock);
+	return G_MESSAGE_TOPIC_STATUS_SUCCESSFUL;
+}
+
+g_message_send_status messageTopicsPost(const char* topicName, g_tid sender, void* content, uint32_t length)
+{
+	if(length > G_MESSAGE_MAXIMUM_MESSAGE_LENGTH)
+		return G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM;
+
+	g_message_topic* topic = _messageTopicsGetOrCreate(topicName);
 
-	// Put message into the topic
 	uint32_t lengthWithHeader = sizeof(g_message_header) + length;
 	auto message = (g_message_header*) heapAllocate(lengthWithHeader);
+	if(!message)
+		return G_MESSAGE_SEND_STATUS_FAILED;
 	message->length = length;
 	message->sender = sender;
-	message->transaction = topic->nextTransaction++;
+	message->previous = nullptr;
+	message->next = nullptr;
+	message->grants = 0;
 	memoryCopy(G_MESSAGE_CONTENT(message), content, length);
-	_messageTopicsAddToTail(topic, message);
-	waitQueueWake(&topic->waitersReceive);
 
+	// Put message into its slot, replacing the oldest one
+	mutexAcquire(&topic->lock);
+	message->transaction = topic->nextTransaction++;
+
+	g_message_header** slot = &topic->ring[message->transaction % topic->capacity];
+	if(*slot)
+		heapFree(*slot);
+	*slot = message;
+	if(topic->nextTransaction - topic->oldestTransaction > (g_message_transaction) topic->capacity)
+		topic->oldestTransaction++;
+
+	waitQueueWake(&topic->waitersReceive);
 	mutexRelease(&topic->lock);
 	return G_MESSAGE_SEND_STATUS_SUCCESSFUL;
 }
 
 g_message_receive_status messageTopicsReceive(const char* topicName, g_message_transaction startAfter, void* out,
-                                              uint32_t max)
+                                              uint32_t max, uint32_t* outDropped)
 {
+	*outDropped = 0;
+
 	auto topic = _messageTopicsGetOrCreate(topicName);
 	mutexAcquire(&topic->lock);
 
-	// Find message that has higher or equal transaction number
-	auto message = topic->head;
-	while(message)
+	// Messages older than the capacity were overwritten
+	g_message_transaction wanted = startAfter + 1;
+	if(wanted < topic->oldestTransaction)
 	{
-		if(message->transaction > startAfter)
-			break;
-		message = message->next;
+		*outDropped = topic->oldestTransaction - wanted;
+		wanted = topic->oldestTransaction;
 	}
 
-	// Return it
 	g_message_receive_status status;
-	if(message)
+	if(wanted < topic->nextTransaction)
 	{
+		g_message_header* message = topic->ring[wanted % topic->capacity];
 		size_t lengthWithHeader = sizeof(g_message_header) + message->length;
 		if(lengthWithHeader > max)
 		{
@@ -110,18 +138,46 @@ g_message_topic* _messageTopicsGetOrCreate(const char* name)
 		topic = (g_message_topic*) heapAllocate(sizeof(g_message_topic));
 		mutexInitializeTask(&topic->lock, __func__);
 		topic->name = stringDuplicate(name);
-		topic->size = 0;
-		topic->head = nullptr;
-		topic->tail = nullptr;
+		topic->capacity = G_MESSAGE_TOPIC_DEFAULT_CAPACITY;
+		topic->ring = (g_message_header**) heapAllocateClear(sizeof(g_message_header*) * topic->capacity);
 		topic->nextTransaction = 0;
+		topic->oldestTransaction = 0;
 		waitQueueInitialize(&topic->waitersReceive);
-		hashmapPut(messageTopics, name, topic);
+		hashmapPut(messageTopics, topic->name, topic);
 	}
 
 	mutexRelease(&messageTopicsLock);
 	return topic;
 }
 
+/**
+ * Moves the newest messages into a ring of the new capacity, dropping those that no longer fit.
+ */
+void _messageTopicsResize(g_message_topic* topic, uint32_t capacity)
+{
+	if(capacity == topic->capacity)
+		return;
+
+	auto ring = (g_message_header**) heapAllocateClear(sizeof(g_message_header*) * capacity);
+	for(uint32_t i = 0; i < topic->capacity; i++)
+	{
+		g_message_header* message = topic->ring[i];
+		if(!message)
+			continue;
+
+		if(message->transaction + (g_message_transaction) capacity >= topic->nextTransaction)
+			ring[message->transaction % capacity] = message;
+		else
+			heapFree(message);
+	}
+
+	heapFree(topic->ring);
+	topic->ring = ring;
+	topic->capacity = capacity;
+	if(topic->nextTransaction - topic->oldestTransaction > (g_message_transaction) capacity)
+		topic->oldestTransaction = topic->nextTransaction - capacity;
+}
+
 void messageTopicsWaitForReceive(const char* topicName, g_tid receiver)
 {
 	auto topic = _messageTopicsGetOrCreate(topicName);
@@ -133,27 +189,3 @@ void messageTopicsUnwaitForReceive(const char* topicName, g_tid receiver)
 	auto topic = _messageTopicsGetOrCreate(topicName);
 	waitQueueRemove(&topic->waitersReceive, receiver);
 }
-
-void _messageTopicsAddToTail(g_message_topic* topic, g_message_header* message)
-{
-	mutexAcquire(&topic->lock);
-
-	topic->size += sizeof(g_message_header) + message->length;
-
-	message->next = nullptr;
-	if(topic->head)
-	{
-		message->previous = topic->tail;
-		topic->tail->next = message;
-		topic->tail = message;
-	}
-	else
-	{
-		topic->head = message;
-		topic->tail = message;
-		message->previous = nullptr;
-		message->next = nullptr;
-	}
-
-	mutexRelease(&topic->lock);
-}
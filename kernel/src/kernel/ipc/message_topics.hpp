@@ -29,15 +29,18 @@
  * A message topic is identified by a name and persists posted message.
  * The transaction is always counted up for each posted message. Receiving tasks
  * must always use the previous transaction number for receiving.
+ *
+ * Only the newest messages are retained in a ring that is indexed by the
+ * transaction modulo the capacity of the topic.
  */
 struct g_message_topic
 {
     const char* name;
     g_mutex lock;
-    g_message_header* head;
-    g_message_header* tail;
-    uint32_t size;
+    g_message_header** ring;
+    uint32_t capacity;
 
+    g_message_transaction oldestTransaction;
     g_message_transaction nextTransaction;
 
     g_wait_queue waitersReceive;
@@ -48,6 +51,11 @@ struct g_message_topic
  */
 void messageTopicsInitialize();
 
+/**
+ * Creates the topic if it doesn't exist and sets the number of messages it retains.
+ */
+g_message_topic_status messageTopicsCreate(const char* topicName, uint32_t capacity);
+
 /**
  * Posts a message to the topic.
  */
@@ -55,9 +63,11 @@ g_message_send_status messageTopicsPost(const char* topicName, g_tid sender, voi
 
 /**
  * Receives the next message from the topic, starting at the given transaction index.
+ * If messages after the given transaction were already overwritten, the oldest retained
+ * message is received and the number of missed messages is written to outDropped.
  */
 g_message_receive_status messageTopicsReceive(const char* topicName, g_message_transaction startAfter, void* out,
-                                              uint32_t max);
+                                              uint32_t max, uint32_t* outDropped);
 
 /**
  * Adds the task to the receive-wait queue of the topic.
@@ -28,6 +28,11 @@ static g_fs_phys_id pipeNextId;
 static g_mutex pipeNextIdLock;
 static g_hashmap<g_fs_phys_id, g_pipeline*>* pipeMap;
 
+/**
+ * Applies the default to and page-aligns the capacity, or returns 0 if it is too large.
+ */
+uint32_t _pipeValidateCapacity(uint32_t capacity);
+
 void pipeInitialize()
 {
 	mutexInitializeTask(&pipeNextIdLock, __func__);
@@ -36,13 +41,21 @@ void pipeInitialize()
 	pipeMap = hashmapCreateNumeric<g_fs_phys_id, g_pipeline*>(128);
 }
 
-g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId)
+g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId, uint32_t capacity)
 {
+	capacity = _pipeValidateCapacity(capacity);
+	if(!capacity)
+		return G_FS_PIPE_INVALID_CAPACITY;
+
+	uint8_t* buffer = (uint8_t*) memoryAllocateKernel(capacity / G_PAGE_SIZE);
+	if(!buffer)
+		return G_FS_PIPE_ERROR;
+
 	g_pipeline* pipe = (g_pipeline*) heapAllocateClear(sizeof(g_pipeline));
 
 	mutexInitializeTask(&pipe->lock, __func__);
-	pipe->capacity = G_PIPE_DEFAULT_CAPACITY;
-	pipe->buffer = (uint8_t*) memoryAllocateKernel(G_PAGE_ALIGN_UP(pipe->capacity) / G_PAGE_SIZE);
+	pipe->capacity = capacity;
+	pipe->buffer = buffer;
 	pipe->readPosition = pipe->buffer;
 	pipe->writePosition = pipe->buffer;
 	waitQueueInitialize(&pipe->waitersRead);
@@ -55,8 +68,75 @@ g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId)
 	return G_FS_PIPE_SUCCESSFUL;
 }
 
+uint32_t _pipeValidateCapacity(uint32_t capacity)
+{
+	if(capacity == 0)
+		capacity = G_PIPE_DEFAULT_CAPACITY;
+	if(capacity > G_PIPE_MAXIMUM_CAPACITY)
+		return 0;
+
+	// The buffer is allocated in pages, so don't waste the rest of the last one
+	return G_PAGE_ALIGN_UP(capacity);
+}
+
+g_fs_pipe_status pipeSetCapacity(g_fs_phys_id pipeId, uint32_t capacity)
+{
+	g_pipeline* pipe = pipeGetById(pipeId);
+	if(!pipe)
+		return G_FS_PIPE_ERROR;
+
+	capacity = _pipeValidateCapacity(capacity);
+	if(!capacity)
+		return G_FS_PIPE_INVALID_CAPACITY;
+
+	mutexAcquire(&pipe->lock);
+
+	if(capacity < pipe->size)
+	{
+		mutexRelease(&pipe->lock);
+		return G_FS_PIPE_INVALID_CAPACITY;
+	}
+
+	if(capacity == pipe->capacity)
+	{
+		mutexRelease(&pipe->lock);
+		return G_FS_PIPE_SUCCESSFUL;
+	}
+
+	uint8_t* buffer = (uint8_t*) memoryAllocateKernel(capacity / G_PAGE_SIZE);
+	if(!buffer)
+	{
+		mutexRelease(&pipe->lock);
+		return G_FS_PIPE_ERROR;
+	}
+
+	// Move the buffered content to the start of the new buffer
+	uint32_t lengthToEnd = ((uint32_t) pipe->buffer + pipe->capacity) - (uint32_t) pipe->readPosition;
+	if(pipe->size > lengthToEnd)
+	{
+		memoryCopy(buffer, pipe->readPosition, lengthToEnd);
+		memoryCopy(&buffer[lengthToEnd], pipe->buffer, pipe->size - lengthToEnd);
+	}
+	else
+	{
+		memoryCopy(buffer, pipe->readPosition, pipe->size);
+	}
+
+	memoryFreeKernelRange((g_virtual_address) pipe->buffer);
+	pipe->buffer = buffer;
+	pipe->capacity = capacity;
+	pipe->readPosition = buffer;
+	pipe->writePosition = (pipe->size == capacity) ? buffer : buffer + pipe->size;
+
+	waitQueueWakeOne(&pipe->waitersWrite);
+	mutexRelease(&pipe->lock);
+	return G_FS_PIPE_SUCCESSFUL;
+}
+
 void pipeDeleteInternal(g_fs_phys_id pipeId, g_pipeline* pipe)
 {
+	waitQueueDestroy(&pipe->waitersRead);
+	waitQueueDestroy(&pipe->waitersWrite);
 	memoryFreeKernelRange((g_virtual_address) pipe->buffer);
 	heapFree(pipe);
 	hashmapRemove(pipeMap, pipeId);
@@ -170,7 +250,9 @@ g_fs_read_status pipeRead(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offset,
 
 		*outRead = length;
 		status = G_FS_READ_SUCCESSFUL;
-		waitQueueWake(&pipe->waitersWrite);
+		waitQueueWakeOne(&pipe->waitersWrite);
+		if(pipe->size > 0)
+			waitQueueWakeOne(&pipe->waitersRead);
 	}
 	else
 	{
@@ -221,7 +303,9 @@ g_fs_write_status pipeWrite(g_fs_phys_id pipeId, uint8_t* buffer, uint64_t offse
 		*outWrote = length;
 
 		status = G_FS_WRITE_SUCCESSFUL;
-		waitQueueWake(&pipe->waitersRead);
+		waitQueueWakeOne(&pipe->waitersRead);
+		if(pipe->size < pipe->capacity)
+			waitQueueWakeOne(&pipe->waitersWrite);
 	}
 	else
 	{
@@ -258,20 +342,54 @@ g_fs_open_status pipeTruncate(g_fs_phys_id pipeId)
 	return G_FS_OPEN_SUCCESSFUL;
 }
 
-void pipeWaitForRead(g_tid task, g_fs_phys_id pipeId)
+void pipeWaitForRead(g_tid task, g_fs_phys_id pipeId, bool exclusive)
+{
+	g_pipeline* pipe = pipeGetById(pipeId);
+	if(!pipe)
+		return;
+
+	waitQueueAdd(&pipe->waitersRead, task, exclusive);
+}
+
+void pipeWaitForWrite(g_tid task, g_fs_phys_id pipeId, bool exclusive)
 {
 	g_pipeline* pipe = pipeGetById(pipeId);
 	if(!pipe)
 		return;
 
-	waitQueueAdd(&pipe->waitersRead, task);
+	waitQueueAdd(&pipe->waitersWrite, task, exclusive);
 }
 
-void pipeWaitForWrite(g_tid task, g_fs_phys_id pipeId)
+void pipeUnwaitForRead(g_tid task, g_fs_phys_id pipeId)
 {
 	g_pipeline* pipe = pipeGetById(pipeId);
 	if(!pipe)
 		return;
 
-	waitQueueAdd(&pipe->waitersWrite, task);
+	waitQueueRemove(&pipe->waitersRead, task);
+}
+
+void pipeUnwaitForWrite(g_tid task, g_fs_phys_id pipeId)
+{
+	g_pipeline* pipe = pipeGetById(pipeId);
+	if(!pipe)
+		return;
+
+	waitQueueRemove(&pipe->waitersWrite, task);
+}
+
+g_poll_events pipePoll(g_fs_phys_id pipeId)
+{
+	g_pipeline* pipe = pipeGetById(pipeId);
+	if(!pipe)
+		return G_POLL_EVENT_INVALID;
+
+	g_poll_events events = G_POLL_EVENT_NONE;
+	mutexAcquire(&pipe->lock);
+	if(pipe->size > 0 || pipe->referencesWrite == 0)
+		events |= G_POLL_EVENT_READ;
+	if(pipe->size < pipe->capacity)
+		events |= G_POLL_EVENT_WRITE;
+	mutexRelease(&pipe->lock);
+	return events;
 }
@@ -23,6 +23,7 @@
 
 #include "kernel/utils/wait_queue.hpp"
 #include "shared/system/mutex.hpp"
+#include <ghost/poll/types.h>
 
 /**
  * Entry in the reference list of a pipe.
@@ -69,9 +70,15 @@ g_fs_phys_id pipeGetNextId();
 g_pipeline* pipeGetById(g_fs_phys_id pipeId);
 
 /**
- * Creates a new pipe.
+ * Creates a new pipe. A capacity of zero uses the default capacity.
  */
-g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId);
+g_fs_pipe_status pipeCreate(g_fs_phys_id* outPipeId, uint32_t capacity = 0);
+
+/**
+ * Resizes the buffer of the pipe, keeping its content. Fails if the content
+ * doesn't fit into the new capacity.
+ */
+g_fs_pipe_status pipeSetCapacity(g_fs_phys_id pipeId, uint32_t capacity);
 
 /**
  * Adds a read or write reference to the pipe.
@@ -96,7 +103,19 @@ g_fs_open_status pipeTruncate(g_fs_phys_id pipeId);
  */
 void pipeDeleteInternal(g_fs_phys_id pipeId, g_pipeline* pipe);
 
-void pipeWaitForRead(g_tid task, g_fs_phys_id pipeId);
-void pipeWaitForWrite(g_tid task, g_fs_phys_id pipeId);
+/**
+ * Adds the task to the waiters of the pipe. Read and write only wake as many exclusive
+ * waiters as can make progress, each of them passes the wake on if there is more left.
+ */
+void pipeWaitForRead(g_tid task, g_fs_phys_id pipeId, bool exclusive);
+void pipeWaitForWrite(g_tid task, g_fs_phys_id pipeId, bool exclusive);
+void pipeUnwaitForRead(g_tid task, g_fs_phys_id pipeId);
+void pipeUnwaitForWrite(g_tid task, g_fs_phys_id pipeId);
+
+/**
+ * A pipe is readable while it has content or no writer is left (end of file),
+ * and writable while it has space.
+ */
+g_poll_events pipePoll(g_fs_phys_id pipeId);
 
 #endif
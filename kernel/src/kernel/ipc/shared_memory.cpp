@@ -0,0 +1,321 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/ipc/shared_memory.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/memory/page_reference_tracker.hpp"
+#include "kernel/utils/hashmap.hpp"
+
+#include "shared/logger/logger.hpp"
+
+static g_shm sharedMemoryNextId;
+static g_mutex sharedMemoryLock;
+static g_hashmap<g_shm, g_shared_memory*>* sharedMemoryObjects;
+
+bool _sharedMemoryIsHeldBy(g_process* process, g_shm id);
+bool _sharedMemoryAddToProcess(g_process* process, g_shm id);
+bool _sharedMemoryRemoveFromProcess(g_process* process, g_shm id);
+g_shared_memory* _sharedMemoryAcquire(g_process* process, g_shm id);
+void _sharedMemoryDestroy(g_shared_memory* shm);
+
+void sharedMemoryInitialize()
+{
+	mutexInitializeTask(&sharedMemoryLock, __func__);
+	sharedMemoryNextId = 0;
+
+	sharedMemoryObjects = hashmapCreateNumeric<g_shm, g_shared_memory*>(64);
+}
+
+g_shm_status sharedMemoryCreate(g_process* process, uint32_t pages, g_shm* outId)
+{
+	if(pages == 0)
+		return G_SHM_STATUS_ERROR;
+
+	auto physicalPages = (g_physical_address*) heapAllocate(sizeof(g_physical_address) * pages);
+	if(!physicalPages)
+		return G_SHM_STATUS_NO_MEMORY;
+
+	for(uint32_t i = 0; i < pages; i++)
+	{
+		physicalPages[i] = memoryPhysicalAllocate();
+		if(!physicalPages[i])
+		{
+			logInfo("%! ran out of physical memory when creating shared memory object", "shm");
+			for(uint32_t j = 0; j < i; j++)
+				memoryPhysicalFree(physicalPages[j]);
+			heapFree(physicalPages);
+			return G_SHM_STATUS_NO_MEMORY;
+		}
+	}
+
+	auto shm = (g_shared_memory*) heapAllocateClear(sizeof(g_shared_memory));
+	mutexInitializeTask(&shm->lock, __func__);
+	shm->references = 1;
+	shm->sealed = false;
+	shm->pages = pages;
+	shm->physicalPages = physicalPages;
+
+	mutexAcquire(&sharedMemoryLock);
+	shm->id = sharedMemoryNextId++;
+	hashmapPut<g_shm, g_shared_memory*>(sharedMemoryObjects, shm->id, shm);
+	mutexRelease(&sharedMemoryLock);
+
+	_sharedMemoryAddToProcess(process, shm->id);
+
+	*outId = shm->id;
+	return G_SHM_STATUS_SUCCESSFUL;
+}
+
+g_shm_status sharedMemoryGrant(g_process* process, g_shm id, g_process* target)
+{
+	g_shared_memory* shm = _sharedMemoryAcquire(process, id);
+	if(!shm)
+		return G_SHM_STATUS_INVALID;
+
+	if(_sharedMemoryAddToProcess(target, id))
+		shm->references++;
+
+	mutexRelease(&shm->lock);
+	return G_SHM_STATUS_SUCCESSFUL;
+}
+
+g_shm_status sharedMemoryMap(g_process* process, g_shm id, g_virtual_address* outAddress, uint32_t* outPages)
+{
+	g_shared_memory* shm = _sharedMemoryAcquire(process, id);
+	if(!shm)
+		return G_SHM_STATUS_INVALID;
+
+	g_virtual_address base = addressRangePoolAllocate(process->virtualRangePool, shm->pages,
+	                                                  G_PROC_VIRTUAL_RANGE_FLAG_NONE);
+	if(base == 0)
+	{
+		logInfo("%! process %i could not allocate a virtual range for mapping object %i", "shm", process->id, id);
+		mutexRelease(&shm->lock);
+		return G_SHM_STATUS_NO_MEMORY;
+	}
+
+	uint32_t pageFlags = shm->sealed ? (G_PAGE_PRESENT | G_PAGE_USERSPACE) : G_PAGE_USER_DEFAULT;
+	mutexAcquire(&process->lock);
+	for(uint32_t i = 0; i < shm->pages; i++)
+	{
+		pagingMapPage(base + i * G_PAGE_SIZE, shm->physicalPages[i], G_PAGE_TABLE_USER_DEFAULT, pageFlags);
+		pageReferenceTrackerIncrement(shm->physicalPages[i]);
+	}
+	mutexRelease(&process->lock);
+
+	*outAddress = base;
+	*outPages = shm->pages;
+	mutexRelease(&shm->lock);
+	return G_SHM_STATUS_SUCCESSFUL;
+}
+
+g_shm_status sharedMemoryResize(g_process* process, g_shm id, uint32_t pages)
+{
+	if(pages == 0)
+		return G_SHM_STATUS_ERROR;
+
+	g_shared_memory* shm = _sharedMemoryAcquire(process, id);
+	if(!shm)
+		return G_SHM_STATUS_INVALID;
+
+	if(shm->sealed)
+	{
+		mutexRelease(&shm->lock);
+		return G_SHM_STATUS_SEALED;
+	}
+
+	auto physicalPages = (g_physical_address*) heapAllocate(sizeof(g_physical_address) * pages);
+	if(!physicalPages)
+	{
+		mutexRelease(&shm->lock);
+		return G_SHM_STATUS_NO_MEMORY;
+	}
+
+	uint32_t kept = shm->pages < pages ? shm->pages : pages;
+	for(uint32_t i = 0; i < kept; i++)
+		physicalPages[i] = shm->physicalPages[i];
+
+	for(uint32_t i = kept; i < pages; i++)
+	{
+		physicalPages[i] = memoryPhysicalAllocate();
+		if(!physicalPages[i])
+		{
+			logInfo("%! ran out of physical memory when resizing shared memory object %i", "shm", id);
+			for(uint32_t j = kept; j < i; j++)
+				memoryPhysicalFree(physicalPages[j]);
+			heapFree(physicalPages);
+			mutexRelease(&shm->lock);
+			return G_SHM_STATUS_NO_MEMORY;
+		}
+	}
+
+	// Pages that are cut off stay alive as long as they are mapped somewhere
+	for(uint32_t i = kept; i < shm->pages; i++)
+		memoryPhysicalFree(shm->physicalPages[i]);
+
+	heapFree(shm->physicalPages);
+	shm->physicalPages = physicalPages;
+	shm->pages = pages;
+
+	mutexRelease(&shm->lock);
+	return G_SHM_STATUS_SUCCESSFUL;
+}
+
+g_shm_status sharedMemorySeal(g_process* process, g_shm id)
+{
+	g_shared_memory* shm = _sharedMemoryAcquire(process, id);
+	if(!shm)
+		return G_SHM_STATUS_INVALID;
+
+	// The object holds one reference on each page, any other is a writable mapping
+	for(uint32_t i = 0; i < shm->pages && !shm->sealed; i++)
+	{
+		if(pageReferenceTrackerGet(shm->physicalPages[i]) > 1)
+		{
+			mutexRelease(&shm->lock);
+			return G_SHM_STATUS_MAPPED;
+		}
+	}
+	shm->sealed = true;
+
+	mutexRelease(&shm->lock);
+	return G_SHM_STATUS_SUCCESSFUL;
+}
+
+g_shm_status sharedMemoryRelease(g_process* process, g_shm id)
+{
+	if(!_sharedMemoryRemoveFromProcess(process, id))
+		return G_SHM_STATUS_INVALID;
+
+	mutexAcquire(&sharedMemoryLock);
+	g_shared_memory* shm = hashmapGet<g_shm, g_shared_memory*>(sharedMemoryObjects, id, nullptr);
+	if(!shm)
+	{
+		mutexRelease(&sharedMemoryLock);
+		return G_SHM_STATUS_INVALID;
+	}
+
+	mutexAcquire(&shm->lock);
+	bool destroy = --shm->references == 0;
+	if(destroy)
+		hashmapRemove<g_shm, g_shared_memory*>(sharedMemoryObjects, id);
+	mutexRelease(&shm->lock);
+	mutexRelease(&sharedMemoryLock);
+
+	if(destroy)
+		_sharedMemoryDestroy(shm);
+	return G_SHM_STATUS_SUCCESSFUL;
+}
+
+void sharedMemoryProcessRemoved(g_process* process)
+{
+	while(process->sharedMemory)
+		sharedMemoryRelease(process, process->sharedMemory->id);
+}
+
+void _sharedMemoryDestroy(g_shared_memory* shm)
+{
+	for(uint32_t i = 0; i < shm->pages; i++)
+		memoryPhysicalFree(shm->physicalPages[i]);
+
+	heapFree(shm->physicalPages);
+	heapFree(shm);
+}
+
+/**
+ * Looks up the object and acquires its lock, if the process holds a handle to it.
+ */
+g_shared_memory* _sharedMemoryAcquire(g_process* process, g_shm id)
+{
+	if(!_sharedMemoryIsHeldBy(process, id))
+		return nullptr;
+
+	mutexAcquire(&sharedMemoryLock);
+	g_shared_memory* shm = hashmapGet<g_shm, g_shared_memory*>(sharedMemoryObjects, id, nullptr);
+	if(shm)
+		mutexAcquire(&shm->lock);
+	mutexRelease(&sharedMemoryLock);
+	return shm;
+}
+
+bool _sharedMemoryIsHeldBy(g_process* process, g_shm id)
+{
+	mutexAcquire(&process->lock);
+	g_shared_memory_reference* ref = process->sharedMemory;
+	while(ref && ref->id != id)
+		ref = ref->next;
+	mutexRelease(&process->lock);
+	return ref != nullptr;
+}
+
+/**
+ * @return whether the handle was added, false if the process already held it
+ */
+bool _sharedMemoryAddToProcess(g_process* process, g_shm id)
+{
+	mutexAcquire(&process->lock);
+
+	g_shared_memory_reference* ref = process->sharedMemory;
+	while(ref && ref->id != id)
+		ref = ref->next;
+
+	bool added = false;
+	if(!ref)
+	{
+		ref = (g_shared_memory_reference*) heapAllocate(sizeof(g_shared_memory_reference));
+		ref->id = id;
+		ref->next = process->sharedMemory;
+		process->sharedMemory = ref;
+		added = true;
+	}
+
+	mutexRelease(&process->lock);
+	return added;
+}
+
+/**
+ * @return whether the process held the handle
+ */
+bool _sharedMemoryRemoveFromProcess(g_process* process, g_shm id)
+{
+	mutexAcquire(&process->lock);
+
+	g_shared_memory_reference* previous = nullptr;
+	g_shared_memory_reference* ref = process->sharedMemory;
+	while(ref && ref->id != id)
+	{
+		previous = ref;
+		ref = ref->next;
+	}
+
+	bool removed = false;
+	if(ref)
+	{
+		if(previous)
+			previous->next = ref->next;
+		else
+			process->sharedMemory = ref->next;
+		heapFree(ref);
+		removed = true;
+	}
+
+	mutexRelease(&process->lock);
+	return removed;
+}
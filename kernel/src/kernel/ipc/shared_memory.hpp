@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_IPC_SHARED_MEMORY__
+#define __KERNEL_IPC_SHARED_MEMORY__
+
+#include "kernel/tasking/task.hpp"
+#include "shared/system/mutex.hpp"
+
+#include <ghost/memory/types.h>
+
+/**
+ * A shared memory object is a set of physical pages that can be mapped by each
+ * process that holds a handle to it. The object itself holds one reference on
+ * each of its pages, each mapping holds another one.
+ */
+struct g_shared_memory
+{
+	g_mutex lock;
+	g_shm id;
+
+	/**
+	 * Number of processes that hold a handle to this object.
+	 */
+	int references;
+
+	/**
+	 * Once sealed, the object can't be resized and is only mapped read-only.
+	 */
+	bool sealed;
+
+	uint32_t pages;
+	g_physical_address* physicalPages;
+};
+
+/**
+ * Entry in the list of shared memory handles that a process holds.
+ */
+struct g_shared_memory_reference
+{
+	g_shm id;
+	g_shared_memory_reference* next;
+};
+
+/**
+ * Initializes the shared memory objects.
+ */
+void sharedMemoryInitialize();
+
+/**
+ * Creates a new shared memory object with the given number of pages. The process
+ * receives the first handle to it.
+ */
+g_shm_status sharedMemoryCreate(g_process* process, uint32_t pages, g_shm* outId);
+
+/**
+ * Gives a handle to the object to the target process. The granting process must
+ * hold a handle itself.
+ */
+g_shm_status sharedMemoryGrant(g_process* process, g_shm id, g_process* target);
+
+/**
+ * Maps all pages of the object into the current address space, which must be the
+ * address space of the given process.
+ */
+g_shm_status sharedMemoryMap(g_process* process, g_shm id, g_virtual_address* outAddress, uint32_t* outPages);
+
+/**
+ * Changes the number of pages of the object. Existing mappings are not changed.
+ */
+g_shm_status sharedMemoryResize(g_process* process, g_shm id, uint32_t pages);
+
+/**
+ * Seals the object so that it can't be resized and is only mapped read-only. Fails
+ * while any of its pages is mapped, as these mappings are writable.
+ */
+g_shm_status sharedMemorySeal(g_process* process, g_shm id);
+
+/**
+ * Removes the handle of the process to the object. If no more handles exist, the
+ * object is destroyed.
+ */
+g_shm_status sharedMemoryRelease(g_process* process, g_shm id);
+
+/**
+ * Releases all handles when a process is removed.
+ */
+void sharedMemoryProcessRemoved(g_process* process);
+
+#endif
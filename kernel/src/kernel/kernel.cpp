@@ -25,14 +25,16 @@
 #include "kernel/ipc/message_queues.hpp"
 #include "kernel/ipc/message_topics.hpp"
 #include "kernel/ipc/pipes.hpp"
+#include "kernel/ipc/shared_memory.hpp"
 #include "kernel/logger/kernel_logger.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/system/processor/processor.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/system/system.hpp"
-#include "kernel/tasking/user_mutex.hpp"
+#include "kernel/tasking/futex.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/tasking.hpp"
+#include "kernel/utils/wait_queue.hpp"
 #include "shared/system/mutex.hpp"
 #include "shared/panic.hpp"
 #include "shared/setup_information.hpp"
@@ -78,11 +80,13 @@ void kernelRunBootstrapCore(g_physical_address initialPdPhys)
 
 	systemInitializeBsp(initialPdPhys);
 	clockInitialize();
+	waitQueuesInitialize();
 	filesystemInitialize();
 	pipeInitialize();
+	sharedMemoryInitialize();
 	messageQueuesInitialize();
 	messageTopicsInitialize();
-	userMutexInitialize();
+	futexInitialize();
 
 	taskingInitializeBsp();
 	logInfo("%! starting on %i cores", "kernel", processorGetNumberOfProcessors());
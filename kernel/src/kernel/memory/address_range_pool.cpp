@@ -21,6 +21,7 @@
 #include "kernel/memory/address_range_pool.hpp"
 #include "kernel/memory/heap.hpp"
 #include "shared/logger/logger.hpp"
+#include "shared/memory/memory.hpp"
 #include "shared/panic.hpp"
 
 void addressRangePoolInitialize(g_address_range_pool* pool)
@@ -177,6 +178,79 @@ g_address addressRangePoolAllocate(g_address_range_pool* pool, uint32_t requeste
 	return 0;
 }
 
+g_address addressRangePoolAllocateAligned(g_address_range_pool* pool, uint32_t requestedPages, g_address alignment,
+                                          uint8_t flags)
+{
+	if(pool == 0)
+		panic("%! tried to access null pool", "addrpool");
+
+	mutexAcquire(&pool->lock);
+
+	if(requestedPages == 0)
+	{
+		requestedPages = 1;
+	}
+
+	// Find an unused range that fits the requested pages after its aligned base
+	g_address_range* range = pool->first;
+	uint32_t leadingPages = 0;
+	while(range)
+	{
+		if(!range->used)
+		{
+			g_address alignedBase = G_ALIGN_UP(range->base, alignment);
+			leadingPages = (alignedBase - range->base) / G_PAGE_SIZE;
+			if(range->pages >= leadingPages + requestedPages)
+				break;
+		}
+
+		range = range->next;
+	}
+
+	if(range)
+	{
+		// Leave the part before the aligned base free
+		if(leadingPages > 0)
+		{
+			g_address_range* aligned = (g_address_range*) heapAllocate(sizeof(g_address_range));
+			aligned->used = false;
+			aligned->pages = range->pages - leadingPages;
+			aligned->base = range->base + leadingPages * G_PAGE_SIZE;
+			aligned->flags = 0;
+
+			aligned->next = range->next;
+			range->next = aligned;
+			range->pages = leadingPages;
+			range = aligned;
+		}
+
+		range->used = true;
+		range->flags = flags;
+
+		int32_t remainingPages = range->pages - requestedPages;
+		if(remainingPages > 0)
+		{
+			g_address_range* splinter = (g_address_range*) heapAllocate(sizeof(g_address_range));
+			splinter->used = false;
+			splinter->pages = remainingPages;
+			splinter->base = range->base + requestedPages * G_PAGE_SIZE;
+			splinter->flags = 0;
+
+			splinter->next = range->next;
+			range->next = splinter;
+			range->pages = requestedPages;
+		}
+
+		mutexRelease(&pool->lock);
+		return range->base;
+	}
+
+	logInfo("%! critical, no free range of size %i pages aligned to %h", "addrpool", requestedPages, alignment);
+	addressRangePoolDump(pool);
+	mutexRelease(&pool->lock);
+	return 0;
+}
+
 int32_t addressRangePoolFree(g_address_range_pool* pool, g_address base)
 {
 	mutexAcquire(&pool->lock);
@@ -53,6 +53,12 @@ void addressRangePoolMerge(g_address_range_pool* pool);
 
 g_address addressRangePoolAllocate(g_address_range_pool* pool, uint32_t pages, uint8_t flags = 0);
 
+/**
+ * Allocates a range whose base is aligned to the given alignment (a multiple of the page size).
+ */
+g_address addressRangePoolAllocateAligned(g_address_range_pool* pool, uint32_t pages, g_address alignment,
+                                          uint8_t flags = 0);
+
 int32_t addressRangePoolFree(g_address_range_pool* pool, g_address base);
 
 g_address_range* addressRangePoolGetRanges(g_address_range_pool* pool);
@@ -116,7 +116,7 @@ void memoryFreeKernelRange(g_virtual_address address)
 }
 
 void memoryOnDemandMapFile(g_process* process, g_fd file, g_offset fileOffset, g_address fileStart, g_ptrsize fileSize,
-                           g_ptrsize memorySize)
+                           g_ptrsize memorySize, bool writable)
 {
 	g_memory_file_ondemand* mapping = (g_memory_file_ondemand*) heapAllocate(sizeof(g_memory_file_ondemand));
 	mapping->fd = file;
@@ -124,6 +124,7 @@ void memoryOnDemandMapFile(g_process* process, g_fd file, g_offset fileOffset, g
 	mapping->fileOffset = fileOffset;
 	mapping->fileSize = fileSize;
 	mapping->memSize = memorySize;
+	mapping->writable = writable;
 
 	mapping->next = process->onDemandMappings;
 	process->onDemandMappings = mapping;
@@ -145,8 +146,12 @@ g_memory_file_ondemand* memoryOnDemandFindMapping(g_task* task, g_address addres
 	return nullptr;
 }
 
-bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed)
+bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed, uint32_t error)
 {
+	// Faults on present pages are protection violations, like writing to a page shared with the page cache
+	if(error & G_PAGE_FAULT_PRESENT)
+		return false;
+
 	auto mapping = memoryOnDemandFindMapping(task, accessed);
 	if(!mapping)
 		return false;
@@ -155,6 +160,16 @@ bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed)
 	auto accessedRight = accessedLeft + G_PAGE_SIZE;
 	auto fileEnd = mapping->fileStart + mapping->fileSize;
 
+	// Kernel accesses (like relocating during spawn) always get a private copy
+	if(!mapping->writable && (error & G_PAGE_FAULT_USER) && !(error & G_PAGE_FAULT_WRITE) &&
+	   accessedLeft >= mapping->fileStart && accessedRight <= fileEnd)
+	{
+		g_offset fileOffset = mapping->fileOffset + (accessedLeft - mapping->fileStart);
+		if(G_PAGE_ALIGN_DOWN(fileOffset) == fileOffset &&
+		   filesystemMapCachedPage(task->process, mapping->fd, fileOffset, accessedLeft))
+			return true;
+	}
+
 	// Allocate requested page
 	pagingMapPage(accessedLeft, memoryPhysicalAllocate(), G_PAGE_TABLE_USER_DEFAULT, G_PAGE_USER_DEFAULT);
 
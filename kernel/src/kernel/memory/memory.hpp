@@ -60,7 +60,7 @@ void memoryFreeKernelRange(g_virtual_address address);
  * Creates an on-demand mapping for a file in memory.
  */
 void memoryOnDemandMapFile(g_process* process, g_fd file, g_offset fileOffset, g_address fileStart, g_ptrsize fileSize,
-                           g_ptrsize memorySize);
+                           g_ptrsize memorySize, bool writable);
 
 /**
  * Searches for an on-demand mapping containing the given address.
@@ -68,8 +68,12 @@ void memoryOnDemandMapFile(g_process* process, g_fd file, g_offset fileOffset, g
 g_memory_file_ondemand* memoryOnDemandFindMapping(g_task* task, g_address address);
 
 /**
- * Handles loading of the on-demand mapped file content.
+ * Handles loading of the on-demand mapped file content. Pages of read-only content that a
+ * user-mode read faults in are mapped directly from the page cache, all others are copies.
+ *
+ * @param error
+ * 		the error code of the page fault
  */
-bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed);
+bool memoryOnDemandHandlePageFault(g_task* task, g_address accessed, uint32_t error);
 
 #endif
@@ -74,3 +74,15 @@ int16_t pageReferenceTrackerDecrement(g_physical_address address)
 
 	return refs < 0 ? 0 : refs;
 }
+
+int16_t pageReferenceTrackerGet(g_physical_address address)
+{
+	mutexAcquire(&lock);
+
+	uint32_t ti = G_TABLE_IN_DIRECTORY_INDEX(address);
+	uint32_t pi = G_PAGE_IN_TABLE_INDEX(address);
+	int16_t refs = directory.tables[ti] ? directory.tables[ti]->referenceCount[pi] : 0;
+
+	mutexRelease(&lock);
+	return refs < 0 ? 0 : refs;
+}
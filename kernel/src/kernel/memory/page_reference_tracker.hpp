@@ -54,4 +54,9 @@ void pageReferenceTrackerIncrement(g_physical_address address);
  */
 int16_t pageReferenceTrackerDecrement(g_physical_address address);
 
+/**
+ * @return the number of references on a physical page
+ */
+int16_t pageReferenceTrackerGet(g_physical_address address);
+
 #endif
@@ -20,6 +20,9 @@
 
 #include "kernel/memory/paging.hpp"
 #include "shared/memory/constants.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "shared/logger/logger.hpp"
+#include "shared/panic.hpp"
 
 g_physical_address pagingVirtualToPhysical(g_virtual_address addr)
 {
@@ -30,6 +33,45 @@ g_physical_address pagingVirtualToPhysical(g_virtual_address addr)
 	if(directory[ti] == 0)
 		return 0;
 
+	if(directory[ti] & G_PAGE_TABLE_SIZE)
+		return (directory[ti] & ~G_LARGE_PAGE_ALIGN_MASK) + (addr & G_LARGE_PAGE_ALIGN_MASK & ~G_PAGE_ALIGN_MASK);
+
 	g_page_table table = ((g_page_table) G_RECURSIVE_PAGE_DIRECTORY_AREA) + (0x400 * ti);
 	return table[pi] & ~G_PAGE_ALIGN_MASK;
 }
+
+uint32_t pagingVirtualToFlags(g_virtual_address addr)
+{
+	uint32_t ti = G_TABLE_IN_DIRECTORY_INDEX(addr);
+	uint32_t pi = G_PAGE_IN_TABLE_INDEX(addr);
+
+	g_page_directory directory = (g_page_directory) G_RECURSIVE_PAGE_DIRECTORY_ADDRESS;
+	if(directory[ti] == 0)
+		return 0;
+
+	if(directory[ti] & G_PAGE_TABLE_SIZE)
+		return directory[ti] & G_PAGE_ALIGN_MASK;
+
+	g_page_table table = ((g_page_table) G_RECURSIVE_PAGE_DIRECTORY_AREA) + (0x400 * ti);
+	return table[pi] & G_PAGE_ALIGN_MASK;
+}
+
+bool pagingMapLargePage(g_virtual_address virt, g_physical_address phys, uint32_t flags)
+{
+	if((virt & G_LARGE_PAGE_ALIGN_MASK) || (phys & G_LARGE_PAGE_ALIGN_MASK))
+		panic("%! tried to map unaligned large page: %h -> %h", "paging", virt, phys);
+
+	uint32_t ti = G_TABLE_IN_DIRECTORY_INDEX(virt);
+	g_page_directory directory = (g_page_directory) G_RECURSIVE_PAGE_DIRECTORY_ADDRESS;
+	if(directory[ti] != 0)
+		return false;
+
+	directory[ti] = phys | flags | G_PAGE_TABLE_SIZE;
+	pagingInvalidatePage(virt);
+	return true;
+}
+
+bool pagingLargePagesAvailable()
+{
+	return processorHasFeature(g_cpuid_standard_edx_feature::PSE);
+}
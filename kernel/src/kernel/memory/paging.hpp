@@ -25,6 +25,13 @@
 #include "shared/memory/memory.hpp"
 #include "shared/memory/paging.hpp"
 
+/**
+ * Bits of the error code that the processor pushes on a page fault.
+ */
+#define G_PAGE_FAULT_PRESENT    (1 << 0)
+#define G_PAGE_FAULT_WRITE      (1 << 1)
+#define G_PAGE_FAULT_USER       (1 << 2)
+
 /**
  * Reads for a given virtual address (which must exist in the currently mapped
  * address space) the underlying physical address.
@@ -36,4 +43,25 @@
  */
 g_physical_address pagingVirtualToPhysical(g_virtual_address addr);
 
+/**
+ * Reads the flags of the entry that maps the given virtual address in the current
+ * address space. For large pages, these are the flags of the directory entry.
+ *
+ * @return the entry flags or 0 if the address is not mapped
+ */
+uint32_t pagingVirtualToFlags(g_virtual_address addr);
+
+/**
+ * Maps a 4 MiB page into the current address space by creating a directory entry
+ * with the size flag set. Both addresses must be aligned to G_LARGE_PAGE_SIZE.
+ *
+ * @return whether the page was mapped, false if there already is a table for this area
+ */
+bool pagingMapLargePage(g_virtual_address virt, g_physical_address phys, uint32_t flags);
+
+/**
+ * @return whether 4 MiB pages are enabled on this processor
+ */
+bool pagingLargePagesAvailable();
+
 #endif
@@ -32,6 +32,9 @@ static bool available = false;
 static g_physical_address physicalBase = 0;
 static g_virtual_address virtualBase = 0;
 
+// Timer ticks per nanosecond with divider 16, same bus clock on all processors
+static double timerTicksPerNano = 0;
+
 void lapicSetup(g_physical_address address)
 {
 	physicalBase = address;
@@ -132,6 +135,7 @@ void lapicStartTimer()
 
 	// Now we know how often the APIC timer has ticked in 10ms
 	uint32_t ticksPer10ms = 0xFFFFFFFF - lapicRead(APIC_REGISTER_TIMER_CURRCNT);
+	timerTicksPerNano = (double) ticksPer10ms / 10000000;
 
 	// Start timer as periodic on IRQ 0
 	lapicWrite(APIC_REGISTER_TIMER_DIV, 0x3);
@@ -139,6 +143,17 @@ void lapicStartTimer()
 	lapicWrite(APIC_REGISTER_TIMER_INITCNT, ticksPer10ms / (G_TIMER_FREQUENCY / 100));
 }
 
+void lapicStartTimerOneShot(uint64_t nanos)
+{
+	double ticks = (double) nanos * timerTicksPerNano;
+	uint32_t initialCount = ticks >= 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t) ticks;
+	if(initialCount == 0)
+		initialCount = 1;
+
+	lapicWrite(APIC_REGISTER_LVT_TIMER, 0x20 | APIC_LVT_TIMER_MODE_ONESHOT);
+	lapicWrite(APIC_REGISTER_TIMER_INITCNT, initialCount);
+}
+
 void lapicSendEndOfInterrupt()
 {
 	lapicWrite(APIC_REGISTER_EOI, 0);
@@ -124,6 +124,12 @@ void lapicCreateMapping();
 
 void lapicStartTimer();
 
+/**
+ * Switches the timer of the executing processor to one-shot mode and lets it fire once
+ * after the given number of nanoseconds.
+ */
+void lapicStartTimerOneShot(uint64_t nanos);
+
 uint32_t lapicRead(uint32_t reg);
 
 void lapicWrite(uint32_t reg, uint32_t value);
@@ -163,7 +163,7 @@ bool exceptionsHandlePageFault(g_task* task)
 	if(taskingMemoryHandleStackOverflow(task, accessed))
 		return true;
 
-	if(memoryOnDemandHandlePageFault(task, accessed))
+	if(memoryOnDemandHandlePageFault(task, accessed, task->state->error))
 		return true;
 
 	g_physical_address physPage = pagingVirtualToPhysical(G_PAGE_ALIGN_DOWN(accessed));
@@ -91,8 +91,10 @@ extern "C" volatile g_processor_state* _interruptHandler(volatile g_processor_st
 		uint8_t irq = state->intr - 0x20;
 		if(irq == 0) // Timer
 		{
-			clockUpdate();
-			taskingSchedule(true);
+			bool woken;
+			bool tick = clockUpdate(&woken);
+			if(tick || woken)
+				taskingSchedule(tick);
 		}
 		else
 		{
@@ -24,6 +24,7 @@
 #include "kernel/system/processor/processor.hpp"
 
 static g_tid registrations[256] = {};
+static bool pending[256] = {};
 static g_mutex registrationsLock;
 
 void requestsInitialize()
@@ -42,6 +43,23 @@ void requestsSetHandlerTask(uint8_t irq, g_tid task)
 	mutexRelease(&registrationsLock);
 }
 
+bool requestsIsPending(uint8_t irq)
+{
+	mutexAcquire(&registrationsLock);
+	bool fired = pending[irq];
+	mutexRelease(&registrationsLock);
+	return fired;
+}
+
+bool requestsConsumePending(uint8_t irq)
+{
+	mutexAcquire(&registrationsLock);
+	bool fired = pending[irq];
+	pending[irq] = false;
+	mutexRelease(&registrationsLock);
+	return fired;
+}
+
 g_tid requestsGetHandlerTask(uint8_t irq)
 {
 	mutexAcquire(&registrationsLock);
@@ -52,7 +70,11 @@ g_tid requestsGetHandlerTask(uint8_t irq)
 
 void requestsHandle(g_task* currentTask, uint8_t irq)
 {
-	g_tid handlerTid = requestsGetHandlerTask(irq);
+	mutexAcquire(&registrationsLock);
+	g_tid handlerTid = registrations[irq];
+	if(handlerTid != G_TID_NONE)
+		pending[irq] = true;
+	mutexRelease(&registrationsLock);
 	if(handlerTid == G_TID_NONE)
 		return;
 
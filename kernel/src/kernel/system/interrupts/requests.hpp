@@ -35,6 +35,19 @@ g_tid requestsGetHandlerTask(uint8_t irq);
  */
 void requestsSetHandlerTask(uint8_t irq, g_tid task);
 
+/**
+ * Tells whether the IRQ has fired since it was last acknowledged. Only IRQs that
+ * have a handler task are recorded.
+ */
+bool requestsIsPending(uint8_t irq);
+
+/**
+ * Acknowledges a fired IRQ.
+ *
+ * @return whether the IRQ was pending
+ */
+bool requestsConsumePending(uint8_t irq);
+
 /**
  * Wakes a registered IRQ handler.
  */
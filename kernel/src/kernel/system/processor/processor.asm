@@ -23,6 +23,8 @@ BITS 32
 
 global _checkForCPUID
 global _enableSSE
+global _enableLargePages
+global _enableWriteProtect
 
 ;
 ; bool checkForCPUID()
@@ -76,3 +78,24 @@ _enableSSE:
 
 	ret
 
+
+;
+; void enableLargePages()
+;
+; Sets CR4.PSE so that page directory entries can map 4 MiB pages
+_enableLargePages:
+    mov eax, cr4
+    or eax, (1 << 4)    ; set CR4.PSE
+    mov cr4, eax
+	ret
+
+;
+; void enableWriteProtect()
+;
+; Sets CR0.WP so that read-only pages are also protected against writes from
+; the kernel
+_enableWriteProtect:
+    mov eax, cr0
+    or eax, (1 << 16)   ; set CR0.WP
+    mov cr0, eax
+	ret
@@ -24,6 +24,7 @@
 #include "kernel/system/system.hpp"
 #include "shared/logger/logger.hpp"
 #include "shared/memory/gdt_macros.hpp"
+#include "shared/memory/paging.hpp"
 #include "shared/panic.hpp"
 
 static g_processor* processors = nullptr;
@@ -74,6 +75,27 @@ void processorFinalizeSetup()
 	{
 		logWarn("%! no SSE support", "cpu");
 	}
+
+	if(processorHasFeature(g_cpuid_standard_edx_feature::PSE))
+		_enableLargePages();
+
+	_enableWriteProtect();
+
+	if(processorHasFeature(g_cpuid_standard_edx_feature::PAT))
+		processorEnablePat();
+}
+
+void processorEnablePat()
+{
+	// PA0 WB, PA1 WC, PA2 UC-, PA3 UC. The upper half keeps its power-on defaults
+	// (PA4 WB) since kernel pages set bit 7 which selects the upper entries.
+	uint32_t lo = 0x00070106;
+	uint32_t hi = 0x00070406;
+
+	asm volatile("wbinvd" ::: "memory");
+	processorWriteMsr(G_MSR_IA32_PAT, lo, hi);
+	pagingSwitchToSpace(pagingGetCurrentSpace());
+	logDebug("%! %i: page attribute table programmed", "cpu", processorGetCurrentId());
 }
 
 bool processorHasFeatureReady(g_cpuid_standard_edx_feature feature)
@@ -26,6 +26,8 @@
 #define G_SSE_STATE_SIZE       512
 #define G_SSE_STATE_ALIGNMENT  0x10
 
+#define G_MSR_IA32_PAT         0x277
+
 /**
  * CPUID.1 feature flags
  */
@@ -140,6 +142,22 @@ void processorCpuid(uint32_t code, uint32_t* outA, uint32_t* outB, uint32_t* out
  */
 extern "C" void _enableSSE();
 
+/**
+ * Enables 4 MiB pages on the current processor.
+ */
+extern "C" void _enableLargePages();
+
+/**
+ * Protects read-only pages against writes from the kernel on the current processor,
+ * pages shared with the page cache rely on this.
+ */
+extern "C" void _enableWriteProtect();
+
+/**
+ * Programs the page attribute table of the current processor, see G_PAGE_WRITE_COMBINING.
+ */
+void processorEnablePat();
+
 /**
  * Initializes the bootstrap processor.
  */
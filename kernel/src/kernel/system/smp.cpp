@@ -69,12 +69,12 @@ void smpInitialize(g_physical_address initialPageDirectoryPhysical)
 	// Copy start object from ramdisk to lower memory
 	const char* ap_startup_location = "system/lib/apstartup.o";
 	g_ramdisk_entry* startupObject = ramdiskFindAbsolute(ap_startup_location);
-	if(startupObject == 0)
+	if(startupObject == 0 ||
+	   ramdiskRead(startupObject, 0, (uint8_t*) G_SMP_STARTUP_AREA_CODE_START, startupObject->dataSize) < 0)
 	{
 		logInfo("%*%! could not initialize due to missing apstartup object at '%s'", 0x0C, "smp", ap_startup_location);
 		return;
 	}
-	memoryCopy((uint8_t*) G_SMP_STARTUP_AREA_CODE_START, (uint8_t*) startupObject->data, startupObject->dataSize);
 
 	smpInitialized = true;
 
@@ -18,6 +18,7 @@
  *                                                                           *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include "kernel/filesystem/filesystem_page_cache.hpp"
 #include "kernel/memory/heap.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/tasking.hpp"
@@ -72,6 +73,9 @@ void taskingCleanupThread()
 			deadList = next;
 		}
 
+		// Give pages back if physical memory runs low, no locks are held here
+		filesystemPageCacheTrim();
+
 		// Sleep for some time
 		INTERRUPTS_PAUSE;
 		mutexAcquire(&self->lock);
@@ -20,7 +20,11 @@
 
 #include "kernel/tasking/clock.hpp"
 #include "kernel/memory/heap.hpp"
+#include "kernel/memory/memory.hpp"
+#include "kernel/memory/page_reference_tracker.hpp"
+#include "kernel/memory/paging.hpp"
 #include "kernel/system/configuration.hpp"
+#include "kernel/system/interrupts/apic/lapic.hpp"
 #include "kernel/system/processor/processor.hpp"
 #include "kernel/system/timing/hpet.hpp"
 #include "kernel/tasking/tasking.hpp"
@@ -29,6 +33,25 @@
 
 static g_clock_local* locals = nullptr;
 
+static g_clock_page* clockPage = nullptr;
+static g_physical_address clockPagePhysical = 0;
+static bool clockTscInvariant = false;
+
+/**
+ * Last TSC calibration point of the bootstrap processor.
+ */
+static struct
+{
+	bool valid;
+	uint64_t tsc;
+	uint64_t reference;
+	uint64_t milliTime;
+} clockCalibration;
+
+bool _clockHasInvariantTsc();
+void _clockPublish(g_clock_local* local);
+void _clockArmTimer(g_clock_local* local);
+
 void clockInitialize()
 {
 	uint32_t numProcs = processorGetNumberOfProcessors();
@@ -41,10 +64,41 @@ void clockInitialize()
 		locals[i].time = 0;
 		locals[i].lastNanoTime = 0;
 		locals[i].lastRecalibrateMilliTime = 0;
+		locals[i].highResolution = lapicIsAvailable() && hpetIsAvailable();
+		locals[i].nextTick = 0;
 #if G_DEBUG_THREAD_DUMPING
 		locals[i].lastLogTime = 0;
 #endif
 	}
+
+	clockPage = (g_clock_page*) memoryAllocateKernel(1);
+	memorySetBytes(clockPage, 0, G_PAGE_SIZE);
+	clockPagePhysical = pagingVirtualToPhysical((g_virtual_address) clockPage);
+	clockCalibration.valid = false;
+
+	clockTscInvariant = _clockHasInvariantTsc();
+	if(!clockTscInvariant)
+		logInfo("%! no invariant TSC, user-space nanosecond time uses system calls", "clock");
+}
+
+bool _clockHasInvariantTsc()
+{
+	if(!processorSupportsCpuid())
+		return false;
+
+	uint32_t eax, ebx, ecx, edx;
+	processorCpuid(0x80000000, &eax, &ebx, &ecx, &edx);
+	if(eax < 0x80000007)
+		return false;
+
+	processorCpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+	return edx & (1 << 8);
+}
+
+void clockMapUserPage(g_virtual_address address)
+{
+	pagingMapPage(address, clockPagePhysical, G_PAGE_TABLE_USER_DEFAULT, G_PAGE_PRESENT | G_PAGE_USERSPACE);
+	pageReferenceTrackerIncrement(clockPagePhysical);
 }
 
 g_clock_local* clockGetLocal()
@@ -55,14 +109,41 @@ g_clock_local* clockGetLocal()
 	return &locals[processorGetCurrentId()];
 }
 
+uint64_t clockGetNanos()
+{
+	if(hpetIsAvailable())
+		return hpetGetNanos();
+	return clockGetLocal()->time * 1000000ULL;
+}
+
+uint64_t clockGetDeadline(uint64_t nanos)
+{
+	uint64_t now = clockGetNanos();
+	if(nanos > 0xFFFFFFFFFFFFFFFFULL - now)
+		return 0xFFFFFFFFFFFFFFFFULL;
+	return now + nanos;
+}
+
 void clockWaitForTime(g_tid task, uint64_t wakeTime)
+{
+	uint64_t time = clockGetLocal()->time;
+	uint64_t millis = wakeTime > time ? wakeTime - time : 0;
+
+	// Avoid an overflow when converting to nanoseconds
+	if(millis > 0xFFFFFFFFFFULL)
+		millis = 0xFFFFFFFFFFULL;
+
+	clockWaitForDeadline(task, clockGetDeadline(millis * 1000000ULL));
+}
+
+void clockWaitForDeadline(g_tid task, uint64_t deadline)
 {
 	auto local = clockGetLocal();
 	mutexAcquire(&local->lock);
 
 	g_clock_waiter* waiter = (g_clock_waiter*) heapAllocate(sizeof(g_clock_waiter));
 	waiter->task = task;
-	waiter->wakeTime = wakeTime;
+	waiter->deadline = deadline;
 	waiter->next = nullptr;
 
 	if(local->waiters)
@@ -72,7 +153,7 @@ void clockWaitForTime(g_tid task, uint64_t wakeTime)
 		while(entry)
 		{
 			// Insert in middle
-			if(entry->wakeTime > wakeTime)
+			if(entry->deadline > deadline)
 			{
 				waiter->next = entry;
 				if(prev)
@@ -95,20 +176,27 @@ void clockWaitForTime(g_tid task, uint64_t wakeTime)
 		local->waiters = waiter;
 	}
 
+	// Timer is only re-armed once it was switched to one-shot mode by the first update
+	if(local->highResolution && local->nextTick && local->waiters == waiter)
+		_clockArmTimer(local);
+
 	mutexRelease(&local->lock);
 }
 
-void clockWakeWaiters(g_clock_local* local)
+bool clockWakeWaiters(g_clock_local* local, uint64_t now)
 {
-	while(local->waiters && local->time >= local->waiters->wakeTime)
+	bool woken = false;
+	while(local->waiters && now >= local->waiters->deadline)
 	{
 		g_task* task = taskingGetById(local->waiters->task);
-		taskingWake(task);
+		if(task && taskingWake(task))
+			woken = true;
 
 		auto next = local->waiters->next;
 		heapFree(local->waiters);
 		local->waiters = next;
 	}
+	return woken;
 }
 
 void clockUpdateTime(g_clock_local* local)
@@ -131,13 +219,114 @@ void clockUpdateTime(g_clock_local* local)
 	}
 }
 
-void clockUpdate()
+bool clockUpdate(bool* outWoken)
 {
 	auto local = clockGetLocal();
 	mutexAcquire(&local->lock);
-	clockUpdateTime(local);
-	clockWakeWaiters(local);
+
+	bool tick = true;
+	if(local->highResolution)
+	{
+		// The timer may also fire for a waiter in between two ticks
+		uint64_t now = clockGetNanos();
+		tick = now >= local->nextTick;
+		if(tick)
+		{
+			local->nextTick += G_CLOCK_TICK_NANOS;
+			if(local->nextTick <= now)
+				local->nextTick = now + G_CLOCK_TICK_NANOS;
+		}
+	}
+
+	if(tick)
+	{
+		clockUpdateTime(local);
+		if(local == &locals[0])
+			_clockPublish(local);
+	}
+
+	*outWoken = clockWakeWaiters(local, clockGetNanos());
+
+	if(local->highResolution)
+		_clockArmTimer(local);
+
 	mutexRelease(&local->lock);
+	return tick;
+}
+
+void _clockArmTimer(g_clock_local* local)
+{
+	uint64_t deadline = local->nextTick;
+	if(local->waiters && local->waiters->deadline < deadline)
+		deadline = local->waiters->deadline;
+
+	uint64_t now = clockGetNanos();
+	uint64_t delta = deadline > now ? deadline - now : 0;
+	if(delta < G_CLOCK_MINIMUM_TIMER_NANOS)
+		delta = G_CLOCK_MINIMUM_TIMER_NANOS;
+
+	lapicStartTimerOneShot(delta);
+}
+
+void _clockPublish(g_clock_local* local)
+{
+	uint32_t tscUsable = clockPage->tscUsable;
+	uint32_t tscMultiplier = clockPage->tscMultiplier;
+	uint64_t tscBase = clockPage->tscBase;
+	uint64_t nanosBase = clockPage->nanosBase;
+
+	if(clockTscInvariant &&
+	   (!clockCalibration.valid || local->time - clockCalibration.milliTime >= G_CLOCK_RECALIBRATION_INTERVAL))
+	{
+		uint64_t tsc = processorReadTsc();
+		uint64_t reference = hpetIsAvailable() ? hpetGetNanos() : local->time * 1000000ULL;
+
+		if(clockCalibration.valid && tsc > clockCalibration.tsc && reference > clockCalibration.reference)
+		{
+			uint64_t elapsedTsc = tsc - clockCalibration.tsc;
+			uint64_t elapsedReference = reference - clockCalibration.reference;
+
+			// Continue from where readers are right now so that time never goes backwards
+			uint64_t current = reference;
+			if(tscUsable)
+			{
+				uint64_t extrapolated = nanosBase + (((tsc - tscBase) * tscMultiplier) >> G_CLOCK_PAGE_TSC_SHIFT);
+				if(extrapolated > current)
+					current = extrapolated;
+			}
+
+			// Choose the rate so that readers meet the reference again at the next calibration. If readers
+			// are already past that point, time stands still until then instead of going backwards.
+			uint64_t target = reference + elapsedReference;
+			if(current >= target)
+			{
+				tscMultiplier = 0;
+			}
+			else
+			{
+				double rate = (double) (target - current) * (1 << G_CLOCK_PAGE_TSC_SHIFT) / (double) elapsedTsc;
+				tscMultiplier = rate < (double) UINT32_MAX ? (uint32_t) rate : UINT32_MAX;
+			}
+			tscBase = tsc;
+			nanosBase = current;
+			tscUsable = 1;
+		}
+
+		clockCalibration.valid = true;
+		clockCalibration.tsc = tsc;
+		clockCalibration.reference = reference;
+		clockCalibration.milliTime = local->time;
+	}
+
+	clockPage->sequence++;
+	asm volatile("" ::: "memory");
+	clockPage->millis = local->time;
+	clockPage->tscUsable = tscUsable;
+	clockPage->tscMultiplier = tscMultiplier;
+	clockPage->tscBase = tscBase;
+	clockPage->nanosBase = nanosBase;
+	asm volatile("" ::: "memory");
+	clockPage->sequence++;
 }
 
 void clockUnwaitForTime(g_tid task)
@@ -176,11 +365,12 @@ bool clockHasTimedOut(g_tid task)
 	mutexAcquire(&local->lock);
 
 	bool timeout = true;
+	uint64_t now = clockGetNanos();
 
 	g_clock_waiter* entry = local->waiters;
 	while(entry)
 	{
-		if(entry->task == task && local->time < entry->wakeTime)
+		if(entry->task == task && now < entry->deadline)
 		{
 			timeout = false;
 			break;
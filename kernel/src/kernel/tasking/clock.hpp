@@ -24,6 +24,7 @@
 #include "shared/system/mutex.hpp"
 #include "build_config.hpp"
 #include <ghost/tasks/types.h>
+#include <ghost/memory/types.h>
 
 /**
  * Number of milliseconds on how often a high-precision clock source should be
@@ -31,10 +32,25 @@
  */
 #define G_CLOCK_RECALIBRATION_INTERVAL   1000
 
+/**
+ * Nanoseconds between two scheduler ticks.
+ */
+#define G_CLOCK_TICK_NANOS               (1000000000 / G_TIMER_FREQUENCY)
+
+/**
+ * Minimum distance of a one-shot timer deadline, so that deadlines in the past or very
+ * close by do not cause an interrupt storm.
+ */
+#define G_CLOCK_MINIMUM_TIMER_NANOS      2000
+
 struct g_clock_waiter
 {
     g_tid task;
-    uint64_t wakeTime;
+
+    /**
+     * Absolute wake-up time in nanoseconds, see {clockGetNanos}.
+     */
+    uint64_t deadline;
     g_clock_waiter* next;
 };
 
@@ -57,6 +73,13 @@ struct g_clock_local
     uint64_t lastNanoTime;
     uint64_t lastRecalibrateMilliTime;
 
+    /**
+     * When the local APIC timer and the HPET are available, the timer runs in one-shot
+     * mode and is armed for the next tick or the earliest waiter, whichever is first.
+     */
+    bool highResolution;
+    uint64_t nextTick;
+
 #if G_DEBUG_THREAD_DUMPING
     uint64_t lastLogTime;
 #endif
@@ -72,17 +95,40 @@ void clockInitialize();
  */
 g_clock_local* clockGetLocal();
 
+/**
+ * @return the current time in nanoseconds, read from the HPET if available and from the
+ * 		local millisecond time otherwise
+ */
+uint64_t clockGetNanos();
+
+/**
+ * @return the absolute deadline that lies the given nanoseconds in the future
+ */
+uint64_t clockGetDeadline(uint64_t nanos);
+
 /**
  * Adds the task to the queue of tasks that are waiting for a specific time. This
  * queue is ordered ascending by the time of wake-up.
+ *
+ * @param wakeTime local time in milliseconds, see {g_clock_local::time}
  */
 void clockWaitForTime(g_tid task, uint64_t wakeTime);
 
 /**
- * Called when the local time has changed. Wakes all tasks on top of the wait queue
- * for which the wake-up time is lower than the current.
+ * Adds the task to the wait queue with a nanosecond deadline, see {clockGetDeadline}.
+ * In high-resolution mode the timer is re-armed if this is the earliest deadline.
  */
-void clockUpdate();
+void clockWaitForDeadline(g_tid task, uint64_t deadline);
+
+/**
+ * Called on each timer interrupt. Advances the local time if a tick has elapsed, wakes
+ * all tasks on top of the wait queue whose deadline has passed and re-arms the timer.
+ *
+ * @param outWoken
+ * 		is set to whether any task was woken
+ * @return whether a scheduler tick has elapsed
+ */
+bool clockUpdate(bool* outWoken);
 
 /**
  * Removes the task from the wake queue.
@@ -94,4 +140,10 @@ void clockUnwaitForTime(g_tid task);
  */
 bool clockHasTimedOut(g_tid task);
 
+/**
+ * Maps the read-only clock page into the current address space at the given address.
+ * The bootstrap processor publishes its time and the TSC calibration on this page.
+ */
+void clockMapUserPage(g_virtual_address address);
+
 #endif
@@ -24,6 +24,7 @@
 #include "kernel/filesystem/filesystem.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/tasking/elf/elf_tls.hpp"
+#include "kernel/tasking/clock.hpp"
 #include "kernel/tasking/tasking_memory.hpp"
 #include "shared/utils/string.hpp"
 #include "shared/logger/logger.hpp"
@@ -122,9 +123,15 @@ g_virtual_address elfUserProcessCreateInfo(g_process* process, g_elf_object* roo
 	hashmapIteratorEnd(&it);
 
 	info->syscallKernelEntry = syscall;
+
+	// The clock page follows directly after the info area
+	g_virtual_address clockPageAddress = areaStart + pages * G_PAGE_SIZE;
+	clockMapUserPage(clockPageAddress);
+	info->clockPage = (const g_clock_page*) clockPageAddress;
+
 	process->userProcessInfo = info;
 
-	return imageEnd + G_PAGE_ALIGN_UP(totalRequired);
+	return imageEnd + G_PAGE_ALIGN_UP(totalRequired) + G_PAGE_SIZE;
 }
 
 g_spawn_validation_details elfReadAndValidateHeader(g_fd file, Elf32_Ehdr* headerBuffer, bool root)
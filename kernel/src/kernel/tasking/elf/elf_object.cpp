@@ -100,7 +100,8 @@ g_elf_object_load_result elfObjectLoad(g_elf_object* parentObject, const char* n
 			}
 			else
 			{
-				memoryOnDemandMapFile(taskingGetCurrentTask()->process, file, phdr.p_offset, fileStart, phdr.p_filesz, phdr.p_memsz);
+				memoryOnDemandMapFile(taskingGetCurrentTask()->process, file, phdr.p_offset, fileStart, phdr.p_filesz, phdr.p_memsz,
+				                      phdr.p_flags & PF_W);
 			}
 
 			if(object->startAddress == 0 || alignedStart < object->startAddress)
@@ -509,7 +510,7 @@ g_fd elfObjectOpenDependency(const char* name)
 	}
 
 	g_fd fd;
-	g_fs_open_status openStatus = filesystemOpenNodeFd(findRes.node, G_FILE_FLAG_MODE_BINARY | G_FILE_FLAG_MODE_READ, taskingGetCurrentTask()->process->id, &fd);
+	g_fs_open_status openStatus = filesystemOpenNodeFd(findRes.node, G_FILE_FLAG_MODE_BINARY | G_FILE_FLAG_MODE_READ, taskingGetCurrentTask()->process, &fd);
 	if(openStatus != G_FS_OPEN_SUCCESSFUL)
 	{
 		logInfo("%! unable to open dependency %s", "elf", absolutePath);
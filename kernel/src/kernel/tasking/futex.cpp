@@ -0,0 +1,138 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/tasking/futex.hpp"
+#include "kernel/memory/heap.hpp"
+#include "kernel/memory/paging.hpp"
+#include "kernel/tasking/clock.hpp"
+#include "kernel/utils/hashmap.hpp"
+#include "shared/memory/constants.hpp"
+
+static g_mutex futexLock;
+static g_hashmap<g_physical_address, g_futex_entry*>* futexMap;
+
+bool _futexResolve(g_address address, g_physical_address* outKey);
+void _futexCleanup(g_physical_address key, g_futex_entry* entry);
+
+void futexInitialize()
+{
+	mutexInitializeTask(&futexLock, __func__);
+	futexMap = hashmapCreateNumeric<g_physical_address, g_futex_entry*>(64);
+}
+
+g_futex_status futexWait(g_task* task, g_address address, uint32_t expected, uint64_t timeout)
+{
+	mutexAcquire(&futexLock);
+
+	g_physical_address key;
+	if(!_futexResolve(address, &key))
+	{
+		mutexRelease(&futexLock);
+		return G_FUTEX_STATUS_INVALID;
+	}
+
+	if(*((volatile uint32_t*) address) != expected)
+	{
+		mutexRelease(&futexLock);
+		return G_FUTEX_STATUS_NOT_EQUAL;
+	}
+
+	g_futex_entry* entry = hashmapGet<g_physical_address, g_futex_entry*>(futexMap, key, nullptr);
+	if(!entry)
+	{
+		entry = (g_futex_entry*) heapAllocate(sizeof(g_futex_entry));
+		waitQueueInitialize(&entry->waiters);
+		hashmapPut(futexMap, key, entry);
+	}
+
+	bool useTimeout = (timeout > 0);
+	if(useTimeout)
+		clockWaitForTime(task->id, clockGetLocal()->time + timeout);
+
+	taskingWait(task, __func__, [entry, task]()
+	{
+		waitQueueAdd(&entry->waiters, task->id);
+		mutexRelease(&futexLock);
+	});
+
+	g_futex_status status = G_FUTEX_STATUS_WOKEN;
+	if(useTimeout)
+	{
+		if(clockHasTimedOut(task->id))
+			status = G_FUTEX_STATUS_TIMEOUT;
+		clockUnwaitForTime(task->id);
+	}
+
+	// The entry may have been freed by a wake in the meantime
+	mutexAcquire(&futexLock);
+	entry = hashmapGet<g_physical_address, g_futex_entry*>(futexMap, key, nullptr);
+	if(entry)
+	{
+		waitQueueRemove(&entry->waiters, task->id);
+		_futexCleanup(key, entry);
+	}
+	mutexRelease(&futexLock);
+
+	return status;
+}
+
+g_futex_status futexWake(g_address address)
+{
+	mutexAcquire(&futexLock);
+
+	g_physical_address key;
+	if(!_futexResolve(address, &key))
+	{
+		mutexRelease(&futexLock);
+		return G_FUTEX_STATUS_INVALID;
+	}
+
+	g_futex_entry* entry = hashmapGet<g_physical_address, g_futex_entry*>(futexMap, key, nullptr);
+	if(entry)
+	{
+		waitQueueWake(&entry->waiters);
+		_futexCleanup(key, entry);
+	}
+
+	mutexRelease(&futexLock);
+	return G_FUTEX_STATUS_WOKEN;
+}
+
+bool _futexResolve(g_address address, g_physical_address* outKey)
+{
+	if((address & 3) || address < G_PAGE_SIZE || address >= G_KERNEL_AREA_START)
+		return false;
+
+	g_physical_address page = pagingVirtualToPhysical(G_PAGE_ALIGN_DOWN(address));
+	if(!page)
+		return false;
+
+	*outKey = page + (address & G_PAGE_ALIGN_MASK);
+	return true;
+}
+
+void _futexCleanup(g_physical_address key, g_futex_entry* entry)
+{
+	if(entry->waiters.head)
+		return;
+
+	hashmapRemove(futexMap, key);
+	heapFree(entry);
+}
@@ -0,0 +1,55 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_FUTEX__
+#define __KERNEL_FUTEX__
+
+#include "kernel/tasking/tasking.hpp"
+#include "kernel/utils/wait_queue.hpp"
+#include <ghost/mutex/types.h>
+
+/**
+ * Waiters on a single futex word. Entries only exist while at least one task
+ * is waiting on the word and are keyed by the physical address of the word,
+ * so processes that share the page also share the entry.
+ */
+struct g_futex_entry
+{
+    g_wait_queue waiters;
+};
+
+/**
+ * Initializes the futex table.
+ */
+void futexInitialize();
+
+/**
+ * Puts the task to sleep if the word at the given address (in the current
+ * address space) still holds the expected value. The comparison and the
+ * enqueueing happen under the futex lock, so a concurrent wake is never lost.
+ */
+g_futex_status futexWait(g_task* task, g_address address, uint32_t expected, uint64_t timeout);
+
+/**
+ * Wakes all tasks that wait on the word at the given address.
+ */
+g_futex_status futexWake(g_address address);
+
+#endif
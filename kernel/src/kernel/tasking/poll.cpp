@@ -0,0 +1,137 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/tasking/poll.hpp"
+#include "kernel/filesystem/filesystem.hpp"
+#include "kernel/ipc/message_queues.hpp"
+#include "kernel/system/interrupts/requests.hpp"
+#include "kernel/system/processor/processor.hpp"
+#include "kernel/tasking/clock.hpp"
+#include "shared/logger/logger.hpp"
+
+bool _pollIsReady(g_task* task, g_poll_set* set);
+uint32_t _pollCollect(g_task* task, g_poll_set* set);
+void _pollWaitForAll(g_task* task, g_poll_set* set);
+void _pollUnwaitForAll(g_task* task, g_poll_set* set);
+
+g_poll_status pollWait(g_task* task, g_poll_set* set, uint64_t timeout, uint32_t* outReady)
+{
+	*outReady = 0;
+	if(set->fd_count > G_POLL_MAXIMUM_FDS || set->irq_count > G_POLL_MAXIMUM_IRQS)
+		return G_POLL_STATUS_INVALID;
+
+	if(set->irq_count > 0)
+	{
+		if(task->securityLevel > G_SECURITY_LEVEL_DRIVER)
+			return G_POLL_STATUS_INVALID;
+
+		if(processorGetCurrentId() != 0)
+		{
+			logWarn("%! awaiting IRQs only possible on core 0", "poll");
+			return G_POLL_STATUS_INVALID;
+		}
+
+		for(uint32_t i = 0; i < set->irq_count; i++)
+			requestsSetHandlerTask(set->irqs[i].irq, task->id);
+	}
+
+	bool useTimeout = (timeout > 0);
+	if(useTimeout)
+		clockWaitForDeadline(task->id, clockGetDeadline(timeout));
+
+	while(!_pollIsReady(task, set) && !(useTimeout && clockHasTimedOut(task->id)))
+	{
+		// Check again once the task is marked as waiting, so an event in between still wakes it
+		taskingWait(task, __func__, [task, set, useTimeout]()
+		{
+			_pollWaitForAll(task, set);
+			if(_pollIsReady(task, set) || (useTimeout && clockHasTimedOut(task->id)))
+				taskingWake(task);
+		});
+		_pollUnwaitForAll(task, set);
+	}
+
+	if(useTimeout)
+		clockUnwaitForTime(task->id);
+
+	*outReady = _pollCollect(task, set);
+	return *outReady > 0 ? G_POLL_STATUS_READY : G_POLL_STATUS_TIMEOUT;
+}
+
+bool _pollIsReady(g_task* task, g_poll_set* set)
+{
+	for(uint32_t i = 0; i < set->fd_count; i++)
+	{
+		g_poll_fd* entry = &set->fds[i];
+		if(entry->events && filesystemPoll(task, entry->fd, entry->events))
+			return true;
+	}
+
+	for(uint32_t i = 0; i < set->irq_count; i++)
+	{
+		if(requestsIsPending(set->irqs[i].irq))
+			return true;
+	}
+
+	return set->messages && messageQueueHasMessages(task->id);
+}
+
+uint32_t _pollCollect(g_task* task, g_poll_set* set)
+{
+	uint32_t ready = 0;
+	for(uint32_t i = 0; i < set->fd_count; i++)
+	{
+		g_poll_fd* entry = &set->fds[i];
+		entry->ready = entry->events ? filesystemPoll(task, entry->fd, entry->events) : G_POLL_EVENT_NONE;
+		if(entry->ready)
+			ready++;
+	}
+
+	for(uint32_t i = 0; i < set->irq_count; i++)
+	{
+		set->irqs[i].fired = requestsConsumePending(set->irqs[i].irq);
+		if(set->irqs[i].fired)
+			ready++;
+	}
+
+	set->messages_ready = set->messages && messageQueueHasMessages(task->id);
+	if(set->messages_ready)
+		ready++;
+
+	return ready;
+}
+
+void _pollWaitForAll(g_task* task, g_poll_set* set)
+{
+	for(uint32_t i = 0; i < set->fd_count; i++)
+	{
+		if(set->fds[i].events)
+			filesystemWaitForEvents(task, set->fds[i].fd, set->fds[i].events);
+	}
+}
+
+void _pollUnwaitForAll(g_task* task, g_poll_set* set)
+{
+	for(uint32_t i = 0; i < set->fd_count; i++)
+	{
+		if(set->fds[i].events)
+			filesystemUnwaitForEvents(task, set->fds[i].fd, set->fds[i].events);
+	}
+}
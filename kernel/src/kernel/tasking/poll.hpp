@@ -0,0 +1,35 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __KERNEL_POLL__
+#define __KERNEL_POLL__
+
+#include "kernel/tasking/tasking.hpp"
+#include <ghost/poll/types.h>
+
+/**
+ * Waits until one of the sources in the set is ready or the timeout in nanoseconds (0 for none) elapses.
+ * The task is registered in the wait queues of all file descriptors, becomes the handler
+ * of all IRQs in the set and is woken by new messages anyway, so there is no polling.
+ * Results are written back into the set.
+ */
+g_poll_status pollWait(g_task* task, g_poll_set* set, uint64_t timeout, uint32_t* outReady);
+
+#endif
@@ -33,6 +33,9 @@ struct g_process;
 struct g_task;
 struct g_tasking_local;
 struct g_elf_object;
+struct g_shared_memory_reference;
+struct g_user_mutex_table;
+struct g_filesystem_process;
 
 /**
  * Data used by virtual 8086 processes
@@ -158,6 +161,11 @@ struct g_task
      */
     g_wait_queue waitersJoin;
 
+    /**
+     * Wait queue entry used when this task waits on a single queue.
+     */
+    g_wait_queue_entry waitEntry;
+
     /**
      * Addition for debugging
      */
@@ -214,6 +222,10 @@ struct g_memory_file_ondemand
      * Total size of the allocated memory, content is followed by 0
      */
     g_ptrsize memSize;
+    /**
+     * Whether the content may be written, otherwise pages can be shared with the page cache
+     */
+    bool writable;
 
     g_memory_file_ondemand* next;
 };
@@ -273,6 +285,21 @@ struct g_process
      * List of on-demand file-to-memory mappings.
      */
     g_memory_file_ondemand* onDemandMappings;
+
+    /**
+     * List of shared memory objects that this process holds a handle to.
+     */
+    g_shared_memory_reference* sharedMemory;
+
+    /**
+     * Mutexes of this process, created with the first one.
+     */
+    g_user_mutex_table* userMutexes;
+
+    /**
+     * File descriptors of this process.
+     */
+    g_filesystem_process* filesystem;
 };
 
 #endif
@@ -21,7 +21,9 @@
 #include "kernel/tasking/tasking.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "kernel/filesystem/filesystem_process.hpp"
+#include "kernel/filesystem/filesystem_taskeddelegate.hpp"
 #include "kernel/ipc/message_queues.hpp"
+#include "kernel/ipc/shared_memory.hpp"
 #include "kernel/memory/gdt.hpp"
 #include "kernel/memory/memory.hpp"
 #include "kernel/memory/page_reference_tracker.hpp"
@@ -34,6 +36,7 @@
 #include "kernel/tasking/tasking_directory.hpp"
 #include "kernel/tasking/tasking_memory.hpp"
 #include "kernel/tasking/tasking_state.hpp"
+#include "kernel/tasking/user_mutex.hpp"
 #include "kernel/utils/hashmap.hpp"
 #include "kernel/utils/wait_queue.hpp"
 #include "shared/logger/logger.hpp"
@@ -170,7 +173,7 @@ void taskingProcessAddToTaskList(g_process* process, g_task* task)
 	{
 		process->main = task;
 		process->id = task->id;
-		filesystemProcessCreate((g_pid) task->id);
+		filesystemProcessCreate(process);
 	}
 
 	mutexRelease(&process->lock);
@@ -353,7 +356,9 @@ void taskingDestroyProcess(g_process* process)
 	if(process->object)
 		elfObjectDestroy(process->object);
 
-	filesystemProcessRemove(process->id);
+	filesystemProcessRemove(process);
+	sharedMemoryProcessRemoved(process);
+	userMutexProcessRemoved(process);
 
 	taskingMemoryDestroyPageDirectory(process->pageDirectory);
 
@@ -417,11 +422,16 @@ void taskingDestroyTask(g_task* task)
 
 	// Wake up tasks that joined this task
 	waitQueueWake(&task->waitersJoin);
+	waitQueueDestroy(&task->waitersJoin);
+
+	// The embedded wait entry must not stay linked into a queue
+	waitQueueRemoveEmbedded(&task->waitEntry);
 
 	// Switch to task space
 	g_physical_address returnDirectory = taskingMemoryTemporarySwitchTo(task->process->pageDirectory);
 
 	messageQueueTaskRemoved(task->id);
+	filesystemTaskedDelegateTaskRemoved(task->id);
 	taskingMemoryDestroy(task);
 
 	taskingMemoryTemporarySwitchBack(returnDirectory);
@@ -582,15 +592,20 @@ void taskingWaitForExit(g_tid joinedTid, g_tid waiter)
 	mutexRelease(&task->process->lock);
 }
 
-void taskingWake(g_task* task)
+bool taskingWake(g_task* task)
 {
-	if(task)
+	if(!task)
+		return false;
+
+	bool woken = false;
+	mutexAcquire(&task->lock);
+	if(task->status == G_TASK_STATUS_WAITING)
 	{
-		mutexAcquire(&task->lock);
-		if(task->status == G_TASK_STATUS_WAITING)
-			task->status = G_TASK_STATUS_RUNNING;
-		mutexRelease(&task->lock);
+		task->status = G_TASK_STATUS_RUNNING;
+		woken = true;
 	}
+	mutexRelease(&task->lock);
+	return woken;
 }
 
 void taskingWait(g_task* task, const char* debugName, const std::function<void ()>& beforeYield)
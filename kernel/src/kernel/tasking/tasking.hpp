@@ -255,8 +255,10 @@ void taskingWaitForExit(g_tid task, g_tid waiter);
 
 /**
  * Wakes the task.
+ *
+ * @return whether the task was waiting before
  */
-void taskingWake(g_task* task);
+bool taskingWake(g_task* task);
 
 /**
  * Sets the task waiting and executes the function before yielding. The lambda
@@ -280,6 +280,14 @@ void taskingMemoryDestroyPageDirectory(g_physical_address directory)
 		if(!(directoryCurrent[ti] & G_PAGE_TABLE_USERSPACE))
 			continue;
 
+		if(directoryCurrent[ti] & G_PAGE_TABLE_SIZE)
+		{
+			g_physical_address largePage = directoryCurrent[ti] & ~G_LARGE_PAGE_ALIGN_MASK;
+			for(uint32_t pi = 0; pi < 1024; pi++)
+				memoryPhysicalFree(largePage + pi * G_PAGE_SIZE);
+			continue;
+		}
+
 		g_page_table tableMapped = ((g_page_table) G_RECURSIVE_PAGE_DIRECTORY_AREA) + (0x400 * ti);
 		for(uint32_t pi = 0; pi < 1024; pi++)
 		{
@@ -386,6 +394,124 @@ void taskingMemoryTemporarySwitchBack(g_physical_address back)
 	pagingSwitchToSpace(back);
 }
 
+void taskingMemoryMapContiguous(g_virtual_address virt, g_physical_address phys, uint32_t pages, uint32_t pageFlags)
+{
+	bool largePages = pagingLargePagesAvailable();
+	const uint32_t pagesPerLargePage = G_LARGE_PAGE_SIZE / G_PAGE_SIZE;
+
+	uint32_t i = 0;
+	while(i < pages)
+	{
+		g_virtual_address pageVirt = virt + i * G_PAGE_SIZE;
+		g_physical_address pagePhys = phys + i * G_PAGE_SIZE;
+
+		if(largePages && pages - i >= pagesPerLargePage &&
+		   (pageVirt & G_LARGE_PAGE_ALIGN_MASK) == 0 && (pagePhys & G_LARGE_PAGE_ALIGN_MASK) == 0 &&
+		   pagingMapLargePage(pageVirt, pagePhys, pageFlags))
+		{
+			i += pagesPerLargePage;
+			continue;
+		}
+
+		pagingMapPage(pageVirt, pagePhys, G_PAGE_TABLE_USER_DEFAULT, pageFlags);
+		++i;
+	}
+}
+
+g_virtual_address taskingMemoryAllocateRangeFor(g_process* process, g_physical_address phys, uint32_t pages, uint8_t flags)
+{
+	if(pages >= G_LARGE_PAGE_SIZE / G_PAGE_SIZE && (phys & G_LARGE_PAGE_ALIGN_MASK) == 0 &&
+	   pagingLargePagesAvailable())
+	{
+		g_virtual_address aligned = addressRangePoolAllocateAligned(process->virtualRangePool, pages,
+		                                                            G_LARGE_PAGE_SIZE, flags);
+		if(aligned)
+			return aligned;
+	}
+
+	return addressRangePoolAllocate(process->virtualRangePool, pages, flags);
+}
+
+g_virtual_address taskingMemoryShare(g_process* targetProcess, g_virtual_address memory, uint32_t pages)
+{
+	// Resolve all physical pages while still in the source address space
+	auto physicalPages = (g_physical_address*) heapAllocate(sizeof(g_physical_address) * pages);
+	if(!physicalPages)
+		return 0;
+	bool contiguous = true;
+	for(uint32_t i = 0; i < pages; i++)
+	{
+		physicalPages[i] = pagingVirtualToPhysical(memory + i * G_PAGE_SIZE);
+		if(physicalPages[i] != physicalPages[0] + i * G_PAGE_SIZE)
+			contiguous = false;
+	}
+	contiguous = contiguous && physicalPages[0] != 0;
+
+	// Keep the caching mode of the source, for example for write-combined framebuffers
+	uint32_t pageFlags = G_PAGE_USER_DEFAULT | (pagingVirtualToFlags(memory) & G_PAGE_CACHE_MASK);
+
+	g_virtual_address virtualRangeBase;
+	if(contiguous)
+		virtualRangeBase = taskingMemoryAllocateRangeFor(targetProcess, physicalPages[0], pages,
+		                                                  G_PROC_VIRTUAL_RANGE_FLAG_NONE);
+	else
+		virtualRangeBase = addressRangePoolAllocate(targetProcess->virtualRangePool, pages,
+		                                            G_PROC_VIRTUAL_RANGE_FLAG_NONE);
+	if(virtualRangeBase == 0)
+	{
+		logInfo("%! unable to share memory area %h of size %h with task %i because there was no free virtual range",
+		        "tasking", memory, pages * G_PAGE_SIZE, targetProcess->main->id);
+		heapFree(physicalPages);
+		return 0;
+	}
+
+	// Map everything with a single switch to the target address space
+	mutexAcquire(&targetProcess->lock);
+	g_physical_address back = taskingMemoryTemporarySwitchTo(targetProcess->pageDirectory);
+	if(contiguous)
+		taskingMemoryMapContiguous(virtualRangeBase, physicalPages[0], pages, pageFlags);
+	for(uint32_t i = 0; i < pages; i++)
+	{
+		if(!physicalPages[i])
+			continue;
+
+		if(!contiguous)
+			pagingMapPage(virtualRangeBase + i * G_PAGE_SIZE, physicalPages[i], G_PAGE_TABLE_USER_DEFAULT, pageFlags);
+		pageReferenceTrackerIncrement(physicalPages[i]);
+	}
+	taskingMemoryTemporarySwitchBack(back);
+	mutexRelease(&targetProcess->lock);
+
+	heapFree(physicalPages);
+
+	logDebug("%! shared memory area at %h of size %h with process %i to address %h", "tasking", memory,
+	         pages * G_PAGE_SIZE, targetProcess->main->id, virtualRangeBase);
+	return virtualRangeBase;
+}
+
+void taskingMemoryUnmapRange(g_process* process, g_virtual_address base)
+{
+	g_address_range* range = addressRangePoolFind(process->virtualRangePool, base);
+	if(!range)
+		return;
+
+	// Free before unmapping, a large page covers many pages of the range
+	if((range->flags & G_PROC_VIRTUAL_RANGE_FLAG_WEAK) == 0)
+	{
+		for(uint32_t i = 0; i < range->pages; i++)
+		{
+			g_physical_address page = pagingVirtualToPhysical(range->base + i * G_PAGE_SIZE);
+			if(page)
+				memoryPhysicalFree(page);
+		}
+	}
+
+	for(uint32_t i = 0; i < range->pages; i++)
+		pagingUnmapPage(range->base + i * G_PAGE_SIZE);
+
+	addressRangePoolFree(process->virtualRangePool, range->base);
+}
+
 bool taskingMemoryHandleStackOverflow(g_task* task, g_virtual_address accessed)
 {
 	g_virtual_address accessedPage = G_PAGE_ALIGN_DOWN(accessed);
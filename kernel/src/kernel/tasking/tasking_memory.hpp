@@ -118,6 +118,34 @@ g_physical_address taskingMemoryTemporarySwitchTo(g_physical_address pageDirecto
  */
 void taskingMemoryTemporarySwitchBack(g_physical_address pageDirectory);
 
+/**
+ * Maps a physically contiguous area into the current address space. Where both addresses
+ * are aligned to 4 MiB, the area is mapped with large pages to save TLB entries.
+ */
+void taskingMemoryMapContiguous(g_virtual_address virt, g_physical_address phys, uint32_t pages, uint32_t pageFlags);
+
+/**
+ * Allocates a virtual range for an area of the given physical address. If it could be
+ * mapped with large pages, the range is aligned accordingly.
+ */
+g_virtual_address taskingMemoryAllocateRangeFor(g_process* process, g_physical_address phys, uint32_t pages, uint8_t flags);
+
+/**
+ * Maps the pages of an area of the current address space into a free range of the target
+ * process. The physical pages are reference-counted, so they stay alive until both sides
+ * have unmapped them.
+ *
+ * @return the address of the range in the target process or 0 if mapping failed
+ */
+g_virtual_address taskingMemoryShare(g_process* targetProcess, g_virtual_address memory, uint32_t pages);
+
+/**
+ * Unmaps a range that was allocated in the virtual range pool of the process and releases
+ * its physical pages unless the range is weak. Must be called within the address space of
+ * the process.
+ */
+void taskingMemoryUnmapRange(g_process* process, g_virtual_address base);
+
 /**
  * Attempts to handle a stack-overflow by mapping the required pages.
  *
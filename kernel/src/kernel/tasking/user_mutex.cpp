@@ -20,87 +20,129 @@
 
 #include "kernel/tasking/user_mutex.hpp"
 #include "kernel/memory/heap.hpp"
-#include "kernel/utils/hashmap.hpp"
 #include "kernel/system/interrupts/interrupts.hpp"
 #include "kernel/tasking/clock.hpp"
 #include "shared/logger/logger.hpp"
 
-static g_user_mutex nextMutex;
-static g_mutex globalLock;
-static g_hashmap<g_user_mutex, g_user_mutex_entry*>* mutexMap;
-
-void _userMutexSetTaskWaiting(g_user_mutex_entry* entry, g_task* task);
+g_user_mutex_entry* _userMutexGet(g_process* process, g_user_mutex mutex);
+g_user_mutex_status _userMutexTryAcquire(g_task* task, g_user_mutex_entry* entry);
 void _userMutexWakeWaitingTasks(g_user_mutex_entry* entry);
 
-void userMutexInitialize()
+g_user_mutex userMutexCreate(g_process* process, bool reentrant)
 {
-	mutexInitializeGlobal(&globalLock, __func__);
-	nextMutex = 0;
-	mutexMap = hashmapCreateNumeric<g_user_mutex, g_user_mutex_entry*>(128);
-}
+	mutexAcquire(&process->lock);
+	if(!process->userMutexes)
+	{
+		auto table = (g_user_mutex_table*) heapAllocateClear(sizeof(g_user_mutex_table));
+		mutexInitializeTask(&table->lock, __func__);
+		process->userMutexes = table;
+	}
+	mutexRelease(&process->lock);
 
-g_user_mutex userMutexCreate(bool reentrant)
-{
-	g_user_mutex_entry* entry = (g_user_mutex_entry*) heapAllocate(sizeof(g_user_mutex_entry));
+	g_user_mutex_table* table = process->userMutexes;
+	mutexAcquire(&table->lock);
+
+	g_user_mutex mutex = table->freeList;
+	if(mutex)
+	{
+		table->freeList = _userMutexGet(process, mutex)->nextFree;
+	}
+	else
+	{
+		if(table->used == table->chunkCount * G_USER_MUTEX_CHUNK_SIZE)
+		{
+			if(table->chunkCount == G_USER_MUTEX_MAXIMUM_CHUNKS)
+			{
+				mutexRelease(&table->lock);
+				logWarn("%! process %i exceeded the maximum number of mutexes", "mutex", process->id);
+				return 0;
+			}
+
+			// Chunk must be visible before lookups can reach it
+			table->chunks[table->chunkCount] =
+					(g_user_mutex_entry*) heapAllocateClear(sizeof(g_user_mutex_entry) * G_USER_MUTEX_CHUNK_SIZE);
+			asm volatile("" ::: "memory");
+			table->chunkCount++;
+		}
+		mutex = ++table->used;
+	}
+
+	uint32_t index = mutex - 1;
+	g_user_mutex_entry* entry = &table->chunks[index / G_USER_MUTEX_CHUNK_SIZE][index % G_USER_MUTEX_CHUNK_SIZE];
 	mutexInitializeTask(&entry->lock, __func__);
 	entry->value = 0;
-	waitQueueInitialize(&entry->waiters);
 	entry->reentrant = reentrant;
-	entry->owner = -1;
-
-	mutexAcquire(&globalLock);
-	g_user_mutex mutex = ++nextMutex;
-	mutexRelease(&globalLock);
-	hashmapPut(mutexMap, mutex, entry);
+	entry->owner = G_TID_NONE;
+	entry->waiters = nullptr;
+	entry->nextFree = 0;
+	entry->used = true;
 
+	mutexRelease(&table->lock);
 	return mutex;
 }
 
+g_user_mutex_entry* _userMutexGet(g_process* process, g_user_mutex mutex)
+{
+	g_user_mutex_table* table = process->userMutexes;
+	if(!table || mutex == 0)
+		return nullptr;
+
+	uint32_t index = mutex - 1;
+	uint32_t chunk = index / G_USER_MUTEX_CHUNK_SIZE;
+	if(chunk >= table->chunkCount)
+		return nullptr;
+
+	return &table->chunks[chunk][index % G_USER_MUTEX_CHUNK_SIZE];
+}
+
 g_user_mutex_status userMutexTryAcquire(g_task* task, g_user_mutex mutex)
 {
-	g_user_mutex_entry* entry = hashmapGet<g_user_mutex, g_user_mutex_entry*>(mutexMap, mutex, nullptr);
-	if(!entry)
+	g_user_mutex_entry* entry = _userMutexGet(task->process, mutex);
+	if(!entry || !entry->used)
 	{
 		logWarn("%! task %i tried to lock unknown mutex %i", "mutex", task->id, mutex);
-		return false;
+		return G_USER_MUTEX_STATUS_NOT_ACQUIRED;
 	}
 
-	g_user_mutex_status status;
 	mutexAcquire(&entry->lock);
+	g_user_mutex_status status = _userMutexTryAcquire(task, entry);
+	mutexRelease(&entry->lock);
+	return status;
+}
+
+g_user_mutex_status _userMutexTryAcquire(g_task* task, g_user_mutex_entry* entry)
+{
 	if(entry->value)
 	{
 		if(entry->reentrant && task->id == entry->owner)
 		{
 			entry->value++;
-			status = G_USER_MUTEX_STATUS_ACQUIRED;
-		}
-		else
-			status = G_USER_MUTEX_STATUS_NOT_ACQUIRED;
-	}
-	else
-	{
-		status = G_USER_MUTEX_STATUS_ACQUIRED;
-		entry->value = 1;
-		if(entry->reentrant)
-		{
-			entry->owner = task->id;
+			return G_USER_MUTEX_STATUS_ACQUIRED;
 		}
-		else
-			entry->owner = G_TID_NONE;
+		return G_USER_MUTEX_STATUS_NOT_ACQUIRED;
 	}
-	mutexRelease(&entry->lock);
-	return status;
+
+	entry->value = 1;
+	entry->owner = entry->reentrant ? task->id : G_TID_NONE;
+	return G_USER_MUTEX_STATUS_ACQUIRED;
 }
 
 g_user_mutex_status userMutexAcquire(g_task* task, g_user_mutex mutex, uint64_t timeout, bool trying)
 {
-	g_user_mutex_entry* entry = hashmapGet<g_user_mutex, g_user_mutex_entry*>(mutexMap, mutex, nullptr);
-	if(!entry)
+	g_user_mutex_entry* entry = _userMutexGet(task->process, mutex);
+	if(!entry || !entry->used)
 	{
-		logWarn("%! task %i attempted to acquire unknown mutex %i", "mutex", taskingGetCurrentTask()->id, mutex);
+		logWarn("%! task %i attempted to acquire unknown mutex %i", "mutex", task->id, mutex);
 		return G_USER_MUTEX_STATUS_NOT_ACQUIRED;
 	}
 
+	// Uncontended case does not need a timer or wait state
+	mutexAcquire(&entry->lock);
+	g_user_mutex_status status = _userMutexTryAcquire(task, entry);
+	mutexRelease(&entry->lock);
+	if(status == G_USER_MUTEX_STATUS_ACQUIRED || trying)
+		return status;
+
 	bool wasSet = false;
 	bool hasTimeout = false;
 
@@ -112,15 +154,18 @@ g_user_mutex_status userMutexAcquire(g_task* task, g_user_mutex mutex, uint64_t
 	{
 		mutexAcquire(&entry->lock);
 		bool stop = false;
-		if(useTimeout && (hasTimeout = clockHasTimedOut(task->id)))
+		if(!entry->used)
+		{
+			stop = true;
+		}
+		else if(useTimeout && (hasTimeout = clockHasTimedOut(task->id)))
 		{
 			stop = true;
 		}
 		else
 		{
-			g_user_mutex_status status = userMutexTryAcquire(task, mutex);
-			wasSet = (status == G_USER_MUTEX_STATUS_ACQUIRED);
-			stop = wasSet || trying;
+			wasSet = (_userMutexTryAcquire(task, entry) == G_USER_MUTEX_STATUS_ACQUIRED);
+			stop = wasSet;
 		}
 		if(stop)
 		{
@@ -128,9 +173,15 @@ g_user_mutex_status userMutexAcquire(g_task* task, g_user_mutex mutex, uint64_t
 			break;
 		}
 
-		taskingWait(task, __func__, [mutex, entry, task]()
+		if(!entry->waiters)
 		{
-			userMutexWaitForAcquire(mutex, task->id);
+			entry->waiters = (g_wait_queue*) heapAllocate(sizeof(g_wait_queue));
+			waitQueueInitialize(entry->waiters);
+		}
+
+		taskingWait(task, __func__, [entry, task]()
+		{
+			waitQueueAdd(entry->waiters, task->id, true);
 			mutexRelease(&entry->lock);
 		});
 	}
@@ -138,19 +189,26 @@ g_user_mutex_status userMutexAcquire(g_task* task, g_user_mutex mutex, uint64_t
 	if(useTimeout)
 		clockUnwaitForTime(task->id);
 
-	userMutexUnwaitForAcquire(mutex, task->id);
+	mutexAcquire(&entry->lock);
+	if(entry->waiters)
+		waitQueueRemove(entry->waiters, task->id);
+
+	// A wake that raced with the timeout must be passed on to the next waiter
+	if(hasTimeout && entry->used && !entry->value)
+		_userMutexWakeWaitingTasks(entry);
+	mutexRelease(&entry->lock);
 
 	return hasTimeout
 		       ? G_USER_MUTEX_STATUS_TIMEOUT
 		       : (wasSet ? G_USER_MUTEX_STATUS_ACQUIRED : G_USER_MUTEX_STATUS_NOT_ACQUIRED);
 }
 
-void userMutexRelease(g_user_mutex mutex)
+void userMutexRelease(g_task* task, g_user_mutex mutex)
 {
-	g_user_mutex_entry* entry = hashmapGet<g_user_mutex, g_user_mutex_entry*>(mutexMap, mutex, nullptr);
-	if(!entry)
+	g_user_mutex_entry* entry = _userMutexGet(task->process, mutex);
+	if(!entry || !entry->used)
 	{
-		logWarn("%! task %i tried to unlock unknown mutex %i", "mutex", taskingGetCurrentTask()->id, mutex);
+		logWarn("%! task %i tried to unlock unknown mutex %i", "mutex", task->id, mutex);
 		return;
 	}
 
@@ -177,45 +235,60 @@ void userMutexRelease(g_user_mutex mutex)
 	mutexRelease(&entry->lock);
 }
 
-void userMutexDestroy(g_user_mutex mutex)
+void userMutexDestroy(g_process* process, g_user_mutex mutex)
 {
-	userMutexRelease(mutex);
+	g_user_mutex_entry* entry = _userMutexGet(process, mutex);
+	if(!entry || !entry->used)
+		return;
 
-	mutexAcquire(&mutexMap->lock);
-	g_user_mutex_entry* entry = hashmapGet<g_user_mutex, g_user_mutex_entry*>(mutexMap, mutex, nullptr);
-	if(entry)
-	{
-		hashmapRemove(mutexMap, mutex);
-		heapFree(entry);
-	}
-	mutexRelease(&mutexMap->lock);
-}
+	g_user_mutex_table* table = process->userMutexes;
+	mutexAcquire(&table->lock);
+	mutexAcquire(&entry->lock);
 
-void userMutexWaitForAcquire(g_user_mutex mutex, g_tid task)
-{
-	g_user_mutex_entry* entry = hashmapGet<g_user_mutex, g_user_mutex_entry*>(mutexMap, mutex, nullptr);
-	if(!entry)
+	// Waiters see that the entry is unused and return
+	entry->used = false;
+	if(entry->waiters)
 	{
-		logWarn("%! tried to add waiter for task %i to unknown mutex %i", "mutex", task, mutex);
-		return;
+		waitQueueWake(entry->waiters);
+		waitQueueDestroy(entry->waiters);
+		heapFree(entry->waiters);
+		entry->waiters = nullptr;
 	}
 
-	waitQueueAdd(&entry->waiters, task);
+	entry->nextFree = table->freeList;
+	table->freeList = mutex;
+
+	mutexRelease(&entry->lock);
+	mutexRelease(&table->lock);
 }
 
-void userMutexUnwaitForAcquire(g_user_mutex mutex, g_tid task)
+void userMutexProcessRemoved(g_process* process)
 {
-	g_user_mutex_entry* entry = hashmapGet<g_user_mutex, g_user_mutex_entry*>(mutexMap, mutex, nullptr);
-	if(!entry)
-	{
-		logWarn("%! tried to remove waiter for task %i from unknown mutex %i", "mutex", task, mutex);
+	g_user_mutex_table* table = process->userMutexes;
+	if(!table)
 		return;
+
+	for(uint32_t chunk = 0; chunk < table->chunkCount; chunk++)
+	{
+		for(uint32_t i = 0; i < G_USER_MUTEX_CHUNK_SIZE; i++)
+		{
+			g_wait_queue* waiters = table->chunks[chunk][i].waiters;
+			if(waiters)
+			{
+				waitQueueDestroy(waiters);
+				heapFree(waiters);
+			}
+		}
+		heapFree(table->chunks[chunk]);
 	}
 
-	waitQueueRemove(&entry->waiters, task);
+	heapFree(table);
+	process->userMutexes = nullptr;
 }
 
 void _userMutexWakeWaitingTasks(g_user_mutex_entry* entry)
 {
-	waitQueueWake(&entry->waiters);
+	// Only one of the waiters can take the mutex, waking all would let the rest go back to sleep
+	if(entry->waiters)
+		waitQueueWakeOne(entry->waiters);
 }
@@ -26,15 +26,44 @@
 #include <ghost/tasks/types.h>
 #include <ghost/mutex/types.h>
 
+/**
+ * Mutex handles are dense per process. Entries are stored in chunks that are never
+ * moved, so that a handle can be resolved without taking a lock.
+ */
+#define G_USER_MUTEX_CHUNK_SIZE           64
+#define G_USER_MUTEX_MAXIMUM_CHUNKS       256
+
 struct g_user_mutex_entry
 {
     g_mutex lock;
+    bool used;
     int value;
 
     bool reentrant;
     g_tid owner;
 
-    g_wait_queue waiters;
+    /**
+     * Only created once a task had to wait for this mutex.
+     */
+    g_wait_queue* waiters;
+
+    /**
+     * Next free handle while this entry is unused.
+     */
+    g_user_mutex nextFree;
+};
+
+/**
+ * Table of all mutexes of a process, created with the first mutex.
+ */
+struct g_user_mutex_table
+{
+    g_mutex lock;
+    g_user_mutex_entry* chunks[G_USER_MUTEX_MAXIMUM_CHUNKS];
+    volatile uint32_t chunkCount;
+
+    uint32_t used;
+    g_user_mutex freeList;
 };
 
 typedef uint32_t g_user_mutex_status;
@@ -43,19 +72,16 @@ typedef uint32_t g_user_mutex_status;
 #define G_USER_MUTEX_STATUS_NOT_ACQUIRED  ((g_user_mutex_status) 3)
 
 /**
- * Initializes the mutexes.
- */
-void userMutexInitialize();
-
-/**
- * Creates a new mutex that can then be locked with the other functions.
+ * Creates a new mutex in the process that can then be locked with the other functions.
+ *
+ * @return the handle or 0 if the process has no more room for mutexes
  */
-g_user_mutex userMutexCreate(bool reentrant);
+g_user_mutex userMutexCreate(g_process* process, bool reentrant);
 
 /**
- * Destroys a mutex.
+ * Destroys a mutex. Tasks that are still waiting for it return without acquiring it.
  */
-void userMutexDestroy(g_user_mutex mutex);
+void userMutexDestroy(g_process* process, g_user_mutex mutex);
 
 /**
  *
@@ -70,16 +96,11 @@ g_user_mutex_status userMutexTryAcquire(g_task* task, g_user_mutex mutex);
 /**
  * Unlocks the mutex and wakes the next waiting task.
  */
-void userMutexRelease(g_user_mutex mutex);
-
-/**
- * Removes the task from a wait queue, for example in case of timeouts.
- */
-void userMutexUnwaitForAcquire(g_user_mutex mutex, g_tid task);
+void userMutexRelease(g_task* task, g_user_mutex mutex);
 
 /**
- * Adds the task to the wait queue for the mutex.
+ * Frees the mutex table of a process that is being destroyed.
  */
-void userMutexWaitForAcquire(g_user_mutex mutex, g_tid task);
+void userMutexProcessRemoved(g_process* process);
 
 #endif
@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "kernel/utils/lz4.hpp"
+#include "shared/memory/memory.hpp"
+
+/**
+ * Reads the continuation bytes of a length field.
+ */
+bool _lz4ReadLength(const uint8_t*& in, const uint8_t* end, uint32_t& length);
+
+bool _lz4ReadLength(const uint8_t*& in, const uint8_t* end, uint32_t& length)
+{
+	uint8_t next;
+	do
+	{
+		if(in >= end)
+			return false;
+		next = *in++;
+		length += next;
+	} while(next == 255);
+	return true;
+}
+
+int32_t lz4Decompress(const uint8_t* source, uint32_t sourceLength, uint8_t* target, uint32_t targetLength)
+{
+	const uint8_t* in = source;
+	const uint8_t* inEnd = source + sourceLength;
+	uint8_t* out = target;
+	uint8_t* outEnd = target + targetLength;
+
+	while(in < inEnd)
+	{
+		uint8_t token = *in++;
+
+		uint32_t literals = token >> 4;
+		if(literals == 15 && !_lz4ReadLength(in, inEnd, literals))
+			return -1;
+		if(literals > (uint32_t) (inEnd - in) || literals > (uint32_t) (outEnd - out))
+			return -1;
+
+		memoryCopy(out, in, literals);
+		in += literals;
+		out += literals;
+
+		// The last sequence consists of literals only
+		if(in == inEnd)
+			break;
+
+		if(inEnd - in < 2)
+			return -1;
+		uint32_t offset = in[0] | (in[1] << 8);
+		in += 2;
+		if(offset == 0 || offset > (uint32_t) (out - target))
+			return -1;
+
+		uint32_t matchLength = token & 15;
+		if(matchLength == 15 && !_lz4ReadLength(in, inEnd, matchLength))
+			return -1;
+		matchLength += 4;
+		if(matchLength > (uint32_t) (outEnd - out))
+			return -1;
+
+		// Byte-wise, as the match may overlap with the output
+		const uint8_t* match = out - offset;
+		while(matchLength--)
+			*out++ = *match++;
+	}
+
+	return out - target;
+}
@@ -22,20 +22,90 @@
 #include "kernel/memory/heap.hpp"
 #include "kernel/tasking/tasking.hpp"
 
+/**
+ * Unlinks the entry that follows prev (or the head) and releases it.
+ */
+void _waitQueueUnlink(g_wait_queue* queue, g_wait_queue_entry* prev, g_wait_queue_entry* entry);
+
+/**
+ * Held while destroying a queue and while removing an embedded entry, so the queue that an
+ * embedded entry points to stays valid until its lock is taken.
+ */
+static g_mutex waitQueuesDestroyLock;
+
+void waitQueuesInitialize()
+{
+	mutexInitializeTask(&waitQueuesDestroyLock, __func__);
+}
+
 void waitQueueInitialize(g_wait_queue* queue)
 {
 	mutexInitializeTask(&queue->lock);
 	queue->head = nullptr;
+	queue->tail = nullptr;
+}
+
+void waitQueueDestroy(g_wait_queue* queue)
+{
+	mutexAcquire(&waitQueuesDestroyLock);
+	mutexAcquire(&queue->lock);
+	while(queue->head)
+		_waitQueueUnlink(queue, nullptr, queue->head);
+	mutexRelease(&queue->lock);
+	mutexRelease(&waitQueuesDestroyLock);
+}
+
+void waitQueueRemoveEmbedded(g_wait_queue_entry* entry)
+{
+	mutexAcquire(&waitQueuesDestroyLock);
+	g_wait_queue* queue = entry->queue;
+	if(queue)
+		waitQueueRemove(queue, entry->task);
+	mutexRelease(&waitQueuesDestroyLock);
 }
 
-void waitQueueAdd(g_wait_queue* queue, g_tid task)
+void waitQueueAdd(g_wait_queue* queue, g_tid task, bool exclusive)
 {
+	g_task* owner = taskingGetById(task);
+
 	mutexAcquire(&queue->lock);
 
-	auto entry = (g_wait_queue_entry*) heapAllocate(sizeof(g_wait_queue_entry));
+	g_wait_queue_entry* entry;
+	if(owner && owner->waitEntry.queue == queue)
+	{
+		mutexRelease(&queue->lock);
+		return;
+	}
+	else if(owner && !owner->waitEntry.queue)
+	{
+		entry = &owner->waitEntry;
+		entry->embedded = true;
+		entry->queue = queue;
+	}
+	else
+	{
+		for(entry = queue->head; entry; entry = entry->next)
+		{
+			if(entry->task == task)
+			{
+				mutexRelease(&queue->lock);
+				return;
+			}
+		}
+
+		entry = (g_wait_queue_entry*) heapAllocate(sizeof(g_wait_queue_entry));
+		entry->embedded = false;
+		entry->queue = nullptr;
+	}
+
 	entry->task = task;
-	entry->next = queue->head;
-	queue->head = entry;
+	entry->exclusive = exclusive;
+	entry->next = nullptr;
+	if(queue->tail)
+		queue->tail->next = entry;
+	else
+		queue->head = entry;
+	queue->tail = entry;
 
 	mutexRelease(&queue->lock);
 }
@@ -48,19 +118,12 @@ void waitQueueRemove(g_wait_queue* queue, g_tid task)
 	g_wait_queue_entry* waiter = queue->head;
 	while(waiter)
 	{
+		auto next = waiter->next;
 		if(waiter->task == task)
-		{
-			auto next = waiter->next;
-			if(prev)
-				prev->next = next;
-			else
-				queue->head = next;
-
-			heapFree(waiter);
-			break;
-		}
-		prev = waiter;
-		waiter = waiter->next;
+			_waitQueueUnlink(queue, prev, waiter);
+		else
+			prev = waiter;
+		waiter = next;
 	}
 
 	mutexRelease(&queue->lock);
@@ -70,17 +133,61 @@ void waitQueueWake(g_wait_queue* queue)
 {
 	mutexAcquire(&queue->lock);
 
-	auto waiter = queue->head;
-	while(waiter)
+	while(queue->head)
 	{
-		g_task* task = taskingGetById(waiter->task);
+		g_task* task = taskingGetById(queue->head->task);
+		_waitQueueUnlink(queue, nullptr, queue->head);
 		taskingWake(task);
+	}
+
+	mutexRelease(&queue->lock);
+}
 
+uint32_t waitQueueWakeCount(g_wait_queue* queue, uint32_t count)
+{
+	mutexAcquire(&queue->lock);
+
+	uint32_t woken = 0;
+	g_wait_queue_entry* prev = nullptr;
+	g_wait_queue_entry* waiter = queue->head;
+	while(waiter)
+	{
 		auto next = waiter->next;
-		heapFree(waiter);
+		if(waiter->exclusive && woken >= count)
+		{
+			prev = waiter;
+		}
+		else
+		{
+			g_task* task = taskingGetById(waiter->task);
+			bool exclusive = waiter->exclusive;
+			_waitQueueUnlink(queue, prev, waiter);
+			if(taskingWake(task) && exclusive)
+				++woken;
+		}
 		waiter = next;
 	}
-	queue->head = nullptr;
 
 	mutexRelease(&queue->lock);
+	return woken;
+}
+
+uint32_t waitQueueWakeOne(g_wait_queue* queue)
+{
+	return waitQueueWakeCount(queue, 1);
+}
+
+void _waitQueueUnlink(g_wait_queue* queue, g_wait_queue_entry* prev, g_wait_queue_entry* entry)
+{
+	if(prev)
+		prev->next = entry->next;
+	else
+		queue->head = entry->next;
+	if(queue->tail == entry)
+		queue->tail = prev;
+
+	if(entry->embedded)
+		entry->queue = nullptr;
+	else
+		heapFree(entry);
 }
@@ -25,30 +25,72 @@
 
 #include <ghost/tasks/types.h>
 
+struct g_wait_queue;
+
+/**
+ * Entry of a wait queue. Each task embeds one entry that is used for the first queue it
+ * waits on, so the common case of blocking on a single queue needs no allocation. Only
+ * when a task waits on multiple queues at once (like when polling) further entries are
+ * allocated on the heap.
+ */
 struct g_wait_queue_entry
 {
     g_tid task;
     g_wait_queue_entry* next;
+
+    /**
+     * Queue the entry is currently linked into, only tracked for embedded entries.
+     */
+    g_wait_queue* queue;
+    bool embedded;
+
+    /**
+     * Exclusive waiters are woken in limited numbers, all others are always woken.
+     */
+    bool exclusive;
 };
 
 struct g_wait_queue
 {
     g_wait_queue_entry* head;
+    g_wait_queue_entry* tail;
     g_mutex lock;
 };
 
+/**
+ * Initializes the lock that orders destroying queues against removing dead tasks from them.
+ */
+void waitQueuesInitialize();
+
 /**
  * Initializes a wait-queue.
  */
 void waitQueueInitialize(g_wait_queue* queue);
 
 /**
- * Adds a task entry to the given wait queue.
+ * Releases all entries that are still in the queue, must be called before the memory of
+ * the queue is freed.
+ */
+void waitQueueDestroy(g_wait_queue* queue);
+
+/**
+ * Unlinks the embedded entry of a task that is being removed from the queue it is still
+ * linked into. The queue can not be destroyed concurrently while doing so.
  */
-void waitQueueAdd(g_wait_queue* queue, g_tid task);
+void waitQueueRemoveEmbedded(g_wait_queue_entry* entry);
 
 /**
- * Removes the entry for this task id from the wait queue.
+ * Adds a task entry to the end of the given wait queue. If the task is already in the queue,
+ * nothing happens. Tasks may only add themselves.
+ *
+ * An exclusive waiter is one that consumes the resource it waits for, so waking one of them
+ * for each available unit is enough. Non-exclusive waiters (like polling tasks) are woken by
+ * every wake.
+ */
+void waitQueueAdd(g_wait_queue* queue, g_tid task, bool exclusive = false);
+
+/**
+ * Removes the entries for this task id from the wait queue.
  */
 void waitQueueRemove(g_wait_queue* queue, g_tid task);
 
@@ -57,4 +99,18 @@ void waitQueueRemove(g_wait_queue* queue, g_tid task);
  */
 void waitQueueWake(g_wait_queue* queue);
 
+/**
+ * Wakes all non-exclusive waiters and up to count of the exclusive waiters, in the order they
+ * were added. Only tasks that were actually waiting count, so a waiter that was already
+ * woken by something else (for example a timeout) doesn't swallow the wake.
+ *
+ * @return the number of exclusive waiters that were woken
+ */
+uint32_t waitQueueWakeCount(g_wait_queue* queue, uint32_t count);
+
+/**
+ * Wakes the first exclusive waiter and all non-exclusive waiters.
+ */
+uint32_t waitQueueWakeOne(g_wait_queue* queue);
+
 #endif
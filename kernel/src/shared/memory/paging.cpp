@@ -50,6 +50,11 @@ bool pagingMapPage(g_virtual_address virt, g_physical_address phys, uint32_t tab
 		for(uint32_t i = 0; i < 1024; i++)
 			table[i] = 0;
 	}
+	else if(directory[ti] & G_PAGE_TABLE_SIZE)
+	{
+		logInfo("%! warning: tried to map page %h within a large page", "paging", virt);
+		return false;
+	}
 	else if((tableFlags & G_PAGE_TABLE_USERSPACE) && ((directory[ti] & G_PAGE_ALIGN_MASK) & G_PAGE_TABLE_USERSPACE) == 0)
 	{
 		panic("%! tried to map user page in kernel space table, virt %h", "paging", virt);
@@ -77,6 +82,13 @@ void pagingUnmapPage(g_virtual_address virt)
 	if(!directory[ti])
 		return;
 
+	if(directory[ti] & G_PAGE_TABLE_SIZE)
+	{
+		directory[ti] = 0;
+		pagingInvalidatePage(virt & ~G_LARGE_PAGE_ALIGN_MASK);
+		return;
+	}
+
 	if(!table[pi])
 		return;
 
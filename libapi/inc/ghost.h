@@ -21,13 +21,16 @@
 #ifndef GHOST_API
 #define GHOST_API
 
+#include "ghost/channel.h"
 #include "ghost/common.h"
 #include "ghost/filesystem.h"
 #include "ghost/kernquery.h"
 #include "ghost/memory.h"
 #include "ghost/messages.h"
 #include "ghost/mutex.h"
+#include "ghost/poll.h"
 #include "ghost/ramdisk.h"
+#include "ghost/ring.h"
 #include "ghost/signal.h"
 #include "ghost/syscall.h"
 #include "ghost/system.h"
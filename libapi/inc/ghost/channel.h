@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_CHANNEL
+#define GHOST_API_CHANNEL
+
+#include "common.h"
+#include "stdint.h"
+#include "channel/types.h"
+#include "tasks/types.h"
+
+__BEGIN_C
+
+/**
+ * Creates a single-producer/single-consumer channel in a new shared memory object
+ * and maps it into the executing process. Records are exchanged entirely in userspace;
+ * the kernel is only entered to sleep when the ring is empty or full, and to wake
+ * a sleeping peer.
+ *
+ * @param channel
+ * 		handle to initialize
+ * @param capacity
+ * 		size of the ring in bytes, rounded up to a power of two
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_channel_status g_channel_create(g_channel* channel, uint32_t capacity);
+
+/**
+ * Opens the other end of a channel from the handle of its shared memory object,
+ * for example one that was granted by the creating process.
+ *
+ * @param channel
+ * 		handle to initialize
+ * @param shm
+ * 		the shared memory object of the channel
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_channel_status g_channel_open(g_channel* channel, g_shm shm);
+
+/**
+ * Grants another process access to the channel, see {g_shm_grant}.
+ *
+ * @security-level APPLICATION
+ */
+g_channel_status g_channel_grant(g_channel* channel, g_pid pid);
+
+/**
+ * Writes a record to the channel. Only one task may write to a channel.
+ *
+ * @param channel
+ * 		the channel
+ * @param data
+ * 		record contents
+ * @param length
+ * 		record length, at most half of the capacity minus four bytes
+ * @param blocking
+ * 		whether to wait while the ring is full
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_channel_status g_channel_write(g_channel* channel, const void* data, uint32_t length);
+g_channel_status g_channel_write_b(g_channel* channel, const void* data, uint32_t length, g_bool blocking);
+
+/**
+ * Reads the next record from the channel. Only one task may read from a channel.
+ * If the buffer is too small, the record is left in the ring and its length is
+ * returned in out_length.
+ *
+ * @param channel
+ * 		the channel
+ * @param buffer
+ * 		target buffer
+ * @param maximum
+ * 		size of the target buffer
+ * @param out_length
+ * 		is filled with the length of the record
+ * @param blocking
+ * 		whether to wait while the ring is empty
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_channel_status g_channel_read(g_channel* channel, void* buffer, uint32_t maximum, uint32_t* out_length);
+g_channel_status g_channel_read_b(g_channel* channel, void* buffer, uint32_t maximum, uint32_t* out_length, g_bool blocking);
+
+/**
+ * Unmaps the channel and releases the handle of the executing process.
+ *
+ * @security-level APPLICATION
+ */
+void g_channel_close(g_channel* channel);
+
+__END_C
+
+#endif
@@ -0,0 +1,92 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_CHANNEL_TYPES
+#define GHOST_API_CHANNEL_TYPES
+
+#include "../common.h"
+#include "../stdint.h"
+#include "../memory/types.h"
+
+__BEGIN_C
+
+/**
+ * Status codes for channel operations
+ */
+typedef int g_channel_status;
+#define G_CHANNEL_STATUS_SUCCESSFUL     ((g_channel_status) 0)
+#define G_CHANNEL_STATUS_WOULD_BLOCK    ((g_channel_status) 1) // ring is full (write) or empty (read)
+#define G_CHANNEL_STATUS_TOO_LARGE      ((g_channel_status) 2) // record does not fit into the ring or the buffer
+#define G_CHANNEL_STATUS_INVALID        ((g_channel_status) 3) // channel is not set up or its memory is corrupt
+#define G_CHANNEL_STATUS_FAILED         ((g_channel_status) 4) // shared memory could not be created or mapped
+
+/**
+ * Ring sizes. The capacity is always a power of two; a single record may use
+ * at most half of the ring so that it always fits after a wrap-around.
+ */
+#define G_CHANNEL_MINIMUM_CAPACITY      0x100
+#define G_CHANNEL_DEFAULT_CAPACITY      0x10000
+#define G_CHANNEL_MAXIMUM_CAPACITY      0x1000000
+
+/**
+ * Each record is a 32-bit length followed by the payload, padded to the alignment.
+ * A length of G_CHANNEL_RECORD_WRAP tells the reader to continue at the start of the ring.
+ */
+#define G_CHANNEL_RECORD_ALIGNMENT      4
+#define G_CHANNEL_RECORD_SIZE(length)   ((sizeof(uint32_t) + (length) + G_CHANNEL_RECORD_ALIGNMENT - 1) & ~(G_CHANNEL_RECORD_ALIGNMENT - 1))
+#define G_CHANNEL_RECORD_WRAP           0xFFFFFFFF
+
+#define G_CHANNEL_MAGIC                 0x4348414E
+#define G_CHANNEL_DATA_OFFSET           0x100
+
+/**
+ * Control block at the start of the shared memory area. The head is only written by
+ * the producer and the tail only by the consumer, each on its own cache line. Both
+ * are free-running byte counters and double as futex words: a side that finds the
+ * ring empty or full sets its waiting flag and sleeps on the other side's counter.
+ */
+typedef struct
+{
+	volatile uint32_t head;
+	uint8_t padding0[60];
+
+	volatile uint32_t tail;
+	uint8_t padding1[60];
+
+	volatile uint32_t readerWaiting;
+	volatile uint32_t writerWaiting;
+	uint32_t capacity;
+	uint32_t magic;
+} g_channel_header;
+
+/**
+ * Process-local handle of one end of a channel.
+ */
+typedef struct
+{
+	g_shm shm;
+	g_channel_header* header;
+	uint8_t* data;
+	uint32_t capacity;
+} g_channel;
+
+__END_C
+
+#endif
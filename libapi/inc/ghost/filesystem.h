@@ -83,6 +83,69 @@ int32_t g_read_s(g_fd fd, void* buffer, uint64_t length, g_fs_read_status* out_s
 int32_t g_write(g_fd fd, const void* buffer, uint64_t length);
 int32_t g_write_s(g_fd fd, const void* buffer, uint64_t length, g_fs_write_status* out_status);
 
+/**
+ * Reads bytes from the file into multiple buffers. Only waits until the
+ * first bytes are available, then fills as much of the buffers as possible.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param vectors
+ * 		the target buffers
+ * @param count
+ * 		number of buffers, at most {G_FS_IOVEC_MAXIMUM}
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_read_status} codes
+ *
+ * @return if the read was successful the total length of bytes or
+ * 		zero if EOF, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_readv(g_fd fd, g_fs_iovec* vectors, uint32_t count);
+int32_t g_readv_s(g_fd fd, g_fs_iovec* vectors, uint32_t count, g_fs_read_status* out_status);
+
+/**
+ * Writes bytes from multiple buffers to the file. Only waits until the
+ * first bytes could be written, then writes as much as possible.
+ *
+ * @param fd
+ * 		the file descriptor
+ * @param vectors
+ * 		the source buffers
+ * @param count
+ * 		number of buffers, at most {G_FS_IOVEC_MAXIMUM}
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_write_status} codes
+ *
+ * @return if successful the total number of bytes that were written, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int32_t g_writev(g_fd fd, const g_fs_iovec* vectors, uint32_t count);
+int32_t g_writev_s(g_fd fd, const g_fs_iovec* vectors, uint32_t count, g_fs_write_status* out_status);
+
+/**
+ * Moves bytes from one file to another within the kernel, without copying
+ * them through the callers memory. Intended for streaming files into pipes
+ * and pipes into files. Waits until the output has accepted everything that
+ * was read, but only waits for input while nothing was moved yet.
+ *
+ * @param in
+ * 		the file descriptor to read from
+ * @param out
+ * 		the file descriptor to write to
+ * @param length
+ * 		maximum number of bytes to move
+ * @param-opt out_status
+ * 		filled with one of the {g_fs_splice_status} codes
+ *
+ * @return the number of bytes moved, zero if EOF, otherwise -1
+ *
+ * @security-level APPLICATION
+ */
+int64_t g_splice(g_fd in, g_fd out, uint64_t length);
+int64_t g_splice_s(g_fd in, g_fd out, uint64_t length, g_fs_splice_status* out_status);
+
 /**
  * Closes a file.
  *
@@ -111,6 +174,41 @@ g_fs_close_status g_close(g_fd fd);
 int64_t g_length(g_fd fd);
 int64_t g_length_s(g_fd fd, g_fs_length_status* out_status);
 
+/**
+ * Waits until everything that was written to the file is stored durably. Delegates
+ * that buffer writes, like the one of the AHCI driver, write them back first.
+ *
+ * @param fd
+ * 		the file descriptor
+ *
+ * @return one of the {g_fs_sync_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_fs_sync_status g_fsync(g_fd fd);
+
+/**
+ * Same as {g_fsync}, but for all mounted file systems.
+ *
+ * @security-level APPLICATION
+ */
+g_fs_sync_status g_sync();
+
+/**
+ * Sets the length of a file. Content past the new length is discarded, growing
+ * the file leaves a hole that reads as zeros.
+ *
+ * @param fd
+ * 		the file descriptor, must be open for writing
+ * @param length
+ * 		the new length in bytes
+ *
+ * @return one of the {g_fs_truncate_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_fs_truncate_status g_ftruncate(g_fd fd, uint64_t length);
+
 /**
  * Opens a directory.
  *
@@ -136,6 +234,28 @@ g_fs_directory_iterator* g_open_directory_s(const char* path, g_fs_open_director
 g_fs_directory_entry* g_read_directory(g_fs_directory_iterator* iterator);
 g_fs_directory_entry* g_read_directory_s(g_fs_directory_iterator* iterator, g_fs_read_directory_status* out_status);
 
+/**
+ * Fills the buffer with as many {g_fs_directory_record} entries of the directory
+ * as fit, starting at the cursor. The cursor is then advanced past the last record
+ * that was written. Start reading with {G_FS_DIRECTORY_CURSOR_START}.
+ *
+ * @param directory
+ * 		node id of the directory
+ * @param cursor
+ * 		position to start at, updated on return
+ * @param buffer
+ * 		target buffer
+ * @param length
+ * 		length of the target buffer
+ * @param out_status
+ * 		is filled with the status code
+ *
+ * @return the number of bytes written to the buffer
+ */
+uint32_t g_read_directory_entries(g_fs_virt_id directory, g_fs_directory_cursor* cursor, void* buffer, uint32_t length);
+uint32_t g_read_directory_entries_s(g_fs_virt_id directory, g_fs_directory_cursor* cursor, void* buffer, uint32_t length,
+                                    g_fs_read_directory_status* out_status);
+
 /**
  * Closes a directory.
  *
@@ -185,16 +305,40 @@ int64_t g_tell_s(g_fd fd, g_fs_tell_status* out_status);
  * 		is filled with the pipes write end
  * @param out_read
  * 		is filled with the pipes read end
- * @param out_status
- * 		is filled with the status code
+ * @param-opt blocking
+ * 		whether accessing the pipe blocks
+ * @param-opt capacity
+ * 		buffer capacity in bytes up to {G_PIPE_MAXIMUM_CAPACITY},
+ * 		zero for {G_PIPE_DEFAULT_CAPACITY}
+ *
+ * @return one of the {g_fs_pipe_status} codes
  *
  * @security-level APPLICATION
  */
 g_fs_pipe_status g_pipe(g_fd* out_write, g_fd* out_read);
 g_fs_pipe_status g_pipe_b(g_fd* out_write, g_fd* out_read, g_bool blocking);
+g_fs_pipe_status g_pipe_bc(g_fd* out_write, g_fd* out_read, g_bool blocking, uint32_t capacity);
+
+/**
+ * Changes the buffer capacity of an existing pipe. The new capacity must be
+ * large enough to hold the content that is currently buffered.
+ *
+ * @param fd
+ * 		either end of the pipe
+ * @param capacity
+ * 		buffer capacity in bytes up to {G_PIPE_MAXIMUM_CAPACITY}
+ *
+ * @return one of the {g_fs_pipe_status} codes
+ *
+ * @security-level APPLICATION
+ */
+g_fs_pipe_status g_pipe_set_capacity(g_fd fd, uint32_t capacity);
 
 /**
  * Creates a mountpoint and registers the current thread as its file system delegate.
+ * The mountpoint is created within "/mount". For each request on the mountpoint, the
+ * kernel sends a {g_fs_tasked_delegate_request} message to the thread, see
+ * "ghost/filesystem/delegate.h" for the layout of the transaction storage.
  *
  * @param name
  * 		the wanted name
@@ -206,7 +350,8 @@ g_fs_pipe_status g_pipe_b(g_fd* out_write, g_fd* out_read, g_bool blocking);
  * 		is filled with the node id of the mountpoint on success
  *
  * @param out_transaction_storage
- * 		is filled with the address of the transaction storage
+ * 		is filled with the address of the transaction storage, which consists of
+ * 		{G_FS_TASKED_DELEGATE_SLOTS} slots
  *
  * @return one of the {g_fs_register_as_delegate_status} codes
  *
@@ -217,7 +362,9 @@ g_fs_register_as_delegate_status g_fs_register_as_delegate(const char* name, g_f
                                                            g_address* out_transaction_storage);
 
 /**
- * Updates the status for a filesystem transaction.
+ * Updates the status for a filesystem transaction. Setting the status to finished
+ * wakes the task that waits for the transaction, setting it to repeat makes the kernel
+ * send the request again.
  *
  * @param id
  * 		the transaction id
@@ -230,7 +377,9 @@ g_fs_register_as_delegate_status g_fs_register_as_delegate(const char* name, g_f
 void g_fs_set_transaction_status(g_fs_transaction_id id, g_fs_transaction_status status);
 
 /**
- * Creates a filesystem node.
+ * Creates a filesystem node. The parent must be a node on a mountpoint that the
+ * calling process is the delegate for. If the parent already has a child with this
+ * name, it is updated instead.
  *
  * @param parent
  * 		id of the parent node
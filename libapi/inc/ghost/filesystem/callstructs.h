@@ -207,6 +207,9 @@ typedef struct
  * @field status
  * 		the call status
  *
+ * @field capacity
+ * 		buffer capacity of the pipe in bytes, zero for the default
+ *
  * @security-level APPLICATION
  */
 typedef struct
@@ -215,8 +218,113 @@ typedef struct
     g_fd read_fd;
     g_fs_pipe_status status;
     g_bool blocking;
+    uint32_t capacity;
 }__attribute__((packed)) g_syscall_fs_pipe;
 
+/**
+ * @field fd
+ * 		either end of the pipe
+ *
+ * @field capacity
+ * 		new buffer capacity in bytes, must fit the current content
+ *
+ * @field status
+ * 		one of the {g_fs_pipe_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_fd fd;
+    uint32_t capacity;
+
+    g_fs_pipe_status status;
+}__attribute__((packed)) g_syscall_fs_pipe_capacity;
+
+/**
+ * @field fd
+ * 		file descriptor
+ *
+ * @field vectors
+ * 		buffers to fill one after another
+ *
+ * @field count
+ * 		number of vectors, at most {G_FS_IOVEC_MAXIMUM}
+ *
+ * @field status
+ * 		one of the {g_fs_read_status} codes
+ *
+ * @field result
+ * 		total number of bytes read
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_fd fd;
+    g_fs_iovec* vectors;
+    uint32_t count;
+
+    g_fs_read_status status;
+    int64_t result;
+}__attribute__((packed)) g_syscall_fs_readv;
+
+/**
+ * @field fd
+ * 		file descriptor
+ *
+ * @field vectors
+ * 		buffers to write one after another
+ *
+ * @field count
+ * 		number of vectors, at most {G_FS_IOVEC_MAXIMUM}
+ *
+ * @field status
+ * 		one of the {g_fs_write_status} codes
+ *
+ * @field result
+ * 		total number of bytes written
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_fd fd;
+    g_fs_iovec* vectors;
+    uint32_t count;
+
+    g_fs_write_status status;
+    int64_t result;
+}__attribute__((packed)) g_syscall_fs_writev;
+
+/**
+ * @field in
+ * 		file descriptor to read from
+ *
+ * @field out
+ * 		file descriptor to write to
+ *
+ * @field length
+ * 		maximum number of bytes to move
+ *
+ * @field status
+ * 		one of the {g_fs_splice_status} codes
+ *
+ * @field result
+ * 		number of bytes moved
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_fd in;
+    g_fd out;
+    int64_t length;
+
+    g_fs_splice_status status;
+    int64_t result;
+}__attribute__((packed)) g_syscall_fs_splice;
+
 /**
  * @field mode
  * 		the mode flags
@@ -243,6 +351,46 @@ typedef struct
     int64_t length;
 }__attribute__((packed)) g_syscall_fs_length;
 
+/**
+ * @field all
+ * 		whether all mounted file systems are synced, the descriptor is then ignored
+ *
+ * @field fd
+ * 		file descriptor
+ *
+ * @field status
+ * 		one of the {g_fs_sync_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_bool all;
+    g_fd fd;
+
+    g_fs_sync_status status;
+}__attribute__((packed)) g_syscall_fs_sync;
+
+/**
+ * @field fd
+ * 		file descriptor
+ *
+ * @field length
+ * 		new length in bytes
+ *
+ * @field status
+ * 		one of the {g_fs_truncate_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_fd fd;
+    uint64_t length;
+
+    g_fs_truncate_status status;
+}__attribute__((packed)) g_syscall_fs_truncate;
+
 /**
  * @field fd
  * 		file descriptor
@@ -399,6 +547,39 @@ typedef struct
     g_fs_directory_refresh_status status;
 }__attribute__((packed)) g_syscall_fs_read_directory;
 
+/**
+ * @field node_id
+ * 		id of the directory node
+ *
+ * @field cursor
+ * 		position to continue reading at, updated to the position after
+ * 		the last written record
+ *
+ * @field buffer
+ * 		target buffer for the records
+ *
+ * @field length
+ * 		length of the target buffer
+ *
+ * @field written
+ * 		number of bytes written to the buffer
+ *
+ * @field status
+ * 		one of the {g_fs_read_directory_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+    g_fs_virt_id node_id;
+    g_fs_directory_cursor cursor;
+    uint8_t* buffer;
+    uint32_t length;
+
+    uint32_t written;
+    g_fs_read_directory_status status;
+}__attribute__((packed)) g_syscall_fs_read_directory_entries;
+
 /**
  * @field iterator
  * 		pointer to the iterator
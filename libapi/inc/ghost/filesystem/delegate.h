@@ -26,11 +26,37 @@
 
 __BEGIN_C
 
+/**
+ * The transaction storage of a tasked delegate consists of multiple slots, so that
+ * requests of different tasks can be in flight at the same time. Each slot starts with
+ * one page for the transaction storage structure and is followed by a buffer that the
+ * contents of reads and writes are transferred through.
+ */
+#define G_FS_TASKED_DELEGATE_SLOTS			8
+#define G_FS_TASKED_DELEGATE_TRANSFER_SIZE	0x10000
+#define G_FS_TASKED_DELEGATE_SLOT_SIZE		(G_PAGE_SIZE + G_FS_TASKED_DELEGATE_TRANSFER_SIZE)
+
+/**
+ * Message that the kernel sends to a tasked delegate for each request. The storage
+ * is the address of the transaction storage of the slot, the transfer buffer follows
+ * directly after it. Once the delegate has filled the result fields, it finishes the
+ * transaction with {g_fs_set_transaction_status}.
+ */
+typedef struct {
+	g_fs_tasked_delegate_request_type type;
+	g_fs_transaction_id transaction;
+	g_address storage;
+}__attribute__((packed)) g_fs_tasked_delegate_request;
+
 /**
  * Transaction storage structures (NOTE limited to 1 page!)
+ *
+ * On discovery, the delegate creates the node with {g_fs_create_node} in the parent
+ * before reporting success.
  */
 typedef struct {
 	g_fs_phys_id parent_phys_fs_id;
+	g_fs_virt_id parent_virt_fs_id;
 	char name[G_FILENAME_MAX];
 
 	g_fs_discovery_status result_status;
@@ -57,19 +83,19 @@ typedef struct {
 	int32_t mapping_pages;
 
 	int64_t result_write;
-	g_fs_read_status result_status;
+	g_fs_write_status result_status;
 } g_fs_tasked_delegate_transaction_storage_write;
 
 typedef struct {
 	g_fs_phys_id phys_fs_id;
 
 	int64_t result_length;
-	g_fs_read_status result_status;
+	g_fs_length_status result_status;
 } g_fs_tasked_delegate_transaction_storage_get_length;
 
 typedef struct {
 	g_fs_phys_id parent_phys_fs_id;
-	g_fs_phys_id parent_virt_fs_id;
+	g_fs_virt_id parent_virt_fs_id;
 
 	g_fs_directory_refresh_status result_status;
 } g_fs_tasked_delegate_transaction_storage_directory_refresh;
@@ -77,6 +103,7 @@ typedef struct {
 typedef struct {
 	g_fs_phys_id phys_fs_id;
 	char name[G_FILENAME_MAX];
+	g_file_flag_mode flags;
 
 	g_fs_open_status result_status;
 } g_fs_tasked_delegate_transaction_storage_open;
@@ -87,6 +114,16 @@ typedef struct {
 	g_fs_close_status result_status;
 } g_fs_tasked_delegate_transaction_storage_close;
 
+/**
+ * On sync, the delegate finishes the transaction once everything it buffered for the
+ * node is stored durably. Syncing the mountpoint syncs all of its files.
+ */
+typedef struct {
+	g_fs_phys_id phys_fs_id;
+
+	g_fs_sync_status result_status;
+} g_fs_tasked_delegate_transaction_storage_sync;
+
 __END_C
 
 #endif
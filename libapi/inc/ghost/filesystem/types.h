@@ -42,9 +42,21 @@ typedef int32_t g_device; // a device id
 #define G_FILENAME_MAX	512
 
 /**
- * Pipes
+ * Pipes, the capacity is rounded up to full pages
  */
-#define G_PIPE_DEFAULT_CAPACITY 0x400
+#define G_PIPE_DEFAULT_CAPACITY 0x1000
+#define G_PIPE_MAXIMUM_CAPACITY 0x100000
+
+/**
+ * Vectored I/O
+ */
+typedef struct
+{
+    void* buffer;
+    uint64_t length;
+}__attribute__((packed)) g_fs_iovec;
+
+#define G_FS_IOVEC_MAXIMUM 64
 
 /**
  * File mode flags
@@ -110,6 +122,8 @@ typedef int g_fs_create_node_status;
 #define G_FS_CREATE_NODE_STATUS_CREATED ((g_fs_create_node_status) 0)
 #define G_FS_CREATE_NODE_STATUS_UPDATED ((g_fs_create_node_status) 1)
 #define G_FS_CREATE_NODE_STATUS_FAILED_NO_PARENT ((g_fs_create_node_status) 2)
+#define G_FS_CREATE_NODE_STATUS_FAILED_NOT_PERMITTED ((g_fs_create_node_status) 3)
+#define G_FS_CREATE_NODE_STATUS_FAILED_INVALID ((g_fs_create_node_status) 4)
 
 /**
  * Status codes for internal use during discovery
@@ -131,6 +145,7 @@ typedef int g_fs_tasked_delegate_request_type;
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_READ_DIRECTORY ((g_fs_tasked_delegate_request_type) 4)
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_OPEN ((g_fs_tasked_delegate_request_type) 5)
 #define G_FS_TASKED_DELEGATE_REQUEST_TYPE_CLOSE ((g_fs_tasked_delegate_request_type) 6)
+#define G_FS_TASKED_DELEGATE_REQUEST_TYPE_SYNC ((g_fs_tasked_delegate_request_type) 7)
 
 /**
  * Status codes for the {g_fs_open} system call
@@ -194,6 +209,23 @@ typedef int g_fs_length_status;
 #define G_FS_LENGTH_BUSY ((g_fs_length_status) 3)
 #define G_FS_LENGTH_ERROR ((g_fs_length_status) 4)
 
+/**
+ * Status codes for the {g_fsync} and {g_sync} system calls
+ */
+typedef int g_fs_sync_status;
+#define G_FS_SYNC_SUCCESSFUL ((g_fs_sync_status) 0)
+#define G_FS_SYNC_INVALID_FD ((g_fs_sync_status) 1)
+#define G_FS_SYNC_ERROR ((g_fs_sync_status) 2)
+
+/**
+ * Status codes for the {g_ftruncate} system call
+ */
+typedef int g_fs_truncate_status;
+#define G_FS_TRUNCATE_SUCCESSFUL ((g_fs_truncate_status) 0)
+#define G_FS_TRUNCATE_INVALID_FD ((g_fs_truncate_status) 1)
+#define G_FS_TRUNCATE_NOT_SUPPORTED ((g_fs_truncate_status) 2)
+#define G_FS_TRUNCATE_ERROR ((g_fs_truncate_status) 3)
+
 /**
  * Status codes for the {g_fs_clonefd} system call
  */
@@ -208,6 +240,17 @@ typedef int g_fs_clonefd_status;
 typedef int g_fs_pipe_status;
 #define G_FS_PIPE_SUCCESSFUL ((g_fs_pipe_status) 0)
 #define G_FS_PIPE_ERROR ((g_fs_pipe_status) 1)
+#define G_FS_PIPE_INVALID_FD ((g_fs_pipe_status) 2)
+#define G_FS_PIPE_INVALID_CAPACITY ((g_fs_pipe_status) 3)
+
+/**
+ * Status codes for the {g_splice} system call
+ */
+typedef int g_fs_splice_status;
+#define G_FS_SPLICE_SUCCESSFUL ((g_fs_splice_status) 0)
+#define G_FS_SPLICE_INVALID_FD ((g_fs_splice_status) 1)
+#define G_FS_SPLICE_ERROR ((g_fs_splice_status) 2)
+#define G_FS_SPLICE_BUSY ((g_fs_splice_status) 3)
 
 /**
  * Status codes for the {g_set_working_directory} system call
@@ -238,6 +281,7 @@ typedef int g_fs_read_directory_status;
 #define G_FS_READ_DIRECTORY_SUCCESSFUL ((g_fs_read_directory_status) 0)
 #define G_FS_READ_DIRECTORY_EOD ((g_fs_read_directory_status) 1)
 #define G_FS_READ_DIRECTORY_ERROR ((g_fs_read_directory_status) 2)
+#define G_FS_READ_DIRECTORY_BUFFER_TOO_SMALL ((g_fs_read_directory_status) 3)
 
 typedef int g_fs_directory_refresh_status;
 #define G_FS_DIRECTORY_REFRESH_SUCCESSFUL ((g_fs_directory_refresh_status) 0)
@@ -248,14 +292,48 @@ typedef struct
 {
     g_fs_virt_id node_id;
     g_fs_node_type type;
+    int64_t size;
     char* name;
 } g_fs_directory_entry;
 
+/**
+ * Opaque position within a directory listing. A cursor stays valid when nodes
+ * are added to the directory while it is being read.
+ */
+typedef uint32_t g_fs_directory_cursor;
+#define G_FS_DIRECTORY_CURSOR_START ((g_fs_directory_cursor) 0)
+#define G_FS_DIRECTORY_CURSOR_END ((g_fs_directory_cursor) -1)
+
+/**
+ * Record written for each entry when reading directory entries in bulk. The
+ * null-terminated name directly follows the record, the next record starts
+ * "record_length" bytes after the start of this one.
+ */
+typedef struct
+{
+    uint16_t record_length;
+    g_fs_virt_id node_id;
+    g_fs_node_type type;
+    int64_t size;
+}__attribute__((packed)) g_fs_directory_record;
+
+#define G_FS_DIRECTORY_RECORD_NAME(record) ((char*) (record) + sizeof(g_fs_directory_record))
+
+/**
+ * Size of the record buffer that an iterator reads ahead into.
+ */
+#define G_FS_DIRECTORY_ITERATOR_BUFFER 4096
+
 typedef struct
 {
     g_fs_virt_id node_id;
     int position;
     g_fs_directory_entry entry_buffer;
+
+    g_fs_directory_cursor cursor;
+    uint8_t* records;
+    uint32_t records_length;
+    uint32_t records_offset;
 } g_fs_directory_iterator;
 
 /**
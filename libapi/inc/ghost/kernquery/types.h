@@ -43,6 +43,10 @@ typedef int g_kernquery_status;
 #define G_KERNQUERY_TASK_LIST 0x601
 #define G_KERNQUERY_TASK_GET_BY_ID 0x602
 
+#define G_KERNQUERY_MESSAGE_QUEUE_GET 0x700
+
+#define G_KERNQUERY_PAGE_CACHE_GET 0x800
+
 /**
  * Used in the {G_KERNQUERY_TASK_COUNT} query to retrieve the number
  * of existing tasks.
@@ -82,6 +86,36 @@ typedef struct
 	uint64_t cpu_time;
 } __attribute__((packed)) g_kernquery_task_get_data;
 
+/**
+ * Used in the {G_KERNQUERY_MESSAGE_QUEUE_GET} query to retrieve the
+ * counters of the message queue of a task.
+ */
+typedef struct
+{
+	g_tid id;
+	uint8_t found;
+
+	uint32_t depth;
+	uint32_t high_water_depth;
+	uint32_t high_water_size;
+	uint32_t capacity;
+} __attribute__((packed)) g_kernquery_message_queue_data;
+
+/**
+ * Counters of the kernel page cache for file contents. Hits and misses are counted
+ * per page, mapped counts pages that were mapped into processes directly.
+ */
+typedef struct
+{
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t mapped;
+
+	uint32_t pages;
+	uint32_t capacity;
+} __attribute__((packed)) g_kernquery_page_cache_data;
+
 __END_C
 
 #endif
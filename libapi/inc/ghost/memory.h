@@ -44,6 +44,22 @@ __BEGIN_C
  */
 void* g_alloc_mem(g_size size);
 
+/**
+ * Allocates a memory region like {g_alloc_mem} and reports the physical address of each
+ * of its pages, so that a driver can let a device transfer data to or from it. The pages
+ * stay at their physical addresses until the region is unmapped.
+ *
+ * @param size
+ * 		the size in bytes
+ * @param out_physical_pages
+ * 		array with an entry for each page of the region
+ *
+ * @return a pointer to the allocated memory region, or 0 if failed
+ *
+ * @security-level DRIVER
+ */
+void* g_alloc_dma_mem(g_size size, g_physical_address* out_physical_pages);
+
 /**
  * Shares a memory area with another process.
  *
@@ -68,12 +84,15 @@ void* g_share_mem(void* memory, int32_t size, g_pid pid);
  * 		the physical memory address that should be mapped
  * @param size
  * 		the size that should be mapped
+ * @param-opt flags
+ * 		one of the {g_mmio_flags}, for example to map a framebuffer write-combining
  *
  * @return a pointer to the mapped area within the executing processes address space
  *
  * @security-level DRIVER
  */
 void* g_map_mmio(void* addr, uint32_t size);
+void* g_map_mmio_f(void* addr, uint32_t size, g_mmio_flags flags);
 
 /**
  * Unmaps the given memory area.
@@ -119,6 +138,94 @@ void* g_lower_malloc(uint32_t size);
  */
 uint8_t g_sbrk(int amount, void** out_brk);
 
+/**
+ * Creates a shared memory object with at least the given size in bytes. The executing
+ * process holds a handle to the object that it can map with {g_shm_map} and pass on
+ * to other processes with {g_shm_grant}. The object is destroyed once no process holds
+ * a handle anymore, its pages live as long as they are mapped somewhere.
+ *
+ * @param size
+ * 		the size in bytes
+ *
+ * @return the handle of the object, or G_SHM_NONE if creation failed
+ *
+ * @security-level APPLICATION
+ */
+g_shm g_shm_create(g_size size);
+
+/**
+ * Grants a handle to a shared memory object to another process. The executing
+ * process must hold a handle to the object.
+ *
+ * @param shm
+ * 		the object to grant
+ * @param pid
+ * 		the id of the target process
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_shm_status g_shm_grant(g_shm shm, g_pid pid);
+
+/**
+ * Maps a shared memory object into the address space of the executing process in one
+ * operation. If the object is sealed, the area is mapped read-only. The area can be
+ * unmapped with {g_unmap}.
+ *
+ * @param shm
+ * 		the object to map
+ * @param outSize
+ * 		if not null, is filled with the size of the mapped area
+ *
+ * @return a pointer to the mapped area or 0 if mapping failed
+ *
+ * @security-level APPLICATION
+ */
+void* g_shm_map(g_shm shm, g_size* outSize);
+
+/**
+ * Resizes a shared memory object. Existing mappings keep their size, the object must
+ * be mapped again to see the new size.
+ *
+ * @param shm
+ * 		the object to resize
+ * @param size
+ * 		the new size in bytes
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_shm_status g_shm_resize(g_shm shm, g_size size);
+
+/**
+ * Seals a shared memory object. Afterwards it can no longer be resized and all
+ * further mappings of it are read-only. As existing mappings are writable, the
+ * object can only be sealed while it is not mapped anywhere.
+ *
+ * @param shm
+ * 		the object to seal
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_shm_status g_shm_seal(g_shm shm);
+
+/**
+ * Releases the handle of the executing process to a shared memory object. Existing
+ * mappings stay valid until they are unmapped.
+ *
+ * @param shm
+ * 		the object to release
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_shm_status g_shm_release(g_shm shm);
+
 
 __END_C
 
@@ -23,6 +23,7 @@
 
 #include "../stdint.h"
 #include "../tasks/types.h"
+#include "types.h"
 
 /**
  * @field size
@@ -42,6 +43,27 @@ typedef struct
 	void* virtualResult;
 }__attribute__((packed)) g_syscall_alloc_mem;
 
+/**
+ * @field size
+ * 		the required size in bytes
+ *
+ * @field physicalPages
+ * 		array with one entry per page, filled with the physical address
+ * 		of each page of the area
+ *
+ * @field virtualResult
+ * 		the virtual address of the allocated area, or 0 if allocation failed
+ *
+ * @security-level DRIVER
+ */
+typedef struct
+{
+	g_size size;
+	g_physical_address* physicalPages;
+
+	void* virtualResult;
+}__attribute__((packed)) g_syscall_alloc_dma_mem;
+
 /**
  * @field memory
  * 		the memory area to share
@@ -74,6 +96,9 @@ typedef struct
  * @field size
  * 		the minimum size to map
  *
+ * @field flags
+ * 		one of the {g_mmio_flags}
+ *
  * @field virtualAddress
  * 		the resulting page-aligned virtual address in the current
  * 		processes address space. if mapping fails, this field is 0.
@@ -84,6 +109,7 @@ typedef struct
 {
 	g_physical_address physicalAddress;
 	uint32_t size;
+	g_mmio_flags flags;
 
 	void* virtualAddress;
 }__attribute__((packed)) g_syscall_map_mmio;
@@ -146,4 +172,121 @@ typedef struct
 	uint8_t successful;
 }__attribute__((packed)) g_syscall_sbrk;
 
+/**
+ * @field size
+ * 		the minimum size of the object
+ *
+ * @field status
+ * 		the result of the call
+ *
+ * @field shm
+ * 		the handle of the created object
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_size size;
+
+	g_shm_status status;
+	g_shm shm;
+}__attribute__((packed)) g_syscall_shm_create;
+
+/**
+ * @field shm
+ * 		the object to grant
+ *
+ * @field processId
+ * 		the id of the process that receives the handle
+ *
+ * @field status
+ * 		the result of the call
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_shm shm;
+	g_pid processId;
+
+	g_shm_status status;
+}__attribute__((packed)) g_syscall_shm_grant;
+
+/**
+ * @field shm
+ * 		the object to map
+ *
+ * @field status
+ * 		the result of the call
+ *
+ * @field virtualAddress
+ * 		the resulting page-aligned virtual address in the current
+ * 		processes address space. if mapping fails, this field is 0.
+ *
+ * @field size
+ * 		the size of the mapped area
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_shm shm;
+
+	g_shm_status status;
+	void* virtualAddress;
+	g_size size;
+}__attribute__((packed)) g_syscall_shm_map;
+
+/**
+ * @field shm
+ * 		the object to resize
+ *
+ * @field size
+ * 		the new minimum size of the object
+ *
+ * @field status
+ * 		the result of the call
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_shm shm;
+	g_size size;
+
+	g_shm_status status;
+}__attribute__((packed)) g_syscall_shm_resize;
+
+/**
+ * @field shm
+ * 		the object to seal
+ *
+ * @field status
+ * 		the result of the call
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_shm shm;
+
+	g_shm_status status;
+}__attribute__((packed)) g_syscall_shm_seal;
+
+/**
+ * @field shm
+ * 		the object to release
+ *
+ * @field status
+ * 		the result of the call
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_shm shm;
+
+	g_shm_status status;
+}__attribute__((packed)) g_syscall_shm_release;
+
 #endif
@@ -67,6 +67,23 @@ typedef g_address g_size;
 #define G_SEGOFF_TO_FP(seg, off)		((g_far_pointer) (((seg & 0xFFFF) << 16) | (off & 0xFFFF)))
 #define G_LINEAR_TO_FP(linear)			((linear > 0x100000) ? 0 : ((((linear >> 4) & 0xFFFF) << 16) + (linear & 0xFL)))
 
+// flags for mapping memory-mapped device areas
+typedef uint32_t g_mmio_flags;
+#define G_MMIO_FLAGS_NONE				((g_mmio_flags) 0)
+#define G_MMIO_FLAGS_WRITE_COMBINING	((g_mmio_flags) 1) // for framebuffers, ignored if the processor has no PAT
+
+// shared memory objects
+typedef int32_t g_shm;
+#define G_SHM_NONE ((g_shm) -1)
+
+typedef int g_shm_status;
+#define G_SHM_STATUS_SUCCESSFUL ((g_shm_status) 0)
+#define G_SHM_STATUS_INVALID ((g_shm_status) 1) // object does not exist or is not held by the process
+#define G_SHM_STATUS_SEALED ((g_shm_status) 2) // object is sealed and can no longer be modified
+#define G_SHM_STATUS_NO_MEMORY ((g_shm_status) 3) // out of physical or virtual memory
+#define G_SHM_STATUS_ERROR ((g_shm_status) 4)
+#define G_SHM_STATUS_MAPPED ((g_shm_status) 5) // object can't be sealed while it is mapped
+
 __END_C
 
 #endif
@@ -66,6 +66,46 @@ g_message_send_status g_send_message_t(g_tid target, void* buf, size_t len, g_me
 g_message_send_status g_send_message_tm(g_tid target, void* buf, size_t len, g_message_transaction tx,
                                         g_message_send_mode mode);
 
+/**
+ * Sends a message that carries page grants. Instead of copying them, the pages of each
+ * granted area are mapped into the address space of the receiving process while the
+ * message is sent. The receiver finds the mapped addresses in the descriptors at
+ * {G_MESSAGE_GRANTS}, and the number of descriptors in the <grants> field of the header.
+ * Unmapping a granted area, for example with {g_release_message_grants}, releases it.
+ *
+ * With {G_MESSAGE_GRANT_FLAGS_MOVE}, each area must be one that was allocated with
+ * {g_alloc_mem}; it is unmapped from the sender once the message was sent.
+ *
+ * @param target id of the target task
+ * @param buf message content buffer
+ * @param len number of bytes to copy from the buffer
+ * @param grants page-aligned areas to grant
+ * @param grant_count number of grants, at most {G_MESSAGE_MAXIMUM_GRANTS}
+ * @param-opt tx transaction id
+ * @param-opt mode determines how the function blocks when given, default is {G_MESSAGE_SEND_MODE_BLOCKING}
+ * @param-opt flags one of the {g_message_grant_flags}, default is {G_MESSAGE_GRANT_FLAGS_SHARE}
+ *
+ * @return one of the <g_message_send_status> codes
+ *
+ * @security-level APPLICATION
+ */
+g_message_send_status g_send_message_grants(g_tid target, void* buf, size_t len, g_message_grant* grants,
+                                            uint32_t grant_count);
+g_message_send_status g_send_message_grants_f(g_tid target, void* buf, size_t len, g_message_grant* grants,
+                                              uint32_t grant_count, g_message_grant_flags flags);
+g_message_send_status g_send_message_grants_tmf(g_tid target, void* buf, size_t len, g_message_grant* grants,
+                                                uint32_t grant_count, g_message_transaction tx,
+                                                g_message_send_mode mode, g_message_grant_flags flags);
+
+/**
+ * Unmaps all areas that were granted with a received message.
+ *
+ * @param message the received message
+ *
+ * @security-level APPLICATION
+ */
+void g_release_message_grants(void* message);
+
 /**
  * Receives a message. At maximum <max> bytes will be attempted to be copied to
  * the buffer <buf>. Note that when receiving a message, a buffer with a size of
@@ -102,6 +142,29 @@ g_message_receive_status g_receive_message_tm(void* buf, size_t max, g_message_t
 g_message_receive_status g_receive_message_tmb(void* buf, size_t max, g_message_transaction tx,
                                                g_message_receive_mode mode, g_user_mutex break_condition);
 
+/**
+ * Receives as many messages as fit into the buffer with a single call, in the order
+ * they were sent. The messages are stored back to back, use {G_MESSAGE_BATCH_NEXT}
+ * to get from one message to the next:
+ *
+ * 	auto message = (g_message_header*) buf;
+ * 	for(uint32_t i = 0; i < count; i++, message = G_MESSAGE_BATCH_NEXT(message))
+ *
+ * If the first message does not fit into the buffer, {G_MESSAGE_RECEIVE_STATUS_EXCEEDS_BUFFER_SIZE}
+ * is returned and the message is left in the queue.
+ *
+ * @param buf output buffer
+ * @param max maximum number of bytes to copy to the buffer
+ * @param max_count maximum number of messages to receive, 0 for no limit
+ * @param out_count is filled with the number of received messages
+ * @param-opt mode determines how the function blocks when given, default is {G_MESSAGE_RECEIVE_MODE_BLOCKING}
+ *
+ * @security-level APPLICATION
+ */
+g_message_receive_status g_receive_messages(void* buf, size_t max, uint32_t max_count, uint32_t* out_count);
+g_message_receive_status g_receive_messages_m(void* buf, size_t max, uint32_t max_count, uint32_t* out_count,
+                                              g_message_receive_mode mode);
+
 /**
  * Sends a message to a topic.
  *
@@ -114,18 +177,35 @@ g_message_receive_status g_receive_message_tmb(void* buf, size_t max, g_message_
 g_message_send_status g_send_topic_message(const char* topic, void* buf, size_t len);
 g_message_send_status g_send_topic_message_m(const char* topic, void* buf, size_t len, g_message_send_mode mode);
 
+/**
+ * Creates a topic and sets the number of messages it retains. Topics that are used
+ * without being created retain {G_MESSAGE_TOPIC_DEFAULT_CAPACITY} messages. Calling this on
+ * an existing topic changes its capacity, dropping the oldest messages if necessary.
+ *
+ * @param topic the topic name
+ * @param capacity number of messages to retain, at most {G_MESSAGE_TOPIC_MAXIMUM_CAPACITY}
+ * @return one of the {g_message_topic_status} codes
+ */
+g_message_topic_status g_create_topic(const char* topic, uint32_t capacity);
+
 /**
  * Receives a message from a topic.
  *
+ * Topics only retain their newest messages. If a receiver fell behind, the oldest retained
+ * message is received and the number of messages that were missed is written to <out_dropped>.
+ *
  * @param topic the source topic name
  * @param buf output buffer
  * @param max maximum message length
  * @param start_after transaction number of the last received message or {G_MESSAGE_TOPIC_TRANSACTION_START}
  * @param-opt mode the reception mode
+ * @param-opt out_dropped filled with the number of messages that were missed
  * @return send status
  */
 g_message_send_status g_receive_topic_message(const char* topic, void* buf, size_t max, g_message_transaction start_after);
 g_message_send_status g_receive_topic_message_m(const char* topic, void* buf, size_t max, g_message_transaction start_after, g_message_receive_mode mode);
+g_message_send_status g_receive_topic_message_md(const char* topic, void* buf, size_t max, g_message_transaction start_after, g_message_receive_mode mode,
+                                                 uint32_t* out_dropped);
 
 __END_C
 
@@ -54,6 +54,47 @@ typedef struct
 	g_message_send_status status;
 }__attribute__((packed)) g_syscall_send_message;
 
+/**
+ * @field receiver
+ * 		task id of the target task
+ *
+ * @field buffer
+ * 		message buffer
+ *
+ * @field length
+ * 		message length, without the grant descriptors
+ *
+ * @field grants
+ * 		page-aligned areas to map into the receiver
+ *
+ * @field grantCount
+ * 		number of grants, at most {G_MESSAGE_MAXIMUM_GRANTS}
+ *
+ * @field flags
+ * 		one of the {g_message_grant_flags}
+ *
+ * @field mode
+ * 		sending mode
+ *
+ * @field status
+ * 		one of the {g_message_send_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_tid receiver;
+	void* buffer;
+	size_t length;
+	g_message_grant* grants;
+	uint32_t grantCount;
+	g_message_grant_flags flags;
+	g_message_send_mode mode;
+	g_message_transaction transaction;
+
+	g_message_send_status status;
+}__attribute__((packed)) g_syscall_send_message_grants;
+
 /**
  * @field buffer
  * 		target buffer
@@ -87,6 +128,38 @@ typedef struct
 	g_message_receive_status status;
 }__attribute__((packed)) g_syscall_receive_message;
 
+/**
+ * @field buffer
+ * 		buffer to write the messages to
+ *
+ * @field maximum
+ * 		maximum number of bytes to write to the buffer
+ *
+ * @field maximumCount
+ * 		maximum number of messages to receive, 0 for no limit
+ *
+ * @field mode
+ * 		whether to block until at least one message is available
+ *
+ * @field count
+ * 		number of messages written to the buffer
+ *
+ * @field status
+ * 		one of the {g_message_receive_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	g_message_header* buffer;
+	size_t maximum;
+	uint32_t maximumCount;
+	g_message_receive_mode mode;
+
+	uint32_t count;
+	g_message_receive_status status;
+}__attribute__((packed)) g_syscall_receive_message_batch;
+
 /**
  * @security-level APPLICATION
  */
@@ -120,6 +193,7 @@ typedef struct
  * @field maximum buffer maximum length
  * @field mode receiving mode
  * @field start_after id of the last received topic message
+ * @field dropped number of messages that were overwritten before they could be received
  * @field status one of the {g_message_receive_status} codes
  *
  * @security-level APPLICATION
@@ -132,8 +206,24 @@ typedef struct
 	g_message_receive_mode mode;
 	g_message_transaction start_after;
 
+	uint32_t dropped;
 	g_message_receive_status status;
 }__attribute__((packed)) g_syscall_receive_topic_message;
 
+/**
+ * @field topic topic name
+ * @field capacity number of messages the topic retains
+ * @field status one of the {g_message_topic_status} codes
+ *
+ * @security-level APPLICATION
+ */
+typedef struct
+{
+	const char* topic;
+	uint32_t capacity;
+
+	g_message_topic_status status;
+}__attribute__((packed)) g_syscall_create_topic;
+
 
 #endif
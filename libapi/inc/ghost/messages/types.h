@@ -40,14 +40,50 @@ typedef struct _g_message_header
     size_t length;
     struct _g_message_header* previous;
     struct _g_message_header* next;
+    uint32_t grants;
 }__attribute__((packed)) g_message_header;
 
 #define G_MESSAGE_CONTENT(message)					(((uint8_t*) message) + sizeof(g_message_header))
 
+/**
+ * A page grant attached to a message. When sending, the address and size describe a
+ * page-aligned area of the sender. The receiver finds the same descriptors behind the
+ * message content, with the address where the pages were mapped into its own address
+ * space. The descriptors are counted in the length of the message.
+ */
+typedef struct
+{
+    void* address;
+    uint32_t size;
+}__attribute__((packed)) g_message_grant;
+
+#define G_MESSAGE_MAXIMUM_GRANTS					8
+#define G_MESSAGE_GRANTS_SIZE(message)				(((g_message_header*) message)->grants * sizeof(g_message_grant))
+#define G_MESSAGE_CONTENT_LENGTH(message)			(((g_message_header*) message)->length - G_MESSAGE_GRANTS_SIZE(message))
+#define G_MESSAGE_GRANTS(message)					((g_message_grant*) (G_MESSAGE_CONTENT(message) + G_MESSAGE_CONTENT_LENGTH(message)))
+
+// how the pages of a grant are handed over
+typedef int g_message_grant_flags;
+#define G_MESSAGE_GRANT_FLAGS_SHARE ((g_message_grant_flags) 0) // sender keeps its mapping
+#define G_MESSAGE_GRANT_FLAGS_MOVE ((g_message_grant_flags) 1) // areas from g_alloc_mem are unmapped from the sender
+
+// messages received in a batch are stored back to back, each aligned to 4 bytes
+#define G_MESSAGE_BATCH_ALIGNMENT					4
+#define G_MESSAGE_BATCH_SIZE(message)				((sizeof(g_message_header) + ((g_message_header*) message)->length + (G_MESSAGE_BATCH_ALIGNMENT - 1)) & ~(G_MESSAGE_BATCH_ALIGNMENT - 1))
+#define G_MESSAGE_BATCH_NEXT(message)				((g_message_header*) (((uint8_t*) message) + G_MESSAGE_BATCH_SIZE(message)))
+
 // messaging bounds
 #define G_MESSAGE_MAXIMUM_MESSAGE_LENGTH			(2048)
 #define G_MESSAGE_MAXIMUM_QUEUE_CONTENT				(2048 * 32)
 
+// retention of message topics
+#define G_MESSAGE_TOPIC_DEFAULT_CAPACITY			64
+#define G_MESSAGE_TOPIC_MAXIMUM_CAPACITY			4096
+
+typedef int g_message_topic_status;
+#define G_MESSAGE_TOPIC_STATUS_SUCCESSFUL ((g_message_topic_status) 0)
+#define G_MESSAGE_TOPIC_STATUS_INVALID_CAPACITY ((g_message_topic_status) 1)
+
 // modes for message sending
 typedef int g_message_send_mode;
 #define G_MESSAGE_SEND_MODE_BLOCKING ((g_message_send_mode) 0)
@@ -64,6 +100,7 @@ typedef int g_message_send_status;
 #define G_MESSAGE_SEND_STATUS_FULL ((g_message_send_status) 2)
 #define G_MESSAGE_SEND_STATUS_FAILED ((g_message_send_status) 3)
 #define G_MESSAGE_SEND_STATUS_EXCEEDS_MAXIMUM ((g_message_send_status) 4)
+#define G_MESSAGE_SEND_STATUS_INVALID_GRANT ((g_message_send_status) 5)
 
 // status for message receiving
 typedef int g_message_receive_status;
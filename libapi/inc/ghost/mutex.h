@@ -82,6 +82,38 @@ void g_mutex_release(g_user_mutex mutex);
  */
 void g_mutex_destroy(g_user_mutex mutex);
 
+/**
+ * Waits on a word in memory until another task calls {g_futex_wake} for it. The
+ * kernel compares the word against the expected value atomically with putting the
+ * task to sleep, so a wake that happens after the caller read the word is never lost.
+ * Words are identified by their physical address, so the same word can be waited on
+ * from several processes through shared memory.
+ *
+ * @param address
+ * 		the word to wait on, must be 4-byte aligned
+ * @param expected
+ * 		the value the caller last observed
+ * @param timeout
+ * 		timeout in milliseconds
+ *
+ * @return {G_FUTEX_STATUS_WOKEN} when woken, {G_FUTEX_STATUS_NOT_EQUAL} if the word
+ * 		did not hold the expected value, {G_FUTEX_STATUS_TIMEOUT} if the timeout elapsed
+ *
+ * @security-level APPLICATION
+ */
+g_futex_status g_futex_wait(volatile uint32_t* address, uint32_t expected);
+g_futex_status g_futex_wait_to(volatile uint32_t* address, uint32_t expected, uint64_t timeout);
+
+/**
+ * Wakes all tasks that wait on the given word.
+ *
+ * @param address
+ * 		the word to wake waiters of
+ *
+ * @security-level APPLICATION
+ */
+g_futex_status g_futex_wake(volatile uint32_t* address);
+
 
 __END_C
 
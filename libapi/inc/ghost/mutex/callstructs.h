@@ -71,6 +71,38 @@ typedef struct
 	g_user_mutex mutex;
 } __attribute__((packed)) g_syscall_user_mutex_release;
 
+/**
+ * @field address
+ * 		the word to wait on, must be 4-byte aligned
+ * @field expected
+ * 		the task only waits if the word still holds this value
+ * @field timeout
+ * 		timeout in milliseconds or 0 to wait indefinitely
+ * @field status
+ * 		result of the operation
+ */
+typedef struct
+{
+	volatile uint32_t* address;
+	uint32_t expected;
+	uint64_t timeout;
+
+	g_futex_status status;
+} __attribute__((packed)) g_syscall_futex_wait;
+
+/**
+ * @field address
+ * 		the word that waiting tasks are waiting on
+ * @field status
+ * 		result of the operation
+ */
+typedef struct
+{
+	volatile uint32_t* address;
+
+	g_futex_status status;
+} __attribute__((packed)) g_syscall_futex_wake;
+
 __END_C
 
 #endif
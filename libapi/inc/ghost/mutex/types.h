@@ -28,6 +28,15 @@ __BEGIN_C
 
 typedef uint32_t g_user_mutex;
 
+/**
+ * Status codes for futex operations
+ */
+typedef int g_futex_status;
+#define G_FUTEX_STATUS_WOKEN        ((g_futex_status) 0)
+#define G_FUTEX_STATUS_NOT_EQUAL    ((g_futex_status) 1)
+#define G_FUTEX_STATUS_TIMEOUT      ((g_futex_status) 2)
+#define G_FUTEX_STATUS_INVALID      ((g_futex_status) 3)
+
 __END_C
 
 #endif
@@ -0,0 +1,66 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_POLL
+#define GHOST_API_POLL
+
+#include "common.h"
+#include "poll/types.h"
+
+__BEGIN_C
+
+/**
+ * Waits until at least one source of the set is ready, or the timeout elapses. A set
+ * can contain file descriptors, IRQs and the message queue of the executing task, so
+ * a service can handle all of its inputs from a single thread.
+ *
+ * On return, the ready events of each descriptor, the fired flag of each IRQ and the
+ * messages_ready flag are filled in. Fired IRQs are acknowledged by this call, while
+ * descriptors and messages stay ready until they are read.
+ *
+ * IRQs can only be waited for on core 0, see {g_await_irq}.
+ *
+ * @param set
+ * 		the sources to wait for
+ * @param-opt timeout
+ * 		timeout in milliseconds
+ * @param-opt out_ready
+ * 		is filled with the number of ready sources
+ *
+ * @return {G_POLL_STATUS_READY} if a source is ready, {G_POLL_STATUS_TIMEOUT} if the
+ * 		timeout elapsed first, or {G_POLL_STATUS_INVALID} if the set is malformed
+ *
+ * @security-level APPLICATION, DRIVER for IRQs
+ */
+g_poll_status g_poll(g_poll_set* set);
+g_poll_status g_poll_t(g_poll_set* set, uint64_t timeout);
+g_poll_status g_poll_tr(g_poll_set* set, uint64_t timeout, uint32_t* out_ready);
+
+/**
+ * Same as {g_poll_tr}, but with a timeout in nanoseconds. The timeout does not depend
+ * on the scheduler tick, so it can be well below a millisecond.
+ *
+ * @security-level APPLICATION, DRIVER for IRQs
+ */
+g_poll_status g_poll_tn(g_poll_set* set, uint64_t timeout_nanos, uint32_t* out_ready);
+
+__END_C
+
+#endif
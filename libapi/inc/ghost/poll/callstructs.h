@@ -0,0 +1,51 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_POLL_CALLSTRUCTS
+#define GHOST_API_POLL_CALLSTRUCTS
+
+#include "../common.h"
+#include "../stdint.h"
+#include "types.h"
+
+__BEGIN_C
+
+/**
+ * @field set
+ * 		the sources to wait for, results are written back into it
+ * @field timeout
+ * 		timeout in nanoseconds or 0 to wait indefinitely
+ * @field ready
+ * 		number of sources that are ready
+ * @field status
+ * 		result of the operation
+ */
+typedef struct
+{
+	g_poll_set* set;
+	uint64_t timeout;
+
+	uint32_t ready;
+	g_poll_status status;
+} __attribute__((packed)) g_syscall_poll;
+
+__END_C
+
+#endif
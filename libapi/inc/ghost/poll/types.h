@@ -0,0 +1,84 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_POLL_TYPES
+#define GHOST_API_POLL_TYPES
+
+#include "../common.h"
+#include "../stdint.h"
+#include "../filesystem/types.h"
+
+__BEGIN_C
+
+/**
+ * Events a file descriptor can be waited for
+ */
+typedef uint8_t g_poll_events;
+#define G_POLL_EVENT_NONE       ((g_poll_events) 0)
+#define G_POLL_EVENT_READ       ((g_poll_events) 1) // reading would not block
+#define G_POLL_EVENT_WRITE      ((g_poll_events) 2) // writing would not block
+#define G_POLL_EVENT_INVALID    ((g_poll_events) 4) // only reported, the descriptor does not exist
+
+/**
+ * A file descriptor in a poll set. The kernel fills in the ready events.
+ */
+typedef struct
+{
+    g_fd fd;
+    g_poll_events events;
+    g_poll_events ready;
+} __attribute__((packed)) g_poll_fd;
+
+/**
+ * An IRQ in a poll set. Waiting on an IRQ makes the executing task its handler,
+ * like {g_await_irq} does.
+ */
+typedef struct
+{
+    uint8_t irq;
+    g_bool fired;
+} __attribute__((packed)) g_poll_irq;
+
+/**
+ * Everything a task waits for with a single call to {g_poll}.
+ */
+typedef struct
+{
+    g_poll_fd* fds;
+    uint32_t fd_count;
+
+    g_poll_irq* irqs;
+    uint32_t irq_count;
+
+    g_bool messages; // whether to wait for the message queue of the executing task
+    g_bool messages_ready;
+} __attribute__((packed)) g_poll_set;
+
+#define G_POLL_MAXIMUM_FDS      64
+#define G_POLL_MAXIMUM_IRQS     16
+
+typedef int g_poll_status;
+#define G_POLL_STATUS_READY     ((g_poll_status) 0)
+#define G_POLL_STATUS_TIMEOUT   ((g_poll_status) 1)
+#define G_POLL_STATUS_INVALID   ((g_poll_status) 2)
+
+__END_C
+
+#endif
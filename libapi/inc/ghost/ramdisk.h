@@ -36,6 +36,15 @@ typedef int g_ramdisk_entry_type;
 #define G_RAMDISK_ENTRY_TYPE_FOLDER		((g_ramdisk_entry_type) 0)
 #define G_RAMDISK_ENTRY_TYPE_FILE		((g_ramdisk_entry_type) 1)
 
+// only used within the ramdisk image, a file with LZ4 compressed contents
+#define G_RAMDISK_ENTRY_TYPE_FILE_LZ4	((g_ramdisk_entry_type) 2)
+
+/**
+ * Compressed files are split into chunks of this size that are compressed separately,
+ * so that each can be unpacked on its own. Must match the ramdisk writer.
+ */
+#define G_RAMDISK_COMPRESSED_CHUNK_SIZE	0x1000
+
 typedef uint32_t g_ramdisk_id;
 
 /**
@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_RING
+#define GHOST_API_RING
+
+#include "common.h"
+#include "stdint.h"
+#include "ring/types.h"
+
+__BEGIN_C
+
+/**
+ * Creates a submission/completion ring pair in memory of the executing process. Calls
+ * are queued in userspace with {g_ring_submit} and issued together with a single
+ * {g_ring_enter}, so that a batch of small calls only pays for one kernel entry.
+ *
+ * @param ring
+ * 		handle to initialize
+ * @param entries
+ * 		number of entries of each ring, rounded up to a power of two
+ *
+ * @return the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_ring_status g_ring_create(g_ring* ring, uint32_t entries);
+
+/**
+ * Queues a call. Supported are file reads, writes and seeks, message send and receive,
+ * IRQ waits and sleeps; other calls complete with {G_RING_COMPLETION_UNSUPPORTED}.
+ * The call structure must stay valid until the completion was reaped. Only one task
+ * may submit to a ring.
+ *
+ * @param ring
+ * 		the ring
+ * @param call
+ * 		the system call number, for example {G_SYSCALL_FS_READ}
+ * @param data
+ * 		the call structure
+ * @param user_data
+ * 		value that is returned in the completion
+ *
+ * @return {G_RING_STATUS_WOULD_BLOCK} if the submission ring is full
+ *
+ * @security-level APPLICATION
+ */
+g_ring_status g_ring_submit(g_ring* ring, uint32_t call, void* data, uint64_t user_data);
+
+/**
+ * Lets the kernel process the queued calls in order. Calls that block, block this
+ * function; the calls behind them are processed afterwards.
+ *
+ * @param ring
+ * 		the ring
+ * @param out_processed
+ * 		is filled with the number of processed submissions
+ *
+ * @return {G_RING_STATUS_BUSY} if submissions are left because the completion ring
+ * 		is full, otherwise the status of the operation
+ *
+ * @security-level APPLICATION
+ */
+g_ring_status g_ring_enter(g_ring* ring, uint32_t* out_processed);
+
+/**
+ * Takes the next completion from the ring, without entering the kernel.
+ *
+ * @return {G_RING_STATUS_WOULD_BLOCK} if there is no completion
+ *
+ * @security-level APPLICATION
+ */
+g_ring_status g_ring_reap(g_ring* ring, g_ring_completion* out);
+
+/**
+ * Frees the memory of the ring.
+ *
+ * @security-level APPLICATION
+ */
+void g_ring_destroy(g_ring* ring);
+
+__END_C
+
+#endif
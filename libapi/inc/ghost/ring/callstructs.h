@@ -0,0 +1,48 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_RING_CALLSTRUCTS
+#define GHOST_API_RING_CALLSTRUCTS
+
+#include "../common.h"
+#include "../stdint.h"
+#include "types.h"
+
+__BEGIN_C
+
+/**
+ * @field ring
+ * 		control block of the ring to drain
+ * @field processed
+ * 		number of submissions that were processed
+ * @field status
+ * 		result of the operation
+ */
+typedef struct
+{
+	g_ring_header* ring;
+
+	uint32_t processed;
+	g_ring_status status;
+} __attribute__((packed)) g_syscall_ring_enter;
+
+__END_C
+
+#endif
@@ -0,0 +1,110 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GHOST_API_RING_TYPES
+#define GHOST_API_RING_TYPES
+
+#include "../common.h"
+#include "../stdint.h"
+
+__BEGIN_C
+
+/**
+ * Status codes for ring operations
+ */
+typedef int g_ring_status;
+#define G_RING_STATUS_SUCCESSFUL        ((g_ring_status) 0)
+#define G_RING_STATUS_WOULD_BLOCK       ((g_ring_status) 1) // submission ring is full (submit) or no completion is there (reap)
+#define G_RING_STATUS_BUSY              ((g_ring_status) 2) // completion ring is full, submissions are left over
+#define G_RING_STATUS_INVALID           ((g_ring_status) 3) // ring is not set up or its memory is corrupt
+#define G_RING_STATUS_FAILED            ((g_ring_status) 4) // memory for the ring could not be allocated
+
+/**
+ * Result of a single submission. The result of the call itself is written into its
+ * call structure, exactly as if the call was issued directly.
+ */
+typedef int g_ring_completion_status;
+#define G_RING_COMPLETION_SUCCESSFUL    ((g_ring_completion_status) 0)
+#define G_RING_COMPLETION_UNSUPPORTED   ((g_ring_completion_status) 1) // call can not be issued through a ring
+
+/**
+ * Ring sizes. The number of entries is always a power of two.
+ */
+#define G_RING_MINIMUM_ENTRIES          0x10
+#define G_RING_DEFAULT_ENTRIES          0x100
+#define G_RING_MAXIMUM_ENTRIES          0x1000
+
+#define G_RING_MAGIC                    0x52494E47
+
+/**
+ * One queued system call. The data points to the same call structure that is used
+ * when issuing the call directly, for example a {g_syscall_fs_read}.
+ */
+typedef struct
+{
+	uint32_t call;
+	void* data;
+	uint64_t userData;
+} __attribute__((packed)) g_ring_submission;
+
+/**
+ * Completion of one submission, identified by the user data of the submission.
+ */
+typedef struct
+{
+	uint64_t userData;
+	uint32_t call;
+	g_ring_completion_status status;
+} __attribute__((packed)) g_ring_completion;
+
+/**
+ * Control block at the start of the ring memory, followed by the submission and then
+ * the completion entries. All counters are free-running; the submission tail and the
+ * completion head are only written by userspace, the other two only by the kernel.
+ */
+typedef struct
+{
+	volatile uint32_t submissionHead;
+	volatile uint32_t submissionTail;
+	volatile uint32_t completionHead;
+	volatile uint32_t completionTail;
+	uint32_t entries;
+	uint32_t magic;
+} g_ring_header;
+
+#define G_RING_SUBMISSIONS_OFFSET       0x40
+#define G_RING_SUBMISSIONS(header)      ((g_ring_submission*) (((uint8_t*) (header)) + G_RING_SUBMISSIONS_OFFSET))
+#define G_RING_COMPLETIONS(header, entries) ((g_ring_completion*) (G_RING_SUBMISSIONS(header) + (entries)))
+#define G_RING_SIZE(entries)            (G_RING_SUBMISSIONS_OFFSET + (entries) * (sizeof(g_ring_submission) + sizeof(g_ring_completion)))
+
+/**
+ * Process-local handle of a ring.
+ */
+typedef struct
+{
+	g_ring_header* header;
+	g_ring_submission* submissions;
+	g_ring_completion* completions;
+	uint32_t entries;
+} g_ring;
+
+__END_C
+
+#endif
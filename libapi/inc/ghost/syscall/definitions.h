@@ -52,6 +52,7 @@ __BEGIN_C
 #define G_SYSCALL_DUMP							24
 #define G_SYSCALL_GET_NANOSECONDS				25
 #define G_SYSCALL_TASK_AWAIT_BY_NAME		26
+#define G_SYSCALL_SLEEP_NANOS					27
 
 // Memory
 #define G_SYSCALL_LOWER_MEMORY_ALLOCATE			40
@@ -61,12 +62,21 @@ __BEGIN_C
 #define G_SYSCALL_SHARE_MEMORY					44
 #define G_SYSCALL_MAP_MMIO_AREA					45
 #define G_SYSCALL_SBRK							46
+#define G_SYSCALL_SHM_CREATE					47
+#define G_SYSCALL_SHM_GRANT						48
+#define G_SYSCALL_SHM_MAP						49
+#define G_SYSCALL_SHM_RESIZE					50
+#define G_SYSCALL_SHM_SEAL						51
+#define G_SYSCALL_SHM_RELEASE					52
+#define G_SYSCALL_ALLOCATE_DMA_MEMORY			53
 
 // Mutex
 #define G_SYSCALL_USER_MUTEX_INITIALIZE 		60
 #define G_SYSCALL_USER_MUTEX_ACQUIRE			61
 #define G_SYSCALL_USER_MUTEX_RELEASE			62
 #define G_SYSCALL_USER_MUTEX_DESTROY			63
+#define G_SYSCALL_FUTEX_WAIT					64
+#define G_SYSCALL_FUTEX_WAKE					65
 
 // Messages
 #define G_SYSCALL_MESSAGE_SEND                  70
@@ -74,6 +84,9 @@ __BEGIN_C
 #define G_SYSCALL_MESSAGE_NEXT_TXID				72
 #define G_SYSCALL_MESSAGE_TOPIC_SEND            73
 #define G_SYSCALL_MESSAGE_TOPIC_RECEIVE  		74
+#define G_SYSCALL_MESSAGE_RECEIVE_BATCH			75
+#define G_SYSCALL_MESSAGE_TOPIC_CREATE			76
+#define G_SYSCALL_MESSAGE_SEND_GRANTS			77
 
 // Filesystem
 #define G_SYSCALL_FS_OPEN						80
@@ -94,6 +107,13 @@ __BEGIN_C
 #define G_SYSCALL_FS_READ_DIRECTORY				95
 #define G_SYSCALL_FS_CLOSE_DIRECTORY			96
 #define G_SYSCALL_FS_REAL_PATH					97
+#define G_SYSCALL_FS_PIPE_CAPACITY				98
+#define G_SYSCALL_FS_READV						99
+#define G_SYSCALL_FS_WRITEV						100
+#define G_SYSCALL_FS_SPLICE						101
+#define G_SYSCALL_FS_READ_DIRECTORY_ENTRIES		102
+#define G_SYSCALL_FS_SYNC						103
+#define G_SYSCALL_FS_TRUNCATE					104
 
 // System
 #define G_SYSCALL_CALL_VM86						120
@@ -102,6 +122,8 @@ __BEGIN_C
 #define G_SYSCALL_TEST							123
 #define G_SYSCALL_IRQ_CREATE_REDIRECT           124
 #define G_SYSCALL_AWAIT_IRQ         			125
+#define G_SYSCALL_POLL							126
+#define G_SYSCALL_RING_ENTER					127
 
 // Kernquery
 #define G_SYSCALL_KERNQUERY						129
@@ -218,6 +218,17 @@ void g_join(g_tid tid);
  */
 void g_sleep(uint64_t ms);
 
+/**
+ * Sleeps for the given amount of nanoseconds. The wake-up does not wait for the next
+ * scheduler tick, so sleeps well below a millisecond are possible. Without a local APIC
+ * and HPET, the sleep is still rounded up to the next tick.
+ *
+ * @param nanos the nanoseconds to sleep
+ *
+ * @security-level APPLICATION
+ */
+void g_sleep_nanos(uint64_t nanos);
+
 
 /**
  * Yields, causing a switch to the next process.
@@ -234,6 +245,9 @@ void g_yield();
 void g_yield_t(g_tid target);
 
 /**
+ * Reads the clock time from the clock page of the process, only falls back to a system
+ * call if the page is not available.
+ *
  * @return local clock time in milliseconds
  *
  * @security-level APPLICATION
@@ -241,12 +255,22 @@ void g_yield_t(g_tid target);
 uint64_t g_millis();
 
 /**
+ * Computes the time from the TSC and the calibration in the clock page. If no invariant
+ * TSC is available, this falls back to a system call.
+ *
  * @return elapsed time from HPET
  *
  * @security-level APPLICATION
  */
 uint64_t g_nanos();
 
+/**
+ * @return the clock page of the process or null if it is not available
+ *
+ * @security-level APPLICATION
+ */
+const g_clock_page* g_clock_get_page();
+
 /**
  * Sets the working directory for the current process.
  *
@@ -114,6 +114,34 @@ typedef struct _g_object_info
     uint32_t finiArraySize;
 } __attribute__((packed)) g_object_info;
 
+/**
+ * Read-only page that the kernel maps into every process to allow reading the time
+ * without a system call. While the kernel updates the page, the sequence is odd; a
+ * reader must retry if the sequence was odd or changed while reading.
+ *
+ * If the TSC is usable, nanoseconds are calculated as:
+ *   nanosBase + (((rdtsc - tscBase) * tscMultiplier) >> G_CLOCK_PAGE_TSC_SHIFT)
+ */
+typedef struct
+{
+    volatile uint32_t sequence;
+
+    /**
+     * Clock time in milliseconds of the bootstrap processor.
+     */
+    volatile uint64_t millis;
+
+    /**
+     * Whether an invariant TSC is available and was calibrated.
+     */
+    volatile uint32_t tscUsable;
+    volatile uint32_t tscMultiplier;
+    volatile uint64_t tscBase;
+    volatile uint64_t nanosBase;
+} __attribute__((packed)) g_clock_page;
+
+#define G_CLOCK_PAGE_TSC_SHIFT		24
+
 /**
  * The object information structure is used within the process information section
  * to provide details about the process.
@@ -131,6 +159,11 @@ typedef struct
      * to use a system call while within a user-space interrupt service routine.
      */
     void (*syscallKernelEntry)(uint32_t, void*);
+
+    /**
+     * Clock page mapped into the process, see {g_clock_page}.
+     */
+    const g_clock_page* clockPage;
 } __attribute__((packed)) g_process_info;
 
 /**
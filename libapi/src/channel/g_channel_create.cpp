@@ -0,0 +1,108 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/channel.h"
+#include "ghost/memory.h"
+
+static g_channel_status __g_channel_attach(g_channel* channel, g_shm shm, uint32_t initialCapacity)
+{
+	g_size size;
+	void* area = g_shm_map(shm, &size);
+	if(!area)
+		return G_CHANNEL_STATUS_FAILED;
+
+	g_channel_header* header = (g_channel_header*) area;
+	if(initialCapacity)
+	{
+		header->head = 0;
+		header->tail = 0;
+		header->readerWaiting = 0;
+		header->writerWaiting = 0;
+		header->capacity = initialCapacity;
+		header->magic = G_CHANNEL_MAGIC;
+	}
+
+	uint32_t capacity = header->capacity;
+	if(header->magic != G_CHANNEL_MAGIC || capacity < G_CHANNEL_MINIMUM_CAPACITY || (capacity & (capacity - 1)) ||
+	   capacity > size - G_CHANNEL_DATA_OFFSET)
+	{
+		g_unmap(area);
+		return G_CHANNEL_STATUS_INVALID;
+	}
+
+	channel->shm = shm;
+	channel->header = header;
+	channel->data = ((uint8_t*) area) + G_CHANNEL_DATA_OFFSET;
+	channel->capacity = capacity;
+	return G_CHANNEL_STATUS_SUCCESSFUL;
+}
+
+/**
+ *
+ */
+g_channel_status g_channel_create(g_channel* channel, uint32_t capacity)
+{
+	if(capacity > G_CHANNEL_MAXIMUM_CAPACITY)
+		return G_CHANNEL_STATUS_TOO_LARGE;
+
+	uint32_t rounded = G_CHANNEL_MINIMUM_CAPACITY;
+	while(rounded < capacity)
+		rounded <<= 1;
+
+	g_shm shm = g_shm_create(G_CHANNEL_DATA_OFFSET + rounded);
+	if(shm == G_SHM_NONE)
+		return G_CHANNEL_STATUS_FAILED;
+
+	g_channel_status status = __g_channel_attach(channel, shm, rounded);
+	if(status != G_CHANNEL_STATUS_SUCCESSFUL)
+		g_shm_release(shm);
+	return status;
+}
+
+/**
+ *
+ */
+g_channel_status g_channel_open(g_channel* channel, g_shm shm)
+{
+	return __g_channel_attach(channel, shm, 0);
+}
+
+/**
+ *
+ */
+g_channel_status g_channel_grant(g_channel* channel, g_pid pid)
+{
+	return g_shm_grant(channel->shm, pid) == G_SHM_STATUS_SUCCESSFUL ? G_CHANNEL_STATUS_SUCCESSFUL : G_CHANNEL_STATUS_INVALID;
+}
+
+/**
+ *
+ */
+void g_channel_close(g_channel* channel)
+{
+	if(channel->header)
+		g_unmap(channel->header);
+	g_shm_release(channel->shm);
+
+	channel->shm = G_SHM_NONE;
+	channel->header = nullptr;
+	channel->data = nullptr;
+	channel->capacity = 0;
+}
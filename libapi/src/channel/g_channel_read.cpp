@@ -0,0 +1,82 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/channel.h"
+#include "ghost/mutex.h"
+
+#include <string.h>
+
+// redirect
+g_channel_status g_channel_read(g_channel* channel, void* buffer, uint32_t maximum, uint32_t* out_length)
+{
+	return g_channel_read_b(channel, buffer, maximum, out_length, true);
+}
+
+/**
+ *
+ */
+g_channel_status g_channel_read_b(g_channel* channel, void* buffer, uint32_t maximum, uint32_t* out_length, g_bool blocking)
+{
+	g_channel_header* header = channel->header;
+	if(!header)
+		return G_CHANNEL_STATUS_INVALID;
+
+	uint32_t capacity = channel->capacity;
+	uint32_t tail = header->tail;
+
+	while(__atomic_load_n(&header->head, __ATOMIC_ACQUIRE) == tail)
+	{
+		if(!blocking)
+			return G_CHANNEL_STATUS_WOULD_BLOCK;
+
+		// Announce before re-checking, the writer checks the flag after publishing its head
+		__atomic_store_n(&header->readerWaiting, 1, __ATOMIC_SEQ_CST);
+		uint32_t head = __atomic_load_n(&header->head, __ATOMIC_SEQ_CST);
+		if(head == tail)
+			g_futex_wait(&header->head, head);
+		__atomic_store_n(&header->readerWaiting, 0, __ATOMIC_RELAXED);
+	}
+
+	// The writer publishes the wrap marker together with the record behind it
+	uint32_t offset = tail & (capacity - 1);
+	uint32_t length = *((uint32_t*) (channel->data + offset));
+	if(length == G_CHANNEL_RECORD_WRAP)
+	{
+		tail += capacity - offset;
+		offset = 0;
+		length = *((uint32_t*) channel->data);
+	}
+
+	if(length > capacity / 2 - sizeof(uint32_t))
+		return G_CHANNEL_STATUS_INVALID;
+
+	if(out_length)
+		*out_length = length;
+	if(length > maximum)
+		return G_CHANNEL_STATUS_TOO_LARGE;
+
+	memcpy(buffer, channel->data + offset + sizeof(uint32_t), length);
+
+	__atomic_store_n(&header->tail, tail + G_CHANNEL_RECORD_SIZE(length), __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&header->writerWaiting, __ATOMIC_SEQ_CST))
+		g_futex_wake(&header->tail);
+
+	return G_CHANNEL_STATUS_SUCCESSFUL;
+}
@@ -0,0 +1,80 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/channel.h"
+#include "ghost/mutex.h"
+
+#include <string.h>
+
+// redirect
+g_channel_status g_channel_write(g_channel* channel, const void* data, uint32_t length)
+{
+	return g_channel_write_b(channel, data, length, true);
+}
+
+/**
+ *
+ */
+g_channel_status g_channel_write_b(g_channel* channel, const void* data, uint32_t length, g_bool blocking)
+{
+	g_channel_header* header = channel->header;
+	if(!header)
+		return G_CHANNEL_STATUS_INVALID;
+
+	uint32_t capacity = channel->capacity;
+	if(length > capacity / 2 - sizeof(uint32_t))
+		return G_CHANNEL_STATUS_TOO_LARGE;
+
+	// A record that does not fit before the end of the ring is preceded by a wrap marker
+	uint32_t recordSize = G_CHANNEL_RECORD_SIZE(length);
+	uint32_t head = header->head;
+	uint32_t offset = head & (capacity - 1);
+	uint32_t contiguous = capacity - offset;
+	uint32_t required = (recordSize > contiguous) ? (contiguous + recordSize) : recordSize;
+
+	while(capacity - (head - __atomic_load_n(&header->tail, __ATOMIC_ACQUIRE)) < required)
+	{
+		if(!blocking)
+			return G_CHANNEL_STATUS_WOULD_BLOCK;
+
+		// Announce before re-checking, the reader checks the flag after publishing its tail
+		__atomic_store_n(&header->writerWaiting, 1, __ATOMIC_SEQ_CST);
+		uint32_t tail = __atomic_load_n(&header->tail, __ATOMIC_SEQ_CST);
+		if(capacity - (head - tail) < required)
+			g_futex_wait(&header->tail, tail);
+		__atomic_store_n(&header->writerWaiting, 0, __ATOMIC_RELAXED);
+	}
+
+	if(recordSize > contiguous)
+	{
+		*((uint32_t*) (channel->data + offset)) = G_CHANNEL_RECORD_WRAP;
+		head += contiguous;
+		offset = 0;
+	}
+
+	*((uint32_t*) (channel->data + offset)) = length;
+	memcpy(channel->data + offset + sizeof(uint32_t), data, length);
+
+	__atomic_store_n(&header->head, head + recordSize, __ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&header->readerWaiting, __ATOMIC_SEQ_CST))
+		g_futex_wake(&header->head);
+
+	return G_CHANNEL_STATUS_SUCCESSFUL;
+}
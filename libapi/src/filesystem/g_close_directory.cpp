@@ -29,6 +29,7 @@
  */
 void g_close_directory(g_fs_directory_iterator* iterator)
 {
+	free(iterator->records);
 	free(iterator->entry_buffer.name);
 	free(iterator);
 }
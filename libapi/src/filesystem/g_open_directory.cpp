@@ -38,6 +38,10 @@ g_fs_directory_iterator* g_open_directory_s(const char* path, g_fs_open_director
 {
 	auto iterator = (g_fs_directory_iterator*) malloc(sizeof(g_fs_directory_iterator));
 	iterator->entry_buffer.name = (char*) malloc(G_FILENAME_MAX);
+	iterator->cursor = G_FS_DIRECTORY_CURSOR_START;
+	iterator->records = (uint8_t*) malloc(G_FS_DIRECTORY_ITERATOR_BUFFER);
+	iterator->records_length = 0;
+	iterator->records_offset = 0;
 
 	g_syscall_fs_open_directory data;
 	data.path = (char*) path;
@@ -50,6 +54,8 @@ g_fs_directory_iterator* g_open_directory_s(const char* path, g_fs_open_director
 	if(data.status == G_FS_OPEN_DIRECTORY_SUCCESSFUL)
 		return iterator;
 
+	free(iterator->records);
+	free(iterator->entry_buffer.name);
 	free(iterator);
 	return nullptr;
 }
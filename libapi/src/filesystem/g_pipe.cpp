@@ -25,13 +25,20 @@
 // redirect
 g_fs_pipe_status g_pipe(g_fd* out_write, g_fd* out_read)
 {
-	return g_pipe_b(out_write, out_read, true);
+	return g_pipe_bc(out_write, out_read, true, 0);
 }
 
+// redirect
 g_fs_pipe_status g_pipe_b(g_fd* out_write, g_fd* out_read, g_bool blocking)
+{
+	return g_pipe_bc(out_write, out_read, blocking, 0);
+}
+
+g_fs_pipe_status g_pipe_bc(g_fd* out_write, g_fd* out_read, g_bool blocking, uint32_t capacity)
 {
 	g_syscall_fs_pipe data;
 	data.blocking = blocking;
+	data.capacity = capacity;
 
 	g_syscall(G_SYSCALL_FS_PIPE, (g_address) &data);
 	*out_write = data.write_fd;
@@ -23,6 +23,7 @@
 #include "ghost/filesystem/callstructs.h"
 
 #include <stdarg.h>
+#include <string.h>
 
 // redirect
 g_fs_directory_entry* g_read_directory(g_fs_directory_iterator* iterator)
@@ -35,17 +36,32 @@ g_fs_directory_entry* g_read_directory(g_fs_directory_iterator* iterator)
  */
 g_fs_directory_entry* g_read_directory_s(g_fs_directory_iterator* iterator, g_fs_read_directory_status* out_status)
 {
-	g_syscall_fs_read_directory data;
-	data.iterator = iterator;
-	g_syscall(G_SYSCALL_FS_READ_DIRECTORY, (g_address) &data);
+	if(iterator->records_offset >= iterator->records_length)
+	{
+		g_fs_read_directory_status status;
+		iterator->records_length = g_read_directory_entries_s(iterator->node_id, &iterator->cursor, iterator->records,
+		                                                      G_FS_DIRECTORY_ITERATOR_BUFFER, &status);
+		iterator->records_offset = 0;
+
+		if(out_status)
+			*out_status = status;
 
-	if(out_status)
+		if(status != G_FS_READ_DIRECTORY_SUCCESSFUL)
+			return nullptr;
+	}
+	else if(out_status)
 	{
-		*out_status = data.status;
+		*out_status = G_FS_READ_DIRECTORY_SUCCESSFUL;
 	}
 
-	if(data.status == G_FS_READ_DIRECTORY_SUCCESSFUL)
-		return &iterator->entry_buffer;
+	auto record = (g_fs_directory_record*) &iterator->records[iterator->records_offset];
+	iterator->records_offset += record->record_length;
+	++iterator->position;
 
-	return nullptr;
+	iterator->entry_buffer.node_id = record->node_id;
+	iterator->entry_buffer.type = record->type;
+	iterator->entry_buffer.size = record->size;
+	strncpy(iterator->entry_buffer.name, G_FS_DIRECTORY_RECORD_NAME(record), G_FILENAME_MAX);
+	iterator->entry_buffer.name[G_FILENAME_MAX - 1] = 0;
+	return &iterator->entry_buffer;
 }
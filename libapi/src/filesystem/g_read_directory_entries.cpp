@@ -0,0 +1,49 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/filesystem.h"
+#include "ghost/filesystem/callstructs.h"
+
+// redirect
+uint32_t g_read_directory_entries(g_fs_virt_id directory, g_fs_directory_cursor* cursor, void* buffer, uint32_t length)
+{
+	return g_read_directory_entries_s(directory, cursor, buffer, length, nullptr);
+}
+
+/**
+ *
+ */
+uint32_t g_read_directory_entries_s(g_fs_virt_id directory, g_fs_directory_cursor* cursor, void* buffer, uint32_t length,
+                                    g_fs_read_directory_status* out_status)
+{
+	g_syscall_fs_read_directory_entries data;
+	data.node_id = directory;
+	data.cursor = *cursor;
+	data.buffer = (uint8_t*) buffer;
+	data.length = length;
+	g_syscall(G_SYSCALL_FS_READ_DIRECTORY_ENTRIES, (g_address) &data);
+
+	if(out_status)
+		*out_status = data.status;
+
+	*cursor = data.cursor;
+	return data.written;
+}
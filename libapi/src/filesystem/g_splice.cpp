@@ -0,0 +1,47 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/filesystem.h"
+#include "ghost/filesystem/callstructs.h"
+
+// redirect
+int64_t g_splice(g_fd in, g_fd out, uint64_t length)
+{
+	return g_splice_s(in, out, length, nullptr);
+}
+
+/**
+ *
+ */
+int64_t g_splice_s(g_fd in, g_fd out, uint64_t length, g_fs_splice_status* out_status)
+{
+	g_syscall_fs_splice data;
+	data.in = in;
+	data.out = out;
+	data.length = length;
+
+	g_syscall(G_SYSCALL_FS_SPLICE, (g_address) &data);
+
+	if(out_status)
+		*out_status = data.status;
+
+	return data.result;
+}
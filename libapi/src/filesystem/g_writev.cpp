@@ -0,0 +1,47 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/filesystem.h"
+#include "ghost/filesystem/callstructs.h"
+
+// redirect
+int32_t g_writev(g_fd file, const g_fs_iovec* vectors, uint32_t count)
+{
+	return g_writev_s(file, vectors, count, nullptr);
+}
+
+/**
+ *
+ */
+int32_t g_writev_s(g_fd file, const g_fs_iovec* vectors, uint32_t count, g_fs_write_status* out_status)
+{
+	g_syscall_fs_writev data;
+	data.fd = file;
+	data.vectors = (g_fs_iovec*) vectors;
+	data.count = count;
+
+	g_syscall(G_SYSCALL_FS_WRITEV, (g_address) &data);
+
+	if(out_status)
+		*out_status = data.status;
+
+	return data.result;
+}
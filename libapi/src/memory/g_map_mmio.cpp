@@ -22,14 +22,21 @@
 #include "ghost/memory.h"
 #include "ghost/memory/callstructs.h"
 
+// redirect
+void* g_map_mmio(void* physicalAddress, uint32_t size)
+{
+	return g_map_mmio_f(physicalAddress, size, G_MMIO_FLAGS_NONE);
+}
+
 /**
  *
  */
-void* g_map_mmio(void* physicalAddress, uint32_t size)
+void* g_map_mmio_f(void* physicalAddress, uint32_t size, g_mmio_flags flags)
 {
 	g_syscall_map_mmio data;
 	data.physicalAddress = (g_physical_address) physicalAddress;
 	data.size = size;
+	data.flags = flags;
 
 	g_syscall(G_SYSCALL_MAP_MMIO_AREA, (g_address) &data);
 
@@ -0,0 +1,48 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/messages.h"
+#include "ghost/messages/callstructs.h"
+
+// redirect
+g_message_receive_status g_receive_messages(void* buf, size_t max, uint32_t max_count, uint32_t* out_count)
+{
+	return g_receive_messages_m(buf, max, max_count, out_count, G_MESSAGE_RECEIVE_MODE_BLOCKING);
+}
+
+/**
+ *
+ */
+g_message_receive_status g_receive_messages_m(void* buf, size_t max, uint32_t max_count, uint32_t* out_count,
+                                              g_message_receive_mode mode)
+{
+	g_syscall_receive_message_batch data;
+	data.buffer = (g_message_header*) buf;
+	data.maximum = max;
+	data.maximumCount = max_count;
+	data.mode = mode;
+
+	g_syscall(G_SYSCALL_MESSAGE_RECEIVE_BATCH, (g_address) &data);
+
+	if(out_count)
+		*out_count = data.count;
+	return data.status;
+}
@@ -29,11 +29,19 @@ g_message_send_status g_receive_topic_message(const char* topic, void* buf, size
 	return g_receive_topic_message_m(topic, buf, len, start_after, G_MESSAGE_RECEIVE_MODE_BLOCKING);
 }
 
+// redirect
+g_message_send_status g_receive_topic_message_m(const char* topic, void* buf, size_t len,
+                                                g_message_transaction start_after, g_message_receive_mode mode)
+{
+	return g_receive_topic_message_md(topic, buf, len, start_after, mode, nullptr);
+}
+
 /**
  *
  */
-g_message_send_status g_receive_topic_message_m(const char* topic, void* buf, size_t len,
-                                                g_message_transaction start_after, g_message_receive_mode mode)
+g_message_send_status g_receive_topic_message_md(const char* topic, void* buf, size_t len,
+                                                 g_message_transaction start_after, g_message_receive_mode mode,
+                                                 uint32_t* out_dropped)
 {
 	g_syscall_receive_topic_message data;
 	data.topic = topic;
@@ -44,5 +52,7 @@ g_message_send_status g_receive_topic_message_m(const char* topic, void* buf, si
 
 	g_syscall(G_SYSCALL_MESSAGE_TOPIC_RECEIVE, (g_address) &data);
 
+	if(out_dropped)
+		*out_dropped = data.dropped;
 	return data.status;
 }
@@ -0,0 +1,73 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/messages.h"
+#include "ghost/messages/callstructs.h"
+#include "ghost/memory.h"
+
+// redirect
+g_message_send_status g_send_message_grants(g_tid tid, void* buf, size_t len, g_message_grant* grants,
+                                            uint32_t grant_count)
+{
+	return g_send_message_grants_tmf(tid, buf, len, grants, grant_count, G_MESSAGE_TRANSACTION_NONE,
+	                                 G_MESSAGE_SEND_MODE_BLOCKING, G_MESSAGE_GRANT_FLAGS_SHARE);
+}
+
+// redirect
+g_message_send_status g_send_message_grants_f(g_tid tid, void* buf, size_t len, g_message_grant* grants,
+                                              uint32_t grant_count, g_message_grant_flags flags)
+{
+	return g_send_message_grants_tmf(tid, buf, len, grants, grant_count, G_MESSAGE_TRANSACTION_NONE,
+	                                 G_MESSAGE_SEND_MODE_BLOCKING, flags);
+}
+
+/**
+ *
+ */
+g_message_send_status g_send_message_grants_tmf(g_tid tid, void* buf, size_t len, g_message_grant* grants,
+                                                uint32_t grant_count, g_message_transaction tx,
+                                                g_message_send_mode mode, g_message_grant_flags flags)
+{
+	g_syscall_send_message_grants data;
+	data.receiver = tid;
+	data.buffer = buf;
+	data.length = len;
+	data.grants = grants;
+	data.grantCount = grant_count;
+	data.flags = flags;
+	data.mode = mode;
+	data.transaction = tx;
+	g_syscall(G_SYSCALL_MESSAGE_SEND_GRANTS, (g_address) &data);
+	return data.status;
+}
+
+/**
+ *
+ */
+void g_release_message_grants(void* message)
+{
+	g_message_grant* grants = G_MESSAGE_GRANTS(message);
+	for(uint32_t i = 0; i < ((g_message_header*) message)->grants; i++)
+	{
+		if(grants[i].address)
+			g_unmap(grants[i].address);
+	}
+}
@@ -0,0 +1,42 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/mutex.h"
+#include "ghost/mutex/callstructs.h"
+
+// redirect
+g_futex_status g_futex_wait(volatile uint32_t* address, uint32_t expected)
+{
+	return g_futex_wait_to(address, expected, 0);
+}
+
+/**
+ *
+ */
+g_futex_status g_futex_wait_to(volatile uint32_t* address, uint32_t expected, uint64_t timeout)
+{
+	g_syscall_futex_wait data;
+	data.address = address;
+	data.expected = expected;
+	data.timeout = timeout;
+	g_syscall(G_SYSCALL_FUTEX_WAIT, (g_address) &data);
+	return data.status;
+}
@@ -0,0 +1,58 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/syscall.h"
+#include "ghost/poll.h"
+#include "ghost/poll/callstructs.h"
+
+// redirect
+g_poll_status g_poll(g_poll_set* set)
+{
+	return g_poll_tr(set, 0, nullptr);
+}
+
+// redirect
+g_poll_status g_poll_t(g_poll_set* set, uint64_t timeout)
+{
+	return g_poll_tr(set, timeout, nullptr);
+}
+
+// redirect
+g_poll_status g_poll_tr(g_poll_set* set, uint64_t timeout, uint32_t* out_ready)
+{
+	if(timeout > 0xFFFFFFFFFFULL)
+		timeout = 0xFFFFFFFFFFULL;
+	return g_poll_tn(set, timeout * 1000000ULL, out_ready);
+}
+
+/**
+ *
+ */
+g_poll_status g_poll_tn(g_poll_set* set, uint64_t timeout_nanos, uint32_t* out_ready)
+{
+	g_syscall_poll data;
+	data.set = set;
+	data.timeout = timeout_nanos;
+	g_syscall(G_SYSCALL_POLL, (g_address) &data);
+
+	if(out_ready)
+		*out_ready = data.ready;
+	return data.status;
+}
@@ -0,0 +1,62 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/ring.h"
+#include "ghost/memory.h"
+
+/**
+ *
+ */
+g_ring_status g_ring_create(g_ring* ring, uint32_t entries)
+{
+	if(entries > G_RING_MAXIMUM_ENTRIES)
+		return G_RING_STATUS_INVALID;
+
+	uint32_t rounded = G_RING_MINIMUM_ENTRIES;
+	while(rounded < entries)
+		rounded <<= 1;
+
+	auto header = (g_ring_header*) g_alloc_mem(G_RING_SIZE(rounded));
+	if(!header)
+		return G_RING_STATUS_FAILED;
+
+	header->submissionHead = 0;
+	header->submissionTail = 0;
+	header->completionHead = 0;
+	header->completionTail = 0;
+	header->entries = rounded;
+	header->magic = G_RING_MAGIC;
+
+	ring->header = header;
+	ring->submissions = G_RING_SUBMISSIONS(header);
+	ring->completions = G_RING_COMPLETIONS(header, rounded);
+	ring->entries = rounded;
+	return G_RING_STATUS_SUCCESSFUL;
+}
+
+/**
+ *
+ */
+void g_ring_destroy(g_ring* ring)
+{
+	if(ring->header)
+		g_unmap(ring->header);
+	ring->header = nullptr;
+}
@@ -0,0 +1,60 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "ghost/ring.h"
+
+/**
+ *
+ */
+g_ring_status g_ring_submit(g_ring* ring, uint32_t call, void* data, uint64_t user_data)
+{
+	g_ring_header* header = ring->header;
+	uint32_t tail = header->submissionTail;
+	if(tail - header->submissionHead >= ring->entries)
+		return G_RING_STATUS_WOULD_BLOCK;
+
+	g_ring_submission* submission = &ring->submissions[tail & (ring->entries - 1)];
+	submission->call = call;
+	submission->data = data;
+	submission->userData = user_data;
+
+	// Entry must be complete before the kernel can see it
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	header->submissionTail = tail + 1;
+	return G_RING_STATUS_SUCCESSFUL;
+}
+
+/**
+ *
+ */
+g_ring_status g_ring_reap(g_ring* ring, g_ring_completion* out)
+{
+	g_ring_header* header = ring->header;
+	uint32_t head = header->completionHead;
+	if(head == header->completionTail)
+		return G_RING_STATUS_WOULD_BLOCK;
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	*out = ring->completions[head & (ring->entries - 1)];
+
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	header->completionHead = head + 1;
+	return G_RING_STATUS_SUCCESSFUL;
+}
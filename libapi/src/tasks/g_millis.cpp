@@ -27,6 +27,20 @@
  */
 uint64_t g_millis()
 {
+	const g_clock_page* page = g_clock_get_page();
+	if(page)
+	{
+		for(;;)
+		{
+			uint32_t sequence = page->sequence;
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			uint64_t millis = page->millis;
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if(!(sequence & 1) && sequence == page->sequence)
+				return millis;
+		}
+	}
+
 	g_syscall_millis data;
 
 	g_syscall(G_SYSCALL_GET_MILLISECONDS, (g_address) &data);
@@ -22,11 +22,36 @@
 #include "ghost/tasks.h"
 #include "ghost/tasks/callstructs.h"
 
+static inline uint64_t g_nanos_read_tsc()
+{
+	uint32_t lo, hi;
+	asm volatile("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t) hi << 32) | lo;
+}
+
 /**
  *
  */
 uint64_t g_nanos()
 {
+	const g_clock_page* page = g_clock_get_page();
+	while(page && page->tscUsable)
+	{
+		uint32_t sequence = page->sequence;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		uint64_t tscBase = page->tscBase;
+		uint64_t nanosBase = page->nanosBase;
+		uint32_t multiplier = page->tscMultiplier;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if((sequence & 1) || sequence != page->sequence)
+			continue;
+
+		uint64_t tsc = g_nanos_read_tsc();
+		if(tsc < tscBase)
+			tsc = tscBase;
+		return nanosBase + (((tsc - tscBase) * multiplier) >> G_CLOCK_PAGE_TSC_SHIFT);
+	}
+
 	g_syscall_nanos data;
 
 	g_syscall(G_SYSCALL_GET_NANOSECONDS, (g_address) &data);
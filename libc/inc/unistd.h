@@ -62,6 +62,21 @@ long int tell(int filedes);
  */
 int close(int filedes);
 
+/**
+ * POSIX wrapper for <g_fsync>
+ */
+int fsync(int filedes);
+
+/**
+ * POSIX wrapper for <g_sync>
+ */
+void sync();
+
+/**
+ * POSIX wrapper for <g_ftruncate>
+ */
+int ftruncate(int filedes, off_t length);
+
 /**
  * POSIX wrapper for <g_sbrk>
  */
@@ -40,7 +40,15 @@ struct dirent* readdir(DIR* dir) {
 		dir->entbuf->d_dev = -1; // TODO
 		dir->entbuf->d_namlen = strlen(entry->name);
 		dir->entbuf->d_reclen = -1; // TODO
-		dir->entbuf->d_type = -1; // TODO
+		if (entry->type == G_FS_NODE_TYPE_FILE) {
+			dir->entbuf->d_type = DT_REG;
+		} else if (entry->type == G_FS_NODE_TYPE_PIPE) {
+			dir->entbuf->d_type = DT_FIFO;
+		} else if (entry->type == G_FS_NODE_TYPE_NONE) {
+			dir->entbuf->d_type = DT_UNKNOWN;
+		} else {
+			dir->entbuf->d_type = DT_DIR;
+		}
 		strcpy(ent->d_name, entry->name);
 		return ent;
 
@@ -0,0 +1,47 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "unistd.h"
+#include "errno.h"
+
+/**
+ *
+ */
+int ftruncate(int filedes, off_t length) {
+
+	if (length < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	g_fs_truncate_status status = g_ftruncate(filedes, length);
+
+	if (status == G_FS_TRUNCATE_SUCCESSFUL) {
+		return 0;
+	} else if (status == G_FS_TRUNCATE_INVALID_FD) {
+		errno = EBADF;
+	} else if (status == G_FS_TRUNCATE_NOT_SUPPORTED) {
+		errno = EINVAL;
+	} else {
+		errno = EIO;
+	}
+
+	return -1;
+}
@@ -21,6 +21,11 @@ with ISO_SRC        "iso"
 with ISO_TGT        "ghost.iso"
 with GRUB_MKRESCUE  "grub-mkrescue"
 
+#
+# Disk image for the AHCI target
+#
+with DISK_IMG       "disk.img"
+
 #
 # Binaries to copy
 #
@@ -37,7 +42,7 @@ target_headline $TARGET
 #
 target_ramdisk() {
 	headline "building ramdisk"
-	$RAMDISK_WRITER "$SYSROOT" "$ISO_SRC/boot/ramdisk"
+	$RAMDISK_WRITER "$SYSROOT" "$ISO_SRC/boot/ramdisk" -c
 	failOnError
 }
 
@@ -71,6 +76,20 @@ target_qemu() {
 	fi
 }
 
+#
+# Run in QEMU with a raw disk image on an AHCI controller
+#
+target_qemu_ahci() {
+	if [ ! -e $DISK_IMG ]; then
+		qemu-img create -f raw $DISK_IMG 256M
+		failOnError
+	fi
+
+	qemu-system-i386 -cdrom $ISO_TGT -s -m 1024 -serial file:serial.log \
+		-drive id=disk,file=$DISK_IMG,if=none,format=raw \
+		-device ahci,id=ahci -device ide-hd,drive=disk,bus=ahci.0
+}
+
 #
 # Run in lingemu
 #
@@ -112,6 +131,9 @@ for var in $TARGET; do
 	elif [[ $TARGET == "lingemu" ]]; then
 		target_lingemu
 
+	elif [[ "$var" == "qemu-ahci" ]]; then
+		target_qemu_ahci
+
 	elif [[ "$var" == "qemu-debug-gdb" ]]; then
 		target_qemu_debug_gdb
 
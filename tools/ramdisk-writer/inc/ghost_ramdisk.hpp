@@ -28,6 +28,11 @@
 #define VERSION_MAJOR	1
 #define	VERSION_MINOR	0
 
+/**
+ * Size of the chunks that compressed files are split into, must match the kernel.
+ */
+#define COMPRESSED_CHUNK_SIZE	0x1000
+
 /**
  *
  */
@@ -38,15 +43,20 @@ private:
 	std::ofstream out;
 	std::list<std::string> ignores;
 
+	uint64_t uncompressedTotal;
+	uint64_t compressedTotal;
+
 	void writeRecursive(const char* basePath, const char* path, const char* name, uint32_t contentLength, uint32_t parentId, bool isFile);
+	void writeInt(char* buffer, uint32_t value);
 
 public:
 	ghost_ramdisk() :
-			idCounter(0), verbose(false)
+			idCounter(0), uncompressedTotal(0), compressedTotal(0), verbose(false), compress(false)
 	{
 	}
 
 	bool verbose;
+	bool compress;
 	void create(const char* sourcePath, const char* targetPath);
 };
 
@@ -19,6 +19,7 @@
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "../inc/ghost_ramdisk.hpp"
+#include "../inc/lz4.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -29,6 +30,8 @@
 #include <string.h>
 #include <algorithm>
 #include <list>
+#include <vector>
+#include <iterator>
 
 /**
  *
@@ -48,7 +51,10 @@ int main(int argc, char** argv)
 			std::cout << "  This program generates a Ghost ramdisk from a given source folder." << std::endl;
 			std::cout << "  To do so, use the following command syntax:" << std::endl;
 			std::cout << std::endl;
-			std::cout << "\tpath/to/source path/to/target" << std::endl;
+			std::cout << "\tpath/to/source path/to/target [-v] [-c]" << std::endl;
+			std::cout << std::endl;
+			std::cout << "  -v  list each entry that is written" << std::endl;
+			std::cout << "  -c  store files LZ4 compressed where that makes them smaller" << std::endl;
 			std::cout << std::endl;
 			return 0;
 		}
@@ -60,12 +66,15 @@ int main(int argc, char** argv)
 	if(argc >= 3)
 	{
 
-		if(argc == 4)
+		for(int i = 3; i < argc; i++)
 		{
-			char* flag = argv[3];
+			char* flag = argv[i];
 			if(strcmp(flag, "-v") == 0)
 			{
 				ramdisk.verbose = true;
+			} else if(strcmp(flag, "-c") == 0)
+			{
+				ramdisk.compress = true;
 			}
 		}
 
@@ -123,6 +132,11 @@ void ghost_ramdisk::create(const char* sourcePath, const char* targetPath)
 			writeRecursive(sourcePath, sourcePath, "", 0, 0, false);
 			int64_t written = out.tellp() - pos;
 			std::cout << "status: ramdisk successfully created, wrote " << written << " bytes" << std::endl;
+			if(compress)
+			{
+				std::cout << "status: compressed file contents from " << uncompressedTotal << " to " << compressedTotal << " bytes"
+						<< std::endl;
+			}
 		} else
 		{
 			std::cerr << "error: could not write to file '" << targetPath << "'" << std::endl;
@@ -139,6 +153,18 @@ void ghost_ramdisk::create(const char* sourcePath, const char* targetPath)
 	}
 }
 
+/**
+ *
+ */
+void ghost_ramdisk::writeInt(char* buffer, uint32_t value)
+{
+	buffer[0] = ((value >> 0) & 0xFF);
+	buffer[1] = ((value >> 8) & 0xFF);
+	buffer[2] = ((value >> 16) & 0xFF);
+	buffer[3] = ((value >> 24) & 0xFF);
+	out.write(buffer, 4);
+}
+
 /**
  *
  */
@@ -195,11 +221,43 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 		std::cout << msg.str() << std::endl;
 	}
 
+	// Read file content first, it decides whether the entry is stored compressed
+	std::vector<uint8_t> content;
+	std::vector<uint8_t> compressed;
+	std::vector<uint32_t> chunkEnds;
+	bool isCompressed = false;
+	if(isFile && compress)
+	{
+		std::ifstream fileInput(path, std::ios::in | std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(fileInput), std::istreambuf_iterator<char>());
+
+		// Chunks are compressed separately so that the kernel can unpack each of them on its own
+		for(size_t start = 0; start < content.size(); start += COMPRESSED_CHUNK_SIZE)
+		{
+			size_t length = std::min((size_t) COMPRESSED_CHUNK_SIZE, content.size() - start);
+			std::vector<uint8_t> chunk(content.begin() + start, content.begin() + start + length);
+			std::vector<uint8_t> packed = lz4Compress(chunk);
+
+			// Chunks that do not get smaller are stored as they are
+			if(packed.size() < length)
+				compressed.insert(compressed.end(), packed.begin(), packed.end());
+			else
+				compressed.insert(compressed.end(), chunk.begin(), chunk.end());
+			chunkEnds.push_back(compressed.size());
+		}
+
+		size_t packedSize = chunkEnds.size() * sizeof(uint32_t) + compressed.size();
+		isCompressed = packedSize < content.size();
+
+		uncompressedTotal += content.size();
+		compressedTotal += isCompressed ? packedSize : content.size();
+	}
+
 	// Root must not be written
 	if(entryId > 0)
 	{
-		// file or folder
-		buffer[0] = isFile ? 1 : 0;
+		// file, compressed file or folder
+		buffer[0] = isFile ? (isCompressed ? 2 : 1) : 0;
 		out.write(buffer, 1);
 
 		// id
@@ -229,7 +287,21 @@ void ghost_ramdisk::writeRecursive(const char* basePath, const char* path, const
 		out.write(buffer, namelen);
 	}
 
-	if(isFile)
+	if(isCompressed)
+	{
+		// file length, compressed length, end offset of each chunk & compressed chunks
+		writeInt(buffer, content.size());
+		writeInt(buffer, chunkEnds.size() * sizeof(uint32_t) + compressed.size());
+		for(uint32_t end : chunkEnds)
+			writeInt(buffer, end);
+		out.write((const char*) compressed.data(), compressed.size());
+
+	} else if(isFile && compress)
+	{
+		writeInt(buffer, content.size());
+		out.write((const char*) content.data(), content.size());
+
+	} else if(isFile)
 	{
 		// file length
 		buffer[0] = ((contentLength >> 0) & 0xFF);
@@ -0,0 +1,115 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *                                                                           *
+ *  Ghost, a micro-kernel based operating system for the x86 architecture    *
+ *  Copyright (C) 2015, Max Schlüssel <lokoxe@gmail.com>                     *
+ *                                                                           *
+ *  This program is free software: you can redistribute it and/or modify     *
+ *  it under the terms of the GNU General Public License as published by     *
+ *  the Free Software Foundation, either version 3 of the License, or        *
+ *  (at your option) any later version.                                      *
+ *                                                                           *
+ *  This program is distributed in the hope that it will be useful,          *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *
+ *  GNU General Public License for more details.                             *
+ *                                                                           *
+ *  You should have received a copy of the GNU General Public License        *
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.    *
+ *                                                                           *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "../inc/lz4.hpp"
+
+#include <string.h>
+
+#define LZ4_MINIMUM_MATCH		4
+#define LZ4_LAST_LITERALS		5
+#define LZ4_MATCH_FIND_LIMIT	12
+#define LZ4_MAXIMUM_OFFSET		65535
+#define LZ4_HASH_BITS			16
+
+/**
+ *
+ */
+static uint32_t lz4Read32(const std::vector<uint8_t>& input, size_t pos)
+{
+	uint32_t value;
+	memcpy(&value, &input[pos], 4);
+	return value;
+}
+
+/**
+ *
+ */
+static void lz4WriteLength(std::vector<uint8_t>& output, size_t length)
+{
+	while(length >= 255)
+	{
+		output.push_back(255);
+		length -= 255;
+	}
+	output.push_back(length);
+}
+
+/**
+ *
+ */
+static void lz4WriteSequence(std::vector<uint8_t>& output, const std::vector<uint8_t>& input, size_t literalStart, size_t literalLength,
+		size_t offset, size_t matchLength)
+{
+	size_t matchCode = matchLength ? matchLength - LZ4_MINIMUM_MATCH : 0;
+	uint8_t token = ((literalLength >= 15 ? 15 : literalLength) << 4) | (matchCode >= 15 ? 15 : matchCode);
+	output.push_back(token);
+
+	if(literalLength >= 15)
+		lz4WriteLength(output, literalLength - 15);
+	output.insert(output.end(), input.begin() + literalStart, input.begin() + literalStart + literalLength);
+
+	if(matchLength)
+	{
+		output.push_back(offset & 0xFF);
+		output.push_back((offset >> 8) & 0xFF);
+		if(matchCode >= 15)
+			lz4WriteLength(output, matchCode - 15);
+	}
+}
+
+/**
+ *
+ */
+std::vector<uint8_t> lz4Compress(const std::vector<uint8_t>& input)
+{
+	std::vector<uint8_t> output;
+	output.reserve(input.size() + input.size() / 255 + 16);
+
+	std::vector<int64_t> table(1 << LZ4_HASH_BITS, -1);
+	size_t length = input.size();
+	size_t anchor = 0;
+	size_t pos = 0;
+
+	// Matches must start before the last 12 bytes and leave the last 5 bytes as literals
+	while(length >= LZ4_MATCH_FIND_LIMIT && pos + LZ4_MATCH_FIND_LIMIT <= length)
+	{
+		uint32_t sequence = lz4Read32(input, pos);
+		uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+		int64_t candidate = table[hash];
+		table[hash] = pos;
+
+		if(candidate < 0 || pos - candidate > LZ4_MAXIMUM_OFFSET || lz4Read32(input, candidate) != sequence)
+		{
+			++pos;
+			continue;
+		}
+
+		size_t matchLength = LZ4_MINIMUM_MATCH;
+		while(pos + matchLength < length - LZ4_LAST_LITERALS && input[candidate + matchLength] == input[pos + matchLength])
+			++matchLength;
+
+		lz4WriteSequence(output, input, anchor, pos - anchor, pos - candidate, matchLength);
+		pos += matchLength;
+		anchor = pos;
+	}
+
+	lz4WriteSequence(output, input, anchor, length - anchor, 0, 0);
+	return output;
+}